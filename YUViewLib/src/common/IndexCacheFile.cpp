@@ -0,0 +1,139 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IndexCacheFile.h"
+
+#include <cstring>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace IndexCacheFile
+{
+
+namespace
+{
+
+void setupStream(QDataStream &stream)
+{
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+} // namespace
+
+FileState getFileState(const QString &filePath)
+{
+  FileState state;
+  const QFileInfo fileInfo(filePath);
+  if (fileInfo.exists())
+  {
+    state.size = fileInfo.size();
+    state.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  }
+  return state;
+}
+
+QString getIndexFilePath(const QString &filePath, const Format &format)
+{
+  const QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+  const QByteArray hash = QCryptographicHash::hash(absolutePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+  const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return QDir(cacheDir).filePath(format.cacheSubDir + "/" + QString::fromLatin1(hash) + ".idx");
+}
+
+bool load(const QString &filePath, const Format &format, const QString &formatTag, const ReadFunction &readIndex)
+{
+  const FileState fileState = getFileState(filePath);
+  if (fileState.size < 0)
+    return false;
+
+  QFile indexFile(getIndexFilePath(filePath, format));
+  if (!indexFile.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream in(&indexFile);
+  setupStream(in);
+
+  char magic[8];
+  if (in.readRawData(magic, 8) != 8 || memcmp(magic, format.magic, 8) != 0)
+    return false;
+
+  // Check that the index belongs to this file and that the file did not change since the index was saved
+  quint32 version;
+  QString path, tag;
+  qint64 fileSize, lastModified;
+  in >> version >> path >> tag >> fileSize >> lastModified;
+  if (in.status() != QDataStream::Ok || version != format.version)
+    return false;
+  if (path != QFileInfo(filePath).absoluteFilePath() || tag != formatTag || fileSize != fileState.size || lastModified != fileState.lastModified)
+    return false;
+
+  return readIndex(in) && in.status() == QDataStream::Ok;
+}
+
+bool save(const QString &filePath, const Format &format, const QString &formatTag, const FileState &parsedFileState, const WriteFunction &writeIndex)
+{
+  // Do not save an index for a file that changed while it was parsed
+  if (parsedFileState.size < 0 || !(getFileState(filePath) == parsedFileState))
+    return false;
+
+  const QString indexFilePath = getIndexFilePath(filePath, format);
+  if (!QDir().mkpath(QFileInfo(indexFilePath).absolutePath()))
+    return false;
+
+  // Write to a temporary file first so that a reader never sees a partially written index
+  QSaveFile indexFile(indexFilePath);
+  if (!indexFile.open(QIODevice::WriteOnly))
+    return false;
+
+  QDataStream out(&indexFile);
+  setupStream(out);
+
+  out.writeRawData(format.magic, 8);
+  out << format.version << QFileInfo(filePath).absoluteFilePath() << formatTag << parsedFileState.size << parsedFileState.lastModified;
+  writeIndex(out);
+
+  if (out.status() != QDataStream::Ok)
+  {
+    indexFile.cancelWriting();
+    return false;
+  }
+  return indexFile.commit();
+}
+
+} // namespace IndexCacheFile
@@ -0,0 +1,81 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QDataStream>
+#include <QString>
+
+#include <functional>
+
+/* The common part of the persistent index caches (see SeekIndexCache and StatisticsIndexCache).
+ * Building the index of a large file can take a long time. Once it is built, it is written to an index file in
+ * the cache directory. The index file is keyed by the absolute path of the file. It starts with a header which
+ * contains the type of the index file, the path, a tag of the reader/parser that created the index and the size
+ * and modification time of the file. The index is only reused if all of these match.
+ */
+namespace IndexCacheFile
+{
+
+// The state of a file that the index is valid for
+struct FileState
+{
+  qint64 size {-1};
+  qint64 lastModified {-1};
+  bool operator==(const FileState &other) const { return size == other.size && lastModified == other.lastModified; }
+};
+FileState getFileState(const QString &filePath);
+
+// The type of the index file. The magic (8 characters) and the version are checked when the file is loaded.
+// The index files of one type are saved in a sub directory of the cache directory.
+struct Format
+{
+  const char *magic;
+  quint32 version;
+  QString cacheSubDir;
+};
+
+// Get the path of the index file for the given file
+QString getIndexFilePath(const QString &filePath, const Format &format);
+
+// Open the index file of the given file and check the header. Then readIndex is called to read the rest of
+// the file. Returns false if there is no index, if it does not match the current state of the file or if
+// readIndex returns false.
+using ReadFunction = std::function<bool(QDataStream &in)>;
+bool load(const QString &filePath, const Format &format, const QString &formatTag, const ReadFunction &readIndex);
+
+// Write the header and then call writeIndex to write the index. parsedFileState is the state of the file when
+// the parsing started. If the file changed since then, the index is not saved.
+using WriteFunction = std::function<void(QDataStream &out)>;
+bool save(const QString &filePath, const Format &format, const QString &formatTag, const FileState &parsedFileState, const WriteFunction &writeIndex);
+
+} // namespace IndexCacheFile
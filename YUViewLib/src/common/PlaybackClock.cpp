@@ -0,0 +1,123 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "PlaybackClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The lowest supported frame rate (100 seconds per frame)
+#define MIN_FRAME_RATE 0.01
+
+void PlaybackClock::start(int64_t nowNs, double frameRate)
+{
+  this->frameRate = std::max(frameRate, MIN_FRAME_RATE);
+  frameDurationNs = 1e9 / this->frameRate;
+  startNs = nowNs;
+  nrFramesSinceStart = 0;
+  lastDrawnNs = -1;
+}
+
+void PlaybackClock::setFrameRate(double frameRate)
+{
+  const auto lastDueNs = int64_t(getDueTime(nrFramesSinceStart));
+  this->frameRate = std::max(frameRate, MIN_FRAME_RATE);
+  frameDurationNs = 1e9 / this->frameRate;
+  startNs = lastDueNs;
+  nrFramesSinceStart = 0;
+}
+
+int PlaybackClock::getNumberFramesDue(int64_t nowNs) const
+{
+  if (frameDurationNs <= 0)
+    return 0;
+  const auto framesSinceStart = int64_t(std::floor((nowNs - startNs) / frameDurationNs));
+  return int(std::max(framesSinceStart - nrFramesSinceStart, int64_t(0)));
+}
+
+void PlaybackClock::advance(int64_t nowNs, int nrFrames)
+{
+  nrFrames = std::max(nrFrames, 1);
+  nrFramesSinceStart += nrFrames;
+  nrDroppedFrames += nrFrames - 1;
+  nrPresentedFrames++;
+
+  const double dueNs = getDueTime(nrFramesSinceStart);
+  if (nowNs < dueNs || nowNs - dueNs > frameDurationNs)
+  {
+    startNs = nowNs;
+    nrFramesSinceStart = 0;
+  }
+}
+
+void PlaybackClock::addDrawnFrame(int64_t nowNs)
+{
+  if (lastDrawnNs >= 0)
+  {
+    const double frameTime = (nowNs - lastDrawnNs) / 1e6;
+    nrFrameTimes++;
+    frameTimeSum += frameTime;
+    frameTimeSquareSum += frameTime * frameTime;
+  }
+  lastDrawnNs = nowNs;
+}
+
+int PlaybackClock::getMsecsToNextFrame(int64_t nowNs) const
+{
+  const double nsToNextFrame = getDueTime(nrFramesSinceStart + 1) - nowNs;
+  return std::max(int(std::ceil(nsToNextFrame / 1e6)), 0);
+}
+
+double PlaybackClock::getAverageFrameRate() const
+{
+  if (nrFrameTimes == 0 || frameTimeSum <= 0)
+    return 0;
+  return nrFrameTimes * 1000.0 / frameTimeSum;
+}
+
+double PlaybackClock::getFrameTimeJitter() const
+{
+  if (nrFrameTimes == 0)
+    return 0;
+  const double mean = frameTimeSum / nrFrameTimes;
+  return std::sqrt(std::max(frameTimeSquareSum / nrFrameTimes - mean * mean, 0.0));
+}
+
+void PlaybackClock::resetStatistics()
+{
+  nrPresentedFrames = 0;
+  nrDroppedFrames = 0;
+  nrFrameTimes = 0;
+  frameTimeSum = 0;
+  frameTimeSquareSum = 0;
+}
@@ -0,0 +1,92 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+/* The clock that schedules the frames during playback. All times are given in nanoseconds of a monotonic time source
+ * (e.g. QElapsedTimer). Frames are scheduled by their presentation time relative to the start of playback
+ * (frame n is due at start + n / frameRate). So the timer that triggers the presentation may fire late or
+ * early without accumulating drift. The clock also measures the actual time between the frames that were drawn.
+ */
+class PlaybackClock
+{
+public:
+  PlaybackClock() = default;
+
+  // Start the schedule. The current frame is presented at nowNs.
+  void start(int64_t nowNs, double frameRate);
+  // Change the frame rate. The schedule continues from the frame that was presented last.
+  void setFrameRate(double frameRate);
+  double getFrameRate() const { return frameRate; }
+
+  // How many frames are due at nowNs? This is 0 if the next frame is not due yet and more than 1 if playback is late.
+  int getNumberFramesDue(int64_t nowNs) const;
+  // Advance the schedule by nrFrames. Only the last of these frames is presented (at nowNs), the others are dropped.
+  // If the frame is presented before it is due or more than one frame duration late (e.g. a late frame was not
+  // dropped), the schedule restarts from it instead of catching up.
+  void advance(int64_t nowNs, int nrFrames = 1);
+  // The time in milliseconds until the next frame is due (0 if it is due already)
+  int getMsecsToNextFrame(int64_t nowNs) const;
+
+  // A new frame was drawn at nowNs. The frame times are measured between drawn frames because the frame is only visible
+  // once the view was painted (which happens some time after the frame was presented by advance()).
+  void addDrawnFrame(int64_t nowNs);
+
+  // Statistics since the last reset. The frame rate and jitter are measured from the drawn frames.
+  double getAverageFrameRate() const;
+  // The standard deviation of the time between drawn frames in milliseconds
+  double getFrameTimeJitter() const;
+  int getNumberPresentedFrames() const { return nrPresentedFrames; }
+  int getNumberDroppedFrames() const { return nrDroppedFrames; }
+  void resetStatistics();
+
+private:
+  double getDueTime(int64_t frame) const { return double(startNs) + frame * frameDurationNs; }
+
+  double frameRate {0};
+  double frameDurationNs {0};
+  int64_t startNs {0};
+  // The number of frames that the schedule advanced since startNs
+  int64_t nrFramesSinceStart {0};
+
+  int nrPresentedFrames {0};
+  int nrDroppedFrames {0};
+  // The time that the last frame was drawn at. -1 if there is none (since the last start).
+  int64_t lastDrawnNs {-1};
+  // The number, sum and sum of squares of the times between drawn frames (in milliseconds)
+  int nrFrameTimes {0};
+  double frameTimeSum {0};
+  double frameTimeSquareSum {0};
+};
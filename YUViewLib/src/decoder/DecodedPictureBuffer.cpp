@@ -0,0 +1,122 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "DecodedPictureBuffer.h"
+
+#include <algorithm>
+
+void DecodedPictureBuffer::addPicture(int frameIdx, const QByteArray &data)
+{
+  QMutexLocker locker(&this->mutex);
+
+  for (int i = 0; i < this->pictures.size(); i++)
+  {
+    if (this->pictures[i].frameIdx == frameIdx)
+    {
+      this->size -= this->pictures[i].data.size();
+      this->pictures.removeAt(i);
+      break;
+    }
+  }
+  if (data.isEmpty() || data.size() > this->maxSize)
+    return;
+
+  this->removeOldestPictures(this->maxSize - data.size());
+  this->pictures.append({frameIdx, data});
+  this->size += data.size();
+}
+
+void DecodedPictureBuffer::setMaxSize(int64_t maxSizeInBytes)
+{
+  QMutexLocker locker(&this->mutex);
+  this->maxSize = std::max(maxSizeInBytes, int64_t(0));
+  this->removeOldestPictures(this->maxSize);
+}
+
+int64_t DecodedPictureBuffer::getMaxSize() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->maxSize;
+}
+
+bool DecodedPictureBuffer::canHold(int nrPictures, int64_t pictureSize) const
+{
+  QMutexLocker locker(&this->mutex);
+  return pictureSize > 0 && nrPictures * pictureSize <= this->maxSize;
+}
+
+void DecodedPictureBuffer::removeOldestPictures(int64_t maxSizeInBytes)
+{
+  while (!this->pictures.isEmpty() && this->size > maxSizeInBytes)
+  {
+    this->size -= this->pictures.first().data.size();
+    this->pictures.removeFirst();
+  }
+}
+
+QByteArray DecodedPictureBuffer::getPicture(int frameIdx) const
+{
+  QMutexLocker locker(&this->mutex);
+  for (const auto &picture : this->pictures)
+    if (picture.frameIdx == frameIdx)
+      return picture.data;
+  return {};
+}
+
+bool DecodedPictureBuffer::contains(int frameIdx) const
+{
+  QMutexLocker locker(&this->mutex);
+  for (const auto &picture : this->pictures)
+    if (picture.frameIdx == frameIdx)
+      return true;
+  return false;
+}
+
+void DecodedPictureBuffer::clear()
+{
+  QMutexLocker locker(&this->mutex);
+  this->pictures.clear();
+  this->size = 0;
+}
+
+int DecodedPictureBuffer::getNumberOfPictures() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->pictures.size();
+}
+
+int64_t DecodedPictureBuffer::getSizeInBytes() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->size;
+}
@@ -0,0 +1,79 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+
+/* A small buffer of raw decoded pictures (in the order in which they were decoded). If the buffer is full, the
+ * oldest pictures are removed. The interactive decoder adds all pictures that it decodes (also the ones that are
+ * decoded while seeking to a frame) so that stepping backwards within the current GOP does not require decoding
+ * all frames from the last random access point again.
+ */
+class DecodedPictureBuffer
+{
+public:
+  DecodedPictureBuffer(int64_t maxSizeInBytes = 0) : maxSize(maxSizeInBytes) {}
+
+  // Set the maximum size. If the buffer is bigger, the oldest pictures are removed. 0 disables the buffer.
+  void setMaxSize(int64_t maxSizeInBytes);
+  int64_t getMaxSize() const;
+  // Can the given number of pictures of the given size be in the buffer at the same time? If a picture would be
+  // removed again before it is needed, there is no need to copy it out of the decoder.
+  bool canHold(int nrPictures, int64_t pictureSize) const;
+
+  // Add the picture. An existing picture with the same index is replaced.
+  // Pictures that are bigger than the buffer are not added.
+  void addPicture(int frameIdx, const QByteArray &data);
+  // Get the picture. Return an empty array if the picture is not in the buffer.
+  QByteArray getPicture(int frameIdx) const;
+  bool contains(int frameIdx) const;
+  void clear();
+
+  int getNumberOfPictures() const;
+  int64_t getSizeInBytes() const;
+
+private:
+  struct Picture
+  {
+    int frameIdx;
+    QByteArray data;
+  };
+  QList<Picture> pictures;   ///< The oldest picture first
+  int64_t size {0};
+  int64_t maxSize;
+  void removeOldestPictures(int64_t maxSizeInBytes);
+  mutable QMutex mutex;
+};
@@ -0,0 +1,108 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "DecodingCostModel.h"
+
+#include <algorithm>
+#include <limits>
+
+// Until a duration was measured, seeking is assumed to cost as much as decoding this many frames.
+#define DEFAULT_SEEK_COST_IN_FRAMES 5
+
+// Seeking never costs less than decoding this many frames. Resetting the decoder drops all reference pictures and
+// frames waiting for output, so the measurements of single seeks which were fast by chance are not trusted.
+#define MIN_SEEK_COST_IN_FRAMES 2
+
+// The weight of a new measurement in the running averages
+#define MEASUREMENT_WEIGHT 0.2
+
+namespace
+{
+
+void updateAverage(double &average, double value)
+{
+  if (average < 0)
+    average = value;
+  else
+    average = (1.0 - MEASUREMENT_WEIGHT) * average + MEASUREMENT_WEIGHT * value;
+}
+
+} // namespace
+
+void DecodingCostModel::addFrameDecodeTime(double msec, int nrFrames)
+{
+  if (nrFrames > 0 && msec >= 0)
+    updateAverage(this->frameDecodeTime, msec / nrFrames);
+}
+
+void DecodingCostModel::addSeekTime(double msec)
+{
+  if (msec < 0)
+    return;
+  const double frameTime = (this->frameDecodeTime > 0) ? this->frameDecodeTime : 0.0;
+  updateAverage(this->seekTime, std::max(msec - frameTime, 0.0));
+}
+
+double DecodingCostModel::getDecodeForwardCost(int currentFrameIdx, int targetFrameIdx) const
+{
+  if (currentFrameIdx < 0 || targetFrameIdx < currentFrameIdx)
+    return std::numeric_limits<double>::infinity();
+  // Without a measurement, the cost is counted in frames
+  const double frameTime = (this->frameDecodeTime > 0) ? this->frameDecodeTime : 1.0;
+  return (targetFrameIdx - currentFrameIdx) * frameTime;
+}
+
+double DecodingCostModel::getSeekCost(int seekFrameIdx, int targetFrameIdx) const
+{
+  if (seekFrameIdx < 0 || seekFrameIdx > targetFrameIdx)
+    return std::numeric_limits<double>::infinity();
+  const double frameTime = (this->frameDecodeTime > 0) ? this->frameDecodeTime : 1.0;
+  const double seekTime = (this->frameDecodeTime > 0 && this->seekTime >= 0) ? std::max(this->seekTime, MIN_SEEK_COST_IN_FRAMES * frameTime) : DEFAULT_SEEK_COST_IN_FRAMES * frameTime;
+  // After seeking, all frames from the random access point on are decoded
+  return seekTime + (targetFrameIdx - seekFrameIdx + 1) * frameTime;
+}
+
+double DecodingCostModel::getCost(int currentFrameIdx, int targetFrameIdx, int seekFrameIdx) const
+{
+  return std::min(this->getDecodeForwardCost(currentFrameIdx, targetFrameIdx), this->getSeekCost(seekFrameIdx, targetFrameIdx));
+}
+
+bool DecodingCostModel::shouldSeek(int currentFrameIdx, int targetFrameIdx, int seekFrameIdx) const
+{
+  if (currentFrameIdx < 0 || targetFrameIdx < currentFrameIdx)
+    return true;
+  if (seekFrameIdx <= currentFrameIdx)
+    // The random access point does not get us closer to the target
+    return false;
+  return this->getSeekCost(seekFrameIdx, targetFrameIdx) < this->getDecodeForwardCost(currentFrameIdx, targetFrameIdx);
+}
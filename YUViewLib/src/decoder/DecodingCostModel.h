@@ -0,0 +1,71 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+/* Estimates the cost of getting a decoder to a certain frame. Every decoder instance has its own model because
+ * the cost depends on the codec, the resolution, the GOP structure of the stream and the threading of the decoder.
+ * The time that is needed to decode a frame and to seek (reset the decoder, seek in the file and refill the decoder
+ * until it outputs the first frame) is measured while decoding. With these, the model decides if it is cheaper to keep on decoding forward from the current position
+ * or to seek to the closest random access point before the requested frame.
+ */
+class DecodingCostModel
+{
+public:
+  DecodingCostModel() = default;
+
+  // Add measurements (in milliseconds). Decoding nrFrames frames took msec.
+  void addFrameDecodeTime(double msec, int nrFrames);
+  // The time from the start of a seek until the decoder output the first frame. The time for decoding that frame
+  // is not counted as seek time.
+  void addSeekTime(double msec);
+
+  // Estimate the cost (in milliseconds) of getting from the frame that was decoded last (currentFrameIdx, -1 if none)
+  // to the target frame. seekFrameIdx is the closest random access point before (or equal to) the target frame.
+  double getDecodeForwardCost(int currentFrameIdx, int targetFrameIdx) const;
+  double getSeekCost(int seekFrameIdx, int targetFrameIdx) const;
+  double getCost(int currentFrameIdx, int targetFrameIdx, int seekFrameIdx) const;
+
+  // Is it cheaper to seek to seekFrameIdx than to decode forward from currentFrameIdx?
+  // Seeking is always needed if nothing was decoded yet or if the target is before the current frame.
+  bool shouldSeek(int currentFrameIdx, int targetFrameIdx, int seekFrameIdx) const;
+
+  bool hasMeasurements() const { return frameDecodeTime >= 0 && seekTime >= 0; }
+  double getFrameDecodeTime() const { return frameDecodeTime; }
+  double getSeekTime() const { return seekTime; }
+
+private:
+  // Running averages of the measurements (-1 if there is no measurement yet)
+  double frameDecodeTime {-1};
+  double seekTime {-1};
+};
@@ -35,6 +35,8 @@
 #include <QDir>
 #include <QSettings>
 
+#include "common/functions.h"
+
 using namespace YUView;
 
 // Debug the decoder ( 0:off 1:interactive deocder only 2:caching decoder only 3:both)
@@ -52,6 +54,9 @@ using namespace YUView;
 #define DEBUG_DECODERBASE(fmt,...) ((void)0)
 #endif
 
+// The number of output buffers that are kept while they are still referenced (see prepareOutputBuffer)
+const int maxNrPooledOutputBuffers = 2;
+
 decoderBase::decoderBase(bool cachingDecoder)
 {
   DEBUG_DECODERBASE("decoderBase::decoderBase create base%s", cachingDecoder ? " - caching" : "");
@@ -65,9 +70,86 @@ void decoderBase::resetDecoder()
   DEBUG_DECODERBASE("decoderBase::resetDecoder");
   decoderState = DecoderState::NeedsMoreData;
   statsCacheCurPOC = -1;
+  curPOCStatsTypes.clear();
   frameSize = QSize();
   formatYUV = YUV_Internals::yuvPixelFormat();
   rawFormat = raw_Invalid;
+  currentOutputBufferFilled = false;
+}
+
+void decoderBase::prepareOutputBuffer(QByteArray &buffer, int nrBytes)
+{
+  if (buffer.isDetached() && buffer.capacity() >= nrBytes)
+  {
+    // Nobody else uses the memory. Resizing within the capacity does not reallocate.
+    buffer.resize(nrBytes);
+    return;
+  }
+
+  // The buffer is still used. Swap it with a pooled buffer that is not used anymore.
+  for (auto &pooledBuffer : outputBufferPool)
+  {
+    if (pooledBuffer.isDetached() && pooledBuffer.capacity() >= nrBytes)
+    {
+      buffer.swap(pooledBuffer);
+      buffer.resize(nrBytes);
+      return;
+    }
+  }
+
+  if (buffer.capacity() >= nrBytes)
+  {
+    // Keep the buffer until it is released. The pool only holds a few frames so that the output buffers of the
+    // decoders do not use much more memory than the frames that are still referenced anyway.
+    outputBufferPool.append(buffer);
+    if (outputBufferPool.size() > maxNrPooledOutputBuffers)
+      outputBufferPool.removeFirst();
+  }
+  buffer = QByteArray(nrBytes, Qt::Uninitialized);
+}
+
+decoderBase::Threading decoderBase::getThreadingFromSettings(bool cachingDecoder, const QString &threadingTypeSetting)
+{
+  QSettings settings;
+  const int nrCores = int(functions::getOptimalThreadCount());
+  settings.beginGroup("VideoCache");
+  const int nrCachingThreads = settings.value("SetNrThreads", false).toBool() ? settings.value("NrThreads", nrCores).toInt() : nrCores;
+  settings.endGroup();
+
+  settings.beginGroup("Decoders");
+  Threading threading;
+  threading.nrThreads = settings.value(cachingDecoder ? "CachingDecoderThreads" : "DecoderThreads", 0).toInt();
+  if (threading.nrThreads <= 0)
+    threading.nrThreads = cachingDecoder ? std::max(1, nrCores / std::max(1, nrCachingThreads)) : nrCores;
+  if (!threadingTypeSetting.isEmpty())
+    threading.type = ThreadingType(clip(settings.value(threadingTypeSetting, 0).toInt(), 0, 2));
+  settings.endGroup();
+
+  return threading;
+}
+
+void decoderBase::setStatisticsTypesToRetrieve(const QList<int> &typeIDs)
+{
+  statisticsTypesToRetrieve.clear();
+  for (int typeID : typeIDs)
+    statisticsTypesToRetrieve.insert(typeID);
+}
+
+bool decoderBase::isStatisticsTypeAvailable(int typeIdx) const
+{
+  // The statistics in curPOCStats belong to the current frame only if it was copied to the output buffer
+  if (!retrieveStatistics || !currentOutputBufferFilled)
+    return false;
+  // Types that were not extracted yet can be extracted from the current frame
+  return curPOCStatsTypes.contains(typeIdx) || internalsSupported;
+}
+
+void decoderBase::cacheStatisticsOfCurrentFrame()
+{
+  curPOCStats.clear();
+  curPOCStatsTypes = statisticsTypesToRetrieve;
+  if (!curPOCStatsTypes.isEmpty())
+    cacheStatistics(curPOCStatsTypes);
 }
 
 statisticsData decoderBase::getStatisticsData(int typeIdx)
@@ -75,7 +157,15 @@ statisticsData decoderBase::getStatisticsData(int typeIdx)
   if (!retrieveStatistics)
     return statisticsData();
 
-  return curPOCStats[typeIdx];
+  if (!curPOCStatsTypes.contains(typeIdx) && isStatisticsTypeAvailable(typeIdx))
+  {
+    // The type was not extracted with the frame (e.g. it was just enabled). The frame is still in the decoder.
+    DEBUG_DECODERBASE("decoderBase::getStatisticsData extracting type %d on demand", typeIdx);
+    curPOCStatsTypes.insert(typeIdx);
+    cacheStatistics(QSet<int>() << typeIdx);
+  }
+
+  return curPOCStats.value(typeIdx);
 }
 
 void decoderBaseSingleLib::loadDecoderLibrary(QString specificLibrary)
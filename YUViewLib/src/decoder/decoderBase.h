@@ -33,6 +33,9 @@
 #pragma once
 
 #include <QLibrary>
+#include <QSet>
+
+#include <optional>
 
 #include "filesource/FileSourceAnnexBFile.h"
 #include "statistics/statisticHandler.h"
@@ -53,6 +56,23 @@ public:
   decoderBase(bool cachingDecoder=false);
   virtual ~decoderBase() {};
 
+  // The threading configuration of a decoder. Not all decoders support all types of threading.
+  enum class ThreadingType
+  {
+    FrameAndSlice, ///< Decode several frames in parallel and parallelize within a frame (slices, tiles, wavefronts)
+    Frame,         ///< Only decode several frames in parallel. This adds latency.
+    Slice          ///< Only parallelize within a frame
+  };
+  struct Threading
+  {
+    int nrThreads {1};
+    ThreadingType type {ThreadingType::FrameAndSlice};
+  };
+  // Get the threading configuration of the given decoder backend from the settings ("Decoders" group). By default, the
+  // interactive decoder uses all cores. The caching decoders run in parallel (one per caching thread) so they share the cores.
+  static Threading getThreadingFromSettings(bool cachingDecoder, const QString &threadingTypeSetting = {});
+  Threading getThreading() const { return threading; }
+
   // Reset the decoder. Afterwards, the decoder should behave as if you just created a new one (without
   // the overhead of reloading the libraries). This must be used in case of errors or when seeking.
   virtual void resetDecoder();
@@ -87,6 +107,12 @@ public:
   bool statisticsSupported() const { return internalsSupported; }
   bool statisticsEnabled() const { return retrieveStatistics; }
   void enableStatisticsRetrieval() { retrieveStatistics = true; }
+  void disableStatisticsRetrieval() { retrieveStatistics = false; }
+  // Only the statistics of these types (usually the ones that are rendered) are extracted from each frame.
+  void setStatisticsTypesToRetrieve(const QList<int> &typeIDs);
+  // Are the statistics of the given type available for the current frame? Types that were not extracted yet are
+  // extracted on demand by getStatisticsData as long as the decoder still holds the current frame.
+  bool isStatisticsTypeAvailable(int typeIdx) const;
   statisticsData getStatisticsData(int typeIdx);
   virtual void fillStatisticList(statisticHandler &statSource) const { Q_UNUSED(statSource); };
 
@@ -117,6 +143,7 @@ protected:
   
   int decodeSignal { 0 }; ///< Which signal should be decoded?
   bool isCachingDecoder; ///< Is this the caching or the interactive decoder?
+  Threading threading;   ///< Set in the constructor of the decoder (if the decoder supports threading)
 
   bool internalsSupported { false };  ///< Enable in the constructor if you support statistics
   bool retrieveStatistics { false };  ///< If enabled, the decoder should also retrive statistics data from the bitstream
@@ -132,9 +159,31 @@ protected:
   bool setErrorB(const QString &reason) { setError(reason); return false; }
   QString errorString;
   
+  // The decoders copy the current frame to their output buffer (currentOutputBuffer) which is returned by getRawFrameData.
+  // The buffer is not freed when the next frame is decoded. If the caller does not hold a reference to the previous
+  // frame anymore (e.g. a caching decoder whose frame was already converted), the memory is reused for the next frame.
+  // If the caller still holds it (e.g. the loading decoder whose previous frame is still shown), the buffer is put into
+  // a small pool and a pooled buffer that was released in the meantime is used instead. Only if there is none, new
+  // memory is allocated without copying the outdated frame data (as detaching would do).
+  void prepareOutputBuffer(QByteArray &buffer, int nrBytes);
+  QList<QByteArray> outputBufferPool;
+#if SSE_CONVERSION
+  static void prepareOutputBuffer(byteArrayAligned &buffer, int nrBytes) { if (buffer.size() != nrBytes) buffer.resize(nrBytes); }
+#endif
+  bool currentOutputBufferFilled { false };  ///< Was the current frame copied to the output buffer yet?
+
   // Statistics caching
   QHash<int, statisticsData> curPOCStats;  // cache of the statistics for the current POC [statsTypeID]
   int statsCacheCurPOC;                    // the POC of the statistics that are in the curPOCStats
+  QSet<int> statisticsTypesToRetrieve;     // The types that are extracted from every frame
+  QSet<int> curPOCStatsTypes;              // The types that were extracted to curPOCStats for the current frame
+
+  // Clear curPOCStats and extract the statistics types to retrieve from the current frame. Call this when
+  // the current frame is copied to the output buffer.
+  void cacheStatisticsOfCurrentFrame();
+  // Extract the statistics of the given types from the current frame and add them to curPOCStats.
+  // Decoders that support statistics must only extract the requested types.
+  virtual void cacheStatistics(const QSet<int> &typeIDs) { Q_UNUSED(typeIDs); }
 };
 
 // This abstract base class extends the decoderBase class by the ability to load one single library
@@ -76,10 +76,11 @@ decoderDav1d_Functions::decoderDav1d_Functions()
   memset(this, 0, sizeof(*this));
 }
 
-decoderDav1d::decoderDav1d(int signalID, bool cachingDecoder) :
+decoderDav1d::decoderDav1d(int signalID, bool cachingDecoder, std::optional<Threading> customThreading) :
   decoderBaseSingleLib(cachingDecoder)
 {
   currentOutputBuffer.clear();
+  threading = customThreading.value_or(getThreadingFromSettings(cachingDecoder, "dav1dThreading"));
 
   // Libde265 can only decoder HEVC in YUV format
   rawFormat = raw_YUV;
@@ -182,6 +183,25 @@ void decoderDav1d::allocateNewDecoder()
 
   dav1d_default_settings(&settings);
 
+  // Frame threads decode several frames in parallel. Tile threads work on the tiles of each of these frames.
+  const auto nrThreads = clip(threading.nrThreads, 1, 256);
+  if (threading.type == ThreadingType::Frame)
+  {
+    settings.n_frame_threads = nrThreads;
+    settings.n_tile_threads = 1;
+  }
+  else if (threading.type == ThreadingType::Slice)
+  {
+    settings.n_frame_threads = 1;
+    settings.n_tile_threads = std::min(nrThreads, 64);
+  }
+  else
+  {
+    settings.n_tile_threads = std::min(nrThreads, 4);
+    settings.n_frame_threads = std::max(1, nrThreads / settings.n_tile_threads);
+  }
+  DEBUG_DAV1D("decoderDav1d::allocateNewDecoder - %d frame threads, %d tile threads", settings.n_frame_threads, settings.n_tile_threads);
+
   // Create new decoder object
   int err = dav1d_open(&decoder, &settings);
   if (err != 0)
@@ -218,7 +238,6 @@ void decoderDav1d::allocateNewDecoder()
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  currentOutputBuffer.clear();
   decodedFrameWaiting = false;
   flushing = false;
 }
@@ -280,7 +299,7 @@ bool decoderDav1d::decodeFrame()
     DEBUG_DAV1D("decoderDav1d::decodeFrame Picture decoded - switching to retrieve frame mode");
 
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBufferFilled = false;
     return true;
   }
   else if (res != -EAGAIN)
@@ -306,15 +325,16 @@ QByteArray decoderDav1d::getRawFrameData()
     return QByteArray();
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (!currentOutputBufferFilled)
   {
     // Put image data into buffer
     copyImgToByteArray(curPicture, currentOutputBuffer);
+    currentOutputBufferFilled = true;
     DEBUG_DAV1D("decoderDav1d::getRawFrameData copied frame to buffer");
 
     if (retrieveStatistics)
       // Get the statistics from the image and put them into the statistics cache
-      cacheStatistics(curPicture);
+      cacheStatisticsOfCurrentFrame();
   }
 
   return currentOutputBuffer;
@@ -430,9 +450,7 @@ void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, QByteArray
 
   DEBUG_DAV1D("decoderDav1d::copyImgToByteArray nrBytes %d", nrBytes);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytes)
-   dst.resize(nrBytes);
+  decoderBase::prepareOutputBuffer(dst, nrBytes);
 
   uint8_t *dst_c = (uint8_t*)dst.data();
 
@@ -706,16 +724,14 @@ void decoderDav1d::fillStatisticList(statisticHandler &statSource) const
   statSource.addStatType(transformDepth);
 }
 
-void decoderDav1d::cacheStatistics(const Dav1dPictureWrapper &img)
+void decoderDav1d::cacheStatistics(const QSet<int> &typeIDs)
 {
   if (!internalsSupported)
     return;
 
   DEBUG_DAV1D("decoderDav1d::cacheStatistics");
 
-  // Clear the local statistics cache
-  curPOCStats.clear();
-
+  const Dav1dPictureWrapper &img = curPicture;
   Av1Block *blockData = img.getBlockData();
   Dav1dFrameHeader *frameHeader = img.getFrameHeader();
   if (frameHeader == nullptr)
@@ -723,6 +739,8 @@ void decoderDav1d::cacheStatistics(const Dav1dPictureWrapper &img)
 
   dav1dFrameInfo frameInfo(img.getFrameSize(), frameHeader->frame_type);
   frameInfo.frameSize = img.getFrameSize();
+  for (int typeID = 0; typeID < dav1dFrameInfo::nrStatisticsTypes; typeID++)
+    frameInfo.retrieveType[typeID] = typeIDs.contains(typeID);
 
   const int sb_step = subBlockSize >> 2;
 
@@ -845,38 +863,49 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
   // Set prediction mode (ID 0)
   const bool isIntra = (b.intra != 0);
   const int predMode = isIntra ? 0 : 1;
-  curPOCStats[0].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, predMode);
+  if (frameInfo.retrieveType[0])
+    curPOCStats[0].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, predMode);
 
   bool FrameIsIntra = (frameInfo.frameType == DAV1D_FRAME_TYPE_KEY || frameInfo.frameType == DAV1D_FRAME_TYPE_INTRA);
-  if (FrameIsIntra)
+  if (FrameIsIntra && frameInfo.retrieveType[1])
   {
     // Set the segment ID (ID 1)
     curPOCStats[1].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.seg_id);
   }
 
   // Set the skip "flag" (ID 2)
-  curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip);
+  if (frameInfo.retrieveType[2])
+    curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip);
 
   // Set the skip_mode (ID 3)
-  curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip_mode);
+  if (frameInfo.retrieveType[3])
+    curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip_mode);
 
   if (isIntra)
   {
     // Set the intra pred mode luma/chrmoa (ID 4, 5)
-    curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_mode);
-    curPOCStats[5].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_mode);
+    if (frameInfo.retrieveType[4])
+      curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_mode);
+    if (frameInfo.retrieveType[5])
+      curPOCStats[5].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_mode);
 
     // Set the palette size Y/UV (ID 6, 7)
-    curPOCStats[6].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[0]);
-    curPOCStats[7].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[1]);
+    if (frameInfo.retrieveType[6])
+      curPOCStats[6].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[0]);
+    if (frameInfo.retrieveType[7])
+      curPOCStats[7].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[1]);
 
     // Set the intra angle delta luma/chroma (ID 8, 9)
-    curPOCStats[8].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_angle);
-    curPOCStats[9].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_angle);
+    if (frameInfo.retrieveType[8])
+      curPOCStats[8].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_angle);
+    if (frameInfo.retrieveType[9])
+      curPOCStats[9].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_angle);
 
     // Calculate and set the intra prediction direction luma/chroma (ID 10, 11)
     for (int yc=0; yc<2; yc++)
     {
+      if (!frameInfo.retrieveType[10 + yc])
+        continue;
       int angleDelta = (yc == 0) ? b.y_angle : b.uv_angle;
       IntraPredMode predMode = (yc == 0) ? (IntraPredMode)b.y_mode : (IntraPredMode)b.uv_mode;
       QIntPair vec = calculateIntraPredDirection(predMode, angleDelta);
@@ -893,8 +922,10 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
     if (b.y_mode == CFL_PRED)
     {
       // Set the chroma from luma alpha U/V (ID 12, 13)
-      curPOCStats[12].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[0]);
-      curPOCStats[13].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[1]);
+      if (frameInfo.retrieveType[12])
+        curPOCStats[12].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[0]);
+      if (frameInfo.retrieveType[13])
+        curPOCStats[13].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[1]);
     }
   }
   else // inter
@@ -903,45 +934,55 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
     bool isCompound = (compoundType != COMP_INTER_NONE);
 
     // Set the reference frame indices 0/1 (ID 14, 15)
-    curPOCStats[14].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[0]);
-    if (isCompound)
+    if (frameInfo.retrieveType[14])
+      curPOCStats[14].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[0]);
+    if (isCompound && frameInfo.retrieveType[15])
       curPOCStats[15].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[1]);
 
     // Set the compound prediction type (ID 16)
-    curPOCStats[16].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.comp_type);
+    if (frameInfo.retrieveType[16])
+      curPOCStats[16].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.comp_type);
 
     // Set the wedge index (ID 17)
-    if (b.comp_type == COMP_INTER_WEDGE || b.interintra_type == INTER_INTRA_WEDGE)
+    if ((b.comp_type == COMP_INTER_WEDGE || b.interintra_type == INTER_INTRA_WEDGE) && frameInfo.retrieveType[17])
       curPOCStats[17].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.wedge_idx);
 
     // Set the mask sign (ID 18)
-    if (isCompound) // TODO: This might not be correct
+    if (isCompound && frameInfo.retrieveType[18]) // TODO: This might not be correct
       curPOCStats[18].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.mask_sign);
 
     // Set the inter mode (ID 19)
-    curPOCStats[19].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.inter_mode);
+    if (frameInfo.retrieveType[19])
+      curPOCStats[19].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.inter_mode);
 
     // Set the dynamic reference list index (ID 20)
-    if (isCompound) // TODO: This might not be correct
+    if (isCompound && frameInfo.retrieveType[20]) // TODO: This might not be correct
       curPOCStats[20].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.drl_idx);
 
     if (isCompound)
     {
       // Set inter intra type (ID 21)
-      curPOCStats[21].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_type);
+      if (frameInfo.retrieveType[21])
+        curPOCStats[21].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_type);
       // Set inter intra mode (ID 22)
-      curPOCStats[22].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_mode);
+      if (frameInfo.retrieveType[22])
+        curPOCStats[22].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_mode);
     }
 
     // Set motion mode (ID 23)
-    curPOCStats[23].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.motion_mode);
+    if (frameInfo.retrieveType[23])
+      curPOCStats[23].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.motion_mode);
 
     // Set motion vector 0/1 (ID 24, 25)
-    curPOCStats[24].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[0].x, b.mv[0].y);
-    if (isCompound)
+    if (frameInfo.retrieveType[24])
+      curPOCStats[24].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[0].x, b.mv[0].y);
+    if (isCompound && frameInfo.retrieveType[25])
       curPOCStats[25].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[1].x, b.mv[1].y);
   }
 
+  if (!frameInfo.retrieveType[26])
+    return;
+
   const TxfmSize tx_val = TxfmSize(isIntra ? b.tx : b.max_ytx);
   static const int TxfmSizeWidthTable[] = {4, 8, 16, 32, 64, 4, 8, 8, 16, 16, 32, 32, 64, 4, 16, 8, 32, 16, 64};
   static const int TxfmSizeHeightTable[] = { 4, 8, 16, 32, 64, 8, 4, 16, 8, 32, 16, 64, 32, 16, 4, 32, 8, 64, 16};
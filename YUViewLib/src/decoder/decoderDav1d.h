@@ -63,7 +63,8 @@ struct decoderDav1d_Functions
 class decoderDav1d : public decoderBaseSingleLib, public decoderDav1d_Functions 
 {
 public:
-  decoderDav1d(int signalID, bool cachingDecoder=false);
+  // If no threading is given, the threading is read from the settings
+  decoderDav1d(int signalID, bool cachingDecoder=false, std::optional<Threading> customThreading={});
   ~decoderDav1d();
 
   void resetDecoder() Q_DECL_OVERRIDE;
@@ -166,11 +167,14 @@ private:
     QSize sizeInBlocksAligned;
     int b4_stride;
     Dav1dFrameType frameType;
+    // Which of the statistics types (fillStatisticList) should be extracted?
+    static const int nrStatisticsTypes = 27;
+    bool retrieveType[nrStatisticsTypes] {};
   };
 
   // Statistics
   void fillStatisticList(statisticHandler &statSource) const Q_DECL_OVERRIDE;
-  void cacheStatistics(const Dav1dPictureWrapper &img);
+  void cacheStatistics(const QSet<int> &typeIDs) Q_DECL_OVERRIDE;
   void parseBlockRecursive(Av1Block *blockData, int x, int y, BlockLevel level, dav1dFrameInfo &frameInfo);
   void parseBlockPartition(Av1Block *blockData, int x, int y, int blockWidth4, int blockHeight4, dav1dFrameInfo &frameInfo);
   QIntPair calculateIntraPredDirection(IntraPredMode predMode, int angleDelta);
@@ -44,9 +44,11 @@ using namespace YUView;
 using namespace YUV_Internals;
 using namespace RGB_Internals;
 
-decoderFFmpeg::decoderFFmpeg(AVCodecIDWrapper codecID, QSize size, QByteArray extradata, yuvPixelFormat fmt, QPair<int,int> profileLevel, QPair<int,int> sampleAspectRatio, bool cachingDecoder) : 
+decoderFFmpeg::decoderFFmpeg(AVCodecIDWrapper codecID, QSize size, QByteArray extradata, yuvPixelFormat fmt, QPair<int,int> profileLevel, QPair<int,int> sampleAspectRatio, bool cachingDecoder, std::optional<Threading> customThreading) : 
   decoderBase(cachingDecoder)
 {
+  this->threading = customThreading.value_or(getThreadingFromSettings(cachingDecoder, "FFmpegThreading"));
+
   // The libraries are only loaded on demand. This way a FFmpegLibraries instance can exist without loading 
   // the libraries which is slow and uses a lot of memory.
   if (!this->ff.loadFFmpegLibraries())
@@ -85,9 +87,11 @@ decoderFFmpeg::decoderFFmpeg(AVCodecIDWrapper codecID, QSize size, QByteArray ex
   DEBUG_FFMPEG("Created new FFmpeg decoder - codec %s%s", this->getCodecName(), cachingDecoder ? " - caching" : "");
 }
 
-decoderFFmpeg::decoderFFmpeg(AVCodecParametersWrapper codecpar, bool cachingDecoder) :
+decoderFFmpeg::decoderFFmpeg(AVCodecParametersWrapper codecpar, bool cachingDecoder, std::optional<Threading> customThreading) :
   decoderBase(cachingDecoder)
 {
+  this->threading = customThreading.value_or(getThreadingFromSettings(cachingDecoder, "FFmpegThreading"));
+
   // The libraries are only loaded on demand. This way a FFmpegLibraries instance can exist without loading 
   // the libraries which is slow and uses a lot of memory.
   if (!this->ff.loadFFmpegLibraries())
@@ -138,11 +142,9 @@ bool decoderFFmpeg::decodeNextFrame()
   if (!decodeFrame())
     return false;
 
-  copyCurImageToBuffer();
-  
-  if (retrieveStatistics)
-    // Get the statistics from the image and put them into the statistics cache
-    cacheCurStatistics();
+  // The frame is only copied to the output buffer (and the statistics are only extracted) if it is
+  // requested (getRawFrameData). Frames that are decoded while seeking to a frame are never copied.
+  this->currentOutputBufferFilled = false;
 
   return true;
 }
@@ -155,7 +157,16 @@ QByteArray decoderFFmpeg::getRawFrameData()
     return QByteArray();
   }
 
-  DEBUG_FFMPEG("decoderFFmpeg::getYUVFrameData Copy frame");
+  if (!this->currentOutputBufferFilled)
+  {
+    DEBUG_FFMPEG("decoderFFmpeg::getYUVFrameData Copy frame");
+    copyCurImageToBuffer();
+    this->currentOutputBufferFilled = true;
+
+    if (retrieveStatistics)
+      // Get the statistics from the image and put them into the statistics cache
+      this->cacheStatisticsOfCurrentFrame();
+  }
 
   if (this->currentOutputBuffer.isEmpty())
     DEBUG_FFMPEG("decoderFFmpeg::loadYUVFrameData empty buffer");
@@ -181,9 +192,7 @@ void decoderFFmpeg::copyCurImageToBuffer()
     const auto nrBytesC = this->frameSize.width() / pixFmt.getSubsamplingHor() * this->frameSize.height() / pixFmt.getSubsamplingVer() * nrBytesPerSample;
     const auto nrBytes = nrBytesY + 2 * nrBytesC;
 
-    // Is the output big enough?
-    if (this->currentOutputBuffer.capacity() < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
+    decoderBase::prepareOutputBuffer(this->currentOutputBuffer, nrBytes);
 
     // Copy line by line. The linesize of the source may be larger than the width of the frame.
     // This may be because the frame buffer is (8) byte aligned. Also the internal decoded
@@ -213,9 +222,7 @@ void decoderFFmpeg::copyCurImageToBuffer()
     const auto nrBytesPerComponent = this->frameSize.width() * this->frameSize.height() * nrBytesPerSample;
     const auto nrBytes = 3 * nrBytesPerComponent;
 
-    // Is the output big enough?
-    if (this->currentOutputBuffer.capacity() < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
+    decoderBase::prepareOutputBuffer(this->currentOutputBuffer, nrBytes);
 
     char* dst = this->currentOutputBuffer.data();
     const auto hDst = this->frameSize.height();
@@ -254,13 +261,13 @@ void decoderFFmpeg::copyCurImageToBuffer()
   }
 }
 
-void decoderFFmpeg::cacheCurStatistics()
+void decoderFFmpeg::cacheStatistics(const QSet<int> &typeIDs)
 {
   // Copy the statistics of the current frame to the buffer
-  DEBUG_FFMPEG("decoderFFmpeg::cacheCurStatistics");
+  DEBUG_FFMPEG("decoderFFmpeg::cacheStatistics");
 
-  // Clear the local statistics cache
-  this->curPOCStats.clear();
+  if (!frame)
+    return;
 
   // Try to get the motion information
   AVFrameSideDataWrapper sd = this->ff.get_side_data(frame, AV_FRAME_DATA_MOTION_VECTORS);
@@ -277,8 +284,12 @@ void decoderFFmpeg::cacheCurStatistics()
       const int16_t mvX = mvs.dst_x - mvs.src_x;
       const int16_t mvY = mvs.dst_y - mvs.src_y;
 
-      this->curPOCStats[mvs.source < 0 ? 0 : 1].addBlockValue(blockX, blockY, mvs.w, mvs.h, (int)mvs.source);
-      this->curPOCStats[mvs.source < 0 ? 2 : 3].addBlockVector(blockX, blockY, mvs.w, mvs.h, mvX, mvY);
+      const int valueTypeID = mvs.source < 0 ? 0 : 1;
+      const int vectorTypeID = mvs.source < 0 ? 2 : 3;
+      if (typeIDs.contains(valueTypeID))
+        this->curPOCStats[valueTypeID].addBlockValue(blockX, blockY, mvs.w, mvs.h, (int)mvs.source);
+      if (typeIDs.contains(vectorTypeID))
+        this->curPOCStats[vectorTypeID].addBlockVector(blockX, blockY, mvs.w, mvs.h, mvX, mvY);
     }
   }
 }
@@ -455,6 +466,14 @@ bool decoderFFmpeg::createDecoder(AVCodecIDWrapper codecID, AVCodecParametersWra
   if (ret < 0)
     return this->setErrorB(QStringLiteral("Could not request motion vector retrieval. Return code %1").arg(ret));
 
+  // Configure the threading. These are generic options so this works for all versions of the libraries.
+  const auto threadType = (this->threading.type == ThreadingType::Frame) ? "frame" : (this->threading.type == ThreadingType::Slice) ? "slice" : "frame+slice";
+  ret = this->ff.av_dict_set(opts, "threads", QString::number(this->threading.nrThreads).toLatin1().constData(), 0);
+  if (ret >= 0)
+    ret = this->ff.av_dict_set(opts, "thread_type", threadType, 0);
+  if (ret < 0)
+    return this->setErrorB(QStringLiteral("Could not set the decoder threading options. Return code %1").arg(ret));
+
   // Open codec
   ret = this->ff.avcodec_open2(decCtx, videoCodec, opts);
   if (ret < 0)
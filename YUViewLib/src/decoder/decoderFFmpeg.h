@@ -38,8 +38,9 @@
 class decoderFFmpeg : public decoderBase
 {
 public:
-  decoderFFmpeg(AVCodecIDWrapper codec, QSize frameSize, QByteArray extradata, YUV_Internals::yuvPixelFormat fmt, QPair<int,int> profileLevel, QPair<int,int> sampleAspectRatio, bool cachingDecoder=false);
-  decoderFFmpeg(AVCodecParametersWrapper codecpar, bool cachingDecoder=false);
+  // If no threading is given, the threading is read from the settings
+  decoderFFmpeg(AVCodecIDWrapper codec, QSize frameSize, QByteArray extradata, YUV_Internals::yuvPixelFormat fmt, QPair<int,int> profileLevel, QPair<int,int> sampleAspectRatio, bool cachingDecoder=false, std::optional<Threading> customThreading={});
+  decoderFFmpeg(AVCodecParametersWrapper codecpar, bool cachingDecoder=false, std::optional<Threading> customThreading={});
   ~decoderFFmpeg();
 
   void resetDecoder() Q_DECL_OVERRIDE;
@@ -76,7 +77,7 @@ protected:
   bool decodeFrame();
 
   // Statistics caching
-  void cacheCurStatistics();
+  void cacheStatistics(const QSet<int> &typeIDs) Q_DECL_OVERRIDE;
 
   QByteArray currentOutputBuffer;
   void copyCurImageToBuffer();   // Copy the raw data from the de265_image source *src to the byte array
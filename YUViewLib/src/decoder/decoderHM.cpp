@@ -280,7 +280,7 @@ bool decoderHM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBufferFilled = false;
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this 
@@ -299,15 +299,16 @@ QByteArray decoderHM::getRawFrameData()
     return QByteArray();
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (!currentOutputBufferFilled)
   {
     // Put image data into buffer
     copyImgToByteArray(currentHMPic, currentOutputBuffer);
+    currentOutputBufferFilled = true;
     DEBUG_DECHM("decoderHM::getRawFrameData copied frame to buffer");
 
     if (retrieveStatistics)
       // Get the statistics from the image and put them into the statistics cache
-      cacheStatistics(currentHMPic);
+      cacheStatisticsOfCurrentFrame();
   }
 
   return currentOutputBuffer;
@@ -340,9 +341,7 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
   int nrBytesOutput = (outSizeY + outSizeCb + outSizeCr) * (outputTwoByte ? 2 : 1);
   DEBUG_DECHM("decoderHM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
-    dst.resize(nrBytesOutput);
+  decoderBase::prepareOutputBuffer(dst, nrBytesOutput);
 
   // The source (from HM) is always short (16bit). The destination is a QByteArray so
   // we have to cast it right.
@@ -398,16 +397,14 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
   }
 }
 
-void decoderHM::cacheStatistics(libHMDec_picture *img)
+void decoderHM::cacheStatistics(const QSet<int> &typeIDs)
 {
-  if (!internalsSupported)
+  if (!internalsSupported || currentHMPic == nullptr)
     return;
 
+  libHMDec_picture *img = currentHMPic;
   DEBUG_DECHM("decoderHM::cacheStatistics POC %d", libHMDEC_get_POC(img));
 
-  // Clear the local statistics cache
-  curPOCStats.clear();
-
   // Conversion from intra prediction mode to vector.
   // Coordinates are in x,y with the axes going right and down.
   static const int vectorTable[35][2] = 
@@ -424,11 +421,13 @@ void decoderHM::cacheStatistics(libHMDec_picture *img)
     {-32, 32} 
   };
 
-  // Get all the statistics
-  // TODO: Could we only retrieve the statistics that are active/displayed?
+  // Get the requested statistics
   unsigned int nrTypes = libHMDEC_get_internal_type_number();
   for (unsigned int t = 0; t <= nrTypes; t++)
   {
+    if (!typeIDs.contains(int(t)))
+      continue;
+
     bool callAgain;
     do
     {
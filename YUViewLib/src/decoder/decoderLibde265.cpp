@@ -61,10 +61,11 @@ decoderLibde265_Functions::decoderLibde265_Functions()
   memset(this, 0, sizeof(*this)); 
 }
 
-decoderLibde265::decoderLibde265(int signalID, bool cachingDecoder) :
+decoderLibde265::decoderLibde265(int signalID, bool cachingDecoder, std::optional<Threading> customThreading) :
   decoderBaseSingleLib(cachingDecoder)
 {
   currentOutputBuffer.clear();
+  threading = customThreading.value_or(getThreadingFromSettings(cachingDecoder));
 
   // Libde265 can only decoder HEVC in YUV format
   rawFormat = raw_YUV;
@@ -220,15 +221,13 @@ void decoderLibde265::allocateNewDecoder()
   // The highest temporal ID to decode. Set this to very high (all) by default.
   de265_set_limit_TID(decoder, 100);
 
-  // Set the number of decoder threads. Libde265 can use wavefronts to utilize these.
-  // TODO: We should add a setting for this maybe?
-  de265_error err = de265_start_worker_threads(decoder, 8);
+  // Set the number of decoder threads. Libde265 can use wavefronts and tiles to utilize these (no frame threading).
+  de265_error err = de265_start_worker_threads(decoder, threading.nrThreads);
   if (err != DE265_OK)
     return setError("Error starting libde265 worker threads (de265_start_worker_threads)");
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  currentOutputBuffer.clear();
   decodedFrameWaiting = false;
   flushing = false;
 }
@@ -308,7 +307,7 @@ bool decoderLibde265::decodeFrame()
     DEBUG_LIBDE265("decoderLibde265::decodeFrame Picture decoded");
 
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBufferFilled = false;
     return true;
   }
   return false;
@@ -324,15 +323,16 @@ QByteArray decoderLibde265::getRawFrameData()
     return QByteArray();
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (!currentOutputBufferFilled)
   {
     // Put image data into buffer
     copyImgToByteArray(curImage, currentOutputBuffer);
+    currentOutputBufferFilled = true;
     DEBUG_LIBDE265("decoderLibde265::getRawFrameData copied frame to buffer");
     
     if (retrieveStatistics)
       // Get the statistics from the image and put them into the statistics cache
-      cacheStatistics(curImage);
+      cacheStatisticsOfCurrentFrame();
   }
 
   return currentOutputBuffer;
@@ -410,9 +410,7 @@ void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst
 
   DEBUG_LIBDE265("decoderLibde265::copyImgToByteArray nrBytes %d", nrBytes);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytes)
-    dst.resize(nrBytes);
+  decoderBase::prepareOutputBuffer(dst, nrBytes);
 
   uint8_t *dst_c = (uint8_t*)dst.data();
 
@@ -446,15 +444,13 @@ void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst
   }
 }
 
-void decoderLibde265::cacheStatistics(const de265_image *img)
+void decoderLibde265::cacheStatistics(const QSet<int> &typeIDs)
 {
-  if (!internalsSupported)
+  if (!internalsSupported || curImage == nullptr)
     return;
 
   DEBUG_LIBDE265("decoderLibde265::cacheStatistics");
-
-  // Clear the local statistics cache
-  curPOCStats.clear();
+  const de265_image *img = curImage;
 
   /// --- CTB internals/statistics
   int widthInCTB, heightInCTB, log2CTBSize;
@@ -462,6 +458,7 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
   int ctb_size = 1 << log2CTBSize;  // width and height of each CTB
 
   // Save Slice index
+  if (typeIDs.contains(0))
   {
     QScopedArrayPointer<uint16_t> tmpArr(new uint16_t[ widthInCTB * heightInCTB ]);
     de265_internals_get_CTB_sliceIdx(img, tmpArr.data());
@@ -474,6 +471,12 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
   }
 
   /// --- CB internals/statistics (part Size, prediction mode, PCM flag, CU trans_quant_bypass_flag)
+  // Only get the info from the library that is needed for the requested types
+  const bool cbTypes = typeIDs.contains(1) || typeIDs.contains(2) || typeIDs.contains(3) || typeIDs.contains(4);
+  const bool pbTypes = typeIDs.contains(5) || typeIDs.contains(6) || typeIDs.contains(7) || typeIDs.contains(8);
+  const bool tuTypes = typeIDs.contains(9) || typeIDs.contains(10) || typeIDs.contains(11);
+  if (!cbTypes && !pbTypes && !tuTypes)
+    return;
 
   // TODO: How do we get the POC in here? / Should the decoder not be able to tell us the POC?
   const int iPOC = 0;
@@ -487,37 +490,45 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
   de265_internals_get_CB_info(img, cbInfoArr.data());
 
   // Get PB array layout from image
-  int widthInPB, heightInPB, log2PBInfoUnitSize;
-  de265_internals_get_PB_Info_layout(img, &widthInPB, &heightInPB, &log2PBInfoUnitSize);
+  int widthInPB = 0, heightInPB = 0, log2PBInfoUnitSize = 0;
+  QScopedArrayPointer<int16_t> refPOC0, refPOC1, vec0_x, vec0_y, vec1_x, vec1_y;
+  if (pbTypes)
+  {
+    de265_internals_get_PB_Info_layout(img, &widthInPB, &heightInPB, &log2PBInfoUnitSize);
+
+    // Get PB info from image
+    refPOC0.reset(new int16_t[widthInPB*heightInPB]);
+    refPOC1.reset(new int16_t[widthInPB*heightInPB]);
+    vec0_x.reset(new int16_t[widthInPB*heightInPB]);
+    vec0_y.reset(new int16_t[widthInPB*heightInPB]);
+    vec1_x.reset(new int16_t[widthInPB*heightInPB]);
+    vec1_y.reset(new int16_t[widthInPB*heightInPB]);
+    de265_internals_get_PB_info(img, refPOC0.data(), refPOC1.data(), vec0_x.data(), vec0_y.data(), vec1_x.data(), vec1_y.data());
+  }
   int pb_infoUnit_size = 1 << log2PBInfoUnitSize;
 
-  // Get PB info from image
-  QScopedArrayPointer<int16_t> refPOC0(new int16_t[widthInPB*heightInPB]);
-  QScopedArrayPointer<int16_t> refPOC1(new int16_t[widthInPB*heightInPB]);
-  QScopedArrayPointer<int16_t> vec0_x(new int16_t[widthInPB*heightInPB]);
-  QScopedArrayPointer<int16_t> vec0_y(new int16_t[widthInPB*heightInPB]);
-  QScopedArrayPointer<int16_t> vec1_x(new int16_t[widthInPB*heightInPB]);
-  QScopedArrayPointer<int16_t> vec1_y(new int16_t[widthInPB*heightInPB]);
-  de265_internals_get_PB_info(img, refPOC0.data(), refPOC1.data(), vec0_x.data(), vec0_y.data(), vec1_x.data(), vec1_y.data());
-
-  // Get intra prediction mode (intra direction) layout from image
-  int widthInIntraDirUnits, heightInIntraDirUnits, log2IntraDirUnitsSize;
-  de265_internals_get_IntraDir_Info_layout(img, &widthInIntraDirUnits, &heightInIntraDirUnits, &log2IntraDirUnitsSize);
-  int intraDir_infoUnit_size = 1 << log2IntraDirUnitsSize;
+  int widthInIntraDirUnits = 0, heightInIntraDirUnits = 0, log2IntraDirUnitsSize = 0;
+  int widthInTUInfoUnits = 0, heightInTUInfoUnits = 0, log2TUInfoUnitSize = 0;
+  QScopedArrayPointer<uint8_t> intraDirY, intraDirC, tuInfo;
+  if (tuTypes)
+  {
+    // Get intra prediction mode (intra direction) layout from image
+    de265_internals_get_IntraDir_Info_layout(img, &widthInIntraDirUnits, &heightInIntraDirUnits, &log2IntraDirUnitsSize);
 
-  // Get intra prediction mode (intra direction) from image
-  QScopedArrayPointer<uint8_t> intraDirY(new uint8_t[widthInIntraDirUnits*heightInIntraDirUnits]);
-  QScopedArrayPointer<uint8_t> intraDirC(new uint8_t[widthInIntraDirUnits*heightInIntraDirUnits]);
-  de265_internals_get_intraDir_info(img, intraDirY.data(), intraDirC.data());
+    // Get intra prediction mode (intra direction) from image
+    intraDirY.reset(new uint8_t[widthInIntraDirUnits*heightInIntraDirUnits]);
+    intraDirC.reset(new uint8_t[widthInIntraDirUnits*heightInIntraDirUnits]);
+    de265_internals_get_intraDir_info(img, intraDirY.data(), intraDirC.data());
 
-  // Get TU info array layout
-  int widthInTUInfoUnits, heightInTUInfoUnits, log2TUInfoUnitSize;
-  de265_internals_get_TUInfo_Info_layout(img, &widthInTUInfoUnits, &heightInTUInfoUnits, &log2TUInfoUnitSize);
-  int tuInfo_unit_size = 1 << log2TUInfoUnitSize;
+    // Get TU info array layout
+    de265_internals_get_TUInfo_Info_layout(img, &widthInTUInfoUnits, &heightInTUInfoUnits, &log2TUInfoUnitSize);
 
-  // Get TU info
-  QScopedArrayPointer<uint8_t> tuInfo(new uint8_t[widthInTUInfoUnits*heightInTUInfoUnits]);
-  de265_internals_get_TUInfo_info(img, tuInfo.data());
+    // Get TU info
+    tuInfo.reset(new uint8_t[widthInTUInfoUnits*heightInTUInfoUnits]);
+    de265_internals_get_TUInfo_info(img, tuInfo.data());
+  }
+  int intraDir_infoUnit_size = 1 << log2IntraDirUnitsSize;
+  int tuInfo_unit_size = 1 << log2TUInfoUnitSize;
 
   for (int y = 0; y < heightInCB; y++)
   {
@@ -540,18 +551,22 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
         bool    tqBypass = (val & 512);        // Next bit (TransQuant bypass flag)
 
                                                // Set part mode (ID 1)
-        curPOCStats[1].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, partMode);
+        if (typeIDs.contains(1))
+          curPOCStats[1].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, partMode);
 
         // Set prediction mode (ID 2)
-        curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, predMode);
+        if (typeIDs.contains(2))
+          curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, predMode);
 
         // Set PCM flag (ID 3)
-        curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, pcmFlag);
+        if (typeIDs.contains(3))
+          curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, pcmFlag);
 
         // Set transQuant bypass flag (ID 4)
-        curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, tqBypass);
+        if (typeIDs.contains(4))
+          curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, tqBypass);
 
-        if (predMode != 0)
+        if (predMode != 0 && pbTypes)
         {
           // For each of the prediction blocks set some info
 
@@ -569,27 +584,30 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
 
             // Add ref index 0 (ID 5)
             int16_t ref0 = refPOC0[pbIdx];
-            if (ref0 != -1)
+            if (ref0 != -1 && typeIDs.contains(5))
               curPOCStats[5].addBlockValue(pbX, pbY, pbW, pbH, ref0-iPOC);
 
             // Add ref index 1 (ID 6)
             int16_t ref1 = refPOC1[pbIdx];
-            if (ref1 != -1)
+            if (ref1 != -1 && typeIDs.contains(6))
               curPOCStats[6].addBlockValue(pbX, pbY, pbW, pbH, ref1-iPOC);
 
             // Add motion vector 0 (ID 7)
-            if (ref0 != -1)
+            if (ref0 != -1 && typeIDs.contains(7))
               curPOCStats[7].addBlockVector(pbX, pbY, pbW, pbH, vec0_x[pbIdx], vec0_y[pbIdx]);
 
             // Add motion vector 1 (ID 8)
-            if (ref1 != -1)
+            if (ref1 != -1 && typeIDs.contains(8))
               curPOCStats[8].addBlockVector(pbX, pbY, pbW, pbH, vec1_x[pbIdx], vec1_y[pbIdx]);
           }
         }
 
         // Walk into the TU tree
-        int tuIdx = (cbPosY / tuInfo_unit_size) * widthInTUInfoUnits + (cbPosX / tuInfo_unit_size);
-        cacheStatistics_TUTree_recursive(tuInfo.data(), widthInTUInfoUnits, tuInfo_unit_size, iPOC, tuIdx, cbSizePix / tuInfo_unit_size, 0, predMode == 0, intraDirY.data(), intraDirC.data(), intraDir_infoUnit_size, widthInIntraDirUnits);
+        if (tuTypes)
+        {
+          int tuIdx = (cbPosY / tuInfo_unit_size) * widthInTUInfoUnits + (cbPosX / tuInfo_unit_size);
+          cacheStatistics_TUTree_recursive(typeIDs, tuInfo.data(), widthInTUInfoUnits, tuInfo_unit_size, iPOC, tuIdx, cbSizePix / tuInfo_unit_size, 0, predMode == 0, intraDirY.data(), intraDirC.data(), intraDir_infoUnit_size, widthInIntraDirUnits);
+        }
       }
     }
   }
@@ -657,6 +675,7 @@ void decoderLibde265::getPBSubPosition(int partMode, int cbSizePix, int pbIdx, i
 }
 
 /* Walk into the TU tree and set the tree depth as a statistic value if the TU is not further split
+* \param typeIDs: The statistics types to extract (9, 10 and 11 are set in the TU tree)
 * \param tuInfo: The tuInfo array
 * \param tuInfoWidth: The number of TU units per line in the tuInfo array
 * \param tuUnitSizePix: The size of one TU unit in pixels
@@ -666,17 +685,17 @@ void decoderLibde265::getPBSubPosition(int partMode, int cbSizePix, int pbIdx, i
 * \param trDepth: The current transform tree depth
 * \param isIntra: is the CU using intra prediction?
 */
-void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits)
+void decoderLibde265::cacheStatistics_TUTree_recursive(const QSet<int> &typeIDs, uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits)
 {
   // Check if the TU is further split.
   if (tuInfo[tuIdx] & (1 << trDepth))
   {
     // The transform is split further
     int yOffset = (tuWidth_units / 2) * tuInfoWidth;
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx                              , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx           + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset                    , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(typeIDs, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx                              , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(typeIDs, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx           + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(typeIDs, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset                    , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(typeIDs, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
   }
   else
   {
@@ -684,9 +703,10 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
     int tuWidth = tuWidth_units * tuUnitSizePix;
     int posX = tuIdx % tuInfoWidth * tuUnitSizePix;
     int posY = tuIdx / tuInfoWidth * tuUnitSizePix;
-    curPOCStats[11].addBlockValue(posX, posY, tuWidth, tuWidth, trDepth);
+    if (typeIDs.contains(11))
+      curPOCStats[11].addBlockValue(posX, posY, tuWidth, tuWidth, trDepth);
 
-    if (isIntra)
+    if (isIntra && (typeIDs.contains(9) || typeIDs.contains(10)))
     {
       // Display the intra prediction mode (as it is executed) per transform unit
   
@@ -711,7 +731,7 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
 
       // Set Intra prediction direction Luma (ID 9)
       int intraDirLuma = intraDirY[intraDirIdx];
-      if (intraDirLuma <= 34)
+      if (intraDirLuma <= 34 && typeIDs.contains(9))
       {
         curPOCStats[9].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirLuma);
 
@@ -726,7 +746,7 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
 
       // Set Intra prediction direction Chroma (ID 10)
       int intraDirChroma = intraDirC[intraDirIdx];
-      if (intraDirChroma <= 34)
+      if (intraDirChroma <= 34 && typeIDs.contains(10))
       {
         curPOCStats[10].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirChroma);
 
@@ -84,7 +84,8 @@ struct decoderLibde265_Functions
 class decoderLibde265 : public decoderBaseSingleLib, public decoderLibde265_Functions 
 {
 public:
-  decoderLibde265(int signalID, bool cachingDecoder=false);
+  // If no threading is given, the threading is read from the settings
+  decoderLibde265(int signalID, bool cachingDecoder=false, std::optional<Threading> customThreading={});
   ~decoderLibde265();
 
   void resetDecoder() Q_DECL_OVERRIDE;
@@ -143,12 +144,12 @@ private:
   YUV_Internals::Subsampling convertFromInternalSubsampling(de265_chroma fmt);
   
   // Statistics caching
-  void cacheStatistics(const de265_image *img);
+  void cacheStatistics(const QSet<int> &typeIDs) Q_DECL_OVERRIDE;
   
   // With the given partitioning mode, the size of the CU and the prediction block index, calculate the
   // sub-position and size of the prediction block
   void getPBSubPosition(int partMode, int CUSizePix, int pbIdx, int *pbX, int *pbY, int *pbW, int *pbH) const;
-  void cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits);
+  void cacheStatistics_TUTree_recursive(const QSet<int> &typeIDs, uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits);
 
   // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as necessary
   // without invoking the copy operation from the libde265 buffer to the QByteArray again.
@@ -252,7 +252,7 @@ bool decoderVTM::getNextFrameFromDecoder()
   }
   
   DEBUG_DECVTM("decoderVTM::getNextFrameFromDecoder got a valid frame wit POC %d", libVTMDec_get_POC(currentVTMPic));
-  currentOutputBuffer.clear();
+  currentOutputBufferFilled = false;
   return true;
 }
 
@@ -281,7 +281,7 @@ bool decoderVTM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBufferFilled = false;
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this 
@@ -300,15 +300,16 @@ QByteArray decoderVTM::getRawFrameData()
     return QByteArray();
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (!currentOutputBufferFilled)
   {
     // Put image data into buffer
     copyImgToByteArray(currentVTMPic, currentOutputBuffer);
+    currentOutputBufferFilled = true;
     DEBUG_DECVTM("decoderVTM::getRawFrameData copied frame to buffer");
 
     if (retrieveStatistics)
       // Get the statistics from the image and put them into the statistics cache
-      cacheStatistics(currentVTMPic);
+      cacheStatisticsOfCurrentFrame();
   }
 
   return currentOutputBuffer;
@@ -335,9 +336,7 @@ void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
   int nrBytesOutput = (outSizeY + outSizeCb + outSizeCr) * (outputTwoByte ? 2 : 1);
   DEBUG_DECVTM("decoderVTM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
-    dst.resize(nrBytesOutput);
+  decoderBase::prepareOutputBuffer(dst, nrBytesOutput);
 
   // The source (from VTM) is always short (16bit). The destination is a QByteArray so
   // we have to cast it right.
@@ -394,17 +393,14 @@ void decoderVTM::copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst)
   }
 }
 
-void decoderVTM::cacheStatistics(libVTMDec_picture *img)
+void decoderVTM::cacheStatistics(const QSet<int> &typeIDs)
 {
-  Q_UNUSED(img);
+  Q_UNUSED(typeIDs);
 
-  if (!internalsSupported)
+  if (!internalsSupported || currentVTMPic == nullptr)
     return;
 
-  DEBUG_DECVTM("decoderVTM::cacheStatistics POC %d", libVTMDec_get_POC(img));
-
-  // Clear the local statistics cache
-  curPOCStats.clear();
+  DEBUG_DECVTM("decoderVTM::cacheStatistics POC %d", libVTMDec_get_POC(currentVTMPic));
 
   // // Conversion from intra prediction mode to vector.
   // // Coordinates are in x,y with the axes going right and down.
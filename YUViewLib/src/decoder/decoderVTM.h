@@ -118,7 +118,7 @@ private:
   bool decodedFrameWaiting {false};
 
   // Statistics caching
-  void cacheStatistics(libVTMDec_picture *pic);
+  void cacheStatistics(const QSet<int> &typeIDs) Q_DECL_OVERRIDE;
 
   bool internalsSupported {false};
   int nrSignals { 0 };
@@ -473,6 +473,7 @@ public:
   int64_t  get_pts()           { update(); return pts; }
   int64_t  get_dts()           { update(); return dts; }
   int64_t  get_duration()      { update(); return duration; }
+  int64_t  get_pos()           { update(); return pos; }
   int      get_flags()         { update(); return flags; }
   bool     get_flag_keyframe() { update(); return flags & AV_PKT_FLAG_KEY; }
   bool     get_flag_corrupt()  { update(); return flags & AV_PKT_FLAG_CORRUPT; }
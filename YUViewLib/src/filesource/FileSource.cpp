@@ -36,24 +36,62 @@
 #include <QDir>
 #include <QRegExp>
 #include <QSettings>
+#include <QStorageInfo>
+#include <QThread>
+#include <QtConcurrent>
 #include <QtGlobal>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "common/typedef.h"
  
 #define FILESOURCE_DEBUG_SIMULATESLOWLOADING 0
-#if FILESOURCE_DEBUG_SIMULATESLOWLOADING && !NDEBUG
-#include <QThread>
+
+namespace
+{
+
+// The maximum number of reads that run in parallel for the read ahead
+const int maxNrParallelReadAheadReads = 4;
+
+#ifndef Q_OS_WIN
+// Files on these file systems are not mapped. If the connection is lost, accessing a mapping would crash.
+const QList<QByteArray> networkFileSystems = QList<QByteArray>() << "nfs" << "nfs4" << "cifs" << "smbfs" << "smb2" << "smb3" << "afpfs" << "webdav" << "davfs" << "fuse.sshfs" << "9p" << "ncpfs" << "afs";
+
+bool isOnLocalFileSystem(const QFileInfo &fileInfo)
+{
+  const QStorageInfo storageInfo(fileInfo.absolutePath());
+  if (!storageInfo.isValid())
+    return false;
+  return !networkFileSystems.contains(storageInfo.fileSystemType().toLower());
+}
 #endif
 
+} // namespace
+
 FileSource::FileSource()
 {
   fileChanged = false;
   isFileOpened = false;
 
   connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, &FileSource::fileSystemWatcherFileChanged);
+  readAheadThreadPool.setMaxThreadCount(maxNrParallelReadAheadReads);
+}
+
+FileSource::~FileSource()
+{
+  // The reads in the background use the file
+  this->clearReadAhead();
 }
 
 bool FileSource::openFile(const QString &filePath)
@@ -63,6 +101,9 @@ bool FileSource::openFile(const QString &filePath)
   if (!fileInfo.exists() || !fileInfo.isFile())
     return false;
 
+  // Closing the file also removes the mapping
+  this->clearReadAhead();
+  this->unmapFile();
   if (isFileOpened && srcFile.isOpen())
     srcFile.close();
 
@@ -72,6 +113,13 @@ bool FileSource::openFile(const QString &filePath)
   if (!isFileOpened)
     return false;
 
+#ifndef Q_OS_WIN
+  // On windows, other applications can not overwrite or truncate a file while it is mapped
+  if (this->useMemoryMapping && isOnLocalFileSystem(fileInfo))
+    this->mapFile();
+#endif
+  this->applyAccessPattern();
+
   // Save the full file path
   fullFilePath = filePath;
 
@@ -100,20 +148,247 @@ void FileSource::readBytes(byteArrayAligned &targetBuffer, int64_t startPos, int
 // Resize the target array if necessary and read the given number of bytes to the data array
 int64_t FileSource::readBytes(QByteArray &targetBuffer, int64_t startPos, int64_t nrBytes)
 {
-  if(!isOk())
+  if(!isOk() || startPos < 0 || nrBytes < 0)
+    return 0;
+
+  if (nrBytes > std::numeric_limits<int>::max())
     return 0;
 
+  bool mappedFileTruncated = false;
+  {
+    // Copy from the mapping. No views into the mapping are returned so that the mapping can be removed at any time.
+    // If the file grew since it was mapped, the new data is read below.
+    QReadLocker locker(&mappingLock);
+    if (this->mappedFileData && startPos + nrBytes <= this->mappedFileSize)
+    {
+      // Accessing the mapping behind the end of a truncated file crashes (SIGBUS). The mapping is also kept if the
+      // file is not watched or if a derived class uses the mapping. So check the size of the file before copying.
+      mappedFileTruncated = (this->getCurrentFileSize() < this->mappedFileSize);
+      if (!mappedFileTruncated)
+      {
+        if (targetBuffer.size() < nrBytes)
+          targetBuffer.resize(int(nrBytes));
+        std::memcpy(targetBuffer.data(), this->mappedFileData + startPos, size_t(nrBytes));
+        return nrBytes;
+      }
+    }
+  }
+  if (mappedFileTruncated && !this->keepMappingIfChanged)
+    // All following reads go to the file
+    this->unmapFile();
+
+  {
+    // Was this range read ahead?
+    QFuture<QByteArray> readAheadData;
+    {
+      QMutexLocker locker(&readAheadMutex);
+      for (int i = 0; i < this->readAheadBuffers.size(); i++)
+      {
+        if (this->readAheadBuffers[i].range == FileRange(startPos, nrBytes))
+        {
+          readAheadData = this->readAheadBuffers.takeAt(i).data;
+          break;
+        }
+      }
+    }
+    if (!readAheadData.isCanceled())
+    {
+      // A default constructed QFuture is canceled. If the read is still running, wait for it.
+      const auto data = readAheadData.result();
+      if (data.size() == nrBytes)
+      {
+        targetBuffer = data;
+        return nrBytes;
+      }
+    }
+  }
+
   if (targetBuffer.size() < nrBytes)
-    targetBuffer.resize(nrBytes);
+    targetBuffer.resize(int(nrBytes));
+  return this->readFromFile(targetBuffer.data(), startPos, nrBytes);
+}
 
+int64_t FileSource::getCurrentFileSize() const
+{
+#ifdef Q_OS_UNIX
+  // Ask the system for the size of the opened file. fileInfo caches the size from when the file was opened.
+  struct stat fileStat;
+  if (::fstat(srcFile.handle(), &fileStat) == 0)
+    return int64_t(fileStat.st_size);
+  return -1;
+#else
+  return srcFile.size();
+#endif
+}
+
+int64_t FileSource::readFromFile(char *data, int64_t startPos, int64_t nrBytes)
+{
 #if FILESOURCE_DEBUG_SIMULATESLOWLOADING && !NDEBUG
   QThread::msleep(50);
 #endif
 
+#ifdef Q_OS_UNIX
+  // pread does not change the position of the file so no locking is needed
+  const auto fileDescriptor = srcFile.handle();
+  int64_t nrBytesRead = 0;
+  while (nrBytesRead < nrBytes)
+  {
+    const auto ret = ::pread(fileDescriptor, data + nrBytesRead, size_t(nrBytes - nrBytesRead), off_t(startPos + nrBytesRead));
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret <= 0)
+      break;
+    nrBytesRead += ret;
+  }
+  return nrBytesRead;
+#else
   // lock the seek and read function
   QMutexLocker locker(&readMutex);
   srcFile.seek(startPos);
-  return srcFile.read(targetBuffer.data(), nrBytes);
+  return srcFile.read(data, nrBytes);
+#endif
+}
+
+void FileSource::readAhead(const QList<FileRange> &ranges, int consumerID)
+{
+  if (!isOk())
+    return;
+
+  {
+    QReadLocker mappingLocker(&mappingLock);
+    if (this->mappedFileData)
+    {
+#ifdef Q_OS_UNIX
+      // Let the system read the pages of the mapping in the background
+      const auto pageSize = int64_t(sysconf(_SC_PAGESIZE));
+      for (const auto &range : ranges)
+      {
+        if (range.first < 0 || range.second <= 0 || range.first + range.second > this->mappedFileSize)
+          continue;
+        const auto start = (range.first / pageSize) * pageSize;
+        ::madvise(const_cast<char*>(this->mappedFileData + start), size_t(range.first + range.second - start), MADV_WILLNEED);
+      }
+#endif
+      return;
+    }
+  }
+
+  QMutexLocker locker(&readAheadMutex);
+
+  // Drop the buffers of this consumer which are not needed anymore. Buffers which were also requested by another
+  // consumer are kept. If the read of a dropped buffer did not start yet, it is skipped.
+  for (int i = this->readAheadBuffers.size() - 1; i >= 0; i--)
+  {
+    auto &buffer = this->readAheadBuffers[i];
+    if (!buffer.consumerIDs.contains(consumerID) || ranges.contains(buffer.range))
+      continue;
+    buffer.consumerIDs.removeAll(consumerID);
+    if (buffer.consumerIDs.isEmpty())
+    {
+      *buffer.canceled = true;
+      this->readAheadBuffers.removeAt(i);
+    }
+  }
+
+  // Start the reads in the given order (the first range is needed first)
+  for (const auto &range : ranges)
+  {
+    if (range.first < 0 || range.second <= 0 || range.second > std::numeric_limits<int>::max())
+      continue;
+    auto requested = std::find_if(this->readAheadBuffers.begin(), this->readAheadBuffers.end(), [&range](const ReadAheadBuffer &b) { return b.range == range; });
+    if (requested != this->readAheadBuffers.end())
+    {
+      if (!requested->consumerIDs.contains(consumerID))
+        requested->consumerIDs.append(consumerID);
+      continue;
+    }
+
+    ReadAheadBuffer buffer;
+    buffer.range = range;
+    buffer.consumerIDs.append(consumerID);
+    buffer.canceled.reset(new std::atomic_bool(false));
+    auto canceled = buffer.canceled;
+    buffer.data = QtConcurrent::run(&this->readAheadThreadPool, [this, range, canceled]() {
+      QByteArray data;
+      if (*canceled)
+        return data;
+      data.resize(int(range.second));
+      const auto nrBytesRead = this->readFromFile(data.data(), range.first, range.second);
+      data.resize(int(std::max(nrBytesRead, int64_t(0))));
+      return data;
+    });
+    this->readAheadBuffers.append(buffer);
+  }
+}
+
+void FileSource::clearReadAhead()
+{
+  {
+    QMutexLocker locker(&readAheadMutex);
+    for (auto &buffer : this->readAheadBuffers)
+      *buffer.canceled = true;
+    this->readAheadBuffers.clear();
+  }
+  this->readAheadThreadPool.waitForDone();
+}
+
+void FileSource::setAccessPattern(AccessPattern pattern)
+{
+  this->accessPattern = pattern;
+  if (isFileOpened)
+    this->applyAccessPattern();
+}
+
+void FileSource::mapFile()
+{
+  const auto fileSize = fileInfo.size();
+  if (fileSize <= 0)
+    return;
+
+  auto mapping = srcFile.map(0, fileSize);
+  if (mapping == nullptr)
+    return;
+  QWriteLocker locker(&mappingLock);
+  this->mappedFileData = reinterpret_cast<const char*>(mapping);
+  this->mappedFileSize = fileSize;
+}
+
+void FileSource::unmapFile()
+{
+  // Wait until all copies from the mapping are done
+  QWriteLocker locker(&mappingLock);
+  if (this->mappedFileData)
+    srcFile.unmap(reinterpret_cast<uchar*>(const_cast<char*>(this->mappedFileData)));
+  this->mappedFileData = nullptr;
+  this->mappedFileSize = 0;
+}
+
+void FileSource::fileSystemWatcherFileChanged(const QString &path)
+{
+  Q_UNUSED(path);
+  fileChanged = true;
+
+  // Accessing the mapping of a file that was truncated crashes (SIGBUS). All following reads go to the file.
+  if (!this->keepMappingIfChanged)
+    this->unmapFile();
+}
+
+void FileSource::applyAccessPattern()
+{
+#ifdef Q_OS_UNIX
+  if (this->mappedFileData)
+  {
+    const int advice = (this->accessPattern == AccessPattern::Sequential) ? MADV_SEQUENTIAL : (this->accessPattern == AccessPattern::Random) ? MADV_RANDOM : MADV_NORMAL;
+    ::madvise(const_cast<char*>(this->mappedFileData), size_t(this->mappedFileSize), advice);
+  }
+#endif
+#ifdef Q_OS_LINUX
+  if (!this->mappedFileData)
+  {
+    const int advice = (this->accessPattern == AccessPattern::Sequential) ? POSIX_FADV_SEQUENTIAL : (this->accessPattern == AccessPattern::Random) ? POSIX_FADV_RANDOM : POSIX_FADV_NORMAL;
+    ::posix_fadvise(srcFile.handle(), 0, 0, advice);
+  }
+#endif
 }
 
 QList<infoItem> FileSource::getFileInfoList() const
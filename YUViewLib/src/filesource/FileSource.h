@@ -35,16 +35,23 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QFileSystemWatcher>
+#include <QFuture>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QReadWriteLock>
+#include <QSharedPointer>
 #include <QSize>
 #include <QString>
+#include <QThreadPool>
+#include <atomic>
 
 #include "common/fileInfo.h"
 
 /* The FileSource class provides functions for accessing files. Besides the reading of
  * certain blocks of the file, it also directly provides information on the file for the
  * fileInfoWidget. It also adds functions for guessing the format from the filename.
+ * Files on a local file system are memory mapped (except on windows). readBytes() then copies from the
+ * mapping so that multiple threads can read from the file without seeking a shared file handle.
  */
 class FileSource : public QObject
 {
@@ -52,6 +59,7 @@ class FileSource : public QObject
 
 public:
   FileSource();
+  ~FileSource();
 
   // Try to open the given file and install a watcher for the file.
   virtual bool openFile(const QString &filePath);
@@ -71,7 +79,7 @@ public:
   virtual bool atEnd() const { return !isFileOpened ? true : srcFile.atEnd(); }
   QByteArray readLine() { return !isFileOpened ? QByteArray() : srcFile.readLine(); }
   virtual bool seek(int64_t pos) { return !isFileOpened ? false : srcFile.seek(pos); }
-  int64_t pos() { return !isFileOpened ? 0 : srcFile.pos(); }
+  virtual int64_t pos() { return !isFileOpened ? 0 : srcFile.pos(); }
 
   // Guess the format (width, height, framerate, packed/planar) from the file name.
   // Certain patterns are recognized. E.g: "something_352x288_24.yuv"
@@ -89,6 +97,7 @@ public:
 
   // Read the given number of bytes starting at startPos into the QByteArray out
   // Resize the QByteArray if necessary. Return how many bytes were read.
+  // This function is thread safe.
   int64_t readBytes(QByteArray &targetBuffer, int64_t startPos, int64_t nrBytes);
 #if SSE_CONVERSION
   void readBytes(byteArrayAligned &data, int64_t startPos, int64_t nrBytes);
@@ -107,8 +116,30 @@ public:
   // Clear the cache of the file in the system. Currently only windows supported.
   void clearFileCache();
 
+  // A hint to the system on how the file will be read (madvise/posix_fadvise). This is kept if the file is reopened.
+  enum class AccessPattern
+  {
+    Normal,
+    Sequential,
+    Random
+  };
+  void setAccessPattern(AccessPattern pattern);
+
+  bool isMemoryMapped() const { return this->mappedFileData != nullptr; }
+  // Local files are memory mapped by default (except on windows). This takes effect when the file is opened.
+  // The mapping is removed when the file is changed by another application (if the file is watched).
+  void setUseMemoryMapping(bool useMapping) { this->useMemoryMapping = useMapping; }
+
+  // Read ahead: Start reading the given ranges (start position and number of bytes) in the background. A readBytes()
+  // call for exactly such a range then returns the data without waiting for the storage (unless the read is still running).
+  // Ranges from previous calls of the same consumer which are not in the list anymore are dropped. Every reader of
+  // the file (e.g. the interactive loading and each caching thread) should use its own consumer ID so that they do
+  // not drop each others ranges. Mapped files are paged in by the system.
+  using FileRange = QPair<int64_t, int64_t>;
+  void readAhead(const QList<FileRange> &ranges, int consumerID = 0);
+
 private slots:
-  void fileSystemWatcherFileChanged(const QString &path) { Q_UNUSED(path); fileChanged = true; }
+  void fileSystemWatcherFileChanged(const QString &path);
 
 protected:
   // Info on the source file.
@@ -119,11 +150,44 @@ protected:
   QFile srcFile;
   bool isFileOpened;
 
+  // The whole file is mapped if it is on a local file system. The mapping is removed when srcFile is closed.
+  const char *mappedFileData {nullptr};
+  int64_t     mappedFileSize {0};
+  // Set this if a derived class uses the mapping directly. The mapping is then kept until the file is reopened
+  // even if the file is changed. readBytes() does not copy from the mapping anymore once the file was truncated.
+  bool keepMappingIfChanged {false};
+
 private:
+  void mapFile();
+  void unmapFile();
+  // Locked for writing while the mapping is removed
+  QReadWriteLock mappingLock;
+  void applyAccessPattern();
+  AccessPattern accessPattern {AccessPattern::Normal};
+  bool useMemoryMapping {true};
+
+  // Read directly from the file. Thread safe.
+  int64_t readFromFile(char *data, int64_t startPos, int64_t nrBytes);
+  // The current size of the opened file on disk (or -1 on error)
+  int64_t getCurrentFileSize() const;
+
+  struct ReadAheadBuffer
+  {
+    FileRange range;
+    QList<int> consumerIDs;  //< The consumers that requested the range. It is dropped when this is empty.
+    QFuture<QByteArray> data;
+    QSharedPointer<std::atomic_bool> canceled;
+  };
+  QList<ReadAheadBuffer> readAheadBuffers;
+  QMutex readAheadMutex;
+  // The reads are mostly waiting for the storage so this pool is separate from the global one that is used for processing
+  QThreadPool readAheadThreadPool;
+  void clearReadAhead();
+
   // Watch the opened file for modifications
   QFileSystemWatcher fileWatcher;
   bool fileChanged;
 
-  // protect the read function with a mutex
+  // protect the read function with a mutex (only used if the file is neither mapped nor can be read using pread)
   QMutex readMutex;
 };
@@ -32,6 +32,27 @@
 
 #include "FileSourceAnnexBFile.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include <QtConcurrent>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANNEXBFILE_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define ANNEXBFILE_SSE2 0
+#endif
+#if defined(__AVX2__)
+#define ANNEXBFILE_AVX2 1
+#include <immintrin.h>
+#else
+#define ANNEXBFILE_AVX2 0
+#endif
+
 #define ANNEXBFILE_DEBUG_OUTPUT 0
 #if ANNEXBFILE_DEBUG_OUTPUT && !NDEBUG
 #include <QDebug>
@@ -40,25 +61,79 @@
 #define DEBUG_ANNEXBFILE(f) ((void)0)
 #endif
 
-const auto BUFFERSIZE = 500000;
-const auto STARTCODE = QByteArrayLiteral("\x00\x00\x01");
+// Ranges smaller than this are not split for the parallel start code search
+const int64_t MIN_START_CODE_SEARCH_CHUNK_SIZE = 1024 * 1024;
+// If the file is not mapped, it is read in blocks of this size
+const int64_t ANNEXBFILE_READ_BLOCK_SIZE = 1024 * 1024;
+
+namespace
+{
 
-FileSourceAnnexBFile::FileSourceAnnexBFile()
+#if ANNEXBFILE_SSE2 || ANNEXBFILE_AVX2
+// Get the index of the lowest set bit. The mask must not be 0.
+inline int countTrailingZeros(unsigned int mask)
 {
-  this->fileBuffer.resize(BUFFERSIZE);
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanForward(&idx, mask);
+  return int(idx);
+#else
+  return __builtin_ctz(mask);
+#endif
 }
+#endif
+
+struct StartCodeSearchRange
+{
+  const char *data;
+  int64_t dataSize;
+  int64_t begin;
+  int64_t end;
+};
 
-// Open the file and fill the read buffer. 
+QVector<int64_t> findStartCodesInRange(const StartCodeSearchRange &range)
+{
+  QVector<int64_t> positions;
+  int64_t pos = range.begin;
+  while ((pos = FileSourceAnnexBFile::findNextStartCode(range.data, range.dataSize, pos, range.end)) >= 0)
+  {
+    // For 0001 point to the first 0 byte
+    if (pos > 0 && range.data[pos - 1] == 0)
+      positions.append(pos - 1);
+    else
+      positions.append(pos);
+    pos += 3;
+  }
+  return positions;
+}
+
+} // namespace
+
+// Open the file and map it into memory.
 bool FileSourceAnnexBFile::openFile(const QString &fileName)
 {
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::openFile fileName " << fileName);
 
-  // Open the input file (again)
-  FileSource::openFile(fileName);
+  // Opening the file again closes it first which also unmaps it
+  this->lastReturnArray.clear();
+  this->fileData = nullptr;
+  this->fileDataSize = 0;
+  this->fileBuffer.clear();
+  this->fileBufferPos = 0;
+  this->posInFile = 0;
+
+  // Open the input file (again). Local files are memory mapped. Otherwise the file is read in blocks.
+  if (!FileSource::openFile(fileName))
+    return false;
 
-  // Fill the buffer
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
-  if (this->fileBufferSize == 0)
+  if (this->mappedFileData)
+  {
+    this->fileData = this->mappedFileData;
+    this->fileDataSize = this->mappedFileSize;
+  }
+  else
+    this->fileDataSize = this->getFileSize();
+  if (this->fileDataSize <= 0)
     // The file is empty of there was an error reading from the file.
     return false;
 
@@ -69,26 +144,87 @@ bool FileSourceAnnexBFile::openFile(const QString &fileName)
 
 bool FileSourceAnnexBFile::atEnd() const
 { 
-  return this->fileBufferSize < BUFFERSIZE && this->posInBuffer >= int64_t(this->fileBufferSize);
+  return this->posInFile >= this->fileDataSize;
 }
 
-void FileSourceAnnexBFile::seekToFirstNAL()
+bool FileSourceAnnexBFile::fillBuffer(int64_t startPos, int64_t nrBytes)
 {
-  auto nextStartCodePos = this->fileBuffer.indexOf(STARTCODE);
-  if (nextStartCodePos < 0)
-    // The first buffer does not contain a start code. This is very unusual. Use the normal getNextNALUnit to seek
-    this->getNextNALUnit();
+  nrBytes = std::min(nrBytes, this->fileDataSize - startPos);
+  const int64_t bufferEnd = this->fileBufferPos + this->fileBuffer.size();
+  if (startPos >= this->fileBufferPos && startPos + nrBytes <= bufferEnd)
+    return true;
+
+  // Keep the data from startPos on if it is in the buffer
+  if (startPos >= this->fileBufferPos && startPos <= bufferEnd)
+    this->fileBuffer.remove(0, int(startPos - this->fileBufferPos));
   else
+    this->fileBuffer.clear();
+  this->fileBufferPos = startPos;
+
+  // Read at least one block
+  const int64_t oldSize = this->fileBuffer.size();
+  const int64_t readPos = startPos + oldSize;
+  const int64_t nrBytesToRead = std::min(std::max(nrBytes - oldSize, ANNEXBFILE_READ_BLOCK_SIZE), this->fileDataSize - readPos);
+  if (nrBytesToRead <= 0)
+    return nrBytes <= oldSize;
+  this->fileBuffer.resize(int(oldSize + nrBytesToRead));
+  int64_t nrBytesRead = 0;
+  if (this->srcFile.seek(readPos))
+    nrBytesRead = std::max(this->srcFile.read(this->fileBuffer.data() + oldSize, nrBytesToRead), int64_t(0));
+  this->fileBuffer.resize(int(oldSize + nrBytesRead));
+  return nrBytes <= this->fileBuffer.size();
+}
+
+const char *FileSourceAnnexBFile::getDataAt(int64_t pos, int64_t nrBytes)
+{
+  if (this->fileData)
+    return this->fileData + pos;
+  if (!this->fillBuffer(pos, nrBytes))
+    return nullptr;
+  return this->fileBuffer.constData() + (pos - this->fileBufferPos);
+}
+
+int64_t FileSourceAnnexBFile::findStartCodeInFile(int64_t begin, int64_t keepFromPos)
+{
+  if (this->fileData)
+    return findNextStartCode(this->fileData, this->fileDataSize, begin, this->fileDataSize);
+
+  // Search the buffer and read the next block until a start code is found
+  int64_t searchPos = begin;
+  int64_t requiredEnd = begin + 3;
+  while (true)
   {
-    // For 0001 or 001 point to the first 0 byte
-    if (nextStartCodePos > 0 && this->fileBuffer.at(nextStartCodePos-1) ==(char)0)
-      this->posInBuffer = nextStartCodePos - 1;
-    else
-      this->posInBuffer = nextStartCodePos;
+    const int64_t keepPos = (keepFromPos >= 0) ? keepFromPos : std::max(searchPos - 1, int64_t(0));
+    const int64_t oldBufferEnd = this->fileBufferPos + this->fileBuffer.size();
+    this->fillBuffer(keepPos, requiredEnd - keepPos);
+    const int64_t bufferEnd = this->fileBufferPos + this->fileBuffer.size();
+
+    const auto pos = findNextStartCode(this->fileBuffer.constData(), this->fileBuffer.size(), searchPos - this->fileBufferPos, this->fileBuffer.size());
+    if (pos >= 0)
+      return this->fileBufferPos + pos;
+    if (bufferEnd >= this->fileDataSize || (bufferEnd <= oldBufferEnd && requiredEnd > bufferEnd))
+      // The end of the file was reached or reading failed
+      return -1;
+
+    // A start code can begin in the last two bytes of the buffer
+    searchPos = std::max(searchPos, bufferEnd - 2);
+    requiredEnd = bufferEnd + 1;
   }
+}
 
-  assert(this->posInBuffer >= 0);
-  this->nrBytesBeforeFirstNAL = this->bufferStartPosInFile + uint64_t(this->posInBuffer);
+void FileSourceAnnexBFile::seekToFirstNAL()
+{
+  const auto startCodePos = this->findStartCodeInFile(0, -1);
+  if (startCodePos < 0)
+    // There is no start code in the file
+    this->posInFile = this->fileDataSize;
+  else if (startCodePos > 0 && *this->getDataAt(startCodePos - 1, 1) == 0)
+    // For 0001 or 001 point to the first 0 byte
+    this->posInFile = startCodePos - 1;
+  else
+    this->posInFile = startCodePos;
+
+  this->nrBytesBeforeFirstNAL = uint64_t(this->posInFile);
 }
 
 QByteArray FileSourceAnnexBFile::getNextNALUnit(bool getLastDataAgain, pairUint64 *startEndPosInFile)
@@ -97,92 +233,111 @@ QByteArray FileSourceAnnexBFile::getNextNALUnit(bool getLastDataAgain, pairUint6
     return this->lastReturnArray;
 
   this->lastReturnArray.clear();
+  if (this->atEnd())
+    return this->lastReturnArray;
 
-  if (startEndPosInFile)
-    startEndPosInFile->first = this->bufferStartPosInFile + uint64_t(this->posInBuffer);
+  // Search the start code of the next NAL (behind the start code of this NAL)
+  const int64_t start = this->posInFile;
+  int64_t end = this->findStartCodeInFile(start + 3, start);
+  if (end < 0)
+  {
+    // No more start codes. The NAL goes to the end of the file.
+    end = this->fileDataSize;
+    if (startEndPosInFile)
+      *startEndPosInFile = pairUint64(start, end - 1);
+  }
+  else
+  {
+    // Check if the start code is 001 or 0001
+    if (*this->getDataAt(end - 1, 1) == 0)
+      end--;
+    if (startEndPosInFile)
+      *startEndPosInFile = pairUint64(start, end);
+  }
 
-  int nextStartCodePos = -1;
-  int searchOffset = 3;
-  bool startCodeFound = false;
-  while (!startCodeFound)
+  // The buffer is overwritten when the next NAL is read so the data is copied if the file is not mapped
+  if (this->fileData)
+    this->lastReturnArray = QByteArray::fromRawData(this->fileData + start, int(end - start));
+  else if (const auto data = this->getDataAt(start, end - start))
+    this->lastReturnArray = QByteArray(data, int(end - start));
+  this->posInFile = end;
+  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getNextNALUnit start code found - ret size " << this->lastReturnArray.size());
+  return this->lastReturnArray;
+}
+
+int64_t FileSourceAnnexBFile::findNextStartCode(const char *data, int64_t dataSize, int64_t begin, int64_t end)
+{
+  // The start code at pos consists of the bytes at pos, pos+1 and pos+2
+  end = std::min(end, dataSize - 2);
+  int64_t pos = begin;
+
+#if ANNEXBFILE_AVX2 || ANNEXBFILE_SSE2
+  // Get a mask of all positions where this and the next byte are 0 and check if the candidates are followed by a 1.
+  // In coded data, two 0 bytes are rare (because of the emulation prevention) so there are few candidates to check.
+#if ANNEXBFILE_AVX2
+  const auto vectorSize = 32;
+  const __m256i zero = _mm256_setzero_si256();
+#else
+  const auto vectorSize = 16;
+  const __m128i zero = _mm_setzero_si128();
+#endif
+  while (pos + vectorSize <= end)
   {
-    if (this->posInBuffer < 0)
+#if ANNEXBFILE_AVX2
+    const __m256i bytes0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+    const __m256i bytes1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 1));
+    unsigned int mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes0, zero))) & unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes1, zero)));
+#else
+    const __m128i bytes0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 1));
+    unsigned int mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes0, zero))) & unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes1, zero)));
+#endif
+    while (mask != 0)
     {
-      // Part of the start code was in the last buffer (see special boundary cases below). Add those parts.
-      const auto nrZeroBytesMissing = std::abs(this->posInBuffer);
-      this->lastReturnArray.append(nrZeroBytesMissing, char(0));
+      const int64_t candidate = pos + countTrailingZeros(mask);
+      if (data[candidate + 2] == 1)
+        return candidate;
+      mask &= mask - 1;
     }
-    nextStartCodePos = this->fileBuffer.indexOf(STARTCODE, this->posInBuffer + searchOffset);
+    pos += vectorSize;
+  }
+#endif
 
-    if (nextStartCodePos < 0 || (uint64_t)nextStartCodePos > this->fileBufferSize)
-    {
-      // No start code found ... append all data in the current buffer.
-      this->lastReturnArray += this->fileBuffer.mid(this->posInBuffer, this->fileBufferSize - this->posInBuffer);
-      DEBUG_ANNEXBFILE("FileSourceHEVCAnnexBFile::getNextNALUnit no start code found - ret size " << this->lastReturnArray.size());
-
-      if (this->fileBufferSize < BUFFERSIZE)
-      {
-        // We are out of file and could not find a next position
-        this->posInBuffer = BUFFERSIZE;
-        if (startEndPosInFile)
-          startEndPosInFile->second = this->bufferStartPosInFile + this->fileBufferSize - 1;
-        return this->lastReturnArray;
-      }
-
-      // Before we load the next bytes: The start code might be located at the boundary to the next buffer
-      const auto lastByteZero0 = this->fileBuffer.at(this->fileBufferSize - 3) == (char)0;
-      const auto lastByteZero1 = this->fileBuffer.at(this->fileBufferSize - 2) == (char)0;
-      const auto lastByteZero2 = this->fileBuffer.at(this->fileBufferSize - 1) == (char)0;
-
-      // We have to continue searching - get the next buffer
-      updateBuffer();
-      
-      if (this->fileBufferSize > 2)
-      {
-        // Now look for the special boundary case:
-        if (this->fileBuffer.at(0) == (char)1 && lastByteZero2 && lastByteZero1)
-        {
-          // Found a start code - the 1 byte is here and the two (or three) 0 bytes were in the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero0 ? -3 : -2;
-          this->lastReturnArray.chop(lastByteZero0 ? 3 : 2);
-        }
-        else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)1 && lastByteZero2)
-        {
-          // Found a start code - the 01 bytes are here and the one (or two) 0 bytes were in the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero1 ? -2 : -1;
-          this->lastReturnArray.chop(lastByteZero0 ? 1 : 1);
-        }
-        else if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)1)
-        {
-          // Found a start code - the 001 bytes are here. Check the last byte of the last buffer
-          startCodeFound = true;
-          nextStartCodePos = lastByteZero2 ? -1 : 0;
-          if (lastByteZero2)
-            this->lastReturnArray.chop(1);
-        }
-      }
-
-      searchOffset = 0;
-    }
-    else
-    {
-      // Start code found. Check if the start code is 001 or 0001
-      startCodeFound = true;
-      if (this->fileBuffer.at(nextStartCodePos - 1) == (char)0)
-        nextStartCodePos--;
-    }
+  // Search for the 1 byte and check the two 0 bytes before it
+  while (pos < end)
+  {
+    const void *one = memchr(data + pos + 2, 1, size_t(end - pos));
+    if (one == nullptr)
+      return -1;
+    const int64_t candidate = static_cast<const char*>(one) - data - 2;
+    if (data[candidate] == 0 && data[candidate + 1] == 0)
+      return candidate;
+    pos = candidate + 1;
   }
+  return -1;
+}
 
-  // Position found
-  if (startEndPosInFile)
-    startEndPosInFile->second = this->bufferStartPosInFile + nextStartCodePos;
-  if (nextStartCodePos > int(this->posInBuffer))
-    this->lastReturnArray += this->fileBuffer.mid(this->posInBuffer, nextStartCodePos - this->posInBuffer);
-  this->posInBuffer = nextStartCodePos;
-  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::getNextNALUnit start code found - ret size " << this->lastReturnArray.size());
-  return this->lastReturnArray;
+QVector<int64_t> FileSourceAnnexBFile::findStartCodes(const char *data, int64_t dataSize, int64_t begin, int64_t end, int nrThreads)
+{
+  end = std::min(end, dataSize);
+  if (begin >= end)
+    return {};
+
+  // Split the range into one chunk per thread. A start code belongs to the chunk in which its first byte is.
+  QVector<StartCodeSearchRange> ranges;
+  const int64_t chunkSize = std::max((end - begin) / std::max(nrThreads, 1), MIN_START_CODE_SEARCH_CHUNK_SIZE);
+  for (int64_t chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize)
+    ranges.append({data, dataSize, chunkBegin, std::min(chunkBegin + chunkSize, end)});
+
+  if (ranges.size() == 1)
+    return findStartCodesInRange(ranges[0]);
+
+  // Search all chunks in parallel and merge the results in the order of the file
+  const auto rangePositions = QtConcurrent::blockingMapped<QList<QVector<int64_t>>>(ranges, findStartCodesInRange);
+  QVector<int64_t> positions;
+  for (const auto &p : rangePositions)
+    positions += p;
+  return positions;
 }
 
 QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
@@ -194,14 +349,18 @@ QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
   
   auto start = startEndFilePos.first;
   auto end = startEndFilePos.second;
+  if (end > start)
+    retArray.reserve(int(end - start) + 64);
 
   // Seek the source file to the start position
   this->seek(start);
 
   // Retrieve NAL units (and repackage them) until we reached out end position
-  while (end > this->bufferStartPosInFile + this->posInBuffer)
+  while (int64_t(end) > this->posInFile)
   {
     auto nalData = getNextNALUnit();
+    if (nalData.isEmpty())
+      break;
 
     int headerOffset = 0;
     if (nalData.at(0) == (char)0 && nalData.at(1) == (char)0)
@@ -222,41 +381,29 @@ QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
   return retArray;
 }
 
-bool FileSourceAnnexBFile::updateBuffer()
-{
-  // Save the position of the first byte in this new buffer
-  this->bufferStartPosInFile += this->fileBufferSize;
-
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
-  this->posInBuffer = 0;
-
-  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::updateBuffer this->fileBufferSize " << this->fileBufferSize);
-  return (this->fileBufferSize > 0);
-}
-
 bool FileSourceAnnexBFile::seek(int64_t pos)
 {
   if (!isFileOpened)
     return false;
 
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::seek ot " << pos);
-  // Seek the file and update the buffer
-  srcFile.seek(pos);
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
-  if (this->fileBufferSize == 0)
-    // The file is empty of there was an error reading from the file.
+  this->lastReturnArray.clear();
+  this->posInFile = pos;
+  if (pos >= this->fileDataSize)
     return false;
-  this->bufferStartPosInFile = pos;
-  this->posInBuffer = 0;
 
   if (pos == 0)
     this->seekToFirstNAL();
   else
   {
     // Check if we are at a start code position (001 or 0001)
-    if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)0 && this->fileBuffer.at(3) == (char)1)
+    const auto remaining = this->fileDataSize - pos;
+    const char *d = this->getDataAt(pos, 4);
+    if (d == nullptr)
+      return false;
+    if (remaining >= 4 && d[0] == (char)0 && d[1] == (char)0 && d[2] == (char)0 && d[3] == (char)1)
       return true;
-    if (this->fileBuffer.at(0) == (char)0 && this->fileBuffer.at(1) == (char)0 && this->fileBuffer.at(2) == (char)1)
+    if (remaining >= 3 && d[0] == (char)0 && d[1] == (char)0 && d[2] == (char)1)
       return true;
 
     DEBUG_ANNEXBFILE("FileSourceAnnexBFile::seek could not find start code at seek position");
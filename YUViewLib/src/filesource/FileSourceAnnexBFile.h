@@ -32,19 +32,23 @@
 
 #pragma once
 
+#include <QVector>
+
 #include "FileSource.h"
 #include "common/typedef.h"
 
 /* This class is a normal FileSource for opening of raw AnnexBFiles.
  * Basically it understands that this is a binary file where each unit starts with a start code (0x0000001)
- * TODO: The reading / parsing could be performed in a background thread in order to increase the performance
+ * If the file is memory mapped, the NAL units are returned as views into the mapping without copying them.
+ * Otherwise, the file is read in blocks into a buffer which only holds the NAL unit that is currently read.
 */
 class FileSourceAnnexBFile : public FileSource
 {
   Q_OBJECT
 
 public:
-  FileSourceAnnexBFile();
+  // The NAL units are returned as views into the mapping so it must be kept until the file is reopened
+  FileSourceAnnexBFile() { this->keepMappingIfChanged = true; }
   FileSourceAnnexBFile(const QString &filePath) : FileSourceAnnexBFile() { openFile(filePath); }
   ~FileSourceAnnexBFile() {};
 
@@ -52,6 +56,7 @@ public:
 
   // Is the file at the end?
   bool atEnd() const override;
+  int64_t pos() override { return this->posInFile; }
 
   // --- Retrieving of data from the file ---
   // You can either read a file NAL by NAL or frame by frame. Do not mix the two interfaces.
@@ -60,35 +65,59 @@ public:
   // Get the next NAL unit (everything including the start code)
   // Also return the start and end position of the NAL unit in the file so you can seek to it.
   // startEndPosInFile: The file positions of the first byte in the NAL header and the end position of the last byte
+  // If the file is mapped, the returned data points into the mapping (QByteArray::fromRawData). It is only valid as
+  // long as the file is open. Modifying it or keeping it for longer requires a copy.
   QByteArray getNextNALUnit(bool getLastDataAgain=false, pairUint64 *startEndPosInFile = nullptr);
 
   // Get all bytes that are needed to decode the next frame (from the given start to the given end position)
   // The data will be returned in the ISO/IEC 14496-15 format (4 bytes size followed by the payload).
   QByteArray getFrameData(pairUint64 startEndFilePos);
   
-  // Seek the file to the given byte position. Update the buffer.
+  // Seek the file to the given byte position.
   bool seek(int64_t pos) override;
 
   uint64_t getNrBytesBeforeFirstNAL() const { return this->nrBytesBeforeFirstNAL; }
 
-protected:
+  // Direct access to all bytes of the file. This is only possible if the file is memory mapped (nullptr otherwise).
+  const char *getFileData() const { return this->fileData; }
+  int64_t getFileDataSize() const { return this->fileDataSize; }
 
-  QByteArray   fileBuffer;
-  uint64_t     fileBufferSize {0};       ///< How many of the bytes are used? We don't resize the fileBuffer
-  uint64_t     bufferStartPosInFile {0}; ///< The byte position in the file of the start of the currently loaded buffer
+  // Find the first start code (001) which begins in the range [begin, end) of the given data. Returns the position
+  // of the first 0 byte of the 001 or -1 if there is none. The search is vectorized using AVX2 or SSE2 (if available).
+  static int64_t findNextStartCode(const char *data, int64_t dataSize, int64_t begin, int64_t end);
 
-  // The current position in the input buffer in bytes. This always points to the first byte of a start code.
-  // So if the start code is 0001 it will point to the first byte (the first 0). If the start code is 001, it will point to the first 0 here.
-  // Note: The pos may be negative if we update the buffer and the start of the start code was in the previous buffer
-  int64_t posInBuffer {0};
+  // Find all start codes which begin in the range [begin, end) of the given file data (e.g. a memory mapped file).
+  // The returned positions are the first byte of the start code (the first 0 of a 0001 start code) like the start
+  // positions of getNextNALUnit. The range is split into chunks which are searched in parallel using nrThreads threads.
+  static QVector<int64_t> findStartCodes(const char *data, int64_t dataSize, int64_t begin, int64_t end, int nrThreads);
 
-  // load the next buffer
-  bool updateBuffer();
+protected:
+
+  // The data of the memory mapped file (nullptr if the file is not mapped) and the size of the file
+  const char *fileData {nullptr};
+  int64_t     fileDataSize {0};
+
+  // If the file is not mapped, a part of the file (starting at fileBufferPos) is read into the fileBuffer
+  QByteArray  fileBuffer;
+  int64_t     fileBufferPos {0};
+  // Make sure that the fileBuffer contains the nrBytes bytes from startPos on (or up to the end of the file).
+  // The data before startPos is discarded. Return false if not all bytes could be read.
+  bool fillBuffer(int64_t startPos, int64_t nrBytes);
+  // Get a pointer to the data at the given position. At least nrBytes (or the rest of the file) are valid.
+  const char *getDataAt(int64_t pos, int64_t nrBytes);
+  // Find the first start code (001) which begins at or after the given position in the file. Return the position
+  // of the first 0 byte of the 001 or -1 if there is none. If the file is not mapped, the data from keepFromPos on
+  // is kept in the buffer (or only the byte before the start code if keepFromPos is -1).
+  int64_t findStartCodeInFile(int64_t begin, int64_t keepFromPos);
+
+  // The current position in the file. This always points to the first byte of a start code.
+  // So if the start code is 0001 it will point to the first byte (the first 0). If the start code is 001, it will point to the first 0 here.
+  int64_t posInFile {0};
 
   // Seek to the first NAL header in the bitstream
   void seekToFirstNAL();
 
-  // We will keep the last buffer in case the reader wants to get it again
+  // We will keep the last returned NAL in case the reader wants to get it again
   QByteArray lastReturnArray;
 
   uint64_t nrBytesBeforeFirstNAL {0};
@@ -34,7 +34,9 @@
 
 #include <QSettings>
 #include <QProgressDialog>
+#include <QtConcurrent>
 
+#include "SeekIndexCache.h"
 #include "parser/common/SubByteReader.h"
 
 #define FILESOURCEFFMPEGFILE_DEBUG_OUTPUT 0
@@ -48,6 +50,17 @@
 using namespace YUView;
 using namespace YUV_Internals;
 
+namespace
+{
+
+// The seek index is only valid for the same video stream
+QString getSeekIndexFormatTag(int videoStreamIndex)
+{
+  return QString("FFmpeg/%1").arg(videoStreamIndex);
+}
+
+} // namespace
+
 FileSourceFFmpegFile::FileSourceFFmpegFile()
 {
   // Set the start code to look for (0x00 0x00 0x01)
@@ -55,6 +68,8 @@ FileSourceFFmpegFile::FileSourceFFmpegFile()
   startCode.append((char)0);
   startCode.append((char)1);
 
+  seekIndex.reset(new SeekIndex);
+
   connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, &FileSourceFFmpegFile::fileSystemWatcherFileChanged);
 }
 
@@ -157,12 +172,11 @@ QByteArray FileSourceFFmpegFile::getNextUnit(bool getLastDataAgain, uint64_t *pt
 
     try
     {
-      QString bitsRead;
-      bool obu_forbidden_bit = (reader.readBits(1, bitsRead) != 0);
-      reader.readBits(4, bitsRead); // obu_type
-      bool obu_extension_flag = (reader.readBits(1, bitsRead) != 0);
-      bool obu_has_size_field = (reader.readBits(1, bitsRead) != 0);
-      bool obu_reserved_1bit = (reader.readBits(1, bitsRead) != 0);
+      bool obu_forbidden_bit = (reader.readBits(1) != 0);
+      reader.readBits(4); // obu_type
+      bool obu_extension_flag = (reader.readBits(1) != 0);
+      bool obu_has_size_field = (reader.readBits(1) != 0);
+      bool obu_reserved_1bit = (reader.readBits(1) != 0);
 
       if (obu_forbidden_bit || obu_reserved_1bit)
       {
@@ -171,9 +185,9 @@ QByteArray FileSourceFFmpegFile::getNextUnit(bool getLastDataAgain, uint64_t *pt
       }
       if (obu_extension_flag)
       {
-        reader.readBits(3, bitsRead); // temporal_id
-        reader.readBits(2, bitsRead); // spatial_id
-        unsigned int extension_header_reserved_3bits = reader.readBits(3, bitsRead);
+        reader.readBits(3); // temporal_id
+        reader.readBits(2); // spatial_id
+        unsigned int extension_header_reserved_3bits = reader.readBits(3);
         if (extension_header_reserved_3bits != 0)
         {
           currentPacketData.clear();
@@ -183,7 +197,7 @@ QByteArray FileSourceFFmpegFile::getNextUnit(bool getLastDataAgain, uint64_t *pt
       if (obu_has_size_field)
       {
         int bitCount;
-        unsigned int obu_size = reader.readLeb128(bitsRead, bitCount);
+        unsigned int obu_size = reader.readLeb128(nullptr, bitCount);
         unsigned int completeSize = obu_size + reader.nrBytesRead();
         lastReturnArray = currentPacketData.mid(posInData, completeSize);
         posInData += completeSize;
@@ -321,6 +335,11 @@ QList<QByteArray> FileSourceFFmpegFile::getParameterSets()
 
 FileSourceFFmpegFile::~FileSourceFFmpegFile()
 {
+  if (backgroundIndexingFuture.isRunning())
+  {
+    seekIndex->cancel = true;
+    backgroundIndexingFuture.waitForFinished();
+  }
   if (pkt)
     pkt.free_packet(ff);
 }
@@ -350,17 +369,17 @@ bool FileSourceFFmpegFile::openFile(const QString &filePath, QWidget *mainWindow
   fileChanged = false;
 
   // If another (already opened) bitstream is given, copy bitstream info from there; Otherwise scan the bitstream.
+  // The index is shared so that it also grows here while the other file is indexed in the background.
   if (other && other->isFileOpened)
-  {
-    nrFrames = other->nrFrames;
-    keyFrameList = other->keyFrameList;
-  }
+    seekIndex = other->seekIndex;
   else if (parseFile)
   {
-    if (!scanBitstream(mainWindow))
-      return false;
-    
-    seekFileToBeginning();
+    if (!loadSeekIndexFromCache())
+    {
+      if (!scanBitstream(mainWindow))
+        return false;
+      seekFileToBeginning();
+    }
   }
 
   return true;
@@ -380,11 +399,18 @@ void FileSourceFFmpegFile::updateFileWatchSetting()
 
 int FileSourceFFmpegFile::getClosestSeekableDTSBefore(int frameIdx, int &seekToFrameIdx) const
 {
+  QMutexLocker locker(&seekIndex->mutex);
+  if (seekIndex->keyFrameList.isEmpty())
+  {
+    seekToFrameIdx = 0;
+    return 0;
+  }
+
   // We are always be able to seek to the beginning of the file
-  int bestSeekDTS = keyFrameList[0].dts;
-  seekToFrameIdx = keyFrameList[0].frame;
+  int bestSeekDTS = seekIndex->keyFrameList[0].dts;
+  seekToFrameIdx = seekIndex->keyFrameList[0].frame;
 
-  for (pictureIdx idx : keyFrameList)
+  for (pictureIdx idx : seekIndex->keyFrameList)
   {
     if (idx.frame >= 0) 
     {
@@ -402,6 +428,15 @@ int FileSourceFFmpegFile::getClosestSeekableDTSBefore(int frameIdx, int &seekToF
   return bestSeekDTS;
 }
 
+int FileSourceFFmpegFile::getNextSeekableFrameAfter(int frameIdx) const
+{
+  QMutexLocker locker(&seekIndex->mutex);
+  for (pictureIdx idx : seekIndex->keyFrameList)
+    if (idx.frame > frameIdx)
+      return int(idx.frame);
+  return -1;
+}
+
 bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
 {
   if (!isFileOpened)
@@ -421,15 +456,39 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
     progress->setWindowModality(Qt::WindowModal);
   }
 
-  nrFrames = 0;
+  const auto fileState = SeekIndexCache::getFileState(fullFilePath);
+  SeekIndexCache::Index index;
+
+  {
+    QMutexLocker locker(&seekIndex->mutex);
+    seekIndex->nrFrames = 0;
+    seekIndex->keyFrameList.clear();
+    seekIndex->complete = false;
+  }
+  int nrFrames = 0;
   while (goToNextPacket(true))
   {
     DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: frame %d pts %d dts %d%s", nrFrames, (int)pkt.get_pts(), (int)pkt.get_dts(), pkt.get_flag_keyframe() ? " - keyframe" : "");
 
-    if (pkt.get_flag_keyframe())
-      keyFrameList.append(pictureIdx(nrFrames, pkt.get_dts()));
+    // The index may be read by other threads while it is built
+    {
+      QMutexLocker locker(&seekIndex->mutex);
+      if (pkt.get_flag_keyframe())
+      {
+        seekIndex->keyFrameList.append(pictureIdx(nrFrames, pkt.get_dts()));
+        if (seekIndex->keyFrameList.size() == 1)
+          seekIndex->keyFrameFound.wakeAll();
+      }
+      seekIndex->nrFrames = nrFrames + 1;
+    }
 
-    if (progress && progress->wasCanceled())
+    SeekIndexCache::Frame frame;
+    frame.dts = pkt.get_dts();
+    frame.startPos = pkt.get_pos();
+    frame.keyFrame = pkt.get_flag_keyframe();
+    index.frames.append(frame);
+
+    if ((progress && progress->wasCanceled()) || seekIndex->cancel)
       return false;
 
     int newPercentValue = 0;
@@ -445,8 +504,70 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
     nrFrames++;
   }
 
-  DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: Scan done. Found %d frames and %d keyframes.", nrFrames, keyFrameList.length());
-  return !progress->wasCanceled();
+  DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: Scan done. Found %d frames.", nrFrames);
+  if (progress && progress->wasCanceled())
+    return false;
+
+  {
+    QMutexLocker locker(&seekIndex->mutex);
+    seekIndex->complete = true;
+    seekIndex->keyFrameFound.wakeAll();
+  }
+
+  // If the index can not be saved, the file is just scanned again the next time
+  SeekIndexCache::saveIndex(fullFilePath, getSeekIndexFormatTag(video_stream.get_index()), fileState, index);
+  return true;
+}
+
+bool FileSourceFFmpegFile::loadSeekIndexFromCache()
+{
+  SeekIndexCache::Index index;
+  if (!SeekIndexCache::loadIndex(fullFilePath, getSeekIndexFormatTag(video_stream.get_index()), index))
+    return false;
+
+  QMutexLocker locker(&seekIndex->mutex);
+  seekIndex->nrFrames = index.frames.size();
+  seekIndex->keyFrameList.clear();
+  for (int i = 0; i < index.frames.size(); i++)
+    if (index.frames[i].keyFrame)
+      seekIndex->keyFrameList.append(pictureIdx(i, index.frames[i].dts));
+  seekIndex->complete = true;
+  DEBUG_FFMPEG("FileSourceFFmpegFile::loadSeekIndexFromCache: Found %d frames and %d keyframes.", seekIndex->nrFrames, seekIndex->keyFrameList.length());
+  return true;
+}
+
+void FileSourceFFmpegFile::startBackgroundIndexing()
+{
+  if (!isFileOpened || backgroundIndexingFuture.isRunning() || loadSeekIndexFromCache())
+    return;
+
+  seekIndex->cancel = false;
+  backgroundIndexingFuture = QtConcurrent::run(this, &FileSourceFFmpegFile::runBackgroundIndexing);
+}
+
+void FileSourceFFmpegFile::waitForFirstKeyFrame()
+{
+  QMutexLocker locker(&seekIndex->mutex);
+  while (seekIndex->keyFrameList.isEmpty() && !seekIndex->complete && backgroundIndexingFuture.isRunning())
+    seekIndex->keyFrameFound.wait(&seekIndex->mutex, 100);
+}
+
+void FileSourceFFmpegFile::runBackgroundIndexing()
+{
+  // Reading packets moves the position in the file. Use a separate context for indexing so that this
+  // file can be read (decoded) at the same time.
+  FileSourceFFmpegFile indexFile;
+  indexFile.openFileAndFindVideoStream(fullFilePath);
+  if (!indexFile.isFileOpened)
+  {
+    QMutexLocker locker(&seekIndex->mutex);
+    seekIndex->complete = true;
+    seekIndex->keyFrameFound.wakeAll();
+    return;
+  }
+  indexFile.fullFilePath = fullFilePath;
+  indexFile.seekIndex = seekIndex;
+  indexFile.scanBitstream(nullptr);
 }
 
 void FileSourceFFmpegFile::openFileAndFindVideoStream(QString fileName)
@@ -617,12 +738,13 @@ int64_t FileSourceFFmpegFile::getMaxTS()
 
 indexRange FileSourceFFmpegFile::getDecodableFrameLimits() const
 {
-  if (this->keyFrameList.isEmpty() || nrFrames == 0)
+  QMutexLocker locker(&seekIndex->mutex);
+  if (seekIndex->keyFrameList.isEmpty() || seekIndex->nrFrames == 0)
     return {};
 
   indexRange range;
-  range.first = this->keyFrameList.at(0).frame;
-  range.second = nrFrames;
+  range.first = seekIndex->keyFrameList.at(0).frame;
+  range.second = seekIndex->nrFrames;
   return range;
 }
 
@@ -32,6 +32,12 @@
 
 #pragma once
 
+#include <QFuture>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWaitCondition>
+#include <atomic>
+
 #include "FileSource.h"
 #include "ffmpeg/FFMpegLibrariesHandling.h"
 #include "video/videoHandlerYUV.h"
@@ -101,8 +107,20 @@ public:
   QList<QString> getShortStreamDescriptionAllStreams();
 
   // Look through the keyframes and find the closest one before (or equal)
-  // the given frameIdx where we can start decoding
+  // the given frameIdx where we can start decoding. If the frame was not indexed yet (background indexing),
+  // the last key frame that is known is returned and decoding has to continue from there.
   int getClosestSeekableDTSBefore(int frameIdx, int &seekToFrameIdx) const;
+  // Get the frame index of the first key frame after the given frameIdx. Return -1 if no such key frame was indexed (yet).
+  int getNextSeekableFrameAfter(int frameIdx) const;
+
+  // Build the index of the file (frames and key frames) in a background thread using a separate context so that
+  // decoding can start right away. If the index is in the seek index cache, it is loaded and no thread is started.
+  // The frame limits (getDecodableFrameLimits) grow while the index is built.
+  void startBackgroundIndexing();
+  bool isIndexing() const { return backgroundIndexingFuture.isRunning(); }
+  // Block until the first key frame was indexed (decoding can start) or until the whole file is indexed
+  void waitForFirstKeyFrame();
+  void waitForIndexingFinished() { backgroundIndexingFuture.waitForFinished(); }
 
   QStringList getFFmpegLoadingLog() const { return ff.getLog(); }
   
@@ -153,12 +171,6 @@ protected:
   QFileInfo fileInfo;
   bool      isFileOpened {false};
 
-  // In order to translate from frames to PTS, we need to count the frames and keep a list of
-  // the PTS values of keyframes that we can start decoding at.
-  // If a mainWindow pointer is given, open a progress dialog. Return true on success. False if the process was canceled.
-  bool scanBitstream(QWidget *mainWindow);
-  int nrFrames {0};
-
   // Private struct for navigation. We index frames by frame number and FFMpeg uses the pts.
   // This connects both values.
   struct pictureIdx
@@ -168,15 +180,34 @@ protected:
     int64_t dts;
   };
 
+  // The index of the file. It is shared with a second instance that is opened for the same file (other) and
+  // with the instance that builds the index in the background. All access must lock the mutex.
+  struct SeekIndex
+  {
+    QMutex mutex;
+    QWaitCondition keyFrameFound;
+    int nrFrames {0};
+    QList<pictureIdx> keyFrameList;  //< A list of pairs (frameNr, DTS) that we can seek to.
+    bool complete {false};
+    std::atomic_bool cancel {false};
+  };
+  QSharedPointer<SeekIndex> seekIndex;
+
+  // In order to translate from frames to PTS, we need to count the frames and keep a list of
+  // the PTS values of keyframes that we can start decoding at.
+  // If a mainWindow pointer is given, open a progress dialog. Return true on success. False if the process was canceled.
+  // The result is saved in the seek index cache and restored from there if the file is opened again.
+  bool scanBitstream(QWidget *mainWindow);
+  bool loadSeekIndexFromCache();
+
+  void runBackgroundIndexing();
+  QFuture<void> backgroundIndexingFuture;
+
   packetDataFormat_t packetDataFormat {packetFormatUnknown};
 
   // The start code pattern to look for in case of a raw format
   QByteArray startCode;
 
-  // These are filled after opening a file (after scanBitstream was called)
-  QList<pictureIdx> keyFrameList;  //< A list of pairs (frameNr, PTS) that we can seek to.
-  //pictureIdx getClosestSeekableFrameNumberBeforeBefore(int frameIdx);
-
   // For parsing NAL units from the compressed data:
   QByteArray currentPacketData;
   int posInFile {-1};
@@ -0,0 +1,124 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "SeekIndexCache.h"
+
+namespace SeekIndexCache
+{
+
+namespace
+{
+
+const IndexCacheFile::Format indexFormat {"YUVSKIDX", 1, "seekIndex"};
+
+bool readIndex(QDataStream &in, Index &index)
+{
+  qint32 nrFrames;
+  in >> nrFrames;
+  if (in.status() != QDataStream::Ok || nrFrames < 0)
+    return false;
+  for (int i = 0; i < nrFrames && in.status() == QDataStream::Ok; i++)
+  {
+    Frame frame;
+    qint64 dts, startPos, endPos;
+    qint32 poc;
+    in >> dts >> poc >> startPos >> endPos >> frame.keyFrame;
+    frame.dts = dts;
+    frame.poc = poc;
+    frame.startPos = startPos;
+    frame.endPos = endPos;
+    index.frames.append(frame);
+  }
+
+  qint32 nrParameterSets;
+  in >> nrParameterSets;
+  if (in.status() != QDataStream::Ok || nrParameterSets < 0)
+    return false;
+  for (int i = 0; i < nrParameterSets && in.status() == QDataStream::Ok; i++)
+  {
+    quint64 start, end;
+    in >> start >> end;
+    index.parameterSetPositions.append(pairUint64(start, end));
+  }
+
+  qint32 nrSeekPoints;
+  in >> nrSeekPoints;
+  if (in.status() != QDataStream::Ok || nrSeekPoints < 0)
+    return false;
+  for (int i = 0; i < nrSeekPoints && in.status() == QDataStream::Ok; i++)
+  {
+    qint32 frameIdx;
+    quint64 filePos;
+    SeekPoint seekPoint;
+    in >> frameIdx >> filePos >> seekPoint.parameterSets;
+    seekPoint.filePos = filePos;
+    index.seekPoints.insert(frameIdx, seekPoint);
+  }
+  return true;
+}
+
+void writeIndex(QDataStream &out, const Index &index)
+{
+  out << qint32(index.frames.size());
+  for (const auto &frame : index.frames)
+    out << qint64(frame.dts) << qint32(frame.poc) << qint64(frame.startPos) << qint64(frame.endPos) << frame.keyFrame;
+  out << qint32(index.parameterSetPositions.size());
+  for (const auto &pos : index.parameterSetPositions)
+    out << quint64(pos.first) << quint64(pos.second);
+  out << qint32(index.seekPoints.size());
+  for (auto it = index.seekPoints.constBegin(); it != index.seekPoints.constEnd(); it++)
+    out << qint32(it.key()) << quint64(it.value().filePos) << it.value().parameterSets;
+}
+
+} // namespace
+
+QString getIndexFilePath(const QString &filePath)
+{
+  return IndexCacheFile::getIndexFilePath(filePath, indexFormat);
+}
+
+bool loadIndex(const QString &filePath, const QString &formatTag, Index &index)
+{
+  Index newIndex;
+  if (!IndexCacheFile::load(filePath, indexFormat, formatTag, [&newIndex](QDataStream &in) { return readIndex(in, newIndex); }))
+    return false;
+  index = newIndex;
+  return true;
+}
+
+bool saveIndex(const QString &filePath, const QString &formatTag, const FileState &parsedFileState, const Index &index)
+{
+  return IndexCacheFile::save(filePath, indexFormat, formatTag, parsedFileState, [&index](QDataStream &out) { writeIndex(out, index); });
+}
+
+} // namespace SeekIndexCache
@@ -0,0 +1,92 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "common/IndexCacheFile.h"
+#include "common/typedef.h"
+
+/* A persistent cache for the seek index of compressed files (FFmpeg containers and AnnexB streams).
+ * To seek in a compressed file, the positions of all frames and key frames must be known. Building this
+ * index requires reading every packet of the file. The index file is handled by IndexCacheFile.
+ */
+namespace SeekIndexCache
+{
+
+using IndexCacheFile::FileState;
+using IndexCacheFile::getFileState;
+
+// A frame in coding order
+struct Frame
+{
+  int64_t dts {-1};        //< The DTS (FFmpeg)
+  int poc {-1};            //< The POC (AnnexB)
+  int64_t startPos {-1};   //< The position of the first byte of the frame in the file (-1 if unknown)
+  int64_t endPos {-1};     //< The position of the last byte of the frame in the file (AnnexB)
+  bool keyFrame {false};   //< Decoding can start at this frame
+};
+
+// What is needed to start decoding at a key frame (AnnexB)
+struct SeekPoint
+{
+  uint64_t filePos {0};
+  QList<QByteArray> parameterSets;
+};
+
+struct Index
+{
+  // All frames of the file in coding order. The number of frames is the size of this list.
+  QList<Frame> frames;
+  // The start and end positions of all parameter set NAL units (AnnexB)
+  QList<pairUint64> parameterSetPositions;
+  // The seek points of all key frames (AnnexB). The key is the frame index in display order.
+  QMap<int, SeekPoint> seekPoints;
+};
+
+// Get the path of the index file for the given file
+QString getIndexFilePath(const QString &filePath);
+
+// Load the index of the given file. The formatTag identifies the reader/parser that created the index.
+// Returns false if there is no index or if it does not match the current state of the file.
+bool loadIndex(const QString &filePath, const QString &formatTag, Index &index);
+
+// Save the index of the given file. parsedFileState is the state of the file when the parsing
+// started. If the file changed since then, the index is not saved.
+bool saveIndex(const QString &filePath, const QString &formatTag, const FileState &parsedFileState, const Index &index);
+
+} // namespace SeekIndexCache
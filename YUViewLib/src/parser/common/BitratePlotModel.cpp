@@ -41,6 +41,8 @@
 
 #include "BitratePlotModel.h"
 
+#include <algorithm>
+
 #include <common/functions.h>
 
 unsigned BitratePlotModel::getNrStreams() const
@@ -198,11 +200,13 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
     if (currentSortMode == SortMode::DECODE_ORDER)
       return a.dts < b.dts;
     else
-      return b.pts < a.pts;
+      return a.pts < b.pts;
   };
 
   auto insertIterator = std::upper_bound(this->dataPerStream[streamIndex].begin(), this->dataPerStream[streamIndex].end(), entry, compareFunctionLessThen);
+  const auto insertIndex = int(insertIterator - this->dataPerStream[streamIndex].begin());
   this->dataPerStream[streamIndex].insert(insertIterator, entry);
+  this->updatePyramid(streamIndex, insertIndex);
   this->eventSubsampler.postEvent();
   if (newStream)
     emit nrStreamsChanged();
@@ -228,6 +232,127 @@ void BitratePlotModel::setBitrateSortingIndex(int index)
   QMutexLocker locker(&this->dataMutex);
   for (auto &list : this->dataPerStream)
     std::sort(list.begin(), list.end(), compareFunctionLessThen);
+  for (auto streamIndex : this->dataPerStream.keys())
+    this->updatePyramid(streamIndex, 0);
+}
+
+std::optional<QVector<PlotModel::DecimatedPoint>> BitratePlotModel::getDecimatedPlotPoints(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrPoints) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  auto dataIt = this->dataPerStream.constFind(streamIndex);
+  auto pyramidIt = this->pyramidPerStream.constFind(streamIndex);
+  if (dataIt == this->dataPerStream.constEnd() || pyramidIt == this->pyramidPerStream.constEnd() || maxNrPoints == 0)
+    return {};
+  const auto &entries = dataIt.value();
+  const auto &levels = pyramidIt.value();
+
+  // The entries are sorted by the x value. Get the range of entries that is visible.
+  const auto sortByDts = (this->sortMode == SortMode::DECODE_ORDER);
+  const auto start = std::lower_bound(entries.begin(), entries.end(), xRange.min, [sortByDts](const BitrateEntry &e, double x) { return (sortByDts ? e.dts : e.pts) < x; });
+  const auto end = std::upper_bound(entries.begin(), entries.end(), xRange.max, [sortByDts](double x, const BitrateEntry &e) { return x < (sortByDts ? e.dts : e.pts); });
+  const auto startIndex = int(start - entries.begin());
+  const auto nrEntries = int(end - start);
+  if (nrEntries <= int(maxNrPoints) || levels.isEmpty())
+    return {};
+
+  // Choose the level where the number of nodes in the range is just below the limit
+  int level = 0;
+  while (level + 1 < levels.size() && (nrEntries >> (level + 1)) > int(maxNrPoints))
+    level++;
+  const auto &nodes = levels[level];
+  const auto firstNode = startIndex >> (level + 1);
+  const auto lastNode = std::min((startIndex + nrEntries - 1) >> (level + 1), nodes.size() - 1);
+
+  QVector<DecimatedPoint> points;
+  points.reserve(2 * (lastNode - firstNode + 1));
+  const auto isAveragePlot = (plotIndex == 1);
+  for (int i = firstNode; i <= lastNode; i++)
+  {
+    const auto &node = nodes[i];
+    if (isAveragePlot)
+    {
+      const auto average = double(node.sumBitrate / node.nrEntries);
+      points.append({node.xMin, node.xMax, average, average, node.hasIntra});
+    }
+    else
+    {
+      if (node.hasInter)
+        points.append({node.xMin, node.xMax, double(node.minBitrate), double(node.maxBitrateInter), false});
+      if (node.hasIntra)
+        points.append({node.xMin, node.xMax, double(node.minBitrate), double(node.maxBitrateIntra), true});
+    }
+  }
+  return points;
+}
+
+BitratePlotModel::PyramidNode BitratePlotModel::getEntryNode(const BitrateEntry &entry) const
+{
+  const auto x = double((this->sortMode == SortMode::DECODE_ORDER) ? entry.dts : entry.pts);
+  PyramidNode node;
+  node.xMin = x - entry.duration / 2.0;
+  node.xMax = x + entry.duration / 2.0;
+  node.minBitrate = entry.bitrate;
+  if (entry.keyframe)
+  {
+    node.maxBitrateIntra = entry.bitrate;
+    node.hasIntra = true;
+  }
+  else
+  {
+    node.maxBitrateInter = entry.bitrate;
+    node.hasInter = true;
+  }
+  node.sumBitrate = entry.bitrate;
+  node.nrEntries = 1;
+  return node;
+}
+
+void BitratePlotModel::updatePyramid(unsigned int streamIndex, int firstChangedIndex)
+{
+  auto mergeNodes = [](const PyramidNode &a, const PyramidNode &b)
+  {
+    PyramidNode node;
+    node.xMin = std::min(a.xMin, b.xMin);
+    node.xMax = std::max(a.xMax, b.xMax);
+    node.minBitrate = std::min(a.minBitrate, b.minBitrate);
+    node.maxBitrateInter = std::max(a.maxBitrateInter, b.maxBitrateInter);
+    node.maxBitrateIntra = std::max(a.maxBitrateIntra, b.maxBitrateIntra);
+    node.hasInter = a.hasInter || b.hasInter;
+    node.hasIntra = a.hasIntra || b.hasIntra;
+    node.sumBitrate = a.sumBitrate + b.sumBitrate;
+    node.nrEntries = a.nrEntries + b.nrEntries;
+    return node;
+  };
+
+  const auto &entries = this->dataPerStream[streamIndex];
+  auto &levels = this->pyramidPerStream[streamIndex];
+
+  // When entries are appended, only the last node of every level changes
+  int firstChanged = firstChangedIndex;
+  int nrBelow = entries.size();
+  int level = 0;
+  for (; nrBelow > 1; level++)
+  {
+    if (levels.size() <= level)
+      levels.append({});
+    auto &nodes = levels[level];
+    const int firstNode = firstChanged / 2;
+    const int nrNodes = (nrBelow + 1) / 2;
+    nodes.resize(nrNodes);
+    for (int i = firstNode; i < nrNodes; i++)
+    {
+      const auto left = (level == 0) ? getEntryNode(entries[2 * i]) : levels[level - 1][2 * i];
+      if (2 * i + 1 < nrBelow)
+        nodes[i] = mergeNodes(left, (level == 0) ? getEntryNode(entries[2 * i + 1]) : levels[level - 1][2 * i + 1]);
+      else
+        nodes[i] = left;
+    }
+    firstChanged = firstNode;
+    nrBelow = nrNodes;
+  }
+  while (levels.size() > level)
+    levels.removeLast();
 }
 
 unsigned int BitratePlotModel::calculateAverageValue(unsigned streamIndex, unsigned pointIndex) const
@@ -51,6 +51,7 @@ public:
   QString getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
   std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const override;
   QString formatValue(Axis axis, double value) const override;
+  std::optional<QVector<DecimatedPoint>> getDecimatedPlotPoints(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrPoints) const override;
   
   QString getItemInfoText(int index);
 
@@ -81,6 +82,25 @@ private:
 
   unsigned int calculateAverageValue(unsigned streamIndex, unsigned pointIndex) const;
 
+  // For every stream, a min/max pyramid is kept to draw the plot with a limited number of points when zoomed out.
+  // A node on level 0 combines 2 entries, a node on level 1 combines 2 nodes of level 0 and so on.
+  struct PyramidNode
+  {
+    double xMin {0};
+    double xMax {0};
+    unsigned int minBitrate {0};
+    unsigned int maxBitrateInter {0};
+    unsigned int maxBitrateIntra {0};
+    bool hasInter {false};
+    bool hasIntra {false};
+    uint64_t sumBitrate {0};
+    unsigned int nrEntries {0};
+  };
+  QMap<unsigned int, QList<QVector<PyramidNode>>> pyramidPerStream;
+  // Update all nodes of the pyramid that contain entries from the given index on
+  void updatePyramid(unsigned int streamIndex, int firstChangedIndex);
+  PyramidNode getEntryNode(const BitrateEntry &entry) const;
+
   Range<int> rangeDts;
   Range<int> rangePts;
   QMap<unsigned int, Range<int>> rangeBitratePerStream;
@@ -32,6 +32,8 @@
 
 #include "PacketItemModel.h"
 
+#include <algorithm>
+
 #include <QBrush>
 #include <QColor>
 
@@ -73,7 +75,7 @@ PacketItemModel::~PacketItemModel()
 QVariant PacketItemModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
   if (orientation == Qt::Horizontal && role == Qt::DisplayRole && rootItem != nullptr)
-    return rootItem->itemData.value(section, QString());
+    return rootItem->getData(section);
 
   return QVariant();
 }
@@ -104,7 +106,7 @@ QVariant PacketItemModel::data(const QModelIndex &index, int role) const
     if (index.column() == 0)
       return QVariant(item->getName(!showVideoOnly));
     else
-      return QVariant(item->itemData.value(index.column()));
+      return QVariant(item->getData(index.column()));
   }
   return QVariant();
 }
@@ -140,10 +142,17 @@ QModelIndex PacketItemModel::parent(const QModelIndex &index) const
   if (parentItem == rootItem.data())
     return QModelIndex();
 
-  // Get the row of the item in the list of children of the parent item
+  // Get the row of the item in the list of children of the parent item. For lazy loaded items, we know
+  // the row and don't have to search the (possibly very long) list of first level items.
   int row = 0;
   if (parentItem)
-    row = parentItem->parentItem->childItems.indexOf(const_cast<TreeItem*>(parentItem));
+  {
+    auto it = std::find_if(this->lazyLoadedRows.begin(), this->lazyLoadedRows.end(), [&](int r) { return rootItem->childItems.value(r, nullptr) == parentItem; });
+    if (it != this->lazyLoadedRows.end())
+      row = *it;
+    else
+      row = parentItem->parentItem->childItems.indexOf(const_cast<TreeItem*>(parentItem));
+  }
 
   return createIndex(row, 0, parentItem);
 }
@@ -159,7 +168,72 @@ int PacketItemModel::rowCount(const QModelIndex &parent) const
     return (p == nullptr) ? 0 : nrShowChildItems;
   }
   TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
-  return (p == nullptr) ? 0 : p->childItems.count();
+  if (p == nullptr)
+    return 0;
+  return p->childItems.count();
+}
+
+bool PacketItemModel::hasChildren(const QModelIndex &parent) const
+{
+  if (this->canFetchMore(parent))
+    return true;
+  return QAbstractItemModel::hasChildren(parent);
+}
+
+bool PacketItemModel::canFetchMore(const QModelIndex &parent) const
+{
+  if (!this->lazyChildLoader || !parent.isValid() || parent.column() > 0)
+    return false;
+  
+  TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
+  return p != nullptr && p->parentItem == rootItem.data() && p->childItems.isEmpty();
+}
+
+void PacketItemModel::fetchMore(const QModelIndex &parent)
+{
+  if (!this->canFetchMore(parent))
+    return;
+
+  TreeItem *item = static_cast<TreeItem*>(parent.internalPointer());
+  TreeItem loadedItem(nullptr);
+  if (!this->lazyChildLoader(parent.row(), &loadedItem) || loadedItem.childItems.isEmpty())
+    return;
+
+  beginInsertRows(parent, 0, loadedItem.childItems.count() - 1);
+  for (auto child : loadedItem.childItems)
+    child->parentItem = item;
+  item->childItems.swap(loadedItem.childItems);
+  endInsertRows();
+
+  // Remove the children of the items that were not used for the longest time
+  this->lazyLoadedRows.removeOne(parent.row());
+  this->lazyLoadedRows.append(parent.row());
+  while (this->lazyLoadedRows.count() > this->maxNrLazyLoadedItems)
+  {
+    const int row = this->lazyLoadedRows.takeFirst();
+    TreeItem *unloadItem = rootItem->childItems.value(row, nullptr);
+    if (unloadItem == nullptr || unloadItem->childItems.isEmpty())
+      continue;
+    beginRemoveRows(createIndex(row, 0, unloadItem), 0, unloadItem->childItems.count() - 1);
+    qDeleteAll(unloadItem->childItems);
+    unloadItem->childItems.clear();
+    endRemoveRows();
+  }
+}
+
+void PacketItemModel::setLazyLoadedItemUsed(const QModelIndex &index)
+{
+  if (!this->lazyChildLoader || !index.isValid() || index.parent().isValid())
+    return;
+  // Mark the loaded item as the last used one
+  if (this->lazyLoadedRows.removeOne(index.row()))
+    this->lazyLoadedRows.append(index.row());
+}
+
+void PacketItemModel::setLazyChildLoader(LazyChildLoader loader, int maxNrLoadedItems)
+{
+  this->lazyChildLoader = loader;
+  this->maxNrLazyLoadedItems = maxNrLoadedItems;
 }
 
 void PacketItemModel::updateNumberModelItems()
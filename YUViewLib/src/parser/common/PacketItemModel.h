@@ -35,6 +35,8 @@
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 
+#include <functional>
+
 #include "TreeItem.h"
 
 // The item model which is used to display packets from the bitstream. This can be AVPackets or other units from the bitstream (NAL units e.g.)
@@ -53,6 +55,9 @@ public:
   virtual QModelIndex parent(const QModelIndex &index) const Q_DECL_OVERRIDE;
   virtual int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
   virtual int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE { Q_UNUSED(parent); return 5; }
+  virtual bool hasChildren(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+  virtual bool canFetchMore(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+  virtual void fetchMore(const QModelIndex &parent) Q_DECL_OVERRIDE;
 
   // The root of the tree
   QScopedPointer<TreeItem> rootItem;
@@ -63,6 +68,15 @@ public:
   void setShowVideoStreamOnly(bool showVideoOnly);
 
   void updateNumberModelItems();
+
+  // The children of the first level items can be loaded on demand. If a loader is set, first level items
+  // without children can be expanded and the loader is called to add the children to the item (with the row of
+  // the item). Only the children of the last maxNrLoadedItems used items are kept.
+  using LazyChildLoader = std::function<bool(int row, TreeItem *item)>;
+  void setLazyChildLoader(LazyChildLoader loader, int maxNrLoadedItems);
+  // Mark the (first level) item as used (e.g. when it is expanded again) so that its children are unloaded last
+  void setLazyLoadedItemUsed(const QModelIndex &index);
+
 private:
   // This is the current number of first level child items which we show right now.
   // The brackground parser will add more items and it will notify the bitstreamAnalysisWindow
@@ -71,6 +85,11 @@ private:
 
   unsigned int getNumberFirstLevelChildren() { return rootItem.isNull() ? 0 : rootItem->childItems.size(); }
 
+  LazyChildLoader lazyChildLoader;
+  int maxNrLazyLoadedItems {0};
+  // The rows of the first level items with loaded children. The last used one is at the end.
+  QList<int> lazyLoadedRows;
+
   static QList<QColor> streamIndexColors;
   bool useColorCoding { true };
   bool showVideoOnly  { false };
@@ -59,6 +59,14 @@ ReaderHelper::ReaderHelper(const QByteArray &inArr, TreeItem *item, QString new_
   itemHierarchy.append(currentTreeLevel);
 }
 
+void ReaderHelper::addLogSubLevel(const char *name)
+{
+  // Only convert the name if it is needed
+  if (itemHierarchy.last() == nullptr)
+    return;
+  addLogSubLevel(QString(name));
+}
+
 void ReaderHelper::addLogSubLevel(const QString name)
 {
   assert(!name.isEmpty());
@@ -78,7 +86,7 @@ void ReaderHelper::removeLogSubLevel()
 }
 
 // TODO: Fixed length / variable length codes logging
-bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, QString meaning)
+bool ReaderHelper::readBits(int numBits, unsigned int &into, const char *intoName, const QString &meaning)
 {
   QString code;
   if (!readBits_catch(into, numBits, code))
@@ -88,7 +96,7 @@ bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, Q
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, uint64_t &into, QString intoName, QString meaning)
+bool ReaderHelper::readBits(int numBits, uint64_t &into, const char *intoName, const QString &meaning)
 {
   QString code;
   if (!readBits64_catch(into, numBits, code))
@@ -98,7 +106,7 @@ bool ReaderHelper::readBits(int numBits, uint64_t &into, QString intoName, QStri
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, QStringList meanings)
+bool ReaderHelper::readBits(int numBits, unsigned int &into, const char *intoName, const QStringList &meanings)
 {
   QString code;
   if (!readBits_catch(into, numBits, code))
@@ -108,7 +116,7 @@ bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, Q
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, QMap<int,QString> meanings)
+bool ReaderHelper::readBits(int numBits, unsigned int &into, const char *intoName, const QMap<int,QString> &meanings)
 {
   QString code;
   if (!readBits_catch(into, numBits, code))
@@ -118,45 +126,41 @@ bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, Q
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, unsigned int &into, QString intoName, meaning_callback_function pMeaning)
+bool ReaderHelper::readBits(int numBits, unsigned int &into, const char *intoName, meaning_callback_function pMeaning)
 {
   QString code;
   if (!readBits_catch(into, numBits, code))
     return false;
   if (currentTreeLevel)
-    new TreeItem(intoName, into, QString("u(v) -> u(%1)").arg(numBits), code, pMeaning(into), currentTreeLevel);
+    new TreeItem(intoName, into, QString("u(v) -> u(%1)").arg(numBits), code, pMeaning ? pMeaning(into) : QString(), currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, QList<unsigned int> &into, QString intoName, int idx)
+bool ReaderHelper::readBits(int numBits, QList<unsigned int> &into, const char *intoName, int idx)
 {
   QString code;
   unsigned int val;
   if (!readBits_catch(val, numBits, code))
     return false;
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, QString("u(v) -> u(%1)").arg(numBits), code, currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, QString("u(v) -> u(%1)").arg(numBits), code, currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, QList<unsigned int> &into, QString intoName, int idx, meaning_callback_function pMeaning)
+bool ReaderHelper::readBits(int numBits, QList<unsigned int> &into, const char *intoName, int idx, meaning_callback_function pMeaning)
 {
   QString code;
   unsigned int val;
   if (!readBits_catch(val, numBits, code))
     return false;
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, QString("u(v) -> u(%1)").arg(numBits), code, pMeaning(val), currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, QString("u(v) -> u(%1)").arg(numBits), code, pMeaning ? pMeaning(val) : QString(), currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, QByteArray &into, QString intoName, int idx)
+bool ReaderHelper::readBits(int numBits, QByteArray &into, const char *intoName, int idx)
 {
   assert(numBits <= 8);
   QString code;
@@ -164,14 +168,12 @@ bool ReaderHelper::readBits(int numBits, QByteArray &into, QString intoName, int
   if (!readBits_catch(val, numBits, code))
     return false;
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, QString("u(v) -> u(%1)").arg(numBits), code, currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, QString("u(v) -> u(%1)").arg(numBits), code, currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readBits(int numBits, unsigned int &into, QMap<int, QString> intoNames)
+bool ReaderHelper::readBits(int numBits, unsigned int &into, const QMap<int, QString> &intoNames)
 {
   QString code;
   if (!readBits_catch(into, numBits, code))
@@ -181,7 +183,7 @@ bool ReaderHelper::readBits(int numBits, unsigned int &into, QMap<int, QString>
   return true;
 }
 
-bool ReaderHelper::readZeroBits(int numBits, QString intoName)
+bool ReaderHelper::readZeroBits(int numBits, const QString &intoName)
 {
   QString code;
   bool allZero = true;
@@ -213,7 +215,7 @@ bool ReaderHelper::ignoreBits(int numBits)
   return true;
 }
 
-bool ReaderHelper::readFlag(bool &into, QString intoName, QString meaning)
+bool ReaderHelper::readFlag(bool &into, const char *intoName, const QString &meaning)
 {
   QString code;
   unsigned int read_val;
@@ -225,7 +227,7 @@ bool ReaderHelper::readFlag(bool &into, QString intoName, QString meaning)
   return true;
 }
 
-bool ReaderHelper::readFlag(QList<bool> &into, QString intoName, int idx, QString meaning)
+bool ReaderHelper::readFlag(QList<bool> &into, const char *intoName, int idx, const QString &meaning)
 {
   QString code;
   unsigned int read_val;
@@ -233,14 +235,12 @@ bool ReaderHelper::readFlag(QList<bool> &into, QString intoName, int idx, QStrin
     return false;
   bool val = (read_val != 0);
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, "u(1)", code, meaning, currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, "u(1)", code, meaning, currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readFlag(bool &into, QString intoName, QStringList meanings)
+bool ReaderHelper::readFlag(bool &into, const char *intoName, const QStringList &meanings)
 {
   QString code;
   unsigned int read_val;
@@ -252,7 +252,7 @@ bool ReaderHelper::readFlag(bool &into, QString intoName, QStringList meanings)
   return true;
 }
 
-bool ReaderHelper::readUEV(unsigned int &into, QString intoName, QStringList meanings)
+bool ReaderHelper::readUEV(unsigned int &into, const char *intoName, const QStringList &meanings)
 {
   QString code;
   int bit_count = 0;
@@ -263,7 +263,7 @@ bool ReaderHelper::readUEV(unsigned int &into, QString intoName, QStringList mea
   return true;
 }
 
-bool ReaderHelper::readUEV(unsigned int &into, QString intoName, QString meaning)
+bool ReaderHelper::readUEV(unsigned int &into, const char *intoName, const QString &meaning)
 {
   QString code;
   int bit_count = 0;
@@ -274,7 +274,7 @@ bool ReaderHelper::readUEV(unsigned int &into, QString intoName, QString meaning
   return true;
 }
 
-bool ReaderHelper::readUEV(QList<quint32> &into, QString intoName, int idx, QString meaning)
+bool ReaderHelper::readUEV(QList<quint32> &into, const char *intoName, int idx, const QString &meaning)
 {
   QString code;
   int bit_count = 0;
@@ -282,14 +282,12 @@ bool ReaderHelper::readUEV(QList<quint32> &into, QString intoName, int idx, QStr
   if (!readUEV_catch(val, bit_count, code))
     return false;
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, QString("ue(v) -> ue(%1)").arg(bit_count), code, meaning, currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, QString("ue(v) -> ue(%1)").arg(bit_count), code, meaning, currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readSEV(int &into, QString intoName, QStringList meanings)
+bool ReaderHelper::readSEV(int &into, const char *intoName, const QStringList &meanings)
 {
   QString code;
   int bit_count = 0;
@@ -300,7 +298,7 @@ bool ReaderHelper::readSEV(int &into, QString intoName, QStringList meanings)
   return true;
 }
 
-bool ReaderHelper::readSEV(QList<int> into, QString intoName, int idx)
+bool ReaderHelper::readSEV(QList<int> into, const char *intoName, int idx)
 {
   QString code;
   int bit_count = 0;
@@ -308,14 +306,12 @@ bool ReaderHelper::readSEV(QList<int> into, QString intoName, int idx)
   if (!readUEV_catch(val, bit_count, code))
     return false;
   into.append(val);
-  if (idx >= 0)
-    intoName += QString("[%1]").arg(idx);
   if (currentTreeLevel)
-    new TreeItem(intoName, val, QString("se(v) -> se(%1)").arg(bit_count), code, currentTreeLevel);
+    new TreeItem(getIndexedName(intoName, idx), val, QString("se(v) -> se(%1)").arg(bit_count), code, currentTreeLevel);
   return true;
 }
 
-bool ReaderHelper::readLeb128(uint64_t &into, QString intoName)
+bool ReaderHelper::readLeb128(uint64_t &into, const char *intoName)
 {
   QString code;
   int bit_count = 0;
@@ -326,7 +322,7 @@ bool ReaderHelper::readLeb128(uint64_t &into, QString intoName)
   return true;
 }
 
-bool ReaderHelper::readUVLC(uint64_t &into, QString intoName)
+bool ReaderHelper::readUVLC(uint64_t &into, const char *intoName)
 {
   QString code;
   int bit_count = 0;
@@ -337,7 +333,7 @@ bool ReaderHelper::readUVLC(uint64_t &into, QString intoName)
   return true;
 }
 
-bool ReaderHelper::readNS(int &into, QString intoName, int maxVal)
+bool ReaderHelper::readNS(int &into, const char *intoName, int maxVal)
 {
   QString code;
   int bit_count = 0;
@@ -348,7 +344,7 @@ bool ReaderHelper::readNS(int &into, QString intoName, int maxVal)
   return true;
 }
 
-bool ReaderHelper::readSU(int &into, QString intoName, int nrBits)
+bool ReaderHelper::readSU(int &into, const char *intoName, int nrBits)
 {
   QString code;
   if (!readSU_catch(into, nrBits, code))
@@ -358,25 +354,25 @@ bool ReaderHelper::readSU(int &into, QString intoName, int nrBits)
   return true;
 }
 
-void ReaderHelper::logValue(int value, QString valueName, QString meaning)
+void ReaderHelper::logValue(int value, const QString &valueName, const QString &meaning)
 {
   if (currentTreeLevel)
     new TreeItem(valueName, value, "calc", meaning, currentTreeLevel);
 }
 
-void ReaderHelper::logValue(int value, QString valueName, QString coding, QString code, QString meaning)
+void ReaderHelper::logValue(int value, const QString &valueName, const QString &coding, const QString &code, const QString &meaning)
 {
   if (currentTreeLevel)
     new TreeItem(valueName, value, coding, code, meaning, currentTreeLevel);
 }
 
-void ReaderHelper::logValue(QString value, QString valueName, QString meaning)
+void ReaderHelper::logValue(const QString &value, const QString &valueName, const QString &meaning)
 {
   if (currentTreeLevel)
     new TreeItem(valueName, value, "calc", meaning, currentTreeLevel);
 }
 
-void ReaderHelper::logInfo(QString info)
+void ReaderHelper::logInfo(const QString &info)
 {
   if (currentTreeLevel)
     new TreeItem(info, currentTreeLevel);
@@ -396,7 +392,7 @@ bool ReaderHelper::readBits_catch(unsigned int &into, int numBits, QString &code
 {
   try
   {
-    into = this->reader.readBits(numBits, code);
+    into = this->reader.readBits(numBits, getCodePointer(code));
   }
   catch (const std::exception& ex)
   {
@@ -410,7 +406,7 @@ bool ReaderHelper::readBits64_catch(uint64_t &into, int numBits, QString &code)
 {
   try
   {
-    into = this->reader.readBits64(numBits, code);
+    into = this->reader.readBits64(numBits, getCodePointer(code));
   }
   catch (const std::exception& ex)
   {
@@ -424,7 +420,7 @@ bool ReaderHelper::readUEV_catch(unsigned int &into, int &bit_count, QString &co
 {
   try
   {
-    into = this->reader.readUE_V(code, bit_count);
+    into = this->reader.readUE_V(getCodePointer(code), bit_count);
   }
   catch (const std::exception& ex)
   {
@@ -438,7 +434,7 @@ bool ReaderHelper::readSEV_catch(int &into, int &bit_count, QString &code)
 {
   try
   {
-    into = this->reader.readSE_V(code, bit_count);
+    into = this->reader.readSE_V(getCodePointer(code), bit_count);
   }
   catch (const std::exception& ex)
   {
@@ -452,7 +448,7 @@ bool ReaderHelper::readLeb128_catch(uint64_t &into, int &bit_count, QString &cod
 {
   try
   {
-    into = this->reader.readLeb128(code, bit_count);
+    into = this->reader.readLeb128(getCodePointer(code), bit_count);
   }
   catch (const std::exception& ex)
   {
@@ -466,7 +462,7 @@ bool ReaderHelper::readUVLC_catch(uint64_t &into, int &bit_count, QString &code)
 {
   try
   {
-    into = this->reader.readUVLC(code, bit_count);
+    into = this->reader.readUVLC(getCodePointer(code), bit_count);
   }
   catch (const std::exception& ex)
   {
@@ -480,7 +476,7 @@ bool ReaderHelper::readNS_catch(int &into, int maxVal, int &bit_count, QString &
 {
   try
   {
-    into = this->reader.readNS(maxVal, code, bit_count);
+    into = this->reader.readNS(maxVal, getCodePointer(code), bit_count);
   }
   catch (const std::exception& ex)
   {
@@ -494,7 +490,7 @@ bool ReaderHelper::readSU_catch(int &into, int numBits, QString &code)
 {
   try
   {
-    into = this->reader.readSU(numBits, code);
+    into = this->reader.readSU(numBits, getCodePointer(code));
   }
   catch (const std::exception& ex)
   {
@@ -504,7 +500,7 @@ bool ReaderHelper::readSU_catch(int &into, int numBits, QString &code)
   return true;
 }
 
-QString ReaderHelper::getMeaningValue(QStringList &meanings, unsigned int val)
+QString ReaderHelper::getMeaningValue(const QStringList &meanings, unsigned int val)
 {
   if (val < (unsigned int)meanings.length())
     return meanings.at(val);
@@ -513,7 +509,7 @@ QString ReaderHelper::getMeaningValue(QStringList &meanings, unsigned int val)
   return "";
 }
 
-QString ReaderHelper::getMeaningValue(QMap<int,QString> &meanings, int val)
+QString ReaderHelper::getMeaningValue(const QMap<int,QString> &meanings, int val)
 {
   if (meanings.contains(val))
     return meanings.value(val);
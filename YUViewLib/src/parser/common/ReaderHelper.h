@@ -39,7 +39,11 @@
 
 typedef QString (*meaning_callback_function)(unsigned int);
 
-// This is a wrapper around the sub_byte_reader that adds the functionality to log the read symbold to TreeItems
+/* This is a wrapper around the sub_byte_reader that adds the functionality to log the read symbols to TreeItems.
+ * If no TreeItem is given, nothing is logged. In this mode, the names are never converted to QStrings, the meanings
+ * are not looked up and the bits that were read are not converted to text. This makes parsing much faster if only
+ * the values are needed (e.g. when indexing a file).
+ */
 class ReaderHelper
 {
 public:
@@ -48,41 +52,45 @@ public:
   ReaderHelper(const QByteArray &inArr, TreeItem *item, QString new_sub_item_name = "");
 
   // Add another hierarchical log level to the tree or go back up. Don't call these directly but use the reader_sub_level wrapper.
+  void addLogSubLevel(const char *name);
   void addLogSubLevel(QString name);
   void removeLogSubLevel();
 
-  bool readBits(int numBits, unsigned int &into, QString intoName, QString meaning = "");
-  bool readBits(int numBits, uint64_t     &into, QString intoName, QString meaning = "");
-  bool readBits(int numBits, unsigned int &into, QString intoName, QStringList meanings);
-  bool readBits(int numBits, unsigned int &into, QString intoName, QMap<int,QString> meanings);
-  bool readBits(int numBits, unsigned int &into, QString intoName, meaning_callback_function pMeaning);
-  bool readBits(int numBits, QList<unsigned int> &into, QString intoName, int idx);
-  bool readBits(int numBits, QList<unsigned int> &into, QString intoName, int idx, meaning_callback_function pMeaning);
-  bool readBits(int numBits, QByteArray &into, QString intoName, int idx);
-  bool readBits(int numBits, unsigned int &into, QMap<int, QString> intoNames);
-  bool readZeroBits(int numBits, QString intoName);
+  // Is the syntax logged to a TreeItem? If not, the names and meanings are not needed.
+  bool isLogging() const { return currentTreeLevel != nullptr; }
+
+  bool readBits(int numBits, unsigned int &into, const char *intoName, const QString &meaning = QString());
+  bool readBits(int numBits, uint64_t     &into, const char *intoName, const QString &meaning = QString());
+  bool readBits(int numBits, unsigned int &into, const char *intoName, const QStringList &meanings);
+  bool readBits(int numBits, unsigned int &into, const char *intoName, const QMap<int,QString> &meanings);
+  bool readBits(int numBits, unsigned int &into, const char *intoName, meaning_callback_function pMeaning);
+  bool readBits(int numBits, QList<unsigned int> &into, const char *intoName, int idx);
+  bool readBits(int numBits, QList<unsigned int> &into, const char *intoName, int idx, meaning_callback_function pMeaning);
+  bool readBits(int numBits, QByteArray &into, const char *intoName, int idx);
+  bool readBits(int numBits, unsigned int &into, const QMap<int, QString> &intoNames);
+  bool readZeroBits(int numBits, const QString &intoName);
   bool ignoreBits(int numBits);
 
-  bool readFlag(bool &into, QString intoName, QString meaning = "");
-  bool readFlag(QList<bool> &into, QString intoName, int idx, QString meaning = "");
-  bool readFlag(bool &into, QString intoName, QStringList meanings);
+  bool readFlag(bool &into, const char *intoName, const QString &meaning = QString());
+  bool readFlag(QList<bool> &into, const char *intoName, int idx, const QString &meaning = QString());
+  bool readFlag(bool &into, const char *intoName, const QStringList &meanings);
   
-  bool readUEV(unsigned int   &into, QString intoName, QStringList meanings = QStringList());
-  bool readUEV(unsigned int   &into, QString intoName, QString meaning);
-  bool readUEV(QList<quint32> &into, QString intoName, int idx, QString meaning = "");
-  bool readSEV(          int  &into, QString intoName, QStringList meanings = QStringList());
-  bool readSEV(    QList<int>  into, QString intoName, int idx);
-  bool readLeb128(uint64_t &into, QString intoName);
-  bool readUVLC(uint64_t &into, QString intoName);
-  bool readNS(int &into, QString intoName, int maxVal);
-  bool readSU(int &into, QString intoName, int numBits);
-
-  void logValue(int value, QString valueName, QString meaning = "");
-  void logValue(int value, QString valueName, QStringList meanings) { logValue(value, valueName, getMeaningValue(meanings, value)); }
-  void logValue(int value, QString valueName, QMap<int,QString> meanings) { logValue(value, valueName, getMeaningValue(meanings, value)); }
-  void logValue(int value, QString valueName, QString coding, QString code, QString meaning);
-  void logValue(QString value, QString valueName, QString meaning = "");
-  void logInfo(QString info);
+  bool readUEV(unsigned int   &into, const char *intoName, const QStringList &meanings = QStringList());
+  bool readUEV(unsigned int   &into, const char *intoName, const QString &meaning);
+  bool readUEV(QList<quint32> &into, const char *intoName, int idx, const QString &meaning = QString());
+  bool readSEV(          int  &into, const char *intoName, const QStringList &meanings = QStringList());
+  bool readSEV(    QList<int>  into, const char *intoName, int idx);
+  bool readLeb128(uint64_t &into, const char *intoName);
+  bool readUVLC(uint64_t &into, const char *intoName);
+  bool readNS(int &into, const char *intoName, int maxVal);
+  bool readSU(int &into, const char *intoName, int numBits);
+
+  void logValue(int value, const QString &valueName, const QString &meaning = QString());
+  void logValue(int value, const QString &valueName, const QStringList &meanings) { if (currentTreeLevel) logValue(value, valueName, getMeaningValue(meanings, value)); }
+  void logValue(int value, const QString &valueName, const QMap<int,QString> &meanings) { if (currentTreeLevel) logValue(value, valueName, getMeaningValue(meanings, value)); }
+  void logValue(int value, const QString &valueName, const QString &coding, const QString &code, const QString &meaning);
+  void logValue(const QString &value, const QString &valueName, const QString &meaning = QString());
+  void logInfo(const QString &info);
 
   bool addErrorMessageChildItem(QString msg) { return addErrorMessageChildItem(msg, currentTreeLevel); }
   static bool addErrorMessageChildItem(QString msg, TreeItem *item);
@@ -114,6 +122,7 @@ private:
       }
   }
   */
+  // The reading functions. The bits that were read are only returned in code if the syntax is logged.
   bool readBits_catch(unsigned int &into, int numBits, QString &code);
   bool readBits64_catch(uint64_t &into, int numBits, QString &code);
   bool readUEV_catch(unsigned int &into, int &bit_count, QString &code);
@@ -122,9 +131,13 @@ private:
   bool readUVLC_catch(uint64_t &into, int &bit_count, QString &code);
   bool readNS_catch(int &into, int maxVal, int &bit_count, QString &code);
   bool readSU_catch(int &into, int numBits, QString &code);
+  QString *getCodePointer(QString &code) { return currentTreeLevel ? &code : nullptr; }
 
-  QString getMeaningValue(QStringList &meanings, unsigned int val);
-  QString getMeaningValue(QMap<int,QString> &meanings, int val);
+  // Get the name of an array element (e.g. "name[idx]")
+  static QString getIndexedName(const char *name, int idx) { return (idx >= 0) ? QString("%1[%2]").arg(name).arg(idx) : QString(name); }
+
+  static QString getMeaningValue(const QStringList &meanings, unsigned int val);
+  static QString getMeaningValue(const QMap<int,QString> &meanings, int val);
 
   QList<TreeItem*> itemHierarchy;
   TreeItem *currentTreeLevel { nullptr };
@@ -135,6 +148,7 @@ private:
 class reader_sub_level
 {
 public:
+  reader_sub_level(ReaderHelper &reader, const char *name) { reader.addLogSubLevel(name); r = &reader; }
   reader_sub_level(ReaderHelper &reader, QString name) { reader.addLogSubLevel(name); r = &reader; }
   ~reader_sub_level() { r->removeLogSubLevel(); }
 private:
@@ -35,15 +35,16 @@
 #include <stdexcept>
 #include <cassert>
 
-unsigned int SubByteReader::readBits(int nrBits, QString &bitsRead)
+unsigned int SubByteReader::readBits(int nrBits, QString *bitsRead)
 {
-  int out = 0;
+  unsigned int out = 0;
   int nrBitsRead = nrBits;
 
   // The return unsigned int is of depth 32 bits
   if (nrBits > 32)
     throw std::logic_error("Trying to read more than 32 bits at once from the bitstream.");
 
+  const char *data = byteArray.constData();
   while (nrBits > 0)
   {
     if (posInBuffer_bits == 8 && nrBits != 0) 
@@ -76,9 +77,9 @@ unsigned int SubByteReader::readBits(int nrBits, QString &bitsRead)
     // Shift output value so that the new bits fit
     out = out << readBits;
 
-    char c = byteArray[posInBuffer_bytes];
+    unsigned char c = (unsigned char)data[posInBuffer_bytes];
     c = c >> offset;
-    int mask = ((1<<readBits) - 1);
+    unsigned int mask = ((1<<readBits) - 1);
 
     // Write bits to output
     out += (c & mask);
@@ -88,18 +89,16 @@ unsigned int SubByteReader::readBits(int nrBits, QString &bitsRead)
     posInBuffer_bits += readBits;
   }
 
-  for (int i = nrBitsRead-1; i >= 0; i--)
+  if (bitsRead)
   {
-    if (out & (1 << i))
-      bitsRead.append("1");
-    else
-      bitsRead.append("0");
+    for (int i = nrBitsRead-1; i >= 0; i--)
+      bitsRead->append((out & (1u << i)) ? QChar('1') : QChar('0'));
   }
 
   return out;
 }
 
-uint64_t SubByteReader::readBits64(int nrBits, QString &bitsRead)
+uint64_t SubByteReader::readBits64(int nrBits, QString *bitsRead)
 {
   if (nrBits > 64)
     throw std::logic_error("Trying to read more than 64 bits at once from the bitstream.");
@@ -108,8 +107,8 @@ uint64_t SubByteReader::readBits64(int nrBits, QString &bitsRead)
 
   // We just use the readBits function twice
   int lowerBits = nrBits - 32;
-  int upper = readBits(32, bitsRead);
-  int lower = readBits(lowerBits, bitsRead);
+  uint64_t upper = readBits(32, bitsRead);
+  uint64_t lower = readBits(lowerBits, bitsRead);
   uint64_t ret = (upper << lowerBits) + lower;
   return ret;
 }
@@ -139,7 +138,7 @@ QByteArray SubByteReader::readBytes(int nrBytes)
   return retArray;
 }
 
-unsigned int SubByteReader::readUE_V(QString &bitsRead, int &bit_count)
+unsigned int SubByteReader::readUE_V(QString *bitsRead, int &bit_count)
 {
   int readBit = readBits(1, bitsRead);
   bit_count++;
@@ -164,7 +163,7 @@ unsigned int SubByteReader::readUE_V(QString &bitsRead, int &bit_count)
   return val;
 }
 
-int SubByteReader::readSE_V(QString &bitsRead, int &bit_count)
+int SubByteReader::readSE_V(QString *bitsRead, int &bit_count)
 {
   int val = readUE_V(bitsRead, bit_count);
   if (val%2 == 0) 
@@ -173,7 +172,7 @@ int SubByteReader::readSE_V(QString &bitsRead, int &bit_count)
     return (val+1)/2;
 }
 
-uint64_t SubByteReader::readLeb128(QString &bitsRead, int &bit_count)
+uint64_t SubByteReader::readLeb128(QString *bitsRead, int &bit_count)
 {
   // We will read full bytes (up to 8)
   // The highest bit indicates if we need to read another bit. The rest of the bits is added to the counter (shifted accordingly)
@@ -190,7 +189,7 @@ uint64_t SubByteReader::readLeb128(QString &bitsRead, int &bit_count)
   return value;
 }
 
-uint64_t SubByteReader::readUVLC(QString &bitsRead, int &bit_count)
+uint64_t SubByteReader::readUVLC(QString *bitsRead, int &bit_count)
 {
   int leadingZeros = 0;
   while (1)
@@ -207,7 +206,7 @@ uint64_t SubByteReader::readUVLC(QString &bitsRead, int &bit_count)
   return value + ((uint64_t)1 << leadingZeros) - 1;
 }
 
-int SubByteReader::readNS(int maxVal, QString &bitsRead, int &bit_count)
+int SubByteReader::readNS(int maxVal, QString *bitsRead, int &bit_count)
 {
   // FloorLog2
   int floorVal;
@@ -233,7 +232,7 @@ int SubByteReader::readNS(int maxVal, QString &bitsRead, int &bit_count)
   return (v << 1) - m + extra_bit;
 }
 
-int SubByteReader::readSU(int nrBits, QString &bitsRead)
+int SubByteReader::readSU(int nrBits, QString *bitsRead)
 {
   int value = readBits(nrBits, bitsRead);
   int signMask = 1 << (nrBits - 1);
@@ -47,22 +47,23 @@ public:
   
   void set_input(const QByteArray &inArr, unsigned int inArrOffset = 0) { byteArray = inArr; posInBuffer_bytes = inArrOffset; initialPosInBuffer = inArrOffset; }
   
-  // Read the given number of bits and return as integer. If bitsRead is true, the bits that were read are returned as a QString.
-  unsigned int readBits(int nrBits, QString &bitsRead);
-  uint64_t     readBits64(int nrBits, QString &bitsRead);
+  // Read the given number of bits and return as integer. If bitsRead is given, the bits that were read are appended to it
+  // as a string. Building this string is expensive so it should only be requested if the syntax is logged.
+  unsigned int readBits(int nrBits, QString *bitsRead = nullptr);
+  uint64_t     readBits64(int nrBits, QString *bitsRead = nullptr);
   QByteArray   readBytes(int nrBytes);
   // Read an UE(v) code from the array. If given, increase bit_count with every bit read.
-  unsigned int readUE_V(QString &bitsRead, int &bit_count);
+  unsigned int readUE_V(QString *bitsRead, int &bit_count);
   // Read an SE(v) code from the array
-  int readSE_V(QString &bitsRead, int &bit_count);
+  int readSE_V(QString *bitsRead, int &bit_count);
   // Read an leb128 code from the array (as defined in AV1)
-  uint64_t readLeb128(QString &bitsRead, int &bit_count);
+  uint64_t readLeb128(QString *bitsRead, int &bit_count);
   // REad an uvlc code from the array (as defined in AV1)
-  uint64_t readUVLC(QString &bitsRead, int &bit_count);
+  uint64_t readUVLC(QString *bitsRead, int &bit_count);
   // Read a NS code from the array (as defined in AV1)
-  int readNS(int maxVal, QString &bitsRead, int &bit_count);
+  int readNS(int maxVal, QString *bitsRead, int &bit_count);
   // Read a SU code from the array (as defined in AV1)
-  int readSU(int nrBits, QString &bitsRead);
+  int readSU(int nrBits, QString *bitsRead);
 
   // Is there more RBSP data or are we at the end?
   bool more_rbsp_data();
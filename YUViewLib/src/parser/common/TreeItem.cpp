@@ -0,0 +1,191 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut f�r Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TreeItem.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVector>
+
+namespace
+{
+
+// All interned strings. Items are created in the background parser and read in the main thread.
+struct StringPool
+{
+  StringPool() { strings.append(QString()); ids.insert(QString(), 0); }
+  QReadWriteLock lock;
+  QVector<QString> strings;
+  QHash<QString, uint32_t> ids;
+};
+
+StringPool &getStringPool()
+{
+  static StringPool pool;
+  return pool;
+}
+
+int getTextIndex(uint8_t textColumns, int column)
+{
+  int idx = 0;
+  for (int i = 0; i < column; i++)
+    if (textColumns & (1 << i))
+      idx++;
+  return idx;
+}
+
+} // namespace
+
+QString TreeItem::getData(int column) const
+{
+  if (column < 0 || column > 7)
+    return {};
+  if (textColumns & (1 << column))
+    return texts.value(getTextIndex(textColumns, column));
+
+  if (column == 0)
+    return getInternedString(nameID);
+  if (column == 1)
+  {
+    if (valueType == ValueType::Signed)
+      return QString::number(value.i);
+    if (valueType == ValueType::Unsigned)
+      return QString::number(value.u);
+    if (valueType == ValueType::Bool)
+      return value.u ? "1" : "0";
+    if (valueType == ValueType::Double)
+      return QString::number(value.d);
+    return {};
+  }
+  if (column == 2)
+    return getInternedString(codingID);
+  if (column == 3)
+  {
+    QString code(nrCodeBits, '0');
+    for (int i = 0; i < nrCodeBits; i++)
+      if (codeBits & (uint64_t(1) << (nrCodeBits - 1 - i)))
+        code[i] = '1';
+    return code;
+  }
+  if (column == 4)
+    return getInternedString(meaningID);
+  return {};
+}
+
+int TreeItem::getNumberInternedStrings()
+{
+  auto &pool = getStringPool();
+  QReadLocker locker(&pool.lock);
+  return pool.strings.size();
+}
+
+void TreeItem::init(const QString &name, const QString &coding, const QString &code, const QString &meaning, TreeItem *parent)
+{
+  setParent(parent);
+  nameID = intern(name);
+  codingID = intern(coding);
+  meaningID = intern(meaning);
+  setCode(code);
+}
+
+void TreeItem::setCode(const QString &code)
+{
+  // The code is usually the string of bits that was read
+  if (code.size() <= 64)
+  {
+    uint64_t bits = 0;
+    bool isBitString = true;
+    for (auto c : code)
+    {
+      if (c != '0' && c != '1')
+      {
+        isBitString = false;
+        break;
+      }
+      bits = (bits << 1) | (c == '1' ? 1 : 0);
+    }
+    if (isBitString)
+    {
+      codeBits = bits;
+      nrCodeBits = uint8_t(code.size());
+      return;
+    }
+  }
+  setText(3, code);
+}
+
+void TreeItem::setText(int column, const QString &text)
+{
+  if (column < 0 || column > 7)
+    return;
+  const int idx = getTextIndex(textColumns, column);
+  if (textColumns & (1 << column))
+    texts[idx] = text;
+  else
+  {
+    texts.insert(idx, text);
+    textColumns |= uint8_t(1 << column);
+  }
+}
+
+uint32_t TreeItem::intern(const QString &string)
+{
+  if (string.isEmpty())
+    return 0;
+
+  auto &pool = getStringPool();
+  {
+    QReadLocker locker(&pool.lock);
+    auto it = pool.ids.constFind(string);
+    if (it != pool.ids.constEnd())
+      return it.value();
+  }
+
+  QWriteLocker locker(&pool.lock);
+  auto it = pool.ids.constFind(string);
+  if (it != pool.ids.constEnd())
+    return it.value();
+  const auto id = uint32_t(pool.strings.size());
+  pool.strings.append(string);
+  pool.ids.insert(string, id);
+  return id;
+}
+
+QString TreeItem::getInternedString(uint32_t id)
+{
+  if (id == 0)
+    return {};
+  auto &pool = getStringPool();
+  QReadLocker locker(&pool.lock);
+  return pool.strings.value(int(id));
+}
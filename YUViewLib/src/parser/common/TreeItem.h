@@ -30,47 +30,100 @@
 *   along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+
 #pragma once
 
 #include <QList>
 #include <QString>
+#include <QStringList>
+
+#include <cstdint>
 
-// The tree item is used to feed the tree view. Each NAL unit can return a representation using TreeItems
+/* The tree item is used to feed the tree view. Each NAL unit can return a representation using TreeItems.
+ * An item has up to five columns (name, value, coding, code, meaning). Since a parsed bitstream can contain millions
+ * of items, the columns are not saved as strings:
+ * - The name, coding and meaning are interned (saved once in a global string pool) and the item only keeps an ID.
+ * - The value is saved as a raw number and the code as a bit pattern. Both are only formatted in getData().
+ * - Only strings which are not repeated (e.g. the description of a NAL unit) are saved in the item itself.
+ */
 class TreeItem
 {
 public:
   // Some useful constructors of new Tree items. You must at least specify a parent. The new item is atomatically added as a child 
   // of the parent.
-  TreeItem(TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); }
-  TreeItem(QList<QString> &data, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData = data; }
-  TreeItem(const QString &name, TreeItem *parent)  { parentItem = parent; if (parent) parent->childItems.append(this); itemData.append(name); }
-  TreeItem(const QString &name, int          val, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val); }
-  TreeItem(const QString &name, QString      val, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val; }
-  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, unsigned int val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, uint64_t     val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, int64_t      val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, bool         val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << (val ? "1" : "0")    << coding << code; }
-  TreeItem(const QString &name, double       val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val << coding << code; }
-  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, QString meaning, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; itemData.append(meaning); }
-  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, QString meaning, TreeItem *parent, bool isError=false) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val << coding << code; itemData.append(meaning); setError(isError); }
+  TreeItem(TreeItem *parent) { setParent(parent); }
+  TreeItem(const QStringList &data, TreeItem *parent) { setParent(parent); for (int i = 0; i < data.size(); i++) setText(i, data[i]); }
+  TreeItem(const QString &name, TreeItem *parent)  { setParent(parent); nameID = intern(name); }
+  TreeItem(const QString &name, int          val, TreeItem *parent) { setParent(parent); nameID = intern(name); setValue(int64_t(val)); }
+  TreeItem(const QString &name, QString      val, TreeItem *parent) { setParent(parent); nameID = intern(name); setText(1, val); }
+  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); setValue(int64_t(val)); }
+  TreeItem(const QString &name, unsigned int val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); setValue(uint64_t(val)); }
+  TreeItem(const QString &name, uint64_t     val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); setValue(val); }
+  TreeItem(const QString &name, int64_t      val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); setValue(val); }
+  TreeItem(const QString &name, bool         val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); valueType = ValueType::Bool; value.u = val ? 1 : 0; }
+  TreeItem(const QString &name, double       val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); valueType = ValueType::Double; value.d = val; }
+  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, TreeItem *parent) { init(name, coding, code, QString(), parent); setText(1, val); }
+  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, QString meaning, TreeItem *parent) { init(name, coding, code, meaning, parent); setValue(int64_t(val)); }
+  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, QString meaning, TreeItem *parent, bool isError=false) { init(name, coding, code, meaning, parent); setText(1, val); setError(isError); }
 
   ~TreeItem() { qDeleteAll(childItems); }
   void setError(bool isError = true) { error = isError; }
   bool isError()                     { return error; }
 
-  QString getName(bool showStreamIndex) const { QString r = (showStreamIndex && streamIndex != -1) ? QString("Stream %1 - ").arg(streamIndex) : ""; if (itemData.count() > 0) r += itemData[0]; return r; }
+  // Get the text of the given column (0: name, 1: value, 2: coding, 3: code, 4: meaning)
+  QString getData(int column) const;
+  // Set the name (column 0). The name is not interned because it is usually unique (e.g. "NAL 12: IDR_W_RADL").
+  void setName(const QString &name) { setText(0, name); }
+
+  QString getName(bool showStreamIndex) const { QString r = (showStreamIndex && streamIndex != -1) ? QString("Stream %1 - ").arg(streamIndex) : ""; return r + getData(0); }
 
   QList<TreeItem*> childItems;
-  QList<QString> itemData;
   TreeItem *parentItem { nullptr };
 
   int getStreamIndex() { if (streamIndex >= 0) return streamIndex; if (parentItem) return parentItem->getStreamIndex(); return -1; }
   void setStreamIndex(int idx) { streamIndex = idx; }
 
+  // The number of strings in the global string pool (for debugging and testing)
+  static int getNumberInternedStrings();
+
 private:
+  void setParent(TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); }
+  void init(const QString &name, const QString &coding, const QString &code, const QString &meaning, TreeItem *parent);
+  void setValue(int64_t val)  { valueType = ValueType::Signed; value.i = val; }
+  void setValue(uint64_t val) { valueType = ValueType::Unsigned; value.u = val; }
+  void setCode(const QString &code);
+  // Save a string for the given column in the item itself
+  void setText(int column, const QString &text);
+
+  // Get the ID of the string in the global string pool. The empty string has ID 0.
+  static uint32_t intern(const QString &string);
+  static QString getInternedString(uint32_t id);
+
+  enum class ValueType : uint8_t
+  {
+    None,
+    Signed,
+    Unsigned,
+    Bool,
+    Double
+  };
+
+  union
+  {
+    int64_t i;
+    uint64_t u;
+    double d;
+  } value {0};
+  uint64_t codeBits {0};
+  uint32_t nameID {0};
+  uint32_t codingID {0};
+  uint32_t meaningID {0};
+  ValueType valueType {ValueType::None};
+  uint8_t nrCodeBits {0};
+  // For every column with a bit set here, the text is saved in the texts list (in the order of the columns)
+  uint8_t textColumns {0};
   bool error { false };
   // This is set for the first layer items in case of AVPackets
   int streamIndex { -1 };
+  QStringList texts;
 };
@@ -30,23 +30,31 @@
 *   along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#pragma once
+
+#include <type_traits>
+
+// The meanings are only evaluated if the syntax is logged to a tree. Many meanings are lists or maps that would
+// otherwise be created for every element that is read. If nothing is logged, an empty value of the same type is passed.
+#define MEANING(meanings) (reader.isLogging() ? (meanings) : std::decay_t<decltype(meanings)>())
+
 #define READBITS(into,numBits) do { if (!reader.readBits(numBits, into, #into)) return false; } while(0)
-#define READBITS_M(into,numBits,meanings) do { if (!reader.readBits(numBits, into, #into, meanings)) return false; } while(0)
-#define READBITS_M_E(into,numBits,meanings,type) do { unsigned int val; if (!reader.readBits(numBits, val, #into, meanings)) return false; into = (type)val; } while (0)
+#define READBITS_M(into,numBits,meanings) do { if (!reader.readBits(numBits, into, #into, MEANING(meanings))) return false; } while(0)
+#define READBITS_M_E(into,numBits,meanings,type) do { unsigned int val; if (!reader.readBits(numBits, val, #into, MEANING(meanings))) return false; into = (type)val; } while (0)
 #define READBITS_A(into,numBits,idx) do { if (!reader.readBits(numBits, into, #into, idx)) return false; } while(0)
-#define READBITS_A_M(into,numBits,idx,meanings) do { if (!reader.readBits(numBits, into, #into, idx, meanings)) return false; } while(0)
-#define READZEROBITS(numBits,name) do { if (!reader.readZeroBits(numBits, name)) return false; } while(0)
+#define READBITS_A_M(into,numBits,idx,meanings) do { if (!reader.readBits(numBits, into, #into, idx, MEANING(meanings))) return false; } while(0)
+#define READZEROBITS(numBits,name) do { if (!reader.readZeroBits(numBits, reader.isLogging() ? QString(name) : QString())) return false; } while(0)
 #define IGNOREBITS(numBits) do { if (!reader.ignoreBits(numBits)) return false; } while(0)
 
 #define READFLAG(into) do { if (!reader.readFlag(into, #into)) return false; } while(0)
-#define READFLAG_M(into,meanings) do { if (!reader.readFlag(into, #into, meanings)) return false; } while(0)
+#define READFLAG_M(into,meanings) do { if (!reader.readFlag(into, #into, MEANING(meanings))) return false; } while(0)
 #define READFLAG_A(into,idx) do { if (!reader.readFlag(into, #into, idx)) return false; } while(0)
-#define READFLAG_A_M(into,idx,meanings) do { if (!reader.readFlag(into, #into, idx, meanings)) return false; } while(0)
+#define READFLAG_A_M(into,idx,meanings) do { if (!reader.readFlag(into, #into, idx, MEANING(meanings))) return false; } while(0)
 
 #define READUEV(into) do { if (!reader.readUEV(into, #into)) return false; } while(0)
-#define READUEV_M(into,meanings) do { if (!reader.readUEV(into, #into, meanings)) return false; } while(0)
+#define READUEV_M(into,meanings) do { if (!reader.readUEV(into, #into, MEANING(meanings))) return false; } while(0)
 #define READUEV_A(into,idx) do { if (!reader.readUEV(into, #into, idx)) return false; } while(0)
-#define READUEV_A_M(into,idx,meanings) do { if (!reader.readUEV(into, #into, idx, meanings)) return false; } while(0)
+#define READUEV_A_M(into,idx,meanings) do { if (!reader.readUEV(into, #into, idx, MEANING(meanings))) return false; } while(0)
 
 #define READSEV(into) do { if (!reader.readSEV(into, #into)) return false; } while(0)
 #define READSEV_A(into,idx) do { if (!reader.readSEV(into, #into, idx)) return false; } while(0)
@@ -57,8 +65,9 @@
 #define READNS(into,maxValue) do { if (!reader.readNS(into, #into, maxValue)) return false; } while (0) 
 #define READSU(into,numBits) do { if (!reader.readSU(into, #into, numBits)) return false; } while (0)
 
-#define LOGVAL(val) reader.logValue(val, #val)
-#define LOGVAL_M(val,meaning) reader.logValue(val, #val, meaning)
-#define LOGSTRVAL(name,val) reader.logValue(val, name)
-#define LOGPARAM(name,val,coding,code,meaning) reader.logValue(val, name, coding, code, meaning)
-#define LOGINFO(info) reader.logInfo(info)
\ No newline at end of file
+// Values are only logged (and the names/meanings are only created) if the syntax is logged to a tree
+#define LOGVAL(val) do { if (reader.isLogging()) reader.logValue(val, #val); } while(0)
+#define LOGVAL_M(val,meaning) do { if (reader.isLogging()) reader.logValue(val, #val, meaning); } while(0)
+#define LOGSTRVAL(name,val) do { if (reader.isLogging()) reader.logValue(val, name); } while(0)
+#define LOGPARAM(name,val,coding,code,meaning) do { if (reader.isLogging()) reader.logValue(val, name, coding, code, meaning); } while(0)
+#define LOGINFO(info) do { if (reader.isLogging()) reader.logInfo(info); } while(0)
@@ -33,8 +33,17 @@
 #include "parserAnnexB.h"
 
 #include <assert.h>
+#include <climits>
 #include <QProgressDialog>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QFuture>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "common/functions.h"
 
 #define PARSERANNEXB_DEBUG_OUTPUT 0
 #if PARSERANNEXB_DEBUG_OUTPUT && !NDEBUG
@@ -44,6 +53,142 @@
 #define DEBUG_ANNEXB(msg) ((void)0)
 #endif
 
+// The number of NAL syntax trees that are kept in the packet model. Older trees are removed when more are loaded.
+#define PARSERANNEXB_MAX_LOADED_SYNTAX_TREES 100
+
+// The size of the batches (per thread) in which the start codes in a memory mapped file are searched
+#define PARSERANNEXB_START_CODE_SEARCH_BATCH_SIZE (8 * 1024 * 1024)
+
+// How often (in ms) the progress is updated while waiting for a segment that is parsed in parallel
+#define PARSERANNEXB_SEGMENT_WAIT_INTERVAL_MS 20
+
+namespace
+{
+
+/* Provides the NAL units of an AnnexB file (the data of a FileSourceAnnexBFile). If the file is memory mapped, the
+ * start codes are searched in batches in the background (each batch is split into chunks which are searched in
+ * parallel) while the NAL units of the previous batch are parsed. Otherwise, the NAL units are read from the file.
+ */
+class ParallelNALUnitReader
+{
+public:
+  ParallelNALUnitReader(FileSourceAnnexBFile *file) : file(file), data(file->getFileData()), dataSize(file->getFileDataSize())
+  {
+    this->batchSize = int64_t(PARSERANNEXB_START_CODE_SEARCH_BATCH_SIZE) * this->nrThreads;
+    if (this->data && this->dataSize > 0)
+      this->startSearchOfNextBatch();
+    else if (!this->data)
+      this->file->seek(0);
+  }
+  ~ParallelNALUnitReader()
+  {
+    if (this->nextBatchRunning)
+      this->nextBatch.waitForFinished();
+  }
+
+  int64_t pos() const { return this->data ? this->currentPos : this->file->pos(); }
+
+  // Get the next NAL unit (including the start code) and its start and end position in the file like
+  // FileSourceAnnexBFile::getNextNALUnit. If the file is mapped, the data is not copied and is only valid while
+  // the file is open. Returns false if there are no more NAL units.
+  bool getNextNALUnit(QByteArray &nalData, pairUint64 &startEndPosInFile)
+  {
+    if (this->data == nullptr)
+    {
+      nalData = this->file->getNextNALUnit(false, &startEndPosInFile);
+      return !nalData.isEmpty();
+    }
+
+    // Make sure that we know where the next NAL unit starts (or that there are no more start codes)
+    while (this->startCodes.size() - this->startCodeIdx < 2 && this->nextBatchRunning)
+      this->addResultsOfNextBatch();
+    if (this->startCodeIdx >= this->startCodes.size())
+      return false;
+
+    const int64_t start = this->startCodes[this->startCodeIdx++];
+    const bool isLastNAL = (this->startCodeIdx == this->startCodes.size());
+    const int64_t end = isLastNAL ? this->dataSize : this->startCodes[this->startCodeIdx];
+    nalData = QByteArray::fromRawData(this->data + start, int(end - start));
+    startEndPosInFile = pairUint64(start, isLastNAL ? end - 1 : end);
+    this->currentPos = end;
+    return true;
+  }
+
+private:
+  void startSearchOfNextBatch()
+  {
+    const int64_t begin = this->searchedUntilPos;
+    const int64_t end = std::min(begin + this->batchSize, this->dataSize);
+    this->searchedUntilPos = end;
+    const char *d = this->data;
+    const int64_t size = this->dataSize;
+    const int threads = this->nrThreads;
+    this->nextBatch = QtConcurrent::run([d, size, begin, end, threads]() { return FileSourceAnnexBFile::findStartCodes(d, size, begin, end, threads); });
+    this->nextBatchRunning = true;
+  }
+
+  void addResultsOfNextBatch()
+  {
+    const auto batchStartCodes = this->nextBatch.result();
+    this->nextBatchRunning = false;
+    this->startCodes.remove(0, this->startCodeIdx);
+    this->startCodeIdx = 0;
+    this->startCodes += batchStartCodes;
+    if (this->searchedUntilPos < this->dataSize)
+      this->startSearchOfNextBatch();
+  }
+
+  FileSourceAnnexBFile *file {nullptr};
+  const char *data {nullptr};
+  int64_t dataSize {0};
+  int64_t currentPos {0};
+
+  const int nrThreads {int(functions::getOptimalThreadCount())};
+  int64_t batchSize {0};
+  int64_t searchedUntilPos {0};
+  QFuture<QVector<int64_t>> nextBatch;
+  bool nextBatchRunning {false};
+
+  QVector<int64_t> startCodes;
+  int startCodeIdx {0};
+};
+
+// Update the progress dialog (if any). Updating the dialog (setValue) is quite slow, so this is only done if the
+// percent value changes. Returns false if the user canceled.
+bool updateProgressDialog(QProgressDialog *progressDialog, int percentValue, int &curPercentValue)
+{
+  if (!progressDialog)
+    return true;
+  if (progressDialog->wasCanceled())
+    return false;
+  if (percentValue != curPercentValue)
+  {
+    progressDialog->setValue(percentValue);
+    curPercentValue = percentValue;
+  }
+  return true;
+}
+
+// Get the data of a NAL unit without the start code (without copying it)
+QByteArray getDataAfterStartCode(const char *nalData, int size)
+{
+  int skip = 0;
+  while (skip < size && skip < 3 && nalData[skip] == 0)
+    skip++;
+  if (skip >= 2 && skip < size && nalData[skip] == 1)
+    skip++;
+  else
+    skip = 0;
+  return QByteArray::fromRawData(nalData + skip, size - skip);
+}
+
+} // namespace
+
+parserAnnexB::parserAnnexB(QObject *parent) : parserBase(parent)
+{
+  this->packetModel->setLazyChildLoader([this](int row, TreeItem *item) { return this->loadNALSyntaxTree(row, item); }, PARSERANNEXB_MAX_LOADED_SYNTAX_TREES);
+}
+
 QString parserAnnexB::getShortStreamDescription(int streamIndex) const
 {
   Q_UNUSED(streamIndex);
@@ -78,6 +223,9 @@ bool parserAnnexB::addFrameToList(int poc, std::optional<pairUint64> fileStartEn
 
 void parserAnnexB::logNALSize(QByteArray &data, TreeItem *root, std::optional<pairUint64> nalStartEndPos)
 {
+  if (!root)
+    return;
+
   int startCodeSize = 0;
   if (data[0] == char(0) && data[1] == char(0) && data[2] == char(0) && data[3] == char(1))
     startCodeSize = 4;
@@ -92,6 +240,15 @@ void parserAnnexB::logNALSize(QByteArray &data, TreeItem *root, std::optional<pa
     new TreeItem("Start pos", (*nalStartEndPos).first, root);
 }
 
+TreeItem *parserAnnexB::createNALRootItem(TreeItem *parent)
+{
+  if (parent)
+    return new TreeItem(parent);
+  if (this->packetModel->isNull() || this->indexPassNALItem)
+    return nullptr;
+  return new TreeItem(this->packetModel->getRootItem());
+}
+
 int parserAnnexB::getClosestSeekableFrameNumberBefore(int frameIdx, int &codingOrderFrameIdx) const
 {
   // Get the POC for the frame number
@@ -126,6 +283,27 @@ int parserAnnexB::getClosestSeekableFrameNumberBefore(int frameIdx, int &codingO
   return POCList.indexOf(bestSeekPOC);
 }
 
+int parserAnnexB::getNextSeekableFrameNumberAfter(int frameIdx) const
+{
+  if (frameIdx < 0 || frameIdx >= POCList.size())
+    return -1;
+  const int poc = POCList[frameIdx];
+
+  // The random access point with the smallest POC after the given POC
+  int nextSeekPOC = -1;
+  bool found = false;
+  for (const auto &f : frameList)
+  {
+    if (f.randomAccessPoint && f.poc > poc && (!found || f.poc < nextSeekPOC))
+    {
+      nextSeekPOC = f.poc;
+      found = true;
+    }
+  }
+
+  return found ? POCList.indexOf(nextSeekPOC) : -1;
+}
+
 std::optional<pairUint64> parserAnnexB::getFrameStartEndPos(int codingOrderFrameIdx)
 {
   if (codingOrderFrameIdx < 0 || codingOrderFrameIdx >= frameList.size())
@@ -137,9 +315,7 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
 {
   DEBUG_ANNEXB("parserAnnexB::parseAnnexBFile");
 
-  int64_t maxPos = file->getFileSize();
   QScopedPointer<QProgressDialog> progressDialog;
-  int curPercentValue = 0;
   if (mainWindow)
   {
     // Show a modal QProgressDialog while this operation is running.
@@ -156,24 +332,87 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
   stream_info.parsing = true;
   emit streamInfoUpdated();
 
+  // If the packet model is used (bitstream analyzer), we only create one item per NAL and build an index of the
+  // NAL units. The syntax tree of a NAL is parsed when it is requested (loadNALSyntaxTree).
+  const bool indexPass = !this->packetModel->isNull();
+
+  // For decoding, the index of the file can be restored from the seek index cache if the file was parsed before.
+  // The bitstream analyzer needs all NAL units.
+  const auto fileState = SeekIndexCache::getFileState(file->getAbsoluteFilePath());
+  if (!indexPass && this->loadSeekIndexFromCache(file.data()))
+  {
+    stream_info.parsing = false;
+    stream_info.nr_frames = frameList.size();
+    emit streamInfoUpdated();
+    emit backgroundParsingDone("");
+    return true;
+  }
+  if (indexPass)
+  {
+    QMutexLocker lock(&this->nalIndexMutex);
+    this->nalIndex.clear();
+    this->nalIndexFilePath = file->getAbsoluteFilePath();
+  }
+
+  // The segments are read from the mapped file. The index pass names the items of the NAL units while parsing
+  // them (including the POC) so it always runs in order.
+  const bool parseInSegments = !indexPass && this->canParseInSegments() && file->getFileData() != nullptr && file->getFileDataSize() > 0;
+  int nrNALUnits = 0;
+  if (parseInSegments && !this->parseNALUnitsInSegments(file.data(), progressDialog.data(), nrNALUnits))
+    return false;
+  if (!parseInSegments && !this->parseNALUnitsInOrder(file.data(), progressDialog.data(), indexPass, nrNALUnits))
+    return false;
+
+  // We are done.
+  auto parseResult = parseAndAddNALUnit(-1, QByteArray(), {}, {});
+  if (!parseResult.success)
+    DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Error finalizing parsing. This should not happen.");
+  DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Parsing done. Found " << POCList.length() << " POCs");
+
+  if (packetModel)
+    emit modelDataUpdated();
+
+  stream_info.parsing = false;
+  stream_info.nr_nal_units = nrNALUnits;
+  stream_info.nr_frames = frameList.size();
+  emit streamInfoUpdated();
+  emit backgroundParsingDone("");
+
+  if (!indexPass && !cancelBackgroundParser)
+    this->saveSeekIndexToCache(file->getAbsoluteFilePath(), fileState);
+
+  return !cancelBackgroundParser;
+}
+
+bool parserAnnexB::parseNALUnitsInOrder(FileSourceAnnexBFile *file, QProgressDialog *progressDialog, bool indexPass, int &nrNALUnits)
+{
+  // The start codes are searched in parallel ahead of the parser (if the file is mapped)
+  ParallelNALUnitReader nalUnitReader(file);
+
   // Just push all NAL units from the annexBFile into the annexBParser
   QByteArray nalData;
   int nalID = 0;
   pairUint64 nalStartEndPosFile;
   bool abortParsing = false;
+  int curPercentValue = 0;
   QElapsedTimer signalEmitTimer;
   signalEmitTimer.start();
-  while (!file->atEnd() && !abortParsing)
+  while (!abortParsing)
   {
     // Update the progress dialog
-    int64_t pos = file->pos();
+    int64_t pos = nalUnitReader.pos();
     if (stream_info.file_size > 0)
       progressPercentValue = clip((int)(pos * 100 / stream_info.file_size), 0, 100);
 
+    const auto nrNALUnitsBefore = this->nalUnitList.size();
+    ParseResult parsingResult;
     try
     {
-      nalData = file->getNextNALUnit(false, &nalStartEndPosFile);
-      auto parsingResult = parseAndAddNALUnit(nalID, nalData, {}, nalStartEndPosFile, nullptr);
+      if (!nalUnitReader.getNextNALUnit(nalData, nalStartEndPosFile))
+        break;
+      if (indexPass)
+        this->indexPassNALItem = new TreeItem(this->packetModel->getRootItem());
+      parsingResult = parseAndAddNALUnit(nalID, nalData, {}, nalStartEndPosFile, nullptr);
       if (!parsingResult.success)
       {
         DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Error parsing NAL " << nalID);
@@ -195,24 +434,27 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
       DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Exception thrown parsing NAL " << nalID);
     }
 
-    nalID++;
-
-    if (progressDialog)
+    if (this->indexPassNALItem)
     {
-      // Updating the dialog (setValue) is quite slow. Only do this if the percent value changes.
-      if (progressDialog->wasCanceled())
-        return false;
-
-      int newPercentValue = 0;
-      if (maxPos > 0)
-        newPercentValue = clip(int((file->pos() - maxPos) * 100 / maxPos), 0, 100);
-      if (newPercentValue != curPercentValue)
-      {
-        progressDialog->setValue(newPercentValue);
-        curPercentValue = newPercentValue;
-      }
+      NALIndexEntry entry;
+      entry.fileStartEndPos = nalStartEndPosFile;
+      entry.nrBytes = nalData.size();
+      entry.poc = parsingResult.poc.value_or(-1);
+      entry.isRandomAccessPoint = parsingResult.isRandomAccessPoint;
+      // Parameter sets are added to the nalUnitList
+      if (this->nalUnitList.size() > nrNALUnitsBefore && this->nalUnitList.last()->nal_idx == nalID)
+        entry.isParameterSet = this->nalUnitList.last()->isParameterSet();
+      QMutexLocker lock(&this->nalIndexMutex);
+      this->nalIndex.append(entry);
+      this->indexPassNALItem = nullptr;
     }
 
+    nalID++;
+    nrNALUnits = nalID;
+
+    if (!updateProgressDialog(progressDialog, progressPercentValue, curPercentValue))
+      return false;
+
     if (signalEmitTimer.elapsed() > 1000 && packetModel)
     {
       signalEmitTimer.start();
@@ -224,29 +466,295 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
       DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Abort parsing by user request.");
       abortParsing = true;
     }
-    if (parsingLimitEnabled && frameList.size() > PARSER_FILE_FRAME_NR_LIMIT)
+  }
+  return true;
+}
+
+bool parserAnnexB::parseNALUnitsInSegments(FileSourceAnnexBFile *file, QProgressDialog *progressDialog, int &nrNALUnits)
+{
+  const char *data = file->getFileData();
+  const int64_t dataSize = file->getFileDataSize();
+
+  // The segments run in their own pool so that the start code search (in the global pool) is not queued behind them.
+  // The pool is destroyed first and waits for all segments.
+  std::atomic_bool abortSegments {false};
+  std::atomic<int64_t> parsedBytes {0};
+  QList<QFuture<SegmentResult>> segmentFutures;
+  QThreadPool segmentPool;
+  segmentPool.setMaxThreadCount(int(functions::getOptimalThreadCount()));
+
+  int curPercentValue = 0;
+  auto updateProgress = [&]() {
+    this->progressPercentValue = clip(int(parsedBytes * 100 / dataSize), 0, 100);
+    if (updateProgressDialog(progressDialog, this->progressPercentValue, curPercentValue))
+      return true;
+    abortSegments = true;
+    return false;
+  };
+
+  auto startSegment = [&](const Segment &segment) {
+    DEBUG_ANNEXB("parserAnnexB::parseNALUnitsInSegments Start segment at NAL " << segment.nalUnits.first().nalID << " with " << segment.nalUnits.size() << " NAL units");
+    segmentFutures.append(QtConcurrent::run(&segmentPool, [this, data, segment, &abortSegments, &parsedBytes]() {
+      return this->parseSegment(data, segment, abortSegments, parsedBytes);
+    }));
+  };
+
+  // All parameter sets before the current segment. If a parameter set is repeated, only the last one is kept.
+  QList<SegmentNALUnit> parameterSets;
+  auto addParameterSet = [&parameterSets, data](const SegmentNALUnit &nal) {
+    const auto nalData = getDataAfterStartCode(data + nal.startEndPosInFile.first, nal.size);
+    for (int i = 0; i < parameterSets.size(); i++)
     {
-      DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Abort parsing because frame limit was reached.");
-      abortParsing = true;
+      const auto &p = parameterSets[i];
+      if (getDataAfterStartCode(data + p.startEndPosInFile.first, p.size) == nalData)
+      {
+        parameterSets.removeAt(i);
+        break;
+      }
     }
+    parameterSets.append(nal);
+  };
+
+  // Split the file at the access units of IDR pictures. Each segment is started as soon as its end is known.
+  ParallelNALUnitReader nalUnitReader(file);
+  QByteArray nalData;
+  pairUint64 nalStartEndPosFile;
+  Segment segment;
+  int accessUnitStart = -1;  //< The index in segment.nalUnits where the NAL units in front of the next slice start
+  auto lastSliceType = SegmentNALType::Other;
+  while (!this->cancelBackgroundParser && nalUnitReader.getNextNALUnit(nalData, nalStartEndPosFile))
+  {
+    SegmentNALUnit nal;
+    nal.nalID = nrNALUnits++;
+    nal.startEndPosInFile = nalStartEndPosFile;
+    nal.size = nalData.size();
+    const auto type = this->getSegmentNALType(nalData);
+    nal.isParameterSet = (type == SegmentNALType::ParameterSet);
+
+    if (type == SegmentNALType::AccessUnitPrefix || type == SegmentNALType::ParameterSet)
+    {
+      if (accessUnitStart == -1)
+        accessUnitStart = segment.nalUnits.size();
+    }
+    else if (type == SegmentNALType::Slice || type == SegmentNALType::IDRSlice)
+    {
+      // Consecutive IDR pictures stay in one segment
+      if (type == SegmentNALType::IDRSlice && lastSliceType == SegmentNALType::Slice)
+      {
+        const int splitIdx = (accessUnitStart == -1) ? segment.nalUnits.size() : accessUnitStart;
+        Segment nextSegment;
+        nextSegment.nalUnits = segment.nalUnits.mid(splitIdx);
+        segment.nalUnits.resize(splitIdx);
+        segment.nextNALUnit = nextSegment.nalUnits.isEmpty() ? nal : nextSegment.nalUnits.first();
+        startSegment(segment);
+
+        for (const auto &segmentNAL : segment.nalUnits)
+          if (segmentNAL.isParameterSet)
+            addParameterSet(segmentNAL);
+        nextSegment.parameterSets = parameterSets;
+        segment = nextSegment;
+      }
+      lastSliceType = type;
+      accessUnitStart = -1;
+    }
+    segment.nalUnits.append(nal);
+
+    if (!updateProgress())
+      return false;
   }
+  if (!segment.nalUnits.isEmpty())
+    startSegment(segment);
+  DEBUG_ANNEXB("parserAnnexB::parseNALUnitsInSegments Split " << nrNALUnits << " NAL units into " << segmentFutures.size() << " segments");
+
+  // Merge the segments in order. The POC values and the DTS of the bitrate entries of a segment are shifted
+  // to follow the previous segments.
+  int pocOffset = 0;
+  int dtsOffset = 0;
+  for (auto &future : segmentFutures)
+  {
+    while (!future.isFinished())
+    {
+      if (!updateProgress())
+        return false;
+      QThread::msleep(PARSERANNEXB_SEGMENT_WAIT_INTERVAL_MS);
+    }
 
-  // We are done.
-  auto parseResult = parseAndAddNALUnit(-1, QByteArray(), {}, {});
-  if (!parseResult.success)
-    DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Error finalizing parsing. This should not happen.");
-  DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Parsing done. Found " << POCList.length() << " POCs");
+    const auto result = future.result();
+    for (const auto &frame : result.frames)
+      this->addFrameToList(frame.poc + pocOffset, frame.fileStartEndPos, frame.randomAccessPoint);
+    for (auto entry : result.bitrateEntries)
+    {
+      entry.pts += pocOffset;
+      entry.dts += dtsOffset;
+      this->bitratePlotModel->addBitratePoint(0, entry);
+    }
+    for (const auto &nal : result.nalUnits)
+    {
+      nal->addPOCOffset(pocOffset);
+      this->nalUnitList.append(nal);
+    }
+    pocOffset += result.pocOffsetOfNextIDR;
+    dtsOffset += result.bitrateEntries.size();
+  }
+  return updateProgress();
+}
 
-  if (packetModel)
-    emit modelDataUpdated();
+parserAnnexB::SegmentResult parserAnnexB::parseSegment(const char *data, const Segment &segment, const std::atomic_bool &abort, std::atomic<int64_t> &parsedBytes) const
+{
+  QScopedPointer<parserAnnexB> parser(this->createNewParser());
+  // The frames before the first random access point of the file are dropped when the segments are merged
+  parser->pocOfFirstRandomAccessFrame = INT_MIN;
 
-  stream_info.parsing = false;
-  stream_info.nr_nal_units = nalID;
-  stream_info.nr_frames = frameList.size();
-  emit streamInfoUpdated();
-  emit backgroundParsingDone("");
+  auto parseNALUnit = [&parser, data](const SegmentNALUnit &nal) {
+    const auto nalData = QByteArray::fromRawData(data + nal.startEndPosInFile.first, nal.size);
+    try
+    {
+      return parser->parseAndAddNALUnit(nal.nalID, nalData, {}, nal.startEndPosInFile, nullptr);
+    }
+    catch (...)
+    {
+      DEBUG_ANNEXB("parserAnnexB::parseSegment Exception thrown parsing NAL " << nal.nalID);
+    }
+    return ParseResult();
+  };
 
-  return !cancelBackgroundParser;
+  // Without a preceding slice, the parameter sets do not start an access unit. They are counted into the first
+  // access unit of the segment.
+  unsigned int parameterSetBytes = 0;
+  for (const auto &nal : segment.parameterSets)
+  {
+    parseNALUnit(nal);
+    parameterSetBytes += unsigned(nal.size);
+  }
+
+  SegmentResult result;
+  for (const auto &nal : segment.nalUnits)
+  {
+    if (abort || this->cancelBackgroundParser)
+      break;
+    const auto parseResult = parseNALUnit(nal);
+    if (parseResult.success && parseResult.bitrateEntry)
+      result.bitrateEntries.append(*parseResult.bitrateEntry);
+    parsedBytes += nal.size;
+  }
+  result.pocOffsetOfNextIDR = parser->getPOCOffsetOfNextIDR();
+
+  // Parse the first NAL of the next segment only to complete the last access unit. Everything else that it adds
+  // to the parser is part of the next segment.
+  if (segment.nextNALUnit)
+  {
+    const auto parseResult = parseNALUnit(*segment.nextNALUnit);
+    if (parseResult.success && parseResult.bitrateEntry)
+      result.bitrateEntries.append(*parseResult.bitrateEntry);
+  }
+  parser->parseAndAddNALUnit(-1, QByteArray(), {}, {});
+
+  if (!result.bitrateEntries.isEmpty())
+  {
+    auto &firstEntry = result.bitrateEntries.first();
+    firstEntry.bitrate -= std::min(firstEntry.bitrate, parameterSetBytes);
+  }
+
+  for (const auto &frame : parser->frameList)
+  {
+    if (segment.nextNALUnit && frame.fileStartEndPos && frame.fileStartEndPos->first >= segment.nextNALUnit->startEndPosInFile.first)
+      continue;
+    result.frames.append(frame);
+  }
+
+  const int firstNALID = segment.nalUnits.first().nalID;
+  const int lastNALID = segment.nalUnits.last().nalID;
+  for (const auto &nal : parser->nalUnitList)
+    if (nal->nal_idx >= firstNALID && nal->nal_idx <= lastNALID)
+      result.nalUnits.append(nal);
+
+  return result;
+}
+
+QList<QByteArray> parserAnnexB::getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos)
+{
+  if (this->cachedSeekPoints.contains(iFrameNr))
+  {
+    const auto &seekPoint = this->cachedSeekPoints[iFrameNr];
+    filePos = seekPoint.filePos;
+    return seekPoint.parameterSets;
+  }
+  return this->getSeekFrameParamerSetsFromNALList(iFrameNr, filePos);
+}
+
+bool parserAnnexB::loadSeekIndexFromCache(FileSourceAnnexBFile *file)
+{
+  SeekIndexCache::Index index;
+  if (!SeekIndexCache::loadIndex(file->getAbsoluteFilePath(), this->metaObject()->className(), index))
+    return false;
+
+  // Parse the parameter sets (in the same way as when parsing the whole file). After this, the properties of the
+  // sequence (size, format, frame rate) are known.
+  for (int i = 0; i < index.parameterSetPositions.size(); i++)
+  {
+    pairUint64 nalStartEndPosFile;
+    if (!file->seek(int64_t(index.parameterSetPositions[i].first)))
+      continue;
+    const auto nalData = file->getNextNALUnit(false, &nalStartEndPosFile);
+    try
+    {
+      parseAndAddNALUnit(i, nalData, {}, nalStartEndPosFile, nullptr);
+    }
+    catch (...)
+    {
+      DEBUG_ANNEXB("parserAnnexB::loadSeekIndexFromCache Exception thrown parsing parameter set " << i);
+    }
+  }
+
+  for (const auto &frame : index.frames)
+  {
+    std::optional<pairUint64> fileStartEndPos;
+    if (frame.startPos >= 0)
+      fileStartEndPos = pairUint64(frame.startPos, frame.endPos);
+    addFrameToList(frame.poc, fileStartEndPos, frame.keyFrame);
+  }
+  this->cachedSeekPoints = index.seekPoints;
+
+  // Finish parsing like at the end of the file
+  parseAndAddNALUnit(-1, QByteArray(), {}, {});
+  DEBUG_ANNEXB("parserAnnexB::loadSeekIndexFromCache Loaded " << POCList.length() << " POCs");
+  return true;
+}
+
+void parserAnnexB::saveSeekIndexToCache(const QString &filePath, const SeekIndexCache::FileState &parsedFileState)
+{
+  SeekIndexCache::Index index;
+  for (const auto &nal : this->nalUnitList)
+    if (nal->isParameterSet() && nal->filePosStartEnd)
+      index.parameterSetPositions.append(*nal->filePosStartEnd);
+
+  for (const auto &frame : this->frameList)
+  {
+    SeekIndexCache::Frame cacheFrame;
+    cacheFrame.poc = frame.poc;
+    cacheFrame.keyFrame = frame.randomAccessPoint;
+    if (frame.fileStartEndPos)
+    {
+      cacheFrame.startPos = int64_t(frame.fileStartEndPos->first);
+      cacheFrame.endPos = int64_t(frame.fileStartEndPos->second);
+    }
+    index.frames.append(cacheFrame);
+
+    if (frame.randomAccessPoint)
+    {
+      // When loading from the cache, the random access slices are not in the nalUnitList
+      const int frameIdx = POCList.indexOf(frame.poc);
+      if (frameIdx < 0)
+        continue;
+      SeekIndexCache::SeekPoint seekPoint;
+      seekPoint.parameterSets = this->getSeekFrameParamerSetsFromNALList(frameIdx, seekPoint.filePos);
+      if (!seekPoint.parameterSets.isEmpty())
+        index.seekPoints.insert(frameIdx, seekPoint);
+    }
+  }
+
+  // If the index can not be saved, the file is just parsed again the next time
+  SeekIndexCache::saveIndex(filePath, this->metaObject()->className(), parsedFileState, index);
 }
 
 bool parserAnnexB::runParsingOfFile(QString compressedFilePath)
@@ -256,6 +764,69 @@ bool parserAnnexB::runParsingOfFile(QString compressedFilePath)
   return parseAnnexBFile(file);
 }
 
+bool parserAnnexB::loadNALSyntaxTree(int nalIdx, TreeItem *nalItem)
+{
+  DEBUG_ANNEXB("parserAnnexB::loadNALSyntaxTree NAL " << nalIdx);
+
+  // Get all NAL units that must be parsed. These are all parameter sets before the last random access point
+  // and all NAL units from the random access point to the requested NAL. Without a random access point, all NAL
+  // units from the start of the file are parsed.
+  QList<QPair<int, NALIndexEntry>> nalUnitsToParse;
+  QString filePath;
+  {
+    QMutexLocker lock(&this->nalIndexMutex);
+    if (nalIdx < 0 || nalIdx >= this->nalIndex.size())
+      return false;
+    int randomAccessIdx = nalIdx;
+    while (randomAccessIdx > 0 && !this->nalIndex[randomAccessIdx].isRandomAccessPoint)
+      randomAccessIdx--;
+    for (int i = 0; i < randomAccessIdx; i++)
+      if (this->nalIndex[i].isParameterSet)
+        nalUnitsToParse.append(qMakePair(i, this->nalIndex[i]));
+    for (int i = randomAccessIdx; i <= nalIdx; i++)
+      nalUnitsToParse.append(qMakePair(i, this->nalIndex[i]));
+    filePath = this->nalIndexFilePath;
+  }
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  // The new parser has no packet model so only the requested NAL is parsed into a tree.
+  QScopedPointer<parserAnnexB> parser(this->createNewParser());
+  TreeItem parsedRoot(nullptr);
+  for (const auto &nal : nalUnitsToParse)
+  {
+    const auto &entry = nal.second;
+    if (!file.seek(entry.fileStartEndPos.first))
+      return false;
+    const auto nalData = file.read(entry.nrBytes);
+    if (nalData.size() != entry.nrBytes)
+      return false;
+
+    try
+    {
+      parser->parseAndAddNALUnit(nal.first, nalData, {}, entry.fileStartEndPos, (nal.first == nalIdx) ? &parsedRoot : nullptr);
+    }
+    catch (...)
+    {
+      DEBUG_ANNEXB("parserAnnexB::loadNALSyntaxTree Exception thrown parsing NAL " << nal.first);
+    }
+  }
+
+  // Move the syntax of the NAL to the given item. The name of the item is already set.
+  if (parsedRoot.childItems.isEmpty())
+    return false;
+  auto parsedNALRoot = parsedRoot.childItems.first();
+  for (auto item : parsedNALRoot->childItems)
+  {
+    item->parentItem = nalItem;
+    nalItem->childItems.append(item);
+  }
+  parsedNALRoot->childItems.clear();
+  return true;
+}
+
 QList<QTreeWidgetItem*> parserAnnexB::stream_info_type::getStreamInfo()
 {
   QList<QTreeWidgetItem*> infoList;
@@ -33,18 +33,24 @@
 #pragma once
 
 #include <QList>
+#include <QMutex>
 #include <QTreeWidgetItem>
+#include <QVector>
 
+#include <atomic>
 #include <optional>
 
 #include "common/BitratePlotModel.h"
 #include "common/TreeItem.h"
 #include "filesource/FileSourceAnnexBFile.h"
+#include "filesource/SeekIndexCache.h"
 #include "parserBase.h"
 #include "video/videoHandlerYUV.h"
 
 using namespace YUV_Internals;
 
+class QProgressDialog;
+
 /* The (abstract) base class for the various types of AnnexB files (AVC, HEVC, VVC) that we can parse.
 */
 class parserAnnexB : public parserBase
@@ -52,9 +58,12 @@ class parserAnnexB : public parserBase
   Q_OBJECT
 
 public:
-  parserAnnexB(QObject *parent = nullptr) : parserBase(parent) {};
+  parserAnnexB(QObject *parent = nullptr);
   virtual ~parserAnnexB() {};
 
+  // Create a new (empty) parser of the same type
+  virtual parserAnnexB *createNewParser() const = 0;
+
   // How many POC's have been found in the file
   int getNumberPOCs() const { return frameList.size(); }
 
@@ -81,6 +90,9 @@ public:
     bool success {false};
     std::optional<QString> nalTypeName;
     std::optional<BitratePlotModel::BitrateEntry> bitrateEntry;
+    // The POC of the picture that the NAL belongs to (if known) and if parsing can start at this NAL
+    std::optional<int> poc;
+    bool isRandomAccessPoint {false};
   };
   virtual ParseResult parseAndAddNALUnit(int nalID, QByteArray data, std::optional<BitratePlotModel::BitrateEntry> bitrateEntry, std::optional<pairUint64> nalStartEndPosFile={}, TreeItem *parent=nullptr) = 0;
   
@@ -92,13 +104,16 @@ public:
   // When we want to seek to a specific frame number, this function return the parameter sets that you need
   // to start decoding (without start codes). If file positions were set for the NAL units, the file position 
   // where decoding can begin will also be returned.
-  virtual QList<QByteArray> getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos) = 0;
+  QList<QByteArray> getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos);
 
   // Look through the random access points and find the closest one before (or equal)
   // the given frameIdx where we can start decoding
   // frameIdx: The frame index in display order that we want to seek to
   // codingOrderFrameIdx: The index of the frame in coding order (for use with getFrameStartEndPos).
   int getClosestSeekableFrameNumberBefore(int frameIdx, int &codingOrderFrameIdx) const;
+  // Get the frame index (display order) of the first random access point after the given frameIdx (-1 if there is none).
+  // All frames in between can be decoded by seeking to getClosestSeekableFrameNumberBefore(frameIdx).
+  int getNextSeekableFrameNumberAfter(int frameIdx) const;
 
   // Get the parameters sets as extradata. The format of this depends on the underlying codec.
   virtual QByteArray getExtradata() = 0;
@@ -108,11 +123,22 @@ public:
 
   std::optional<pairUint64> getFrameStartEndPos(int codingOrderFrameIdx);
 
+  // Parse all NAL units of the file. The search for the start codes runs in parallel (ahead of the parser). When the
+  // file is opened for decoding and the parser supports it (canParseInSegments), the file is split into segments at IDR
+  // pictures which are parsed in parallel. Otherwise, the NAL units are parsed one after another in the calling thread.
   bool parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget *mainWindow=nullptr);
 
   // Called from the bitstream analyzer. This function can run in a background process.
   bool runParsingOfFile(QString compressedFilePath) Q_DECL_OVERRIDE;
 
+  // The syntax trees are only created on demand so the entire file can always be parsed
+  bool usesParsingLimit() const override { return false; }
+
+  // Parse the syntax tree of the NAL with the given index and add it to the given item. The parser state
+  // (active parameter sets, POC) is recreated by parsing all parameter sets and all NAL units from the last random
+  // access point on in a new parser. This runs in the main thread while the background parser may still be running.
+  bool loadNALSyntaxTree(int nalIdx, TreeItem *nalItem);
+
   // Parsing of an SEI message may fail when the required parameter sets are not yet available and parsing has to be performed
   // once the required parameter sets are recieved.
   enum sei_parsing_return_t
@@ -142,6 +168,8 @@ public:
     virtual QByteArray getNALHeader() const = 0;
     virtual bool isParameterSet() const = 0;
     virtual int  getPOC() const { return -1; }
+    // Shift the POC of the unit in the sequence (see getPOCOffsetOfNextIDR)
+    virtual void addPOCOffset(int offset) { Q_UNUSED(offset); }
     // Get the raw NAL unit (excluding a start code, including nal unit header and payload)
     // This only works if the payload was saved of course
     QByteArray getRawNALData() const { return getNALHeader() + nalPayload; }
@@ -154,6 +182,9 @@ public:
   };
 
 protected:
+
+  // Get the parameter sets for seeking (see getSeekFrameParamerSets) from the parameter sets and random access points in the nalUnitList
+  virtual QList<QByteArray> getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos) = 0;
   
   struct AnnexBFrame
   {
@@ -175,6 +206,29 @@ protected:
 
   static void logNALSize(QByteArray &data, TreeItem *root, std::optional<pairUint64> nalStartEndPos);
 
+  // When a file is opened for decoding, parseAnnexBFile can split it into segments which are parsed in parallel in new
+  // parsers. A segment starts with the access unit of an IDR picture. From there on, parsing only depends on the
+  // parameter sets and the POC counting starts again. Parsers that support this classify the NAL units by their header.
+  virtual bool canParseInSegments() const { return false; }
+  enum class SegmentNALType
+  {
+    Other,            // A NAL which belongs to the current access unit (e.g. a suffix SEI or filler data)
+    AccessUnitPrefix, // Starts an access unit if it follows a slice (e.g. an access unit delimiter or a prefix SEI)
+    ParameterSet,     // A parameter set. It also starts an access unit if it follows a slice.
+    Slice,            // A slice of a picture which is not an IDR picture
+    IDRSlice          // A slice of an IDR picture
+  };
+  virtual SegmentNALType getSegmentNALType(const QByteArray &nalData) const { Q_UNUSED(nalData); return SegmentNALType::Other; }
+  // The offset that is added to the POC of an IDR picture which follows the NAL units parsed so far. The new parser of
+  // a segment counts the POC from 0, so the POC values of a segment are shifted by the offsets of all previous segments.
+  virtual int getPOCOffsetOfNextIDR() const { return 0; }
+
+  // Get the root item for the syntax of a NAL. In the bitstream analyzer, parseAnnexBFile only runs a fast index
+  // pass which creates one item per NAL without any syntax. Then no root is returned and only the name is set
+  // on the item of the index pass (getNALNameItem).
+  TreeItem *createNALRootItem(TreeItem *parent);
+  TreeItem *getNALNameItem(TreeItem *nalRoot) const { return nalRoot ? nalRoot : this->indexPassNALItem; }
+
   // A list of nal units sorted by position in the file.
   // Only parameter sets and random access positions go in here.
   // So basically all information we need to seek in the stream and get the active parameter sets to start the decoder at a certain position.
@@ -193,4 +247,60 @@ protected:
     bool parsing     { false };
   };
   stream_info_type stream_info;
+
+private:
+  // The index of all NAL units in the file (one entry per first level item in the packet model).
+  // It is filled by the background parser and read from the main thread when a syntax tree is requested.
+  struct NALIndexEntry
+  {
+    pairUint64 fileStartEndPos;
+    int nrBytes {0};
+    int poc {-1};
+    bool isParameterSet {false};
+    bool isRandomAccessPoint {false};
+  };
+  QList<NALIndexEntry> nalIndex;
+  QString nalIndexFilePath;
+  QMutex nalIndexMutex;
+
+  TreeItem *indexPassNALItem {nullptr};
+
+  // Parse the NAL units of the file one after another in this parser (or build the NAL index in the index pass).
+  // Both functions return false if the user canceled parsing in the progress dialog.
+  bool parseNALUnitsInOrder(FileSourceAnnexBFile *file, QProgressDialog *progressDialog, bool indexPass, int &nrNALUnits);
+  // Split the file into segments, parse them in parallel and merge the frames, bitrate entries and NAL units in order.
+  bool parseNALUnitsInSegments(FileSourceAnnexBFile *file, QProgressDialog *progressDialog, int &nrNALUnits);
+
+  struct SegmentNALUnit
+  {
+    int nalID {-1};
+    pairUint64 startEndPosInFile;
+    int size {0};
+    bool isParameterSet {false};
+  };
+  struct Segment
+  {
+    // The parameter sets before the segment. They are parsed first.
+    QList<SegmentNALUnit> parameterSets;
+    QVector<SegmentNALUnit> nalUnits;
+    // The first NAL of the next segment. It starts a new access unit which completes the bitrate entry of the last one.
+    std::optional<SegmentNALUnit> nextNALUnit;
+  };
+  // The results of a segment. The POC values and the DTS of the bitrate entries start at 0.
+  struct SegmentResult
+  {
+    QList<AnnexBFrame> frames;
+    QList<BitratePlotModel::BitrateEntry> bitrateEntries;
+    QList<QSharedPointer<nal_unit>> nalUnits;
+    int pocOffsetOfNextIDR {0};
+  };
+  // Parse the segment in a new parser. The NAL units are read from the mapped file data.
+  SegmentResult parseSegment(const char *data, const Segment &segment, const std::atomic_bool &abort, std::atomic<int64_t> &parsedBytes) const;
+
+  // The frame list, the parameter sets and the seek points are saved in the seek index cache. If the file is opened
+  // again, only the parameter sets are parsed. The nalUnitList then only contains the parameter sets so the seek
+  // points are taken from the cache.
+  bool loadSeekIndexFromCache(FileSourceAnnexBFile *file);
+  void saveSeekIndexToCache(const QString &filePath, const SeekIndexCache::FileState &parsedFileState);
+  QMap<int, SeekIndexCache::SeekPoint> cachedSeekPoints;
 };
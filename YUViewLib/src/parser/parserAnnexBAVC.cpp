@@ -175,11 +175,7 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
   // We don't set data (a name) for this item yet. 
   // We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  TreeItem *nalRoot = this->createNALRootItem(parent);
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -307,6 +303,8 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
 
       currentSliceIntra = new_slice->isRandomAccess();
       currentSliceType = new_slice->getSliceTypeString();
+      parseResult.poc = new_slice->globalPOC;
+      parseResult.isRandomAccessPoint = new_slice->isRandomAccess() && new_slice->first_mb_in_slice == 0;
 
       DEBUG_AVC("parserAnnexBAVC::parseAndAddNALUnit Parsed Slice POC " << new_slice->globalPOC);
     }
@@ -333,7 +331,7 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
       sei_data.remove(0, nrBytes);
 
       if (message_tree)
-        message_tree->itemData[0] = QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName);
+        message_tree->setName(QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName));
 
       // The real number of bytes to read from the bitstream may be higher than the indicated payload size (emulation prevention)
       int realPayloadSize = determineRealNumberOfBytesSEIEmulationPrevention(sei_data, new_sei->payloadSize);
@@ -450,11 +448,11 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
   if (currentPicTimingSEI)
     this->lastPicTimingSEI = currentPicTimingSEI;
 
-  if (nalRoot)
+  if (auto nalItem = this->getNALNameItem(nalRoot))
   {
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
-    nalRoot->setError(!parsingSuccess);
+    nalItem->setName(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
+    nalItem->setError(!parsingSuccess);
   }
 
   parseResult.success = true;
@@ -1994,7 +1992,7 @@ bool parserAnnexBAVC::user_data_sei::parse_internal(QByteArray &sliceHeaderData,
   return true;
 }
 
-QList<QByteArray> parserAnnexBAVC::getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos)
+QList<QByteArray> parserAnnexBAVC::getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos)
 {
   // Get the POC for the frame number
   int seekPOC = POCList[iFrameNr];
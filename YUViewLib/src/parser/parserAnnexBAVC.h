@@ -56,10 +56,11 @@ public:
 
   ParseResult parseAndAddNALUnit(int nalID, QByteArray data, std::optional<BitratePlotModel::BitrateEntry> bitrateEntry, std::optional<pairUint64> nalStartEndPosFile={}, TreeItem *parent=nullptr) Q_DECL_OVERRIDE;
 
-  QList<QByteArray> getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos) Q_DECL_OVERRIDE;
+  QList<QByteArray> getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos) Q_DECL_OVERRIDE;
   QByteArray getExtradata() Q_DECL_OVERRIDE;
   QPair<int,int> getProfileLevel() Q_DECL_OVERRIDE;
   QPair<int,int> getSampleAspectRatio() Q_DECL_OVERRIDE;
+  parserAnnexB *createNewParser() const Q_DECL_OVERRIDE { return new parserAnnexBAVC(); }
 
 protected:
   // ----- Some nested classes that are only used in the scope of this file handler class
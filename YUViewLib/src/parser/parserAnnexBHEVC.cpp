@@ -149,7 +149,7 @@ yuvPixelFormat parserAnnexBHEVC::getPixelFormat() const
   return yuvPixelFormat();
 }
 
-QList<QByteArray> parserAnnexBHEVC::getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos)
+QList<QByteArray> parserAnnexBHEVC::getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos)
 {
   // Get the POC for the frame number
   int seekPOC = POCList[iFrameNr];
@@ -348,11 +348,7 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
   // Create a new TreeItem root for the NAL unit. We don't set data (a name) for this item
   // yet. We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  TreeItem *nalRoot = this->createNALRootItem(parent);
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -519,6 +515,8 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
         currentSliceIntra = true;
       }
       currentSliceType = new_slice->getSliceTypeString();
+      parseResult.poc = POC;
+      parseResult.isRandomAccessPoint = nal_hevc.isIRAP() && new_slice->first_slice_segment_in_pic_flag;
     }
 
     specificDescription = parsingSuccess ? QString(" POC %1").arg(POC) : " POC ERR";
@@ -542,7 +540,7 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
         return parseResult;
 
       if (message_tree)
-        message_tree->itemData[0] = QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName);
+        message_tree->setName(QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName));
 
       auto sub_sei_data = seiReader.readBytes(new_sei->payloadSize);
 
@@ -666,14 +664,47 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
     this->currentAUSliceTypes[currentSliceType]++;
   }
 
-  if (nalRoot)
+  if (auto nalItem = this->getNALNameItem(nalRoot))
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_hevc.nal_idx).arg(nal_unit_type_toString.value(nal_hevc.nal_type)) + specificDescription);
+    nalItem->setName(QString("NAL %1: %2").arg(nal_hevc.nal_idx).arg(nal_unit_type_toString.value(nal_hevc.nal_type)) + specificDescription);
 
   parseResult.success = true;
   return parseResult;
 }
 
+parserAnnexB::SegmentNALType parserAnnexBHEVC::getSegmentNALType(const QByteArray &nalData) const
+{
+  // Skip the start code
+  int skip = 0;
+  if (nalData.size() >= 3 && nalData.at(0) == (char)0 && nalData.at(1) == (char)0 && nalData.at(2) == (char)1)
+    skip = 3;
+  else if (nalData.size() >= 4 && nalData.at(0) == (char)0 && nalData.at(1) == (char)0 && nalData.at(2) == (char)0 && nalData.at(3) == (char)1)
+    skip = 4;
+  if (nalData.size() < skip + 2)
+    return SegmentNALType::Other;
+
+  // Only the nal_unit_type and the nuh_layer_id of the NAL unit header are needed
+  nal_unit_hevc nal(-1, {});
+  const auto headerByte0 = (unsigned char)nalData.at(skip);
+  const auto headerByte1 = (unsigned char)nalData.at(skip + 1);
+  nal.nal_type = (nal_unit_type)((headerByte0 >> 1) & 0x3f);
+  nal.nuh_layer_id = ((headerByte0 & 0x01) << 5) | (headerByte1 >> 3);
+
+  if (nal.isParameterSet())
+    return SegmentNALType::ParameterSet;
+  if (nal.isSlice())
+  {
+    if (nal.nuh_layer_id == 0 && (nal.nal_type == IDR_W_RADL || nal.nal_type == IDR_N_LP))
+      return SegmentNALType::IDRSlice;
+    return SegmentNALType::Slice;
+  }
+  // The other NAL units that start a new access unit after a slice (see auDelimiterDetector_t::isStartOfNewAU)
+  if (nal.nuh_layer_id == 0 && (nal.nal_type == AUD_NUT || nal.nal_type == PREFIX_SEI_NUT ||
+      (nal.nal_type >= RSV_NVCL41 && nal.nal_type <= RSV_NVCL44) || (nal.nal_type >= UNSPEC48 && nal.nal_type <= UNSPEC55)))
+    return SegmentNALType::AccessUnitPrefix;
+  return SegmentNALType::Other;
+}
+
 bool parserAnnexBHEVC::profile_tier_level::parse_profile_tier_level(ReaderHelper &reader, bool profilePresentFlag, int maxNumSubLayersMinus1)
 {
   reader_sub_level s(reader, "profile_tier_level()");
@@ -984,13 +1015,13 @@ bool parserAnnexBHEVC::pred_weight_table::parse_pred_weight_table(ReaderHelper &
   return true;
 }
 
-unsigned int parserAnnexBHEVC::st_ref_pic_set::NumNegativePics[65];
-unsigned int parserAnnexBHEVC::st_ref_pic_set::NumPositivePics[65];
-int parserAnnexBHEVC::st_ref_pic_set::DeltaPocS0[65][16];
-int parserAnnexBHEVC::st_ref_pic_set::DeltaPocS1[65][16];
-bool parserAnnexBHEVC::st_ref_pic_set::UsedByCurrPicS0[65][16];
-bool parserAnnexBHEVC::st_ref_pic_set::UsedByCurrPicS1[65][16];
-unsigned int parserAnnexBHEVC::st_ref_pic_set::NumDeltaPocs[65];
+thread_local unsigned int parserAnnexBHEVC::st_ref_pic_set::NumNegativePics[65];
+thread_local unsigned int parserAnnexBHEVC::st_ref_pic_set::NumPositivePics[65];
+thread_local int parserAnnexBHEVC::st_ref_pic_set::DeltaPocS0[65][16];
+thread_local int parserAnnexBHEVC::st_ref_pic_set::DeltaPocS1[65][16];
+thread_local bool parserAnnexBHEVC::st_ref_pic_set::UsedByCurrPicS0[65][16];
+thread_local bool parserAnnexBHEVC::st_ref_pic_set::UsedByCurrPicS1[65][16];
+thread_local unsigned int parserAnnexBHEVC::st_ref_pic_set::NumDeltaPocs[65];
 
 bool parserAnnexBHEVC::st_ref_pic_set::parse_st_ref_pic_set(ReaderHelper &reader, unsigned int stRpsIdx, sps *actSPS)
 {
@@ -1645,10 +1676,10 @@ bool parserAnnexBHEVC::ref_pic_lists_modification::parse_ref_pic_lists_modificat
   return true;
 }
 
-// Initialize static member. Only true for the first slice instance
-bool parserAnnexBHEVC::slice::bFirstAUInDecodingOrder = true;
-int parserAnnexBHEVC::slice::prevTid0Pic_slice_pic_order_cnt_lsb = 0;
-int parserAnnexBHEVC::slice::prevTid0Pic_PicOrderCntMsb = 0;
+// Initialize static member. Only true for the first slice instance (in each thread)
+thread_local bool parserAnnexBHEVC::slice::bFirstAUInDecodingOrder = true;
+thread_local int parserAnnexBHEVC::slice::prevTid0Pic_slice_pic_order_cnt_lsb = 0;
+thread_local int parserAnnexBHEVC::slice::prevTid0Pic_PicOrderCntMsb = 0;
 
 parserAnnexBHEVC::slice::slice(const nal_unit_hevc &nal) : nal_unit_hevc(nal)
 {
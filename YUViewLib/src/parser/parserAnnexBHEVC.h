@@ -54,14 +54,20 @@ public:
   QSize getSequenceSizeSamples() const Q_DECL_OVERRIDE;
   yuvPixelFormat getPixelFormat() const Q_DECL_OVERRIDE;
 
-  QList<QByteArray> getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos) Q_DECL_OVERRIDE;
+  QList<QByteArray> getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos) Q_DECL_OVERRIDE;
   QByteArray getExtradata() Q_DECL_OVERRIDE;
   QPair<int,int> getProfileLevel() Q_DECL_OVERRIDE;
   QPair<int,int> getSampleAspectRatio() Q_DECL_OVERRIDE;
 
   ParseResult parseAndAddNALUnit(int nalID, QByteArray data, std::optional<BitratePlotModel::BitrateEntry> bitrateEntry, std::optional<pairUint64> nalStartEndPosFile={}, TreeItem *parent=nullptr) Q_DECL_OVERRIDE;
+  parserAnnexB *createNewParser() const Q_DECL_OVERRIDE { return new parserAnnexBHEVC(); }
 
 protected:
+  // Split the file at IDR pictures. Each IDR picture resets the POC.
+  bool canParseInSegments() const override { return true; }
+  SegmentNALType getSegmentNALType(const QByteArray &nalData) const override;
+  int getPOCOffsetOfNextIDR() const override { return (this->maxPOCCount > 0) ? this->maxPOCCount + 1 : this->pocCounterOffset; }
+
   // ----- Some nested classes that are only used in the scope of this file handler class
 
   // All the different NAL unit types (T-REC-H.265-201504 Page 85)
@@ -262,13 +268,14 @@ protected:
     QList<bool> used_by_curr_pic_s1_flag;
 
     // Calculated values. These are static. They are used for reference picture set prediction.
-    static unsigned int NumNegativePics[65];
-    static unsigned int NumPositivePics[65];
-    static int DeltaPocS0[65][16];
-    static int DeltaPocS1[65][16];
-    static bool UsedByCurrPicS0[65][16];
-    static bool UsedByCurrPicS1[65][16];
-    static unsigned int NumDeltaPocs[65];
+    // There is one set per thread so that the segments of a file can be parsed in parallel.
+    static thread_local unsigned int NumNegativePics[65];
+    static thread_local unsigned int NumPositivePics[65];
+    static thread_local int DeltaPocS0[65][16];
+    static thread_local int DeltaPocS1[65][16];
+    static thread_local bool UsedByCurrPicS0[65][16];
+    static thread_local bool UsedByCurrPicS1[65][16];
+    static thread_local unsigned int NumDeltaPocs[65];
   };
 
   struct vui_parameters
@@ -602,11 +609,12 @@ protected:
     bool NoRaslOutputFlag;
 
     int globalPOC {-1};
+    void addPOCOffset(int offset) override { globalPOC += offset; }
 
-    // Static variables for keeping track of the decoding order
-    static bool bFirstAUInDecodingOrder;
-    static int prevTid0Pic_slice_pic_order_cnt_lsb;
-    static int prevTid0Pic_PicOrderCntMsb;
+    // Static variables for keeping track of the decoding order (per thread like the values of st_ref_pic_set)
+    static thread_local bool bFirstAUInDecodingOrder;
+    static thread_local int prevTid0Pic_slice_pic_order_cnt_lsb;
+    static thread_local int prevTid0Pic_PicOrderCntMsb;
 
   private:
     // We will keep a pointer to the active SPS and PPS
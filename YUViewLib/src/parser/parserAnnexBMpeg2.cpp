@@ -163,11 +163,7 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
   // We don't set data (a name) for this item yet. 
   // We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  TreeItem *nalRoot = this->createNALRootItem(parent);
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -244,7 +240,7 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
       return parseResult;
 
     if (message_tree)
-      message_tree->itemData[0] = new_extension->get_extension_function_name();
+      message_tree->setName(new_extension->get_extension_function_name());
 
     if (new_extension->extension_type == EXT_SEQUENCE)
     {
@@ -318,10 +314,14 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
       currentAUAllSlicesIntra = false;
     this->currentAUSliceTypes[currentSliceType]++;
   }
+  if (nal_mpeg2.nal_unit_type == PICTURE || nal_mpeg2.nal_unit_type == SLICE)
+    parseResult.poc = curFramePOC;
+  // All following pictures can be parsed from a sequence header
+  parseResult.isRandomAccessPoint = (nal_mpeg2.nal_unit_type == SEQUENCE_HEADER && parsingSuccess);
   
-  if (nalRoot)
+  if (auto nalItem = this->getNALNameItem(nalRoot))
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
+    nalItem->setName(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
 
   parseResult.success = true;
   return parseResult;
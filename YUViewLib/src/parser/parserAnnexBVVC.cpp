@@ -61,7 +61,7 @@ yuvPixelFormat parserAnnexBVVC::getPixelFormat() const
   return yuvPixelFormat(Subsampling::YUV_420, 8);
 }
 
-QList<QByteArray> parserAnnexBVVC::getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos)
+QList<QByteArray> parserAnnexBVVC::getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos)
 {
   Q_UNUSED(iFrameNr);
   Q_UNUSED(filePos);
@@ -108,11 +108,7 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
   // Create a new TreeItem root for the NAL unit. We don't set data (a name) for this item
   // yet. We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  TreeItem *nalRoot = this->createNALRootItem(parent);
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -158,15 +154,20 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
     curFrameFileStartEndPos = nalStartEndPosFile;
     sizeCurrentAU = 0;
     counterAU++;
+
+    // Only the NAL headers are parsed so there is no state that parsing depends on. Parsing can start at every AU.
+    parseResult.isRandomAccessPoint = true;
   }
   else if (curFrameFileStartEndPos && nalStartEndPosFile)
     curFrameFileStartEndPos->second = nalStartEndPosFile->second;
 
   sizeCurrentAU += data.size();
+  if (counterAU > 0)
+    parseResult.poc = counterAU;
 
-  if (nalRoot)
+  if (auto nalItem = this->getNALNameItem(nalRoot))
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
+    nalItem->setName(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
 
   parseResult.success = true;
   return parseResult;
@@ -53,12 +53,13 @@ public:
   QSize getSequenceSizeSamples() const override;
   yuvPixelFormat getPixelFormat() const override;
 
-  QList<QByteArray> getSeekFrameParamerSets(int iFrameNr, uint64_t &filePos) override;
+  QList<QByteArray> getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos) override;
   QByteArray getExtradata() override;
   QPair<int,int> getProfileLevel() override;
   QPair<int,int> getSampleAspectRatio() override;
 
   ParseResult parseAndAddNALUnit(int nalID, QByteArray data, std::optional<BitratePlotModel::BitrateEntry> bitrateEntry, std::optional<pairUint64> nalStartEndPosFile={}, TreeItem *parent=nullptr) Q_DECL_OVERRIDE;
+  parserAnnexB *createNewParser() const override { return new parserAnnexBVVC(); }
 
 protected:
   // ----- Some nested classes that are only used in the scope of this file handler class
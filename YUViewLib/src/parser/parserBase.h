@@ -78,7 +78,11 @@ public:
 
   void setStreamColorCoding(bool colorCoding) { packetModel->setUseColorCoding(colorCoding); }
   void setFilterStreamIndex(int streamIndex) { streamIndexFilter->setFilterStreamIndex(streamIndex); }
+  // The item with the given index (of the model returned by getPacketItemModel) was expanded in the view
+  void setPacketItemUsed(const QModelIndex &index) { packetModel->setLazyLoadedItemUsed(streamIndexFilter->mapToSource(index)); }
   void setParsingLimitEnabled(bool limitEnabled) { parsingLimitEnabled = limitEnabled; }
+  // Does the parser stop after PARSER_FILE_FRAME_NR_LIMIT frames if the limit is enabled?
+  virtual bool usesParsingLimit() const { return true; }
   void setBitrateSortingIndex(int sortingIndex) { bitratePlotModel->setBitrateSortingIndex(sortingIndex); }
 
 signals:
@@ -169,6 +169,7 @@ void playlistItem::setStartEndFrame(indexRange range, bool emitSignal)
   indexRange startEndFrameLimit = getStartEndFrameLimits();
   startEndFrame.first = std::max(startEndFrameLimit.first, range.first);
   startEndFrame.second = std::min(startEndFrameLimit.second, range.second);
+  lastStartEndFrameLimits = startEndFrameLimit;
 
   if (!ui.created())
     // spin boxes not created yet
@@ -214,9 +215,21 @@ void playlistItem::slotVideoControlChanged()
 
 void playlistItem::slotUpdateFrameLimits()
 {
-  // update the spin boxes
-  indexRange startEndFrameLimit = getStartEndFrameLimits();
-  setStartEndFrame(startEndFrameLimit, false);
+  const indexRange startEndFrameLimit = getStartEndFrameLimits();
+  const indexRange previousLimit = lastStartEndFrameLimits;
+  if (startEndFrameLimit == previousLimit && previousLimit != indexRange(-1, -1))
+    // Nothing changed (the limits are polled while a file is indexed)
+    return;
+
+  indexRange range = startEndFrame;
+  if (previousLimit == indexRange(-1, -1) || startEndFrame == indexRange(-1, -1))
+    range = startEndFrameLimit;
+  else if (startEndFrameLimit.second > previousLimit.second && startEndFrame.second == previousLimit.second)
+    // The sequence grew. The end frame follows the end of the sequence unless the user set a different end frame.
+    range.second = startEndFrameLimit.second;
+
+  // Update the spin boxes (the range is clipped to the new limits)
+  setStartEndFrame(range, false);
   
   // The current frame in the buffer is not invalid, but emit that something has changed.
   // Also no frame in the cache is invalid.
@@ -235,6 +248,7 @@ QLayout *playlistItem::createPlaylistItemControls()
   {
     startEndFrame = startEndFrameLimit;
   }
+  lastStartEndFrameLimits = startEndFrameLimit;
 
   // Set min/max duration for a playlistItem_Static
   ui.durationSpinBox->setMaximum(100000);
@@ -164,11 +164,20 @@ public:
   virtual bool isLoading() const { return false; }
   virtual bool isLoadingDoubleBuffer() const { return false; }
 
-  // If the needsLoading function returns LoadingNeededDoubleBuffer, this should activate the double buffer so that in the next draw
-  // operation it is drawn. This is done because loading of a new double buffer is triggered right after the call to this function.
-  // If the buffer is not activated first, it could be overwritten by the background loading process if the draw even is scheduled 
-  // too late.
-  virtual void activateDoubleBuffer() {}
+  // If the needsLoading function returns LoadingNeededDoubleBuffer, this should activate the given frame from the double buffer so
+  // that in the next draw operation it is drawn. This is done because loading of the next frames into the double buffer is triggered
+  // right after the call to this function. If the frame is not activated first, it could be removed from the double buffer by the
+  // background loading process if the draw event is scheduled too late.
+  virtual void activateDoubleBuffer(int frameIdx) { Q_UNUSED(frameIdx); }
+
+  // The playback controller tells the item which frame is shown next and in which direction the user is moving
+  // (1: forward, -1: backward). The item can then prepare the following frames (e.g. read them from the file).
+  virtual void setPlaybackPosition(int frameIdx, int direction) { Q_UNUSED(frameIdx); Q_UNUSED(direction); }
+
+  // Stop loading frames ahead of playback into the double buffer after the frame that is currently loaded (e.g. because
+  // playback stopped or another frame was requested). This is called from the main thread while the item is loading
+  // in the loading thread. The video cache clears it when it starts the next loading job of the item.
+  virtual void setDoubleBufferLoadingInterrupted(bool interrupted) { Q_UNUSED(interrupted); }
 
   // ----- Caching -----
 
@@ -180,11 +189,17 @@ public:
   virtual bool taggedForDeletion() const { return itemTaggedForDeletion; }
   // Is there a limit on the number of threads that can cache from this item at the same time? (-1 = no limit)
   virtual int cachingThreadLimit() { return -1; }
+  // Get the last frame of a caching job that starts at the given frame. By default, every frame is cached in a separate job.
+  // An item can return a later frame if consecutive frames are cached more efficiently by the same thread (e.g. up to the next
+  // random access point of a compressed stream). The caching job may still end earlier.
+  virtual int getCachingJobEnd(int frameIdx) { return frameIdx; }
   // Tag the item as "to be deleted"
   void tagItemForDeletion() { itemTaggedForDeletion = true; }
   // Cache the given frame. This function is thread save. So multiple instances of this function can run at the same time.
   // In test mode, we don't check if the frame is already cached and don't cache it. We just convert it and return.
-  virtual void cacheFrame(int idx, bool testMode) { Q_UNUSED(idx); Q_UNUSED(testMode); }
+  // The frame is cached by a caching job for the frames in jobRange. The video cache reserved space for all frames of the
+  // job, so other frames of the job that the item gets on the way to the given frame may be cached as well.
+  virtual void cacheFrame(int idx, bool testMode, indexRange jobRange) { Q_UNUSED(idx); Q_UNUSED(testMode); Q_UNUSED(jobRange); }
   // Get a list of all cached frames (just the frame indices)
   virtual QList<int> getCachedFrames() const { return QList<int>(); }
   virtual int getNumberCachedFrames() const { return 0; }
@@ -193,6 +208,9 @@ public:
   // Remove the frame with the given index from the cache.
   virtual void removeFrameFromCache(int idx) { Q_UNUSED(idx); }
   virtual void removeAllFramesFromCache() {};
+  // How many bytes does the item currently use for frames that are kept outside of the cache (e.g. buffers of the
+  // interactive loading)? The video cache counts them against the cache size.
+  virtual int64_t getBufferedFramesSize() const { return 0; }
 
   // ----- Detection of source/file change events -----
 
@@ -271,6 +289,8 @@ protected:
   double      frameRate {DEFAULT_FRAMERATE};
   int         sampling  {1};
   indexRange  startEndFrame;
+  // The frame limits when the range was last set. Used to tell a grown sequence from an end frame set by the user.
+  indexRange  lastStartEndFrameLimits {-1, -1};
 
   // ------ playlistItem_Static
   double duration {PLAYLISTITEMTEXT_DEFAULT_DURATION};    // The duration that this item is shown for
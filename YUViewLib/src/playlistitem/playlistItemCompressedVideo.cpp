@@ -33,10 +33,16 @@
 #include "playlistItemCompressedVideo.h"
 
 #include <QThread>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFutureWatcher>
 #include <QInputDialog>
+#include <QMessageBox>
 #include <QPlainTextEdit>
+#include <QtConcurrent>
 
 #include <inttypes.h>
+#include <limits>
 
 #include "common/functions.h"
 #include "common/YUViewDomElement.h"
@@ -48,6 +54,7 @@
 #include "parser/parserAnnexBAVC.h"
 #include "parser/parserAnnexBHEVC.h"
 #include "parser/parserAnnexBVVC.h"
+#include "statistics/statisticsBinaryFormat.h"
 #include "video/videoHandlerYUV.h"
 #include "video/videoHandlerRGB.h"
 #include "ui/mainwindow.h"
@@ -64,12 +71,14 @@ using namespace functions;
 #define DEBUG_COMPRESSED(fmt,...) ((void)0)
 #endif
 
-// When decoding, it can make sense to seek forward to another random access point.
-// However, for this we have to clear the decoder, seek the file and restart decoding. Internally,
-// the decoder might already have decoded the frame anyways so it makes no sense to seek but to just
-// keep on decoding normally (linearly). If the requested fram number is only is in the future
-// by lower than this threshold, we will not seek.
-#define FORWARD_SEEK_THRESHOLD 5
+// Caching threads decode different parts of the sequence with their own decoders. Every decoder can use
+// a lot of memory (especially for high resolutions) so the number of caching decoders is limited.
+#define MAX_NR_CACHING_DECODERS 8
+
+// The interactive decoder keeps the pictures that it decoded last so that stepping backwards within the current GOP
+// does not require decoding from the last random access point again. The buffer may use this fraction of the cache size.
+// The video cache counts the buffered pictures against the cache size (see getBufferedFramesSize()).
+#define DECODED_PICTURE_BUFFER_CACHE_FRACTION 8
 
 playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compressedFilePath, int displayComponent, inputFormat input, decoderEngine decoder)
   : playlistItemWithVideo(compressedFilePath, playlistItem_Indexed)
@@ -107,9 +116,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   {
     // Open file
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Open annexB file");
-    inputFileAnnexBLoading.reset(new FileSourceAnnexBFile(compressedFilePath));
-    if (cachingEnabled)
-      inputFileAnnexBCaching.reset(new FileSourceAnnexBFile(compressedFilePath));
+    loading.inputFileAnnexB.reset(new FileSourceAnnexBFile(compressedFilePath));
     // inputFormatType a parser
     if (inputFormatType == inputAnnexBHEVC)
     {
@@ -135,7 +142,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     }
 
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Start parsing of file");
-    inputFileAnnexBParser->parseAnnexBFile(inputFileAnnexBLoading, mainWindow);
+    inputFileAnnexBParser->parseAnnexBFile(loading.inputFileAnnexB, mainWindow);
     
     // Get the frame size and the pixel format
     frameSize = inputFileAnnexBParser->getSequenceSizeSamples();
@@ -148,31 +155,34 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   }
   else
   {
-    // Try ffmpeg to open the file
+    // Try ffmpeg to open the file. The file is indexed in the background. Decoding can start once the
+    // first key frame is known and the frame limits are updated while indexing is running.
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Open file using ffmpeg");
-    inputFileFFmpegLoading.reset(new FileSourceFFmpegFile());
-    if (!inputFileFFmpegLoading->openFile(compressedFilePath, mainWindow))
+    loading.inputFileFFmpeg.reset(new FileSourceFFmpegFile());
+    if (!loading.inputFileFFmpeg->openFile(compressedFilePath, mainWindow, nullptr, false))
     {
       setError("Error opening file using libavcodec.");
       return;
     }
+    loading.inputFileFFmpeg->startBackgroundIndexing();
+    loading.inputFileFFmpeg->waitForFirstKeyFrame();
     // Is this file RGB or YUV?
-    rawFormat = inputFileFFmpegLoading->getRawFormat();
+    rawFormat = loading.inputFileFFmpeg->getRawFormat();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Raw format %s", rawFormat == raw_YUV ? "YUV" : rawFormat == raw_RGB ? "RGB" : "Unknown");
     if (rawFormat == raw_YUV)
-      format_yuv = inputFileFFmpegLoading->getPixelFormatYUV();
+      format_yuv = loading.inputFileFFmpeg->getPixelFormatYUV();
     else if (rawFormat == raw_RGB)
-      format_rgb = inputFileFFmpegLoading->getPixelFormatRGB();
+      format_rgb = loading.inputFileFFmpeg->getPixelFormatRGB();
     else
     {
       setError("Unknown raw format.");
       return;
     }
-    frameSize = inputFileFFmpegLoading->getSequenceSizeSamples();
+    frameSize = loading.inputFileFFmpeg->getSequenceSizeSamples();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Frame size %dx%d", frameSize.width(), frameSize.height());
-    frameRate = inputFileFFmpegLoading->getFramerate();
+    frameRate = loading.inputFileFFmpeg->getFramerate();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo framerate %f", frameRate);
-    ffmpegCodec = inputFileFFmpegLoading->getVideoStreamCodecID();
+    ffmpegCodec = loading.inputFileFFmpeg->getVideoStreamCodecID();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo ffmpeg codec %s", ffmpegCodec.getCodecName().toStdString().c_str());
     if (!ffmpegCodec.isNone())
       possibleDecoders.append(decoderEngineFFMpeg);
@@ -183,19 +193,17 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     }
     if (ffmpegCodec.isAV1())
       possibleDecoders.append(decoderEngineDav1d);
-
-    if (cachingEnabled)
-    {
-      // Open the file again for caching
-      inputFileFFmpegCaching.reset(new FileSourceFFmpegFile());
-      if (!inputFileFFmpegCaching->openFile(compressedFilePath, mainWindow, inputFileFFmpegLoading.data()))
-      {
-        setError("Error opening file a second time using libavcodec for caching.");
-        return;
-      }
-    }
   }
 
+  // The file is opened again for every caching decoder. Use as many decoders as there are caching threads.
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  maxNrCachingDecoders = functions::getOptimalThreadCount();
+  if (settings.value("SetNrThreads", false).toBool())
+    maxNrCachingDecoders = settings.value("NrThreads", maxNrCachingDecoders).toInt();
+  maxNrCachingDecoders = clip(maxNrCachingDecoders, 1, MAX_NR_CACHING_DECODERS);
+  settings.endGroup();
+
   // Check/set properties
   if (!frameSize.isValid())
   {
@@ -227,6 +235,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   // Connect the basic signals from the video
   playlistItemWithVideo::connectVideo();
   statSource.setFrameSize(frameSize);
+  this->updateSettings();
 
   decoderEngineType = decoderEngineInvalid;
   if (decoder != decoderEngineInvalid)
@@ -241,7 +250,6 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     else if (possibleDecoders.length() > 1)
     {
       // Is a default decoder set in the settings?
-      QSettings settings;
       settings.beginGroup("Decoders");
       decoderEngine defaultDecoder = (decoderEngine)settings.value("DefaultDecoder", -1).toInt();
       if (possibleDecoders.contains(defaultDecoder))
@@ -267,7 +275,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   if (rawFormat == raw_YUV)
   {
     videoHandlerYUV *yuvVideo = getYUVVideo();
-    yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(loadingDecoder->getDecodeSignal());
+    yuvVideo->showPixelValuesAsDiff = loading.decoder->isSignalDifference(loading.decoder->getDecodeSignal());
   }
 
   // Fill the list of statistics that we can provide
@@ -275,23 +283,43 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   fillStatisticList();
 
   // Set the frame number limits
-  startEndFrame = getStartEndFrameLimits();
+  setStartEndFrame(getStartEndFrameLimits(), false);
   DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Start end frame limits %d,%d", startEndFrame.first, startEndFrame.second);
   if (startEndFrame.second == -1)
     // No frames to decode
     return;
 
-  // Seek both decoders to the start of the bitstream (this will also push the parameter sets / extradata to the decoder)
-  DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Seek decoders to 0");
-  seekToPosition(0, 0, false);
-  if (cachingEnabled)
-    seekToPosition(0, 0, true);
+  // Seek the loading decoder to the start of the bitstream (this will also push the parameter sets / extradata to the decoder).
+  // The caching decoders seek when they are first used.
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Seek decoder to 0");
+  seekToPosition(loading, 0, 0);
 
   // Connect signals for requesting data and statistics
   connect(video.data(), &videoHandler::signalRequestRawData, this, &playlistItemCompressedVideo::loadRawData, Qt::DirectConnection);
   connect(video.data(), &videoHandler::signalUpdateFrameLimits, this, &playlistItemCompressedVideo::slotUpdateFrameLimits);
   connect(&statSource, &statisticHandler::updateItem, this, &playlistItemCompressedVideo::updateStatSource);
   connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemCompressedVideo::loadStatisticToCache, Qt::DirectConnection);
+
+  if (loading.inputFileFFmpeg && loading.inputFileFFmpeg->isIndexing())
+    indexingTimer.start(500, this);
+}
+
+playlistItemCompressedVideo::~playlistItemCompressedVideo()
+{
+  // The decoding speed test uses the decoders and the file of the item
+  stopDecodingSpeedTest();
+}
+
+// This timer event is called regularly while the file is indexed in the background.
+void playlistItemCompressedVideo::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != indexingTimer.timerId())
+    return playlistItem::timerEvent(event);
+
+  // Update the frame limits one last time after indexing finished
+  if (!loading.inputFileFFmpeg->isIndexing())
+    indexingTimer.stop();
+  slotUpdateFrameLimits();
 }
 
 void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &playlistDir) const
@@ -309,7 +337,7 @@ void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &pl
   // Append all the properties of the HEVC file (the path to the file. Relative and absolute)
   d.appendProperiteChild("absolutePath", fileURL.toString());
   d.appendProperiteChild("relativePath", relativePath);
-  d.appendProperiteChild("displayComponent", QString::number(loadingDecoder ? loadingDecoder->getDecodeSignal() : -1));
+  d.appendProperiteChild("displayComponent", QString::number(loading.decoder ? loading.decoder->getDecodeSignal() : -1));
 
   d.appendProperiteChild("inputFormat", functions::getInputFormatName(inputFormatType));
   d.appendProperiteChild("decoder", functions::getDecoderEngineName(decoderEngineType));
@@ -351,12 +379,12 @@ infoData playlistItemCompressedVideo::getInfo() const
   infoData info("HEVC File Info");
 
   // At first append the file information part (path, date created, file size...)
-  // info.items.append(loadingDecoder->getFileInfoList());
+  // info.items.append(loading.decoder->getFileInfoList());
 
   info.items.append(infoItem("Reader", functions::getInputFormatName(inputFormatType)));
-  if (inputFileFFmpegLoading)
+  if (loading.inputFileFFmpeg)
   {
-    QStringList l = inputFileFFmpegLoading->getLibraryPaths();
+    QStringList l = loading.inputFileFFmpeg->getLibraryPaths();
     if (l.length() % 3 == 0)
     {
       for (int i=0; i<l.length()/3; i++)
@@ -368,18 +396,24 @@ infoData playlistItemCompressedVideo::getInfo() const
     QSize videoSize = video->getFrameSize();
     info.items.append(infoItem("Resolution", QString("%1x%2").arg(videoSize.width()).arg(videoSize.height()), "The video resolution in pixel (width x height)"));
     info.items.append(infoItem("Num POCs", QString::number(startEndFrame.second - startEndFrame.first + 1), "The number of pictures in the stream."));
+    if (loading.inputFileFFmpeg && loading.inputFileFFmpeg->isIndexing())
+      info.items.append(infoItem("Indexing", "Running...", "The file is indexed in the background. The number of pictures grows until indexing is done."));
     if (decodingEnabled)
     {
-      QStringList l = loadingDecoder->getLibraryPaths();
+      QStringList l = loading.decoder->getLibraryPaths();
       if (l.length() % 3 == 0)
       {
         for (int i=0; i<l.length()/3; i++)
           info.items.append(infoItem(l[i*3], l[i*3+1], l[i*3+2]));
       }
-      info.items.append(infoItem("Decoder", loadingDecoder->getDecoderName()));
-      info.items.append(infoItem("Decoder", loadingDecoder->getCodecName()));
-      info.items.append(infoItem("Statistics", loadingDecoder->statisticsSupported() ? "Yes" : "No", "Is the decoder able to provide internals (statistics)?"));
-      info.items.append(infoItem("Stat Parsing", loadingDecoder->statisticsEnabled() ? "Yes" : "No", "Are the statistics of the sequence currently extracted from the stream?"));
+      info.items.append(infoItem("Decoder", loading.decoder->getDecoderName()));
+      info.items.append(infoItem("Decoder", loading.decoder->getCodecName()));
+      info.items.append(infoItem("Statistics", loading.decoder->statisticsSupported() ? "Yes" : "No", "Is the decoder able to provide internals (statistics)?"));
+      info.items.append(infoItem("Stat Parsing", loading.decoder->statisticsEnabled() ? "Yes" : "No", "Are the statistics of the sequence currently extracted from the stream?"));
+      info.items.append(infoItem("Threads", QString::number(loading.decoder->getThreading().nrThreads), "The number of threads of the interactive decoder (see the decoder settings)."));
+      info.items.append(infoItem("Decoding Speed", "Test", "Decode the first frames of the sequence with different threading configurations and report the decoding speed.", true, 2));
+      if (loading.decoder->statisticsSupported() && cachingEnabled)
+        info.items.append(infoItem("Statistics", "Export", "Decode the sequence and save all statistics in the binary statistics format (*.yuvstats).", true, 1));
     }
   }
   if (decoderEngineType == decoderEngineFFMpeg)
@@ -406,9 +440,9 @@ void playlistItemCompressedVideo::infoListButtonPressed(int buttonID)
     uiDialog.ffmpegLogEdit->setPlainText(logFFmpegString);
 
     // Get the loading log
-    if (inputFileFFmpegLoading)
+    if (loading.inputFileFFmpeg)
     {
-      QStringList logLoading = inputFileFFmpegLoading->getFFmpegLoadingLog();
+      QStringList logLoading = loading.inputFileFFmpeg->getFFmpegLoadingLog();
       QString logLoadingString;
       for (QString l : logLoading)
         logLoadingString.append(l + "\n");
@@ -417,6 +451,238 @@ void playlistItemCompressedVideo::infoListButtonPressed(int buttonID)
         
     newDialog.exec();
   }
+  else if (buttonID == 1)
+  {
+    // The button "Export statistics" was pressed
+    QFileInfo srcFileInfo(plItemNameOrFileName);
+    QString defaultFileName = srcFileInfo.absoluteDir().filePath(srcFileInfo.completeBaseName() + ".yuvstats");
+    QString fileName = QFileDialog::getSaveFileName(mainWindow, "Export statistics", defaultFileName, "Binary Statistics File (*.yuvstats)");
+    if (fileName.isEmpty())
+      return;
+
+    QProgressDialog progressDialog("Decoding and exporting statistics...", "Cancel", startEndFrame.first, startEndFrame.second + 1, mainWindow);
+    progressDialog.setMinimumDuration(1000);  // Show after 1s
+    progressDialog.setWindowModality(Qt::WindowModal);
+
+    QString errorMessage;
+    if (!exportStatisticsToBinaryFile(fileName, &progressDialog, errorMessage) && !errorMessage.isEmpty())
+      QMessageBox::critical(mainWindow, "Error exporting statistics", errorMessage);
+  }
+  else if (buttonID == 2)
+  {
+    // The button "Test decoding speed" was pressed
+    startDecodingSpeedTest();
+  }
+}
+
+void playlistItemCompressedVideo::startDecodingSpeedTest()
+{
+  if (decodingSpeedTestFuture.isRunning())
+    return;
+
+  // Decoding the sequence several times takes a while. The test runs in a separate thread so that the GUI keeps
+  // responding. The dialog shows the progress and the results are shown when the test is done.
+  QWidget *mainWindow = MainWindow::getMainWindow();
+  auto progressDialog = new QProgressDialog("Testing the decoding speed...", "Cancel", 0, 1, mainWindow);
+  progressDialog->setMinimumDuration(0);
+  progressDialog->setWindowModality(Qt::WindowModal);
+  decodingSpeedTestCanceled = false;
+  connect(this, &QObject::destroyed, progressDialog, &QObject::deleteLater);
+  connect(progressDialog, &QProgressDialog::canceled, this, [this]() { decodingSpeedTestCanceled = true; });
+  connect(this, &playlistItemCompressedVideo::signalDecodingSpeedTestProgress, progressDialog, [progressDialog](int testIdx, int nrTests) {
+    progressDialog->setMaximum(nrTests);
+    progressDialog->setValue(testIdx);
+  });
+
+  auto watcher = new QFutureWatcher<QStringList>(this);
+  connect(watcher, &QFutureWatcher<QStringList>::finished, this, [this, watcher, progressDialog, mainWindow]() {
+    const QStringList results = watcher->result();
+    watcher->deleteLater();
+    progressDialog->deleteLater();
+    if (!decodingSpeedTestCanceled)
+      QMessageBox::information(mainWindow, "Decoding speed", results.join("\n"));
+  });
+
+  decodingSpeedTestFuture = QtConcurrent::run([this]() {
+    return testDecodingSpeed(200, [this](int testIdx, int nrTests) {
+      emit signalDecodingSpeedTestProgress(testIdx, nrTests);
+      return !decodingSpeedTestCanceled;
+    });
+  });
+  watcher->setFuture(decodingSpeedTestFuture);
+}
+
+void playlistItemCompressedVideo::stopDecodingSpeedTest()
+{
+  decodingSpeedTestCanceled = true;
+  decodingSpeedTestFuture.waitForFinished();
+}
+
+QStringList playlistItemCompressedVideo::testDecodingSpeed(int nrFrames, const std::function<bool(int testIdx, int nrTests)> &progress)
+{
+  QStringList results;
+  if (unresolvableError || !decodingEnabled)
+    return results;
+
+  // HM and VTM do not support threading. Only dav1d and FFmpeg can choose between frame and slice (tile) threading.
+  QList<decoderBase::ThreadingType> threadingTypes;
+  threadingTypes << decoderBase::ThreadingType::FrameAndSlice;
+  if (decoderEngineType == decoderEngineDav1d || decoderEngineType == decoderEngineFFMpeg)
+    threadingTypes << decoderBase::ThreadingType::Frame << decoderBase::ThreadingType::Slice;
+  QList<int> nrThreadsList;
+  if (decoderEngineType == decoderEngineHM || decoderEngineType == decoderEngineVTM)
+    nrThreadsList.append(1);
+  else
+  {
+    const int nrCores = int(functions::getOptimalThreadCount());
+    for (int nrThreads = 1; nrThreads < nrCores; nrThreads *= 2)
+      nrThreadsList.append(nrThreads);
+    nrThreadsList.append(nrCores);
+  }
+
+  const QStringList threadingTypeNames = QStringList() << "frames and slices" << "frames" << "slices";
+  const indexRange range = getStartEndFrameLimits();
+  const int lastFrame = std::min(range.first + nrFrames - 1, range.second);
+  const int nrTests = threadingTypes.size() * nrThreadsList.size();
+
+  int testIdx = 0;
+  for (auto type : threadingTypes)
+  {
+    for (int nrThreads : nrThreadsList)
+    {
+      if (progress && !progress(testIdx++, nrTests))
+        return results;
+
+      // Every configuration uses a new decoder. Opening the decoder is not measured.
+      decoderBase::Threading threading;
+      threading.nrThreads = nrThreads;
+      threading.type = type;
+      DecodingContext context;
+      if (!openCachingContext(context, threading))
+      {
+        results.append("Error opening the decoder.");
+        return results;
+      }
+
+      QElapsedTimer timer;
+      timer.start();
+      int frameIdx = range.first;
+      QByteArray frameData;
+      while (frameIdx <= lastFrame && decodeFrame(context, frameIdx, frameData))
+        frameIdx++;
+      const auto msec = std::max(timer.elapsed(), qint64(1));
+
+      QString configuration = QString("%1 threads").arg(nrThreads);
+      if (threadingTypes.size() > 1)
+        configuration += QString(" (%1)").arg(threadingTypeNames[int(type)]);
+      results.append(QString("%1: %2 frames in %3 msec (%4 fps)").arg(configuration).arg(frameIdx - range.first).arg(msec).arg((frameIdx - range.first) * 1000.0 / msec, 0, 'f', 1));
+    }
+  }
+  if (progress)
+    progress(testIdx, nrTests);
+  return results;
+}
+
+bool playlistItemCompressedVideo::exportStatisticsToBinaryFile(const QString &fileName, QProgressDialog *progressDialog, QString &errorMessage)
+{
+  if (unresolvableError || !decodingEnabled || !cachingEnabled || !loading.decoder->statisticsSupported())
+  {
+    errorMessage = "The decoder can not provide statistics for this sequence.";
+    return false;
+  }
+
+  // All frames must be known to export the statistics of the whole sequence
+  if (loading.inputFileFFmpeg)
+    loading.inputFileFFmpeg->waitForIndexingFinished();
+
+  const StatisticsTypeList types = statSource.getStatisticsTypeList();
+  StatisticsBinaryFormat::Writer writer;
+  if (!writer.open(fileName, video->getFrameSize(), frameRate, types))
+  {
+    errorMessage = writer.getErrorMessage();
+    return false;
+  }
+
+  // The sequence is decoded using a caching decoder. Statistics retrieval must be enabled before
+  // decoding, so the decoder has to seek to the beginning.
+  const indexRange range = getStartEndFrameLimits();
+  auto context = getCachingContext(range.first);
+  if (!context)
+  {
+    errorMessage = "Error opening a decoder for the sequence.";
+    return false;
+  }
+  QList<int> typeIDs;
+  for (const StatisticsType &type : types)
+    typeIDs.append(type.typeID);
+  context->decoder->enableStatisticsRetrieval();
+  context->decoder->setStatisticsTypesToRetrieve(typeIDs);
+  context->currentFrameIdx = -1;
+  context->cachingJobRange = indexRange(-1, -1);
+
+  bool success = true;
+  for (int frameIdx = range.first; frameIdx <= range.second && success; frameIdx++)
+  {
+    if (progressDialog)
+    {
+      progressDialog->setValue(frameIdx);
+      if (progressDialog->wasCanceled())
+        break;
+    }
+
+    // Getting the frame data also extracts the statistics of the frame
+    QByteArray frameData;
+    if (!decodeFrame(*context, frameIdx, frameData) || context->decoder->errorInDecoder())
+    {
+      errorMessage = QString("Decoding of frame %1 failed.").arg(frameIdx);
+      success = false;
+      break;
+    }
+
+    for (const StatisticsType &type : types)
+    {
+      const statisticsData data = context->decoder->getStatisticsData(type.typeID);
+      if (!data.isEmpty() && !writer.addStatisticsData(frameIdx, type.typeID, data))
+      {
+        errorMessage = writer.getErrorMessage();
+        success = false;
+        break;
+      }
+    }
+  }
+  const bool canceled = progressDialog && progressDialog->wasCanceled();
+
+  // Statistics are not needed for caching. Seek again when the next frame is cached.
+  context->decoder->disableStatisticsRetrieval();
+  context->currentFrameIdx = -1;
+  context->mutex.unlock();
+
+  if (!writer.finish() && success)
+  {
+    errorMessage = writer.getErrorMessage();
+    success = false;
+  }
+  if (!success || canceled)
+  {
+    // Remove the incomplete file
+    QFile::remove(fileName);
+    return false;
+  }
+  if (progressDialog)
+    progressDialog->setValue(range.second + 1);
+  return true;
+}
+
+void playlistItemCompressedVideo::updateSettings()
+{
+  playlistItemWithVideo::updateSettings();
+  // TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings();
+
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  const int64_t cacheSize = int64_t(settings.value("ThresholdValueMB", 49).toUInt()) * 1000 * 1000;
+  settings.endGroup();
+  loadingPictureBuffer.setMaxSize(cacheSize / DECODED_PICTURE_BUFFER_CACHE_FRACTION);
 }
 
 itemLoadingState playlistItemCompressedVideo::needsLoading(int frameIdx, bool loadRawData)
@@ -426,7 +692,7 @@ itemLoadingState playlistItemCompressedVideo::needsLoading(int frameIdx, bool lo
 
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
   auto videoState = video->needsLoading(frameIdxInternal, loadRawData);
-  if (videoState == LoadingNeeded && decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter && frameIdxInternal >= currentFrameIdx[0])
+  if (videoState == LoadingNeeded && loading.isDecodingNotPossible(frameIdxInternal) && frameIdxInternal >= loading.currentFrameIdx)
     // The decoder can not decode this frame. 
     return LoadingNotNeeded;
   if (videoState == LoadingNeeded || statSource.needsLoading(frameIdxInternal) == LoadingNeeded)
@@ -438,7 +704,7 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
 {
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
-  if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
+  if (loading.isDecodingNotPossible(frameIdxInternal))
   {
     infoText = "Decoding of the frame not possible:\n";
     infoText += "The frame could not be decoded. Possibly, the bitstream is corrupt or was cut at an invalid position.";
@@ -448,7 +714,7 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
   {
     playlistItem::drawItem(painter, -1, zoomFactor, drawRawData);
   }
-  else if (loadingDecoder.isNull())
+  else if (loading.decoder.isNull())
   {
     infoText = "No decoder allocated.\n";
     playlistItem::drawItem(painter, -1, zoomFactor, drawRawData);
@@ -460,139 +726,192 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
   }
 }
 
-void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching)
+void playlistItemCompressedVideo::loadRawData(int frameIdxInternal)
 {
-  if (caching && !cachingEnabled)
-    return;
-  if (!caching && loadingDecoder->errorInDecoder())
+  // Frames for caching are not requested here. cacheFrame decodes them with the caching decoders.
+  if (loading.decoder->errorInDecoder())
   {
-    if (frameIdxInternal < currentFrameIdx[0])
+    if (frameIdxInternal < loading.currentFrameIdx)
     {
       // There was an error in the loading decoder but we will seek backwards so maybe this will work again
     }
     else
       return;
   }
-  if (caching && cachingDecoder->errorInDecoder())
-    return;
-  
-  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData %d %s", frameIdxInternal, caching ? "caching" : "");
 
-  if (frameIdxInternal > startEndFrame.second || frameIdxInternal < 0)
+  // Keep all pictures that the loading decoder decodes. Getting the data of every picture also extracts its
+  // statistics, so this is only done if no statistics are retrieved.
+  const bool useLoadingPictureBuffer = !loading.decoder->statisticsEnabled() && loadingPictureBuffer.getMaxSize() > 0;
+  if (useLoadingPictureBuffer)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData Invalid frame index");
-    return;
+    const auto bufferedFrameData = loadingPictureBuffer.getPicture(frameIdxInternal);
+    if (!bufferedFrameData.isEmpty())
+    {
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData frame %d from the decoded picture buffer", frameIdxInternal);
+      video->rawData = bufferedFrameData;
+      video->rawData_frameIdx = frameIdxInternal;
+      return;
+    }
   }
 
-  // Get the right decoder
-  decoderBase *dec = caching ? cachingDecoder.data() : loadingDecoder.data();
-  int curFrameIdx = caching ? currentFrameIdx[1] : currentFrameIdx[0];
-
-  // Should we seek?
-  if (curFrameIdx == -1 || frameIdxInternal < curFrameIdx || frameIdxInternal > curFrameIdx + FORWARD_SEEK_THRESHOLD)
+  if (cachingEnabled && !loading.decoder->statisticsEnabled())
   {
-    // Definitely seek when we have to go backwards
-    bool seek = (frameIdxInternal < curFrameIdx);
-
-    // Get the closest possible seek position
-    int seekToFrame = -1;
+    // If a caching decoder is cheaper to get to the frame than the loading decoder (e.g. because it is positioned
+    // closer to the frame), the frame is decoded by the caching decoder. Statistics are only retrieved by the loading decoder.
     int seekToAnnexBFrameCount = -1;
     int seekToDTS = -1;
-    if (isInputFormatTypeAnnexB(inputFormatType))
-      seekToFrame = inputFileAnnexBParser->getClosestSeekableFrameNumberBefore(frameIdxInternal, seekToAnnexBFrameCount);
-    else
+    const int seekToFrame = getClosestSeekableFrame(frameIdxInternal, seekToAnnexBFrameCount, seekToDTS);
+    auto context = getCheaperCachingContext(frameIdxInternal, seekToFrame, getDecodingCost(loading, frameIdxInternal, seekToFrame));
+    if (context)
     {
-      if (caching)
-        seekToDTS = inputFileFFmpegCaching->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
-      else
-        seekToDTS = inputFileFFmpegLoading->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoding frame %d with a caching decoder at frame %d", frameIdxInternal, context->currentFrameIdx);
+      // Interactive loading is not a caching job. Only the requested frame is decoded.
+      context->cachingJobRange = indexRange(-1, -1);
+      QByteArray frameData;
+      const bool frameDecoded = decodeFrame(*context, frameIdxInternal, frameData);
+      context->mutex.unlock();
+      if (frameDecoded && !frameData.isNull())
+      {
+        video->rawData = frameData;
+        video->rawData_frameIdx = frameIdxInternal;
+        return;
+      }
     }
+  }
 
-    if (curFrameIdx == -1 || seekToFrame > curFrameIdx + FORWARD_SEEK_THRESHOLD)
-    {
-      // A seek forward makes sense
-      seek = true;
-    }
+  loading.pictureBuffer = useLoadingPictureBuffer ? &loadingPictureBuffer : nullptr;
+
+  QByteArray frameData;
+  if (decodeFrame(loading, frameIdxInternal, frameData) && !frameData.isNull())
+  {
+    video->rawData = frameData;
+    video->rawData_frameIdx = frameIdxInternal;
+  }
+  else if (loading.isDecodingNotPossible(frameIdxInternal))
+    // Just set the frame number of the buffer to the current frame so that it will trigger a
+    // reload when the frame number changes.
+    video->rawData_frameIdx = frameIdxInternal;
 
-    if (seek)
+  if (loading.decoder->errorInDecoder())
+  {
+    // There was an error in the deocder. 
+    infoText = "There was an error in the decoder: \n";
+    infoText += loading.decoder->decoderErrorString();
+    infoText += "\n";
+    
+    decodingEnabled = false;
+  }
+}
+
+bool playlistItemCompressedVideo::decodeFrame(DecodingContext &context, int frameIdxInternal, QByteArray &frameData)
+{
+  decoderBase *dec = context.decoder.data();
+  if (dec == nullptr || (dec->errorInDecoder() && frameIdxInternal >= context.currentFrameIdx))
+    return false;
+  
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame %d %s", frameIdxInternal, (&context == &loading) ? "" : "caching");
+
+  if (frameIdxInternal > startEndFrame.second || frameIdxInternal < 0)
+  {
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame Invalid frame index");
+    return false;
+  }
+
+  // The time from the start of a seek until the first frame is output is measured as seek time. All other
+  // frames are measured as decoding time.
+  QElapsedTimer decodeTimer;
+  decodeTimer.start();
+  bool seekPending = false;
+
+  // Should we seek? Seeking to the next frame never makes sense. Otherwise, the cost model of the decoder decides
+  // if seeking to the closest random access point is cheaper than decoding forward.
+  const int curFrameIdx = context.currentFrameIdx;
+  if (curFrameIdx == -1 || frameIdxInternal < curFrameIdx || frameIdxInternal > curFrameIdx + 1)
+  {
+    int seekToAnnexBFrameCount = -1;
+    int seekToDTS = -1;
+    const int seekToFrame = getClosestSeekableFrame(frameIdxInternal, seekToAnnexBFrameCount, seekToDTS);
+    if (context.costModel.shouldSeek(curFrameIdx, frameIdxInternal, seekToFrame))
     {
-      // Seek and update the frame counters. The seekToPosition function will update the currentFrameIdx[] indices
-      readAnnexBFrameCounterCodingOrder = seekToAnnexBFrameCount;
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData seeking to frame %d PTS %d AnnexBCnt %d", seekToFrame, seekToDTS, readAnnexBFrameCounterCodingOrder);
-      seekToPosition(seekToFrame, seekToDTS, caching);
+      // Seek and update the frame counters. The seekToPosition function will update the currentFrameIdx of the context.
+      context.readAnnexBFrameCounterCodingOrder = seekToAnnexBFrameCount;
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame seeking to frame %d PTS %d AnnexBCnt %d", seekToFrame, seekToDTS, context.readAnnexBFrameCounterCodingOrder);
+      seekToPosition(context, seekToFrame, seekToDTS);
+      seekPending = true;
     }
   }
   
   // Decode until we get the right frame from the deocder
-  bool rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
+  int decodeStartFrameIdx = context.currentFrameIdx;
+  bool rightFrame = context.currentFrameIdx == frameIdxInternal;
   while (!rightFrame)
   {
     while (dec->needsMoreData())
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder needs more data");
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder needs more data");
       if (isInputFormatTypeFFmpeg(inputFormatType) && decoderEngineType == decoderEngineFFMpeg)
       {
         // In this scenario, we can read and push AVPackets
         // from the FFmpeg file and pass them to the FFmpeg decoder directly.
-        AVPacketWrapper pkt = caching ? inputFileFFmpegCaching->getNextPacket(repushData) : inputFileFFmpegLoading->getNextPacket(repushData);
-        repushData = false;
+        AVPacketWrapper pkt = context.inputFileFFmpeg->getNextPacket(context.repushData);
+        context.repushData = false;
         if (pkt)
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived packet PTS %" PRId64 "", pkt.get_pts());
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived packet PTS %" PRId64 "", pkt.get_pts());
         else
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived empty packet");
-        decoderFFmpeg *ffmpegDec = (caching ? dynamic_cast<decoderFFmpeg*>(cachingDecoder.data()) : dynamic_cast<decoderFFmpeg*>(loadingDecoder.data()));
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived empty packet");
+        decoderFFmpeg *ffmpegDec = dynamic_cast<decoderFFmpeg*>(dec);
         if (!ffmpegDec->pushAVPacket(pkt))
         {
           if (!ffmpegDec->decodeFrames())
             // The decoder did not switch to decoding frame mode. Error.
-            return;
-          repushData = true;
+            return false;
+          context.repushData = true;
         }
       }
       else if (isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType == decoderEngineFFMpeg)
       {
         // We are reading from a raw annexB file and use ffmpeg for decoding
         QByteArray data;
-        if (readAnnexBFrameCounterCodingOrder >= inputFileAnnexBParser->getNumberPOCs())
+        if (context.readAnnexBFrameCounterCodingOrder >= inputFileAnnexBParser->getNumberPOCs())
         {
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData EOF");
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame EOF");
         }
         else
         {
           // Get the data of the next frame (which might be multiple NAL units)
-          auto frameStartEndFilePos = inputFileAnnexBParser->getFrameStartEndPos(readAnnexBFrameCounterCodingOrder);
-          Q_ASSERT_X(frameStartEndFilePos, "playlistItemCompressedVideo::loadRawData", "frameStartEndFilePos could not be retrieved. This should always work for a raw AnnexB file.");
+          auto frameStartEndFilePos = inputFileAnnexBParser->getFrameStartEndPos(context.readAnnexBFrameCounterCodingOrder);
+          Q_ASSERT_X(frameStartEndFilePos, "playlistItemCompressedVideo::decodeFrame", "frameStartEndFilePos could not be retrieved. This should always work for a raw AnnexB file.");
 
-          data = caching ? inputFileAnnexBCaching->getFrameData(*frameStartEndFilePos) : inputFileAnnexBLoading->getFrameData(*frameStartEndFilePos);
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived frame data from file - AnnexBCnt %d startEnd %lu-%lu - size %d", readAnnexBFrameCounterCodingOrder, frameStartEndFilePos.first, frameStartEndFilePos.second, data.size());
+          data = context.inputFileAnnexB->getFrameData(*frameStartEndFilePos);
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived frame data from file - AnnexBCnt %d startEnd %lu-%lu - size %d", context.readAnnexBFrameCounterCodingOrder, frameStartEndFilePos->first, frameStartEndFilePos->second, data.size());
         }
 
         if (!dec->pushData(data))
         {
           if (!dec->decodeFrames())
           {
-            DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData The decoder did not switch to decoding frame mode. Error.");
-            decodingNotPossibleAfter = frameIdxInternal;
+            DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame The decoder did not switch to decoding frame mode. Error.");
+            context.decodingNotPossibleAfter = frameIdxInternal;
             break;
           }
           // Pushing the data failed because the ffmpeg decoder wants us to read frames first.
           // Don't increase readAnnexBFrameCounterCodingOrder so that we will push the same data again.
         }
         else
-          readAnnexBFrameCounterCodingOrder++;
+          context.readAnnexBFrameCounterCodingOrder++;
       }
       else if (isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType != decoderEngineFFMpeg)
       {
-        QByteArray data = caching ? inputFileAnnexBCaching->getNextNALUnit(repushData) : inputFileAnnexBLoading->getNextNALUnit(repushData);
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived nal unit from file - size %d", data.size());
-        repushData = !dec->pushData(data);
+        QByteArray data = context.inputFileAnnexB->getNextNALUnit(context.repushData);
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size %d", data.size());
+        context.repushData = !dec->pushData(data);
       }
       else if (isInputFormatTypeFFmpeg(inputFormatType) && decoderEngineType != decoderEngineFFMpeg)
       {
         // Get the next unit (NAL or OBU) form ffmepg and push it to the decoder
-        QByteArray data = caching ? inputFileFFmpegCaching->getNextUnit(repushData) : inputFileFFmpegLoading->getNextUnit(repushData);
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived nal unit from file - size %d", data.size());
-        repushData = !dec->pushData(data);
+        QByteArray data = context.inputFileFFmpeg->getNextUnit(context.repushData);
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size %d", data.size());
+        context.repushData = !dec->pushData(data);
       }
       else
         assert(false);
@@ -602,59 +921,72 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
     {
       if (dec->decodeNextFrame())
       {
-        if (caching)
-          currentFrameIdx[1]++;
-        else
-          currentFrameIdx[0]++;
-
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoded frame %d", caching ? currentFrameIdx[1] : currentFrameIdx[0]);
-        rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
-        if (rightFrame)
+        context.currentFrameIdx++;
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoded frame %d", context.currentFrameIdx);
+        if (seekPending)
         {
-          video->rawData = dec->getRawFrameData();
-          video->rawData_frameIdx = frameIdxInternal;
+          // The decoder was refilled after the seek
+          context.costModel.addSeekTime(decodeTimer.nsecsElapsed() / 1e6);
+          decodeTimer.restart();
+          decodeStartFrameIdx = context.currentFrameIdx;
+          seekPending = false;
         }
+        rightFrame = context.currentFrameIdx == frameIdxInternal;
+        if (rightFrame)
+          frameData = dec->getRawFrameData();
+        // Pictures that would be removed from the buffer again before the requested frame is added are not copied
+        if (context.pictureBuffer && (rightFrame || context.pictureBuffer->canHold(frameIdxInternal - context.currentFrameIdx + 1, video->getBytesPerFrame())))
+          context.pictureBuffer->addPicture(context.currentFrameIdx, rightFrame ? frameData : dec->getRawFrameData());
+        else if (!rightFrame && context.isInCachingJob(context.currentFrameIdx))
+          // The frame belongs to the caching job. Keep it instead of decoding it again later.
+          cacheDecodedFrame(context, context.currentFrameIdx, dec->getRawFrameData(), false);
       }
     }
 
     if (!dec->needsMoreData() && !dec->decodeFrames())
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder neither needs more data nor can decode frames");
-      decodingNotPossibleAfter = frameIdxInternal;
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder neither needs more data nor can decode frames");
+      context.decodingNotPossibleAfter = frameIdxInternal;
       break;
     }
   }
+  context.costModel.addFrameDecodeTime(decodeTimer.nsecsElapsed() / 1e6, context.currentFrameIdx - decodeStartFrameIdx);
 
-  if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
+  if (context.isDecodingNotPossible(frameIdxInternal))
   {
     // The specified frame (which is thoretically in the bitstream) can not be decoded.
     // Maybe the bitstream was cut at a position that it was not supposed to be cut at.
-    if (caching)
-      currentFrameIdx[1] = frameIdxInternal;
-    else
-      currentFrameIdx[0] = frameIdxInternal;
-    // Just set the frame number of the buffer to the current frame so that it will trigger a
-    // reload when the frame number changes.
-    video->rawData_frameIdx = frameIdxInternal;
-  }
-  else if (loadingDecoder->errorInDecoder())
-  {
-    // There was an error in the deocder. 
-    infoText = "There was an error in the decoder: \n";
-    infoText += loadingDecoder->decoderErrorString();
-    infoText += "\n";
-    
-    decodingEnabled = false;
+    context.currentFrameIdx = frameIdxInternal;
+    return false;
   }
+  return rightFrame;
+}
+
+int playlistItemCompressedVideo::getClosestSeekableFrame(int frameIdxInternal, int &seekToAnnexBFrameCount, int &seekToDTS) const
+{
+  // All file readers share the same index so the reader of the loading decoder can be used
+  int seekToFrame = -1;
+  if (isInputFormatTypeAnnexB(inputFormatType))
+    seekToFrame = inputFileAnnexBParser->getClosestSeekableFrameNumberBefore(frameIdxInternal, seekToAnnexBFrameCount);
+  else
+    seekToDTS = loading.inputFileFFmpeg->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
+  return seekToFrame;
 }
 
-void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS, bool caching)
+double playlistItemCompressedVideo::getDecodingCost(const DecodingContext &context, int frameIdxInternal, int seekToFrame) const
+{
+  if (!context.decoder || context.decoder->errorInDecoder())
+    return std::numeric_limits<double>::infinity();
+  return context.costModel.getCost(context.currentFrameIdx, frameIdxInternal, seekToFrame);
+}
+
+void playlistItemCompressedVideo::seekToPosition(DecodingContext &context, int seekToFrame, int seekToDTS)
 {
   // Do the seek
-  decoderBase *dec = caching ? cachingDecoder.data() : loadingDecoder.data();
+  decoderBase *dec = context.decoder.data();
   dec->resetDecoder();
-  repushData = false;
-  decodingNotPossibleAfter = -1;
+  context.repushData = false;
+  context.decodingNotPossibleAfter = -1;
 
   // Retrieval of the raw metadata is only required if the the reader or the decoder is not ffmpeg
   const bool bothFFmpeg = (!isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType == decoderEngineFFMpeg);
@@ -667,20 +999,14 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS,
     if (!bothFFmpeg)
       parametersets = inputFileAnnexBParser->getSeekFrameParamerSets(seekToFrame, filePos);
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking annexB file to filePos %" PRIu64 "", filePos);
-    if (caching)
-      inputFileAnnexBCaching->seek(filePos);
-    else
-      inputFileAnnexBLoading->seek(filePos);
+    context.inputFileAnnexB->seek(filePos);
   }
   else
   {
     if (!bothFFmpeg)
-      parametersets = caching ? inputFileFFmpegCaching->getParameterSets() : inputFileFFmpegLoading->getParameterSets();
+      parametersets = context.inputFileFFmpeg->getParameterSets();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking ffmpeg file to pts %d", seekToDTS);
-    if (caching)
-      inputFileFFmpegCaching->seekToDTS(seekToDTS);
-    else
-      inputFileFFmpegLoading->seekToDTS(seekToDTS);
+    context.inputFileFFmpeg->seekToDTS(seekToDTS);
   }
 
   // In case of using ffmpeg for decoding, we don't need to push the parameter sets (the
@@ -696,10 +1022,108 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS,
         return;
       }
   }
-  if (caching)
-    currentFrameIdx[1] = seekToFrame - 1;
+  context.currentFrameIdx = seekToFrame - 1;
+}
+
+QSharedPointer<playlistItemCompressedVideo::CachingContext> playlistItemCompressedVideo::getCachingContext(int frameIdxInternal)
+{
+  QMutexLocker locker(&cachingContextsMutex);
+
+  // Prefer a free decoder that can continue decoding linearly (decoding forward is cheaper than seeking). Otherwise
+  // take the decoder that was not used for the longest time or open a new one.
+  int seekToAnnexBFrameCount = -1;
+  int seekToDTS = -1;
+  const int seekToFrame = getClosestSeekableFrame(frameIdxInternal, seekToAnnexBFrameCount, seekToDTS);
+  QSharedPointer<CachingContext> bestContext;
+  bool bestContinues = false;
+  for (auto context : cachingContexts)
+  {
+    if (!context->mutex.tryLock())
+      continue;
+    const bool continues = (context->currentFrameIdx >= 0 && context->currentFrameIdx < frameIdxInternal && !context->costModel.shouldSeek(context->currentFrameIdx, frameIdxInternal, seekToFrame));
+    if (!bestContext || (continues && !bestContinues) || (continues == bestContinues && context->lastUsed < bestContext->lastUsed))
+    {
+      if (bestContext)
+        bestContext->mutex.unlock();
+      bestContext = context;
+      bestContinues = continues;
+    }
+    else
+      context->mutex.unlock();
+  }
+
+  if ((!bestContext || !bestContinues) && cachingContexts.size() < maxNrCachingDecoders)
+  {
+    QSharedPointer<CachingContext> newContext(new CachingContext);
+    if (openCachingContext(*newContext))
+    {
+      if (bestContext)
+        bestContext->mutex.unlock();
+      cachingContexts.append(newContext);
+      bestContext = newContext;
+      bestContext->mutex.lock();
+    }
+  }
+
+  if (bestContext)
+    bestContext->lastUsed = ++cachingContextsUseCounter;
+  return bestContext;
+}
+
+QSharedPointer<playlistItemCompressedVideo::CachingContext> playlistItemCompressedVideo::getCheaperCachingContext(int frameIdxInternal, int seekToFrame, double maxCost)
+{
+  QMutexLocker locker(&cachingContextsMutex);
+
+  // Only a decoder that is positioned before the frame can be cheaper. The frame that a decoder decoded last
+  // can not be retrieved again.
+  QSharedPointer<CachingContext> bestContext;
+  for (auto context : cachingContexts)
+  {
+    if (!context->mutex.tryLock())
+      continue;
+    const double cost = getDecodingCost(*context, frameIdxInternal, seekToFrame);
+    if (context->currentFrameIdx >= 0 && context->currentFrameIdx < frameIdxInternal && cost < maxCost)
+    {
+      if (bestContext)
+        bestContext->mutex.unlock();
+      bestContext = context;
+      maxCost = cost;
+    }
+    else
+      context->mutex.unlock();
+  }
+  return bestContext;
+}
+
+void playlistItemCompressedVideo::resetCachingContexts()
+{
+  QMutexLocker locker(&cachingContextsMutex);
+  for (auto context : cachingContexts)
+  {
+    // Wait until no thread is decoding with the decoder
+    context->mutex.lock();
+    context->mutex.unlock();
+  }
+  cachingContexts.clear();
+}
+
+bool playlistItemCompressedVideo::openCachingContext(DecodingContext &context, std::optional<decoderBase::Threading> threading)
+{
+  // Open the file again for the caching decoder
+  if (isInputFormatTypeAnnexB(inputFormatType))
+    context.inputFileAnnexB.reset(new FileSourceAnnexBFile(plItemNameOrFileName));
   else
-    currentFrameIdx[0] = seekToFrame - 1;
+  {
+    context.inputFileFFmpeg.reset(new FileSourceFFmpegFile());
+    if (!context.inputFileFFmpeg->openFile(plItemNameOrFileName, nullptr, loading.inputFileFFmpeg.data()))
+    {
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::openCachingContext Error opening file a second time using libavcodec for caching.");
+      return false;
+    }
+  }
+
+  context.decoder.reset(createDecoder(loading.decoder->getDecodeSignal(), true, context.inputFileFFmpeg.data(), threading));
+  return context.decoder && !context.decoder->errorInDecoder();
 }
 
 void playlistItemCompressedVideo::createPropertiesWidget()
@@ -735,10 +1159,10 @@ void playlistItemCompressedVideo::createPropertiesWidget()
   ui.verticalLayout->insertLayout(6, statSource.createStatisticsHandlerControls(), 1);
 
   // Set the components that we can display
-  if (loadingDecoder)
+  if (loading.decoder)
   {
-    ui.comboBoxDisplaySignal->addItems(loadingDecoder->getSignalNames());
-    ui.comboBoxDisplaySignal->setCurrentIndex(loadingDecoder->getDecodeSignal());
+    ui.comboBoxDisplaySignal->addItems(loading.decoder->getSignalNames());
+    ui.comboBoxDisplaySignal->setCurrentIndex(loading.decoder->getDecodeSignal());
   }
   // Add decoders we can use
   for (decoderEngine e : possibleDecoders)
@@ -755,51 +1179,60 @@ void playlistItemCompressedVideo::createPropertiesWidget()
 
 bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
 {
-  // Reset (existing) decoders
-  loadingDecoder.reset();
-  cachingDecoder.reset();
+  // The decoding speed test opens decoders of the current type
+  stopDecodingSpeedTest();
 
+  // Reset (existing) decoders. The caching decoders are created again when they are needed.
+  loading.decoder.reset();
+  loadingPictureBuffer.clear();
+  resetCachingContexts();
+
+  if (decoderEngineType != decoderEngineLibde265 && decoderEngineType != decoderEngineHM && decoderEngineType != decoderEngineVTM && decoderEngineType != decoderEngineDav1d && decoderEngineType != decoderEngineFFMpeg)
+  {
+    infoText = "No valid decoder was selected.";
+    decodingEnabled = false;
+    return false;
+  }
+
+  loading.decoder.reset(createDecoder(displayComponent, false, loading.inputFileFFmpeg.data()));
+
+  decodingEnabled = !loading.decoder->errorInDecoder();
+  if (!decodingEnabled)
+  {
+    infoText = "There was an error allocating the new decoder: \n";
+    infoText += loading.decoder->decoderErrorString();
+    infoText += "\n";
+    return false;
+  }
+
+  return true;
+}
+
+decoderBase *playlistItemCompressedVideo::createDecoder(int displayComponent, bool cachingDecoder, FileSourceFFmpegFile *ffmpegFile, std::optional<decoderBase::Threading> threading) const
+{
+  const char *decoderUse = cachingDecoder ? "caching" : "interactive";
+  Q_UNUSED(decoderUse);
   if (decoderEngineType == decoderEngineLibde265)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive libde265 decoder");
-    loadingDecoder.reset(new decoderLibde265(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching libde265 decoder");
-      cachingDecoder.reset(new decoderLibde265(displayComponent, true));
-    }
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s libde265 decoder", decoderUse);
+    return new decoderLibde265(displayComponent, cachingDecoder, threading);
   }
-  else if (decoderEngineType == decoderEngineHM)
+  if (decoderEngineType == decoderEngineHM)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive HM decoder");
-    loadingDecoder.reset(new decoderHM(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive HM decoder");
-      cachingDecoder.reset(new decoderHM(displayComponent, true));
-    }
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s HM decoder", decoderUse);
+    return new decoderHM(displayComponent, cachingDecoder);
   }
-  else if (decoderEngineType == decoderEngineVTM)
+  if (decoderEngineType == decoderEngineVTM)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive VTM decoder");
-    loadingDecoder.reset(new decoderVTM(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive VTM decoder");
-      cachingDecoder.reset(new decoderVTM(displayComponent, true));
-    }
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s VTM decoder", decoderUse);
+    return new decoderVTM(displayComponent, cachingDecoder);
   }
-  else if (decoderEngineType == decoderEngineDav1d)
+  if (decoderEngineType == decoderEngineDav1d)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive dav1d decoder");
-    loadingDecoder.reset(new decoderDav1d(displayComponent));
-    if (cachingEnabled)
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive dav1d decoder");
-      cachingDecoder.reset(new decoderDav1d(displayComponent, true));
-    }
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s dav1d decoder", decoderUse);
+    return new decoderDav1d(displayComponent, cachingDecoder, threading);
   }
-  else if (decoderEngineType == decoderEngineFFMpeg)
+  if (decoderEngineType == decoderEngineFFMpeg)
   {
     if (isInputFormatTypeAnnexB(inputFormatType))
     {
@@ -809,50 +1242,21 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
       auto profileLevel = inputFileAnnexBParser->getProfileLevel();
       auto ratio = inputFileAnnexBParser->getSampleAspectRatio();
 
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive ffmpeg decoder from raw anexB stream. frameSize %dx%d extradata length %d yuvPixelFormat %s profile/level %d/%d, aspect raio %d/%d", frameSize.width(), frameSize.height(), extradata.length(), fmt.getName().toStdString().c_str(), profileLevel.first, profileLevel.second, ratio.first, ratio.second);
-      loadingDecoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio));
-      if (cachingEnabled)
-      {
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg decoder from raw anexB stream. Same settings.");
-        cachingDecoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, true));
-      }
-    }
-    else
-    {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive ffmpeg decoder using ffmpeg as parser");
-      loadingDecoder.reset(new decoderFFmpeg(inputFileFFmpegLoading->getVideoCodecPar()));
-      if (cachingEnabled)
-      {
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg decoder using ffmpeg as parser");
-        cachingDecoder.reset(new decoderFFmpeg(inputFileFFmpegCaching->getVideoCodecPar()));
-      }
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s ffmpeg decoder from raw anexB stream. frameSize %dx%d extradata length %d yuvPixelFormat %s profile/level %d/%d, aspect raio %d/%d", decoderUse, frameSize.width(), frameSize.height(), extradata.length(), fmt.getName().toStdString().c_str(), profileLevel.first, profileLevel.second, ratio.first, ratio.second);
+      return new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, cachingDecoder, threading);
     }
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::createDecoder Initializing %s ffmpeg decoder using ffmpeg as parser", decoderUse);
+    return new decoderFFmpeg(ffmpegFile->getVideoCodecPar(), cachingDecoder, threading);
   }
-  else
-  {
-    infoText = "No valid decoder was selected.";
-    decodingEnabled = false;
-    return false;
-  }
-
-  decodingEnabled = !loadingDecoder->errorInDecoder();
-  if (!decodingEnabled)
-  {
-    infoText = "There was an error allocating the new decoder: \n";
-    infoText += loadingDecoder->decoderErrorString();
-    infoText += "\n";
-    return false;
-  }
-
-  return true;
+  return nullptr;
 }
 
 void playlistItemCompressedVideo::fillStatisticList()
 {
-  if (!loadingDecoder || !loadingDecoder->statisticsSupported())
+  if (!loading.decoder || !loading.decoder->statisticsSupported())
     return;
 
-  loadingDecoder->fillStatisticList(statSource);
+  loading.decoder->fillStatisticList(statSource);
 }
 
 void playlistItemCompressedVideo::loadStatisticToCache(int frameIdx, int typeIdx)
@@ -860,28 +1264,37 @@ void playlistItemCompressedVideo::loadStatisticToCache(int frameIdx, int typeIdx
   DEBUG_COMPRESSED("playlistItemCompressedVideo::loadStatisticToCache Request statistics type %d for frame %d", typeIdx, frameIdx);
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
-  if (!loadingDecoder->statisticsSupported())
+  if (!loading.decoder->statisticsSupported())
     return;
-  if (!loadingDecoder->statisticsEnabled())
+
+  // Only the rendered types are extracted from each decoded frame
+  loading.decoder->setStatisticsTypesToRetrieve(statSource.getRenderedTypeIDs());
+  if (!loading.decoder->statisticsEnabled())
   {
     // We have to enable collecting of statistics in the decoder. By default (for speed reasons) this is off.
     // Enabeling works like this: Enable collection, reset the decoder and decode the current frame again.
     // Statisitcs are always retrieved for the loading decoder.
-    loadingDecoder->enableStatisticsRetrieval();
+    loading.decoder->enableStatisticsRetrieval();
 
     // Reload the current frame (force a seek and decode operation)
-    int frameToLoad = currentFrameIdx[0];
-    currentFrameIdx[0] = INT_MAX;
-    loadRawData(frameToLoad, false);
+    int frameToLoad = loading.currentFrameIdx;
+    loading.currentFrameIdx = INT_MAX;
+    loadRawData(frameToLoad);
 
     // The statistics should now be loaded
   }
-  else if (frameIdxInternal != currentFrameIdx[0])
+  else if (frameIdxInternal != loading.currentFrameIdx)
     // If the requested frame is not currently decoded, decode it.
     // This can happen if the picture was gotten from the cache.
-    loadRawData(frameIdxInternal, false);
+    loadRawData(frameIdxInternal);
+  else if (!loading.decoder->isStatisticsTypeAvailable(typeIdx))
+  {
+    // The type was just enabled but the decoder does not hold the current frame anymore. Decode it again.
+    loading.currentFrameIdx = INT_MAX;
+    loadRawData(frameIdxInternal);
+  }
 
-  statSource.statsCache[typeIdx] = loadingDecoder->getStatisticsData(typeIdx);
+  statSource.statsCache[typeIdx] = loading.decoder->getStatisticsData(typeIdx);
 }
 
 indexRange playlistItemCompressedVideo::getStartEndFrameLimits() const
@@ -893,7 +1306,7 @@ indexRange playlistItemCompressedVideo::getStartEndFrameLimits() const
     if (isInputFormatTypeAnnexB(inputFormatType))
       return indexRange(0, inputFileAnnexBParser->getNumberPOCs() - 1);
     else
-      return inputFileFFmpegLoading->getDecodableFrameLimits();
+      return loading.inputFileFFmpeg->getDecodableFrameLimits();
   }  
 }
 
@@ -903,7 +1316,7 @@ ValuePairListSets playlistItemCompressedVideo::getPixelValues(const QPoint &pixe
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
   newSet.append("YUV", video->getPixelValues(pixelPos, frameIdxInternal));
-  if (loadingDecoder->statisticsSupported() && loadingDecoder->statisticsEnabled())
+  if (loading.decoder->statisticsSupported() && loading.decoder->statisticsEnabled())
     newSet.append("Stats", statSource.getValuesAt(pixelPos));
 
   return newSet;
@@ -928,32 +1341,136 @@ void playlistItemCompressedVideo::getSupportedFileExtensions(QStringList &allExt
 
 void playlistItemCompressedVideo::reloadItemSource()
 {
-  // TODO: The caching decoder must also be reloaded
-  //       All items in the cache are also now invalid
+  // Each caching decoder reads from its own file reader which still reads the old file. Close them. They are
+  // opened again (reading the changed file) when they are needed. All cached frames were decoded from the old file.
+  resetCachingContexts();
+  removeAllFramesFromCache();
 
-  //loadingDecoder->reloadItemSource();
+  //loading.decoder->reloadItemSource();
   // Reset the decoder somehow
 
   // Set the frame number limits
-  startEndFrame = getStartEndFrameLimits();
+  setStartEndFrame(getStartEndFrameLimits(), false);
 
   // Reset the videoHandlerYUV source. With the next draw event, the videoHandlerYUV will request to decode the frame again.
   video->invalidateAllBuffers();
+  loadingPictureBuffer.clear();
 
   // Load frame 0. This will decode the first frame in the sequence and set the
   // correct frame size/YUV format.
-  loadRawData(0, false);
+  loadRawData(0);
+
+  emit signalItemChanged(true, RECACHE_CLEAR);
 }
 
-void playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode)
+void playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode, indexRange jobRange)
 {
-  if (!cachingEnabled)
+  if (!cachingEnabled || unresolvableError || !decodingEnabled)
     return;
 
-  // Cache a certain frame. This is always called in a separate thread.
-  cachingMutex.lock();
-  video->cacheFrame(getFrameIdxInternal(frameIdx), testMode);
-  cachingMutex.unlock();
+  // Cache a certain frame. This is always called in a separate thread. The frame is decoded by one
+  // of the caching decoders so that several threads can decode different parts of the sequence at the same time.
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  const QList<int> statisticTypes = getStatisticTypesToCache();
+  if (video->isInCache(frameIdxInternal) && (statisticTypes.isEmpty() || statSource.isInCache(frameIdxInternal)) && !testMode)
+    return;
+
+  auto context = getCachingContext(frameIdxInternal);
+  if (!context)
+    return;
+  if (context->currentFrameIdx == frameIdxInternal)
+    // Decode the frame again
+    context->currentFrameIdx = -1;
+  if (context->decoder->statisticsEnabled() != !statisticTypes.isEmpty())
+  {
+    // The decoders only provide statistics if retrieval was enabled before decoding. Seek again.
+    if (statisticTypes.isEmpty())
+      context->decoder->disableStatisticsRetrieval();
+    else
+      context->decoder->enableStatisticsRetrieval();
+    context->currentFrameIdx = -1;
+  }
+  context->decoder->setStatisticsTypesToRetrieve(statisticTypes);
+  if (testMode)
+    context->cachingJobRange = indexRange(-1, -1);
+  else
+    context->cachingJobRange = indexRange(getFrameIdxInternal(jobRange.first), getFrameIdxInternal(jobRange.second));
+
+  QByteArray frameData;
+  if (decodeFrame(*context, frameIdxInternal, frameData))
+    cacheDecodedFrame(*context, frameIdxInternal, frameData, testMode);
+  context->mutex.unlock();
+}
+
+void playlistItemCompressedVideo::cacheDecodedFrame(DecodingContext &context, int frameIdxInternal, const QByteArray &frameData, bool testMode)
+{
+  if (frameData.isEmpty())
+    return;
+  const QList<int> statisticTypes = context.decoder->statisticsEnabled() ? getStatisticTypesToCache() : QList<int>();
+  if (video->isInCache(frameIdxInternal) && (statisticTypes.isEmpty() || statSource.isInCache(frameIdxInternal)) && !testMode)
+    return;
+
+  // The statistics can only be extracted while the decoder still holds the frame
+  QHash<int, statisticsData> frameStatistics;
+  for (int typeID : statisticTypes)
+  {
+    frameStatistics[typeID] = context.decoder->getStatisticsData(typeID);
+    frameStatistics[typeID].squeeze();
+  }
+
+  // The frame data shares the output buffer of the decoder. Once it is converted and released here, the decoder
+  // reuses the memory for the next frame instead of allocating a new buffer.
+  video->cacheFrame(frameIdxInternal, frameData, testMode);
+  if (!statisticTypes.isEmpty() && !testMode)
+    statSource.addFrameToCache(frameIdxInternal, frameStatistics);
+}
+
+QList<int> playlistItemCompressedVideo::getStatisticTypesToCache() const
+{
+  if (!loading.decoder || !loading.decoder->statisticsSupported())
+    return {};
+  return statSource.getRenderedTypeIDs();
+}
+
+unsigned int playlistItemCompressedVideo::getCachingFrameSize() const
+{
+  const unsigned int frameSize = playlistItemWithVideo::getCachingFrameSize();
+  if (unresolvableError || (getStatisticTypesToCache().isEmpty() && statSource.getNumberCachedFrames() == 0))
+    return frameSize;
+  return frameSize + statSource.getCachingFrameSize();
+}
+
+void playlistItemCompressedVideo::removeFrameFromCache(int idx)
+{
+  playlistItemWithVideo::removeFrameFromCache(idx);
+  statSource.removeFrameFromCache(getFrameIdxInternal(idx));
+}
+
+void playlistItemCompressedVideo::removeAllFramesFromCache()
+{
+  playlistItemWithVideo::removeAllFramesFromCache();
+  statSource.removeAllFramesFromCache();
+}
+
+int playlistItemCompressedVideo::getCachingJobEnd(int frameIdx)
+{
+  if (unresolvableError || !decodingEnabled)
+    return frameIdx;
+
+  // Cache all frames up to the next random access point in one job
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  int nextRandomAccessPoint = -1;
+  if (isInputFormatTypeAnnexB(inputFormatType))
+    nextRandomAccessPoint = inputFileAnnexBParser->getNextSeekableFrameNumberAfter(frameIdxInternal);
+  else
+    nextRandomAccessPoint = loading.inputFileFFmpeg->getNextSeekableFrameAfter(frameIdxInternal);
+  if (nextRandomAccessPoint < 0 && loading.inputFileFFmpeg && loading.inputFileFFmpeg->isIndexing())
+    // The next key frame may not be indexed yet
+    return frameIdx;
+  if (nextRandomAccessPoint < 0)
+    // Cache up to the end of the sequence
+    return startEndFrame.second - startEndFrame.first;
+  return frameIdx + (nextRandomAccessPoint - frameIdxInternal) - 1;
 }
 
 void playlistItemCompressedVideo::loadFrame(int frameIdx, bool playing, bool loadRawdata, bool emitSignals)
@@ -986,42 +1503,42 @@ void playlistItemCompressedVideo::loadFrame(int frameIdx, bool playing, bool loa
   }
 
   if (playing && (stateYUV == LoadingNeeded || stateYUV == LoadingNeededDoubleBuffer))
-  {
-    // Load the next frame into the double buffer
-    int nextFrameIdx = frameIdxInternal + 1;
-    if (nextFrameIdx <= startEndFrame.second)
-    {
-      DEBUG_COMPRESSED("playlistItplaylistItemCompressedVideoemRawFile::loadFrame loading frame into double buffer %d %s", nextFrameIdx, playing ? "(playing)" : "");
-      isFrameLoadingDoubleBuffer = true;
-      video->loadFrame(nextFrameIdx, true);
-      isFrameLoadingDoubleBuffer = false;
-      if (emitSignals)
-        emit signalItemDoubleBufferLoaded();
-    }
-  }
+    // Load the next frames into the double buffer
+    loadDoubleBuffer(frameIdxInternal, emitSignals);
 }
 
 void playlistItemCompressedVideo::displaySignalComboBoxChanged(int idx)
 {
-  if (loadingDecoder && idx != loadingDecoder->getDecodeSignal())
+  if (loading.decoder && idx != loading.decoder->getDecodeSignal())
   {
     bool resetDecoder = false;
-    loadingDecoder->setDecodeSignal(idx, resetDecoder);
-    cachingDecoder->setDecodeSignal(idx, resetDecoder);
-
+    loading.decoder->setDecodeSignal(idx, resetDecoder);
     if (resetDecoder)
     {
-      loadingDecoder->resetDecoder();
-      cachingDecoder->resetDecoder();
+      loading.decoder->resetDecoder();
 
-      // Reset the decoded frame indices so that decoding of the current frame is triggered
-      currentFrameIdx[0] = -1;
-      currentFrameIdx[1] = -1;
+      // Reset the decoded frame index so that decoding of the current frame is triggered
+      loading.currentFrameIdx = -1;
+    }
+
+    QMutexLocker locker(&cachingContextsMutex);
+    for (auto context : cachingContexts)
+    {
+      QMutexLocker contextLocker(&context->mutex);
+      bool resetCachingDecoder = false;
+      context->decoder->setDecodeSignal(idx, resetCachingDecoder);
+      if (resetCachingDecoder)
+      {
+        context->decoder->resetDecoder();
+        context->currentFrameIdx = -1;
+      }
     }
+    locker.unlock();
+    loadingPictureBuffer.clear();
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a redraw.
     videoHandlerYUV *yuvVideo = dynamic_cast<videoHandlerYUV*>(video.data());
-    yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(idx);
+    yuvVideo->showPixelValuesAsDiff = loading.decoder->isSignalDifference(idx);
     yuvVideo->invalidateAllBuffers();
 
     emit signalItemChanged(true, RECACHE_CLEAR);
@@ -1039,21 +1556,20 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a redraw.
     videoHandlerYUV *yuvVideo = dynamic_cast<videoHandlerYUV*>(video.data());
-    if (loadingDecoder)
-      yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(idx);
+    if (loading.decoder)
+      yuvVideo->showPixelValuesAsDiff = loading.decoder->isSignalDifference(idx);
     yuvVideo->invalidateAllBuffers();
 
-    // Reset the decoded frame indices so that decoding of the current frame is triggered
-    currentFrameIdx[0] = -1;
-    currentFrameIdx[1] = -1;
+    // Reset the decoded frame index so that decoding of the current frame is triggered
+    loading.currentFrameIdx = -1;
 
     // Update the list of display signals
-    if (loadingDecoder)
+    if (loading.decoder)
     {
       QSignalBlocker block(ui.comboBoxDisplaySignal);
       ui.comboBoxDisplaySignal->clear();
-      ui.comboBoxDisplaySignal->addItems(loadingDecoder->getSignalNames());
-      ui.comboBoxDisplaySignal->setCurrentIndex(loadingDecoder->getDecodeSignal());
+      ui.comboBoxDisplaySignal->addItems(loading.decoder->getSignalNames());
+      ui.comboBoxDisplaySignal->setCurrentIndex(loading.decoder->getDecodeSignal());
     }
 
     // Update the statistics list with what the new decoder can provide
@@ -32,6 +32,14 @@
 
 #pragma once
 
+#include <QBasicTimer>
+#include <QFuture>
+#include <QProgressDialog>
+#include <atomic>
+#include <functional>
+
+#include "decoder/DecodedPictureBuffer.h"
+#include "decoder/DecodingCostModel.h"
 #include "decoder/decoderBase.h"
 #include "filesource/FileSourceFFmpegFile.h"
 #include "parser/parserAnnexB.h"
@@ -58,6 +66,7 @@ public:
   * 'displayComponent' initializes the component to display (reconstruction/prediction/residual/trCoeff).
   */
   playlistItemCompressedVideo(const QString &fileName, int displayComponent=0, YUView::inputFormat input = YUView::inputInvalid, YUView::decoderEngine decoder = YUView::decoderEngineInvalid);
+  virtual ~playlistItemCompressedVideo();
 
   // Save the compressed file element to the given XML structure.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const Q_DECL_OVERRIDE;
@@ -87,7 +96,7 @@ public:
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()        Q_DECL_OVERRIDE { /* TODO */ return false; }
   virtual void reloadItemSource()       Q_DECL_OVERRIDE;
-  virtual void updateSettings()         Q_DECL_OVERRIDE { /* TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings(); */ }
+  virtual void updateSettings()         Q_DECL_OVERRIDE;
 
   // Do we need to load the given frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawData) Q_DECL_OVERRIDE;
@@ -95,17 +104,38 @@ public:
   virtual void loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals=true) Q_DECL_OVERRIDE;
   // Is an image currently being loaded?
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isFrameLoading; }
-  virtual bool isLoadingDoubleBuffer() const Q_DECL_OVERRIDE { return isFrameLoadingDoubleBuffer; }
 
-  // Cache the frame with the given index.
-  // For all compressed items, a mutex must be locked when caching a frame (only one frame can be cached at a time because we only have one decoder).
-  void cacheFrame(int idx, bool testMode) Q_DECL_OVERRIDE;
-
-  // We only have one caching decoder so it is better if only one thread caches frames from this item.
-  // This way, the frames will always be cached in the right order and no unnecessary decoding is performed.
-  virtual int cachingThreadLimit() Q_DECL_OVERRIDE { return 1; }
+  // Cache the frame with the given index. Every caching thread decodes with its own caching decoder.
+  // The statistics of all rendered types are cached together with the frame.
+  void cacheFrame(int idx, bool testMode, indexRange jobRange) Q_DECL_OVERRIDE;
+  // The cached statistics count against the cache budget and are removed together with the frames
+  virtual unsigned int getCachingFrameSize() const Q_DECL_OVERRIDE;
+  virtual void removeFrameFromCache(int idx) Q_DECL_OVERRIDE;
+  virtual void removeAllFramesFromCache() Q_DECL_OVERRIDE;
+  // The decoded picture buffer of the interactive decoder is counted against the cache size (as well as the double buffer)
+  virtual int64_t getBufferedFramesSize() const Q_DECL_OVERRIDE { return playlistItemWithVideo::getBufferedFramesSize() + loadingPictureBuffer.getSizeInBytes(); }
+
+  // There is one caching decoder per caching thread. The number of decoders is limited.
+  virtual int cachingThreadLimit() Q_DECL_OVERRIDE { return maxNrCachingDecoders; }
+  // All frames up to the next random access point are cached in one job. So every thread decodes a different
+  // part of the sequence and no frame is decoded twice.
+  virtual int getCachingJobEnd(int frameIdx) Q_DECL_OVERRIDE;
 
   YUView::inputFormat getInputFormat() const { return inputFormatType; }
+
+  // Decode the whole sequence and write all statistics from the decoder to a binary statistics file (*.yuvstats).
+  // The progress dialog (if given) is updated and the export is aborted if it is canceled.
+  bool exportStatisticsToBinaryFile(const QString &fileName, QProgressDialog *progressDialog, QString &errorMessage);
+
+  // Decode the first frames of the sequence with different threading configurations of the decoder and return one line
+  // with the decoding speed (frames per second) per configuration. This takes a while, so call it from a separate thread.
+  // Before each configuration, progress (if given) is called with the index and the number of configurations. The test
+  // is aborted if it returns false.
+  QStringList testDecodingSpeed(int nrFrames, const std::function<bool(int testIdx, int nrTests)> &progress = {});
+
+signals:
+  // Emitted from the thread that runs the decoding speed test before each configuration is tested
+  void signalDecodingSpeedTestProgress(int testIdx, int nrTests);
   
 protected:
   // Override from playlistItemIndexed. The readerEngine can tell us how many frames there are in the sequence.
@@ -113,10 +143,63 @@ protected:
 
   virtual void createPropertiesWidget() Q_DECL_OVERRIDE;
 
-  // We allocate two decoder: One for loading images in the foreground and one for caching in the background.
-  // This is better if random access and linear decoding (caching) is performed at the same time.
-  QScopedPointer<decoderBase> loadingDecoder;
-  QScopedPointer<decoderBase> cachingDecoder;
+  // A decoder with its own file reader. Every decoder keeps track of the frame that it decoded last, so that
+  // consecutive frames can be decoded without seeking.
+  struct DecodingContext
+  {
+    QScopedPointer<decoderBase> decoder;
+    QScopedPointer<FileSourceAnnexBFile> inputFileAnnexB;
+    QScopedPointer<FileSourceFFmpegFile> inputFileFFmpeg;
+    // The index of the frame that was decoded last
+    int currentFrameIdx {-1};
+    // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to count how many frames we already read.
+    int readAnnexBFrameCounterCodingOrder {-1};
+    // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch to retrieveing mode.
+    // In this case, we must re-push the packet for which pushing failed.
+    bool repushData {false};
+    // The measured decoding and seeking times of this decoder. Used to decide if seeking or decoding forward is cheaper.
+    DecodingCostModel costModel;
+    // If the bitstream is invalid (for example it was cut at a position that it should not be cut at), the decoder
+    // might be unable to decode some of the frames at the end of the sequence. This is written by the thread that
+    // holds the context. For the loading context, it is also read by the main thread.
+    std::atomic_int decodingNotPossibleAfter {-1};
+    bool isDecodingNotPossible(int frameIdxInternal) const { const int idx = decodingNotPossibleAfter; return idx >= 0 && frameIdxInternal >= idx; }
+    // If set, all decoded pictures are added to this buffer
+    DecodedPictureBuffer *pictureBuffer {nullptr};
+    // The frames (internal indices) of the caching job that the context decodes for. Frames of the job that are decoded on
+    // the way to the requested frame are added to the cache. The video cache reserved space for all frames of the job.
+    // Frames outside of the job (e.g. before the job when decoding from a random access point) are not cached.
+    indexRange cachingJobRange {-1, -1};
+    bool isInCachingJob(int frameIdxInternal) const { return cachingJobRange.first >= 0 && frameIdxInternal >= cachingJobRange.first && frameIdxInternal <= cachingJobRange.second; }
+  };
+
+  // One decoder is used for loading images in the foreground. For caching in the background, each caching thread uses
+  // its own decoder. This is better if random access and linear decoding (caching) is performed at the same time.
+  DecodingContext loading;
+  DecodedPictureBuffer loadingPictureBuffer;
+
+  // The caching decoders are created when they are first needed. A caching decoder is locked while a frame is decoded.
+  struct CachingContext : DecodingContext
+  {
+    QMutex mutex;
+    int lastUsed {0};
+  };
+  QList<QSharedPointer<CachingContext>> cachingContexts;
+  QMutex cachingContextsMutex;
+  int cachingContextsUseCounter {0};
+  int maxNrCachingDecoders {1};
+  // Get a free caching decoder (locked) for decoding the given frame. The decoder that decoded the previous frame is preferred.
+  QSharedPointer<CachingContext> getCachingContext(int frameIdxInternal);
+  // Get a free caching decoder (locked) that can get to the given frame at a lower cost than maxCost. Return null if there is none.
+  QSharedPointer<CachingContext> getCheaperCachingContext(int frameIdxInternal, int seekToFrame, double maxCost);
+  // Open a new file reader and decoder for the context. If no threading is given, the caching decoder threading from the settings is used.
+  bool openCachingContext(DecodingContext &context, std::optional<decoderBase::Threading> threading={});
+  // Close all caching decoders (after waiting for running decodes). They are opened again when they are needed.
+  void resetCachingContexts();
+  // The statistics types that the caching decoders extract for each cached frame (the rendered types)
+  QList<int> getStatisticTypesToCache() const;
+  // Add the frame that the decoder of the (locked) context just output to the video and statistics cache
+  void cacheDecodedFrame(DecodingContext &context, int frameIdxInternal, const QByteArray &frameData, bool testMode);
 
   // When opening the file, we will fill this list with the possible decoders
   QList<YUView::decoderEngine> possibleDecoders;
@@ -124,32 +207,23 @@ protected:
   YUView::decoderEngine decoderEngineType;
   // Delete existing decoders and allocate decoders for the type "decoderEngineType"
   bool allocateDecoder(int displayComponent = 0);
+  decoderBase *createDecoder(int displayComponent, bool cachingDecoder, FileSourceFFmpegFile *ffmpegFile, std::optional<decoderBase::Threading> threading={}) const;
 
   // In order to parse raw annexB files, we need a file reader (that can read NAL units)
-  // and a parser that can understand what the NAL units mean. We open the file source twice (once for interactive loading,
-  // once for the background caching). The parser is only needed once and can be used for both loading and caching tasks.
-  QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBLoading;
-  QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBCaching;
+  // and a parser that can understand what the NAL units mean. Every decoder has its own file source. The parser
+  // is only needed once and can be used for both loading and caching tasks.
   QScopedPointer<parserAnnexB> inputFileAnnexBParser;
-  // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to count how many frames we already read.
-  int readAnnexBFrameCounterCodingOrder { -1 };
   
   // Which type is the input?
   YUView::inputFormat inputFormatType;
   AVCodecIDWrapper ffmpegCodec;
 
-  // For FFMpeg files we don't need a reader to parse them. But if the container contains a supported format, we can
-  // read the NAL units from the compressed file.
-  QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegLoading;
-  QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegCaching;
+  // While the FFmpeg file is indexed in the background, the frame limits are updated regularly
+  QBasicTimer indexingTimer;
+  virtual void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE; // Overloaded from QObject. Called when the timer fires.
   
   // Is the loadFrame function currently loading?
   bool isFrameLoading { false };
-  bool isFrameLoadingDoubleBuffer { false };
-
-  // Only cache one frame at a time. Caching should also always be done in display order of the frames.
-  // TODO: Could we somehow make shure that caching is always performed in display order?
-  QMutex cachingMutex;
 
   statisticHandler statSource;
 
@@ -158,33 +232,39 @@ protected:
 
   SafeUi<Ui::playlistItemCompressedFile_Widget> ui;
 
-  // The current frame index of the decoders (interactive/caching)
-  int currentFrameIdx[2] {-1, -1};
+  // Decode (and seek if necessary) until the given frame was decoded by the decoder of the context. If the frame
+  // was decoded, its raw data is returned in frameData. Return false if the frame could not be decoded.
+  bool decodeFrame(DecodingContext &context, int frameIdxInternal, QByteArray &frameData);
 
-  // Seek the input file to the given position, reset the decoder and prepare it to start decoding from the given position.
-  void seekToPosition(int seekToFrame, int seekToDTS, bool caching);
+  // Get the closest random access point before (or equal to) the given frame. The file position to seek to is returned
+  // in seekToAnnexBFrameCount (AnnexB) or seekToDTS (FFmpeg).
+  int getClosestSeekableFrame(int frameIdxInternal, int &seekToAnnexBFrameCount, int &seekToDTS) const;
+  // Estimate the cost (in milliseconds) for the decoder of the context to decode the given frame
+  double getDecodingCost(const DecodingContext &context, int frameIdxInternal, int seekToFrame) const;
 
-  // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch to retrieveing mode.
-  // In this case, we must re-push the packet for which pushing failed.
-  bool repushData {false};
+  // Seek the input file to the given position, reset the decoder and prepare it to start decoding from the given position.
+  void seekToPosition(DecodingContext &context, int seekToFrame, int seekToDTS);
 
   // Besides the normal stats (error / no error) this item might be able to parse the file but not to decode it.
   void setDecodingError(QString err) { infoText = err; decodingEnabled = false; }
   bool decodingEnabled {false};
 
-  // If the bitstream is invalid (for example it was cut at a position that it should not be cut at), we
-  // might be unable to decode some of the frames at the end of the sequence.
-  int decodingNotPossibleAfter { -1 };
+  // The decoding speed test runs in the background. A progress dialog is shown and the results are shown when it is done.
+  void startDecodingSpeedTest();
+  // Abort a running decoding speed test and wait until it finished
+  void stopDecodingSpeedTest();
+  QFuture<QStringList> decodingSpeedTestFuture;
+  std::atomic_bool decodingSpeedTestCanceled {false};
 
 private slots:
   // Load the raw (YUV or RGN) data for the given frame index from file. This slot is called by the videoHandler if the frame that is
   // requested to be drawn has not been loaded yet.
-  virtual void loadRawData(int frameIdxInternal, bool forceDecodingNow);
+  virtual void loadRawData(int frameIdxInternal);
 
   // The statistic with the given frameIdx/typeIdx could not be found in the cache. Load it.
   virtual void loadStatisticToCache(int frameIdx, int typeIdx);
 
-  void updateStatSource(bool bRedraw) { emit signalItemChanged(bRedraw, RECACHE_NONE); }
+  void updateStatSource(bool bRedraw, recacheIndicator recache) { emit signalItemChanged(bRedraw, recache); }
   void displaySignalComboBoxChanged(int idx);
   void decoderComboxBoxChanged(int idx);
 };
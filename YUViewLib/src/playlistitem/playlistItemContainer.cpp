@@ -266,6 +266,24 @@ void playlistItemContainer::updateSettings()
   }
 }
 
+void playlistItemContainer::setPlaybackPosition(int frameIdx, int direction)
+{
+  for (int i = 0; i < childCount(); i++)
+  {
+    playlistItem *childItem = getChildPlaylistItem(i);
+    childItem->setPlaybackPosition(frameIdx, direction);
+  }
+}
+
+void playlistItemContainer::setDoubleBufferLoadingInterrupted(bool interrupted)
+{
+  for (int i = 0; i < childCount(); i++)
+  {
+    playlistItem *childItem = getChildPlaylistItem(i);
+    childItem->setDoubleBufferLoadingInterrupted(interrupted);
+  }
+}
+
 playlistItem *playlistItemContainer::getChildPlaylistItem(int index) const
 {
   if (index < 0 || index > childCount())
@@ -62,6 +62,10 @@ public:
   virtual void reloadItemSource()       Q_DECL_OVERRIDE;  // Reload all child items
   virtual void updateSettings()         Q_DECL_OVERRIDE;  // Install/remove the file watchers.
 
+  // Pass the playback position and the interruption of the double buffer loading on to all child items
+  virtual void setPlaybackPosition(int frameIdx, int direction) Q_DECL_OVERRIDE;
+  virtual void setDoubleBufferLoadingInterrupted(bool interrupted) Q_DECL_OVERRIDE;
+
     // Return a list containing this item and all child items (if any).
   QList<playlistItem*> getAllChildPlaylistItems() const;
 
@@ -315,6 +315,8 @@ void playlistItemImageFileSequence::reloadItemSource()
 
 void playlistItemImageFileSequence::updateSettings()
 {
+  playlistItemWithVideo::updateSettings();
+
   // Install a file watcher if file watching is active in the settings.
   // The addPath/removePath functions will do nothing if called twice for the same file.
   QSettings settings;
@@ -33,6 +33,7 @@
 #include "playlistItemRawFile.h"
 
 #include <QPainter>
+#include <QSettings>
 #include <QUrl>
 #include <QVBoxLayout>
 
@@ -62,7 +63,10 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath, const QSize
   setIcon(0, functions::convertIcon(":img_video.png"));
   setFlags(flags() | Qt::ItemIsDropEnabled);
 
+  // Raw files are mostly read frame by frame from start to end
+  dataSource.setAccessPattern(FileSource::AccessPattern::Sequential);
   dataSource.openFile(rawFilePath);
+  this->updateSettings();
 
   if (!dataSource.isOk())
   {
@@ -470,12 +474,8 @@ void playlistItemRawFile::loadRawData(int frameIdxInternal)
     return;
 
   // Load the raw data for the given frameIdx from file and set it in the video
-  int64_t fileStartPos;
-  if (isY4MFile)
-    fileStartPos = y4mFrameIndices.at(frameIdxInternal);
-  else
-    fileStartPos = frameIdxInternal * getBytesPerFrame();
-  int64_t nrBytes = getBytesPerFrame();
+  const int64_t fileStartPos = getFrameStartPos(frameIdxInternal);
+  const int64_t nrBytes = getBytesPerFrame();
 
   DEBUG_RAWFILE("playlistItemRawFile::loadRawData frame %d bytes %d", frameIdxInternal, int(nrBytes));
   if (dataSource.readBytes(video->rawData, fileStartPos, nrBytes) < nrBytes)
@@ -485,6 +485,44 @@ void playlistItemRawFile::loadRawData(int frameIdxInternal)
   DEBUG_RAWFILE("playlistItemRawFile::loadRawData %d Done", frameIdxInternal);
 }
 
+int64_t playlistItemRawFile::getFrameStartPos(int frameIdxInternal) const
+{
+  if (isY4MFile)
+    return y4mFrameIndices.at(frameIdxInternal);
+  return frameIdxInternal * getBytesPerFrame();
+}
+
+void playlistItemRawFile::setPlaybackPosition(int frameIdx, int direction)
+{
+  if (this->nrReadAheadFrames <= 0 || !video->isFormatValid())
+    return;
+
+  // Read the frames after the given one in the background. The caching threads read the frames of their jobs
+  // themselves, so these ranges are only dropped by the next call of this function.
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  const auto nrFrames = getNumberFrames();
+  QList<FileSource::FileRange> ranges;
+  for (int i = 1; i <= this->nrReadAheadFrames; i++)
+  {
+    const int nextFrameIdx = frameIdxInternal + i * direction;
+    if (nextFrameIdx < 0 || nextFrameIdx >= nrFrames)
+      break;
+    ranges.append(FileSource::FileRange(getFrameStartPos(nextFrameIdx), getBytesPerFrame()));
+  }
+  dataSource.readAhead(ranges, playbackReadAheadConsumer);
+}
+
+void playlistItemRawFile::updateSettings()
+{
+  playlistItemWithVideo::updateSettings();
+  dataSource.updateFileWatchSetting();
+
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  this->nrReadAheadFrames = settings.value("ReadAheadFrames", 4).toInt();
+  settings.endGroup();
+}
+
 void playlistItemRawFile::slotVideoPropertiesChanged()
 {
   DEBUG_RAWFILE("playlistItemRawFile::slotVideoPropertiesChanged");
@@ -519,6 +557,10 @@ void playlistItemRawFile::getSupportedFileExtensions(QStringList &allExtensions,
 
 void playlistItemRawFile::reloadItemSource()
 {
+  // The raw data of the current frame may have changed
+  video->rawData.clear();
+  video->currentFrameRawData.clear();
+
   // Reopen the file
   dataSource.openFile(plItemNameOrFileName);
   if (!dataSource.isOk())
@@ -73,10 +73,13 @@ public:
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()  Q_DECL_OVERRIDE { return dataSource.isFileChanged(); }
   virtual void reloadItemSource() Q_DECL_OVERRIDE;
-  virtual void updateSettings()   Q_DECL_OVERRIDE { dataSource.updateFileWatchSetting(); }
+  virtual void updateSettings()   Q_DECL_OVERRIDE;
+
+  // Read the next frames in the given direction in the background (see FileSource::readAhead)
+  virtual void setPlaybackPosition(int frameIdx, int direction) Q_DECL_OVERRIDE;
 
   // Cache the given frame
-  virtual void cacheFrame(int idx, bool testMode) Q_DECL_OVERRIDE { if (testMode) dataSource.clearFileCache(); playlistItemWithVideo::cacheFrame(idx, testMode); }
+  virtual void cacheFrame(int idx, bool testMode, indexRange jobRange) Q_DECL_OVERRIDE { if (testMode) dataSource.clearFileCache(); playlistItemWithVideo::cacheFrame(idx, testMode, jobRange); }
 
 private slots:
   // Load the raw data for the given frame index from file. This slot is called by the videoHandler if the frame that is
@@ -104,6 +107,10 @@ private:
   FileSource dataSource;
 
   int64_t getBytesPerFrame() const { return video->getBytesPerFrame(); }
+  int64_t getFrameStartPos(int frameIdxInternal) const;
+
+  int nrReadAheadFrames {0};
+  static const int playbackReadAheadConsumer = 0;
 
   // A y4m file is a raw YUV file but it adds a header (which has information about the YUV format)
   // and start indicators for every frame. This file will parse the header and save all the byte
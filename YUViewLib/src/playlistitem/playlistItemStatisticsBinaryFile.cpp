@@ -0,0 +1,170 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "playlistItemStatisticsBinaryFile.h"
+
+#include <iostream>
+
+playlistItemStatisticsBinaryFile::playlistItemStatisticsBinaryFile(const QString &itemNameOrFileName)
+  : playlistItemStatisticsFile(itemNameOrFileName)
+{
+  cancelBackgroundParser = false;
+  if (!file.isOk())
+    return;
+
+  // The file contains the index. No background parsing is needed.
+  readHeaderFromFile();
+}
+
+void playlistItemStatisticsBinaryFile::readHeaderFromFile()
+{
+  statSource.clearStatTypes();
+  indexLock.lockForWrite();
+  pocTypeIndex.clear();
+  indexLock.unlock();
+
+  StatisticsBinaryFormat::FileInfo info;
+  QString errorMessage;
+  if (!StatisticsBinaryFormat::readFileInfo(file.getQFile(), info, errorMessage))
+  {
+    std::cerr << "Error while parsing: " << errorMessage.toStdString() << '\n';
+    mergeLoadResult({QString("Error while parsing meta data: ") + errorMessage, -1});
+    return;
+  }
+
+  for (const StatisticsType &type : info.types)
+    statSource.addStatType(type);
+  statSource.setFrameSize(info.frameSize);
+  if (info.frameRate > 0)
+    frameRate = info.frameRate;
+
+  indexLock.lockForWrite();
+  pocTypeIndex = info.index;
+  indexLock.unlock();
+  fileSortedByPOC = true;
+  maxPOC = info.maxPOC;
+  backgroundParserProgress = 100.0;
+  setStartEndFrame(indexRange(0, maxPOC), false);
+}
+
+void playlistItemStatisticsBinaryFile::loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result)
+{
+  if (!file.isOk())
+    return;
+
+  statisticsData &data = cache[typeID];
+  data = statisticsData();
+
+  // Look up the position in the index. The index is replaced when the source is reloaded.
+  StatisticsBinaryFormat::IndexEntry entry;
+  {
+    QReadLocker indexLocker(&indexLock);
+    const auto pocIt = pocTypeIndex.constFind(frameIdxInternal);
+    if (pocIt == pocTypeIndex.constEnd() || !pocIt->contains(typeID))
+      // There are no statistics in the file for the given frame and index.
+      return;
+    entry = pocIt->value(typeID);
+  }
+
+  if (!StatisticsBinaryFormat::readStatisticsData(srcFile, entry, data))
+  {
+    data = statisticsData();
+    result.parsingError = QString("Error reading the statistics of frame %1 type %2.").arg(frameIdxInternal).arg(typeID);
+    return;
+  }
+
+  // Check if the blocks are within the image range
+  if (result.blockOutsideOfFrameIdx == -1)
+  {
+    const QSize frameSize = statSource.getFrameSize();
+    for (const statisticsItem_Value &item : data.valueData)
+      if (item.pos[0] + item.size[0] > frameSize.width() || item.pos[1] + item.size[1] > frameSize.height())
+      {
+        // Block not in image. Warn about this.
+        result.blockOutsideOfFrameIdx = frameIdxInternal;
+        break;
+      }
+  }
+}
+
+playlistItemStatisticsBinaryFile *playlistItemStatisticsBinaryFile::newplaylistItemStatisticsBinaryFile(const YUViewDomElement &root, const QString &playlistFilePath)
+{
+  // Parse the DOM element. It should have all values of a playlistItemStatisticsFile
+  QString absolutePath = root.findChildValue("absolutePath");
+  QString relativePath = root.findChildValue("relativePath");
+
+  // check if file with absolute path exists, otherwise check relative path
+  QString filePath = FileSource::getAbsPathFromAbsAndRel(playlistFilePath, absolutePath, relativePath);
+  if (filePath.isEmpty())
+    return nullptr;
+
+  // We can still not be sure that the file really exists, but we gave our best to try to find it.
+  playlistItemStatisticsBinaryFile *newStat = new playlistItemStatisticsBinaryFile(filePath);
+
+  // Load the propertied of the playlistItem
+  playlistItem::loadPropertiesFromPlaylist(root, newStat);
+
+  // Load the status of the statistics (which are shown, transparency ...)
+  newStat->statSource.loadPlaylist(root);
+
+  return newStat;
+}
+
+void playlistItemStatisticsBinaryFile::getSupportedFileExtensions(QStringList &allExtensions, QStringList &filters)
+{
+  allExtensions.append("yuvstats");
+  filters.append("Binary Statistics File (*.yuvstats)");
+}
+
+void playlistItemStatisticsBinaryFile::reloadItemSource()
+{
+  // Set default variables
+  resetLoadResult();
+  currentDrawnFrameIdx = -1;
+  maxPOC = 0;
+
+  // Clear the loaded data
+  statSource.statsCache.clear();
+  statSource.statsCacheFrameIdx = -1;
+  statSource.removeAllFramesFromCache();
+
+  // Reopen the file
+  file.openFile(plItemNameOrFileName);
+  if (!file.isOk())
+    return;
+
+  readHeaderFromFile();
+
+  statSource.updateStatisticsHandlerControls();
+  emit signalItemChanged(true, RECACHE_CLEAR);
+}
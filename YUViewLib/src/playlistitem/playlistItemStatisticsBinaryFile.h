@@ -0,0 +1,70 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "playlistItemStatisticsFile.h"
+#include "statistics/statisticsBinaryFormat.h"
+
+/* A statistics file in the YUView binary statistics format (see StatisticsBinaryFormat).
+ * The file contains an index of all POC/type positions, so no background parsing is needed when opening it.
+ * The data of each POC/type is read directly from the (mapped) file.
+ */
+class playlistItemStatisticsBinaryFile : public playlistItemStatisticsFile
+{
+  Q_OBJECT
+
+public:
+  playlistItemStatisticsBinaryFile(const QString &itemNameOrFileName);
+
+  // Create a new playlistItemStatisticsBinaryFile from the playlist file entry. Return nullptr if parsing failed.
+  static playlistItemStatisticsBinaryFile *newplaylistItemStatisticsBinaryFile(const YUViewDomElement &root, const QString &playlistFilePath);
+
+  // Add the file type filters and the extensions of files that we can load.
+  static void getSupportedFileExtensions(QStringList &allExtensions, QStringList &filters);
+
+  // ----- Detection of source/file change events -----
+  virtual void reloadItemSource() Q_DECL_OVERRIDE;
+
+protected:
+  void loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result) Q_DECL_OVERRIDE;
+
+private:
+  QString getPlaylistTag() const Q_DECL_OVERRIDE { return "playlistItemStatisticsBinaryFile"; }
+
+  // Read the header, the types and the index of the file
+  void readHeaderFromFile();
+
+  // The position of the data of each POC/type in the file
+  StatisticsBinaryFormat::POCTypeIndex pocTypeIndex;
+};
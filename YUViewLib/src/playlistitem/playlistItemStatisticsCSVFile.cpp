@@ -32,18 +32,18 @@
 
 #include "playlistItemStatisticsCSVFile.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <QDebug>
 #include <QtConcurrent>
 #include <QTime>
+#include "common/functions.h"
 #include "statistics/statisticsExtensions.h"
+#include "statistics/statisticsParsing.h"
 
-// The internal buffer for parsing the starting positions. The buffer must not be larger than 2GB
-// so that we can address all the positions in it with int (using such a large buffer is not a good
-// idea anyways)
-#define STAT_PARSING_BUFFER_SIZE 1048576
-#define STAT_MAX_STRING_SIZE 1<<28
+// The size of the range of the file that is indexed by one thread in one batch
+#define STAT_INDEXING_RANGE_SIZE 8388608
 
 playlistItemStatisticsCSVFile::playlistItemStatisticsCSVFile(const QString &itemNameOrFileName)
   : playlistItemStatisticsFile(itemNameOrFileName)
@@ -52,16 +52,22 @@ playlistItemStatisticsCSVFile::playlistItemStatisticsCSVFile(const QString &item
   if (!file.isOk())
     return;
 
+  // If the file was parsed before and did not change, the index is restored from the index cache
+  StatisticsIndexCache::Index index;
+  if (loadIndexFromCache(index))
+  {
+    pocTypeStartList = index.pocTypeStartList;
+    return;
+  }
+
   // Read the statistics file header
   readHeaderFromFile();
+  prepareIndexForCache();
 
   // Run the parsing of the file in the background
   cancelBackgroundParser = false;
   timer.start(1000, this);
   backgroundParserFuture = QtConcurrent::run(this, &playlistItemStatisticsCSVFile::readFrameAndTypePositionsFromFile);
-
-  connect(&statSource, &statisticHandler::updateItem, [this](bool redraw){ emit signalItemChanged(redraw, RECACHE_NONE); });
-  connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemStatisticsCSVFile::loadStatisticToCache, Qt::DirectConnection);
 }
 
 /** The background task that parses the file and extracts the exact file positions
@@ -82,155 +88,150 @@ void playlistItemStatisticsCSVFile::readFrameAndTypePositionsFromFile()
     if (!inputFile.openFile(file.absoluteFilePath()))
       return;
 
-    // We perform reading using an input buffer
+    // Map the whole file into memory if possible. Otherwise read it in batches.
+    const qint64 fileSize = inputFile.getFileSize();
+    const uchar *mappedFile = (fileSize > 0) ? inputFile.getQFile()->map(0, fileSize) : nullptr;
+
+    // Each batch is split into ranges of complete lines which are indexed in parallel
+    const int nrThreads = int(functions::getOptimalThreadCount());
+    const qint64 batchSize = qint64(STAT_INDEXING_RANGE_SIZE) * nrThreads;
+
     QByteArray inputBuffer;
-    bool fileAtEnd = false;
-    qint64 bufferStartPos = 0;
-
-    QString lineBuffer;
-    qint64  lineBufferStartPos = 0;
-    int     lastPOC = INT_INVALID;
-    int     lastType = INT_INVALID;
-    bool    sortingFixed = false; 
-    
-    while (!fileAtEnd && !cancelBackgroundParser)
+    qint64 batchStartPos = 0;
+    int    lastPOC = INT_INVALID;
+    int    lastType = INT_INVALID;
+    bool   sortingFixed = false;
+
+    while (batchStartPos < fileSize && !cancelBackgroundParser)
     {
-      // Fill the buffer
-      int bufferSize = inputFile.readBytes(inputBuffer, bufferStartPos, STAT_PARSING_BUFFER_SIZE);
-      if (bufferSize < STAT_PARSING_BUFFER_SIZE)
-        // Less bytes than the maximum buffer size were read. The file is at the end.
-        // This is the last run of the loop.
-        fileAtEnd = true;
-      // a corrupted file may contain an arbitrary amount of non-\n symbols
-      // prevent lineBuffer overflow by dumping it for such cases
-      if (lineBuffer.size() > STAT_MAX_STRING_SIZE)
-        lineBuffer.clear(); // prevent an overflow here
-      for (int i = 0; i < bufferSize; i++)
+      const char *batchData;
+      qint64 batchDataSize;
+      if (mappedFile)
+      {
+        batchData = reinterpret_cast<const char*>(mappedFile) + batchStartPos;
+        batchDataSize = std::min(batchSize, fileSize - batchStartPos);
+      }
+      else
+      {
+        batchDataSize = inputFile.readBytes(inputBuffer, batchStartPos, batchSize);
+        batchData = inputBuffer.constData();
+      }
+      if (batchDataSize <= 0)
+        break;
+      const bool atEnd = (batchStartPos + batchDataSize >= fileSize);
+
+      StatisticsParsing::CSVPocTypeStartList startList;
+      qint64 bytesIndexed = StatisticsParsing::indexCSVBuffer(batchData, batchDataSize, batchStartPos, atEnd, nrThreads, startList);
+      if (bytesIndexed == 0)
+        // A corrupted file may contain an arbitrary amount of non-\n symbols. Skip this batch.
+        bytesIndexed = batchDataSize;
+
+      for (const StatisticsParsing::CSVPocTypeStart &start : startList)
       {
-        // Search for '\n' newline characters
-        if (inputBuffer.at(i) == 10)
+        const int poc = start.poc;
+        const int typeID = start.typeID;
+
+        if (lastType == -1 && lastPOC == -1)
         {
-          // We found a newline character
-          if (lineBuffer.size() > 0)
+          // First POC/type line
+          pocTypeStartList[poc][typeID] = start.filePos;
+          if (poc == currentDrawnFrameIdx)
+            // We added a start position for the frame index that is currently drawn. We might have to redraw.
+            emit signalItemChanged(true, RECACHE_NONE);
+
+          lastType = typeID;
+          lastPOC = poc;
+
+          // update number of frames
+          if (poc > maxPOC)
+            maxPOC = poc;
+        }
+        else if (typeID != lastType && poc == lastPOC)
+        {
+          // we found a new type but the POC stayed the same.
+          // This seems to be an interleaved file
+          // Check if we already collected a start position for this type
+          if (!sortingFixed)
           {
-            // Parse the previous line
-            // get components of this line
-            QStringList rowItemList = parseCSVLine(lineBuffer, ';');
-
-            // ignore empty entries and headers
-            if (!rowItemList[0].isEmpty() && rowItemList[0][0] != '%')
-            {
-              // check for POC/type information
-              int poc = rowItemList[0].toInt();
-              int typeID = rowItemList[5].toInt();
-
-              if (lastType == -1 && lastPOC == -1)
-              {
-                // First POC/type line
-                pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                if (poc == currentDrawnFrameIdx)
-                  // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                  emit signalItemChanged(true, RECACHE_NONE);
-
-                lastType = typeID;
-                lastPOC = poc;
-
-                // update number of frames
-                if (poc > maxPOC)
-                  maxPOC = poc;
-              }
-              else if (typeID != lastType && poc == lastPOC)
-              {
-                // we found a new type but the POC stayed the same.
-                // This seems to be an interleaved file
-                // Check if we already collected a start position for this type
-                if (!sortingFixed)
-                {
-                  // we only check the first occurence of this, in a non-interleaved file
-                  // the above condition can be met and will reset fileSortedByPOC
-                  
-                  fileSortedByPOC = true;
-                  sortingFixed = true; 
-                }
-                lastType = typeID;
-                if (!pocTypeStartList[poc].contains(typeID))
-                {
-                  pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                  if (poc == currentDrawnFrameIdx)
-                    // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                    emit signalItemChanged(true, RECACHE_NONE);
-                }
-              }
-              else if (poc != lastPOC)
-              {
-                // this is apparently not sorted by POCs and we will not check it further
-                if(!sortingFixed)
-                  sortingFixed = true;
-                
-                // We found a new POC
-                if (fileSortedByPOC)
-                {
-                  // There must not be a start position for any type with this POC already.
-                  if (pocTypeStartList.contains(poc))
-                    throw "The data for each POC must be continuous in an interleaved statistics file->";
-                }
-                else
-                {
-                
-                  // There must not be a start position for this POC/type already.
-                  if (pocTypeStartList.contains(poc) && pocTypeStartList[poc].contains(typeID))
-                    throw "The data for each typeID must be continuous in an non interleaved statistics file->";
-                }
-
-                lastPOC = poc;
-                lastType = typeID;
-
-                pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                if (poc == currentDrawnFrameIdx)
-                  // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                  emit signalItemChanged(true, RECACHE_NONE);
-
-                // update number of frames
-                if (poc > maxPOC)
-                  maxPOC = poc;
-
-                // Update percent of file parsed
-                backgroundParserProgress = ((double)lineBufferStartPos * 100 / (double)inputFile.getFileSize());
-              }
-            }
+            // we only check the first occurence of this, in a non-interleaved file
+            // the above condition can be met and will reset fileSortedByPOC
+            fileSortedByPOC = true;
+            sortingFixed = true;
+          }
+          lastType = typeID;
+          if (!pocTypeStartList[poc].contains(typeID))
+          {
+            pocTypeStartList[poc][typeID] = start.filePos;
+            if (poc == currentDrawnFrameIdx)
+              // We added a start position for the frame index that is currently drawn. We might have to redraw.
+              emit signalItemChanged(true, RECACHE_NONE);
           }
-
-          lineBuffer.clear();
-          lineBufferStartPos = bufferStartPos + i + 1;
         }
-        else
+        else if (poc != lastPOC)
         {
-          // No newline character found
-          lineBuffer.append(inputBuffer.at(i));
+          // this is apparently not sorted by POCs and we will not check it further
+          if (!sortingFixed)
+            sortingFixed = true;
+
+          // We found a new POC
+          if (fileSortedByPOC)
+          {
+            // There must not be a start position for any type with this POC already.
+            if (pocTypeStartList.contains(poc))
+              throw "The data for each POC must be continuous in an interleaved statistics file->";
+          }
+          else
+          {
+            // There must not be a start position for this POC/type already.
+            if (pocTypeStartList.contains(poc) && pocTypeStartList[poc].contains(typeID))
+              throw "The data for each typeID must be continuous in an non interleaved statistics file->";
+          }
+
+          lastPOC = poc;
+          lastType = typeID;
+
+          pocTypeStartList[poc][typeID] = start.filePos;
+          if (poc == currentDrawnFrameIdx)
+            // We added a start position for the frame index that is currently drawn. We might have to redraw.
+            emit signalItemChanged(true, RECACHE_NONE);
+
+          // update number of frames
+          if (poc > maxPOC)
+            maxPOC = poc;
         }
       }
 
-      bufferStartPos += bufferSize;
+      batchStartPos += bytesIndexed;
+
+      // Update percent of file parsed
+      backgroundParserProgress = ((double)batchStartPos * 100 / (double)fileSize);
     }
 
+    if (mappedFile)
+      inputFile.getQFile()->unmap(const_cast<uchar*>(mappedFile));
+
     // Parsing complete
     backgroundParserProgress = 100.0;
 
+    // Save the index so that the file does not have to be parsed again the next time it is opened
+    saveIndexToCache(pocTypeStartList, QMap<int, qint64>());
+
+    // Now that all frame positions are known, the statistics can be cached.
     setStartEndFrame(indexRange(0, maxPOC), false);
-    emit signalItemChanged(false, RECACHE_NONE);
+    emit signalItemChanged(false, RECACHE_UPDATE);
 
   } // try
   catch (const char *str)
   {
     std::cerr << "Error while parsing meta data: " << str << "\n";
-    parsingError = QString("Error while parsing meta data: ") + QString(str);
+    mergeLoadResult({QString("Error while parsing meta data: ") + QString(str), -1});
     emit signalItemChanged(false, RECACHE_NONE);
     return;
   }
   catch (const std::exception& ex)
   {
     std::cerr << "Error while parsing:" << ex.what() << "\n";
-    parsingError = QString("Error while parsing: ") + QString(ex.what());
+    mergeLoadResult({QString("Error while parsing: ") + QString(ex.what()), -1});
     emit signalItemChanged(false, RECACHE_NONE);
     return;
   }
@@ -403,53 +404,54 @@ void playlistItemStatisticsCSVFile::readHeaderFromFile()
   return;
 }
 
-void playlistItemStatisticsCSVFile::loadStatisticToCache(int frameIdxInternal, int typeID)
+void playlistItemStatisticsCSVFile::loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result)
 {
   try
   {
     if (!file.isOk())
       return;
 
-    QTextStream in(file.getQFile());
-
-    if (!pocTypeStartList.contains(frameIdxInternal) || !pocTypeStartList[frameIdxInternal].contains(typeID))
+    qint64 startPos;
     {
-      // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
-      return;
-    }
-
+      QReadLocker indexLocker(&indexLock);
+      const auto pocIt = pocTypeStartList.constFind(frameIdxInternal);
+      if (pocIt == pocTypeStartList.constEnd() || !pocIt->contains(typeID))
+      {
+        // There are no statistics in the file for the given frame and index.
+        cache.insert(typeID, statisticsData());
+        return;
+      }
 
-    qint64 startPos = pocTypeStartList[frameIdxInternal][typeID];
-    if (fileSortedByPOC)
-    {
-      // If the statistics file is sorted by POC we have to start at the first entry of this POC and parse the
-      // file until another POC is encountered. If this is not done, some information from a different typeID
-      // could be ignored during parsing.
-
-      // Get the position of the first line with the given frameIdxInternal
-      startPos = std::numeric_limits<qint64>::max();
-      for (const qint64 &value : pocTypeStartList[frameIdxInternal])
-        if (value < startPos)
-          startPos = value;
+      startPos = pocIt->value(typeID);
+      if (fileSortedByPOC)
+      {
+        // If the statistics file is sorted by POC we have to start at the first entry of this POC and parse the
+        // file until another POC is encountered. If this is not done, some information from a different typeID
+        // could be ignored during parsing.
+
+        // Get the position of the first line with the given frameIdxInternal
+        startPos = std::numeric_limits<qint64>::max();
+        for (const qint64 &value : *pocIt)
+          if (value < startPos)
+            startPos = value;
+      }
     }
 
-    // fast forward
-    in.seek(startPos);
+    // Parse the lines directly from the file (without creating strings)
+    StatisticsParsing::FileLineReader reader(srcFile, startPos);
+    const char *lineBegin, *lineEnd;
+    int rowItems[10];
 
-    while (!in.atEnd())
+    while (reader.readLine(lineBegin, lineEnd))
     {
-      // read one line
-      QString aLine = in.readLine();
-
       // get components of this line
-      QStringList rowItemList = parseCSVLine(aLine, ';');
-
-      if (rowItemList[0].isEmpty())
+      const int nrItems = StatisticsParsing::parseCSVLine(lineBegin, lineEnd, rowItems, 10);
+      // ignore empty lines and lines without a value (POC;xPos;yPos;width;height;type;value)
+      if (nrItems < 7)
         continue;
 
-      int poc = rowItemList[0].toInt();
-      int type = rowItemList[5].toInt();
+      int poc = rowItems[0];
+      int type = rowItems[5];
 
       // if there is a new POC, we are done here!
       if (poc != frameIdxInternal)
@@ -460,56 +462,56 @@ void playlistItemStatisticsCSVFile::loadStatisticToCache(int frameIdxInternal, i
 
       int values[4] = {0};
 
-      values[0] = rowItemList[6].toInt();
+      values[0] = rowItems[6];
 
       bool vectorData = false;
       bool lineData = false; // or a vector specified by 2 points
 
-      if (rowItemList.count() > 7)
+      if (nrItems > 7)
       {
-        values[1] = rowItemList[7].toInt();
+        values[1] = rowItems[7];
         vectorData = true;
       }
-      if (rowItemList.count() > 8)
+      if (nrItems > 8)
       {
-        values[2] = rowItemList[8].toInt();
-        values[3] = rowItemList[9].toInt();
+        values[2] = rowItems[8];
+        values[3] = (nrItems > 9) ? rowItems[9] : 0;
         lineData = true;
         vectorData = false;
       }
 
-      int posX = rowItemList[1].toInt();
-      int posY = rowItemList[2].toInt();
-      int width = rowItemList[3].toUInt();
-      int height = rowItemList[4].toUInt();
+      int posX = rowItems[1];
+      int posY = rowItems[2];
+      int width = rowItems[3];
+      int height = rowItems[4];
 
       // Check if block is within the image range
-      if (blockOutsideOfFrame_idx == -1 && (posX + width > statSource.getFrameSize().width() || posY + height > statSource.getFrameSize().height()))
+      if (result.blockOutsideOfFrameIdx == -1 && (posX + width > statSource.getFrameSize().width() || posY + height > statSource.getFrameSize().height()))
         // Block not in image. Warn about this.
-        blockOutsideOfFrame_idx = frameIdxInternal;
+        result.blockOutsideOfFrameIdx = frameIdxInternal;
 
       const StatisticsType *statsType = statSource.getStatisticsType(type);
       Q_ASSERT_X(statsType != nullptr, Q_FUNC_INFO, "Stat type not found.");
 
       if (vectorData && statsType->hasVectorData)
-        statSource.statsCache[type].addBlockVector(posX, posY, width, height, values[0], values[1]);
+        cache[type].addBlockVector(posX, posY, width, height, values[0], values[1]);
       else if (lineData && statsType->hasVectorData)
-        statSource.statsCache[type].addLine(posX, posY, width, height, values[0], values[1], values[2], values[3]);
+        cache[type].addLine(posX, posY, width, height, values[0], values[1], values[2], values[3]);
       else
-        statSource.statsCache[type].addBlockValue(posX, posY, width, height, values[0]);
+        cache[type].addBlockValue(posX, posY, width, height, values[0]);
     }
 
   } // try
   catch (const char *str)
   {
     std::cerr << "Error while parsing: " << str << '\n';
-    parsingError = QString("Error while parsing meta data: ") + QString(str);
+    result.parsingError = QString("Error while parsing meta data: ") + QString(str);
     return;
   }
   catch (...)
   {
     std::cerr << "Error while parsing.";
-    parsingError = QString("Error while parsing meta data.");
+    result.parsingError = QString("Error while parsing meta data.");
     return;
   }
 
@@ -552,9 +554,8 @@ void playlistItemStatisticsCSVFile::reloadItemSource()
 {
   // Set default variables
   fileSortedByPOC = false;
-  blockOutsideOfFrame_idx = -1;
+  resetLoadResult();
   backgroundParserProgress = 0.0;
-  parsingError.clear();
   currentDrawnFrameIdx = -1;
   maxPOC = 0;
 
@@ -566,18 +567,34 @@ void playlistItemStatisticsCSVFile::reloadItemSource()
     backgroundParserFuture.waitForFinished();
   }
 
-  // Clear the parsed data
+  // Clear the parsed data. Caching threads may still be reading the index.
+  indexLock.lockForWrite();
   pocTypeStartList.clear();
+  indexLock.unlock();
   statSource.statsCache.clear();
   statSource.statsCacheFrameIdx = -1;
+  statSource.removeAllFramesFromCache();
 
   // Reopen the file
   file.openFile(plItemNameOrFileName);
   if (!file.isOk())
     return;
 
+  // Restore the index from the index cache (if the file changed, the cached index is not valid anymore)
+  StatisticsIndexCache::Index index;
+  if (loadIndexFromCache(index))
+  {
+    indexLock.lockForWrite();
+    pocTypeStartList = index.pocTypeStartList;
+    indexLock.unlock();
+    statSource.updateStatisticsHandlerControls();
+    emit signalItemChanged(false, RECACHE_UPDATE);
+    return;
+  }
+
   // Read the new statistics file header
   readHeaderFromFile();
+  prepareIndexForCache();
 
   statSource.updateStatisticsHandlerControls();
 
@@ -35,11 +35,15 @@
 #include <cassert>
 #include <iostream>
 #include <QDebug>
+#include <QFileDialog>
+#include <QMessageBox>
 #include <QTime>
 #include <QUrl>
 
 #include "common/functions.h"
+#include "statistics/statisticsBinaryFormat.h"
 #include "statistics/statisticsExtensions.h"
+#include "ui/mainwindow.h"
 
 // The internal buffer for parsing the starting positions. The buffer must not be larger than 2GB
 // so that we can address all the positions in it with int (using such a large buffer is not a good
@@ -56,10 +60,17 @@ playlistItemStatisticsFile::playlistItemStatisticsFile(const QString &itemNameOr
   currentDrawnFrameIdx = -1;
   maxPOC = 0;
   isStatisticsLoading = false;
+  indexLoadedFromCache = false;
 
   // Set statistics icon
   setIcon(0, functions::convertIcon(":img_stats.png"));
 
+  // The statistics of upcoming frames can be cached in the background
+  cachingEnabled = true;
+
+  connect(&statSource, &statisticHandler::updateItem, [this](bool redraw, recacheIndicator recache){ emit signalItemChanged(redraw, recache); });
+  connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemStatisticsFile::loadStatisticToCache, Qt::DirectConnection);
+
   file.openFile(itemNameOrFileName);
   if (!file.isOk())
     return;
@@ -77,6 +88,84 @@ playlistItemStatisticsFile::~playlistItemStatisticsFile()
   }
 }
 
+bool playlistItemStatisticsFile::loadIndexFromCache(StatisticsIndexCache::Index &index)
+{
+  indexLoadedFromCache = false;
+  if (!StatisticsIndexCache::loadIndex(file.absoluteFilePath(), getPlaylistTag(), index))
+    return false;
+
+  statSource.clearStatTypes();
+  for (const StatisticsType &type : index.types)
+    statSource.addStatType(type);
+  statSource.setFrameSize(index.frameSize);
+  if (index.frameRate > 0)
+    frameRate = index.frameRate;
+  fileSortedByPOC = index.fileSortedByPOC;
+  maxPOC = index.maxPOC;
+  backgroundParserProgress = 100.0;
+  indexLoadedFromCache = true;
+
+  // All frame positions are known. The statistics can be cached right away.
+  setStartEndFrame(indexRange(0, maxPOC), false);
+  return true;
+}
+
+void playlistItemStatisticsFile::prepareIndexForCache()
+{
+  // The state of the file and the header before parsing. The types are saved before the user (or a playlist) changes them.
+  indexFileState = StatisticsIndexCache::getFileState(file.absoluteFilePath());
+  indexForCache = StatisticsIndexCache::Index();
+  indexForCache.frameSize = statSource.getFrameSize();
+  indexForCache.frameRate = frameRate;
+  indexForCache.types = statSource.getStatisticsTypeList();
+}
+
+void playlistItemStatisticsFile::saveIndexToCache(const QMap<int, QMap<int, qint64>> &pocTypeStartList, const QMap<int, qint64> &pocStartList)
+{
+  if (cancelBackgroundParser)
+    return;
+  {
+    QMutexLocker lock(&loadResultMutex);
+    if (!parsingError.isEmpty())
+      return;
+  }
+
+  indexForCache.fileSortedByPOC = fileSortedByPOC;
+  indexForCache.maxPOC = maxPOC;
+  indexForCache.pocTypeStartList = pocTypeStartList;
+  indexForCache.pocStartList = pocStartList;
+  // If the index can not be saved, the file is just parsed again the next time
+  StatisticsIndexCache::saveIndex(file.absoluteFilePath(), getPlaylistTag(), indexFileState, indexForCache);
+  indexForCache = StatisticsIndexCache::Index();
+}
+
+bool playlistItemStatisticsFile::isCachable() const
+{
+  if (!playlistItem::isCachable() || backgroundParserFuture.isRunning())
+    return false;
+  QMutexLocker lock(&loadResultMutex);
+  return parsingError.isEmpty();
+}
+
+void playlistItemStatisticsFile::mergeLoadResult(const LoadResult &result)
+{
+  if (result.parsingError.isEmpty() && result.blockOutsideOfFrameIdx == -1)
+    return;
+
+  QMutexLocker lock(&loadResultMutex);
+  if (parsingError.isEmpty())
+    parsingError = result.parsingError;
+  if (blockOutsideOfFrame_idx == -1)
+    blockOutsideOfFrame_idx = result.blockOutsideOfFrameIdx;
+}
+
+void playlistItemStatisticsFile::resetLoadResult()
+{
+  QMutexLocker lock(&loadResultMutex);
+  parsingError.clear();
+  blockOutsideOfFrame_idx = -1;
+}
+
 infoData playlistItemStatisticsFile::getInfo() const
 {
   infoData info("Statistics File info");
@@ -90,18 +179,114 @@ infoData playlistItemStatisticsFile::getInfo() const
   // Show the progress of the background parsing (if running)
   if (backgroundParserFuture.isRunning())
     info.items.append(infoItem("Parsing:", QString("%1%...").arg(backgroundParserProgress, 0, 'f', 2)));
+  else if (indexLoadedFromCache)
+    info.items.append(infoItem("Index:", "Loaded from cache", "The positions of all frames in the file were loaded from the index cache because the file did not change since it was last parsed."));
+
+  // The caching threads may set these while we read them
+  loadResultMutex.lock();
+  const int blockOutsideOfFrameIdx = blockOutsideOfFrame_idx;
+  const QString error = parsingError;
+  loadResultMutex.unlock();
 
   // Print a warning if one of the blocks in the statistics file is outside of the defined "frame size"
-  if (blockOutsideOfFrame_idx != -1)
-    info.items.append(infoItem("Warning", QString("A block in frame %1 is outside of the given size of the statistics.").arg(blockOutsideOfFrame_idx)));
+  if (blockOutsideOfFrameIdx != -1)
+    info.items.append(infoItem("Warning", QString("A block in frame %1 is outside of the given size of the statistics.").arg(blockOutsideOfFrameIdx)));
 
   // Show any errors that occurred during parsing
-  if (!parsingError.isEmpty())
-    info.items.append(infoItem("Parsing Error:", parsingError));
+  if (!error.isEmpty())
+    info.items.append(infoItem("Parsing Error:", error));
+
+  // Once the file is indexed, it can be converted to the binary statistics format
+  if (!backgroundParserFuture.isRunning() && error.isEmpty())
+    info.items.append(infoItem("Convert", "Save as binary", "Save the statistics in the binary statistics format (*.yuvstats) which can be opened and loaded much faster.", true, 0));
 
   return info;
 }
 
+void playlistItemStatisticsFile::infoListButtonPressed(int buttonID)
+{
+  if (buttonID != 0)
+    return;
+
+  // The button "Save as binary" was pressed
+  QWidget *mainWindow = MainWindow::getMainWindow();
+  QFileInfo srcFileInfo(file.getAbsoluteFilePath());
+  QString defaultFileName = srcFileInfo.absoluteDir().filePath(srcFileInfo.completeBaseName() + ".yuvstats");
+  QString fileName = QFileDialog::getSaveFileName(mainWindow, "Save as binary statistics file", defaultFileName, "Binary Statistics File (*.yuvstats)");
+  if (fileName.isEmpty())
+    return;
+
+  QProgressDialog progressDialog("Converting statistics...", "Cancel", 0, maxPOC + 1, mainWindow);
+  progressDialog.setMinimumDuration(1000);  // Show after 1s
+  progressDialog.setWindowModality(Qt::WindowModal);
+
+  QString errorMessage;
+  if (!convertToBinaryFile(fileName, &progressDialog, errorMessage) && !errorMessage.isEmpty())
+    QMessageBox::critical(mainWindow, "Error converting statistics", errorMessage);
+}
+
+bool playlistItemStatisticsFile::convertToBinaryFile(const QString &fileName, QProgressDialog *progressDialog, QString &errorMessage)
+{
+  // Open the file again so that reading does not interfere with the loading of the current frame
+  QFile srcFile(file.getAbsoluteFilePath());
+  if (!srcFile.open(QIODevice::ReadOnly))
+  {
+    errorMessage = "Could not open the statistics file.";
+    return false;
+  }
+
+  const StatisticsTypeList types = statSource.getStatisticsTypeList();
+  StatisticsBinaryFormat::Writer writer;
+  if (!writer.open(fileName, statSource.getFrameSize(), frameRate, types))
+  {
+    errorMessage = writer.getErrorMessage();
+    return false;
+  }
+
+  bool success = true;
+  for (int poc = 0; poc <= maxPOC && success; poc++)
+  {
+    if (progressDialog)
+    {
+      progressDialog->setValue(poc);
+      if (progressDialog->wasCanceled())
+        break;
+    }
+
+    QHash<int, statisticsData> frameStatistics;
+    LoadResult result;
+    for (const StatisticsType &type : types)
+      if (!frameStatistics.contains(type.typeID))
+        loadStatisticData(&srcFile, poc, type.typeID, frameStatistics, result);
+    mergeLoadResult(result);
+
+    for (auto it = frameStatistics.constBegin(); it != frameStatistics.constEnd() && success; ++it)
+    {
+      if (!it.value().isEmpty() && !writer.addStatisticsData(poc, it.key(), it.value()))
+      {
+        errorMessage = writer.getErrorMessage();
+        success = false;
+      }
+    }
+  }
+  const bool canceled = progressDialog && progressDialog->wasCanceled();
+
+  if (!writer.finish() && success)
+  {
+    errorMessage = writer.getErrorMessage();
+    success = false;
+  }
+  if (!success || canceled)
+  {
+    // Remove the incomplete file
+    QFile::remove(fileName);
+    return false;
+  }
+  if (progressDialog)
+    progressDialog->setValue(maxPOC + 1);
+  return true;
+}
+
 void playlistItemStatisticsFile::drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
 {
   // drawRawData only controls the drawing of raw pixel values
@@ -194,3 +379,52 @@ void playlistItemStatisticsFile::loadFrame(int frameIdx, bool playback, bool loa
       emit signalItemChanged(true, RECACHE_NONE);
   }
 }
+
+void playlistItemStatisticsFile::cacheFrame(int frameIdx, bool testMode, indexRange jobRange)
+{
+  Q_UNUSED(jobRange);
+  if (!cachingEnabled)
+    return;
+
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  if (statSource.isInCache(frameIdxInternal) && !testMode)
+    return;
+
+  // Open the file again. Caching threads read in parallel and must not disturb each other or
+  // the loading of the current frame which reads from the item's file.
+  QFile cacheFile(file.getAbsoluteFilePath());
+  if (!cacheFile.open(QIODevice::ReadOnly))
+    return;
+
+  // Load all statistics types that are currently rendered
+  QHash<int, statisticsData> frameStatistics;
+  LoadResult result;
+  for (int typeID : statSource.getRenderedTypeIDs())
+  {
+    if (!frameStatistics.contains(typeID))
+      loadStatisticData(&cacheFile, frameIdxInternal, typeID, frameStatistics, result);
+    if (!frameStatistics.contains(typeID))
+      // There are no statistics in the file for the given frame and type.
+      frameStatistics.insert(typeID, statisticsData());
+  }
+  mergeLoadResult(result);
+
+  if (!testMode)
+    statSource.addFrameToCache(frameIdxInternal, frameStatistics);
+}
+
+void playlistItemStatisticsFile::loadStatisticToCache(int frameIdxInternal, int typeID)
+{
+  LoadResult result;
+  loadStatisticData(file.getQFile(), frameIdxInternal, typeID, statSource.statsCache, result);
+  mergeLoadResult(result);
+}
+
+QList<int> playlistItemStatisticsFile::getCachedFrames() const
+{
+  // Convert indices from internal to external indices
+  QList<int> retList;
+  for (int i : statSource.getCachedFrames())
+    retList.append(getFrameIdxExternal(i));
+  return retList;
+}
@@ -34,9 +34,13 @@
 
 #include <QBasicTimer>
 #include <QFuture>
+#include <QMutex>
+#include <QProgressDialog>
+#include <QReadWriteLock>
 #include "filesource/FileSource.h"
 #include "playlistItem.h"
 #include "statistics/statisticHandler.h"
+#include "statistics/statisticsIndexCache.h"
 
 class playlistItemStatisticsFile : public playlistItem
 {
@@ -53,6 +57,7 @@ public:
   
   // Return the info title and info list to be shown in the fileInfo groupBox.
   virtual infoData getInfo() const Q_DECL_OVERRIDE;
+  virtual void infoListButtonPressed(int buttonID) Q_DECL_OVERRIDE;
 
   bool isFileSource() const Q_DECL_OVERRIDE { return true; };
 
@@ -76,10 +81,25 @@ public:
   // Override from playlistItem. Return the statistics values under the given pixel position.
   virtual ValuePairListSets getPixelValues(const QPoint &pixelPos, int frameIdx) Q_DECL_OVERRIDE { Q_UNUSED(frameIdx); return ValuePairListSets("Stats",statSource.getValuesAt(pixelPos)); }
 
+  // ----- Caching -----
+  // The statistics of upcoming frames are parsed in the background by the videoCache.
+  // Caching is only possible once the background parser knows where all frames start.
+  virtual bool isCachable() const Q_DECL_OVERRIDE;
+  virtual void cacheFrame(int frameIdx, bool testMode, indexRange jobRange) Q_DECL_OVERRIDE;
+  virtual QList<int> getCachedFrames() const Q_DECL_OVERRIDE;
+  virtual int getNumberCachedFrames() const Q_DECL_OVERRIDE { return statSource.getNumberCachedFrames(); }
+  virtual unsigned int getCachingFrameSize() const Q_DECL_OVERRIDE { return statSource.getCachingFrameSize(); }
+  virtual void removeFrameFromCache(int idx) Q_DECL_OVERRIDE { statSource.removeFrameFromCache(getFrameIdxInternal(idx)); }
+  virtual void removeAllFramesFromCache() Q_DECL_OVERRIDE { statSource.removeAllFramesFromCache(); }
+
   // A statistics file source of course provides statistics
   virtual bool              providesStatistics() const Q_DECL_OVERRIDE { return true; }
   virtual statisticHandler *getStatisticsHandler() Q_DECL_OVERRIDE { return &statSource; }
 
+  // Write all statistics of the file to a binary statistics file (*.yuvstats). The progress dialog (if given)
+  // is updated and conversion is aborted if it is canceled.
+  bool convertToBinaryFile(const QString &fileName, QProgressDialog *progressDialog, QString &errorMessage);
+
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()  Q_DECL_OVERRIDE { return file.isFileChanged(); }
   virtual void updateSettings()   Q_DECL_OVERRIDE { file.updateFileWatchSetting(); statSource.updateSettings(); }
@@ -94,6 +114,25 @@ protected:
   // Get the tag/name which is used when saving the item to a playlist
   virtual QString getPlaylistTag() const = 0;
 
+  // Problems that loadStatisticData noticed while parsing a frame
+  struct LoadResult
+  {
+    QString parsingError;
+    // If not -1, the frame in which a block outside of the "frame" was found
+    int blockOutsideOfFrameIdx {-1};
+  };
+
+  // Load the statistics with frameIdx/type from the given file and put them into the given cache.
+  // This is called for the current frame (reading from the item's file into statSource.statsCache) and from
+  // the caching threads (each reading from its own file handle). So it must not change any other state of the item.
+  // Problems are reported in result and the caller merges them into the item using mergeLoadResult().
+  // The index of the frame positions in the file must only be read while holding indexLock for reading.
+  virtual void loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result) = 0;
+  // Set parsingError and blockOutsideOfFrame_idx from the result (if they are not set yet)
+  void mergeLoadResult(const LoadResult &result);
+  // Reset parsingError and blockOutsideOfFrame_idx (when the source is reloaded)
+  void resetLoadResult();
+
   // The statistics source
   statisticHandler statSource;
 
@@ -107,6 +146,18 @@ protected:
   QBasicTimer timer;
   virtual void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE; // Overloaded from QObject. Called when the timer fires.
 
+  // Restore the header (types, frame size and rate) and the index of the file from the index cache instead
+  // of parsing the whole file again. On success, the caller takes the POC/type start positions from the index.
+  bool loadIndexFromCache(StatisticsIndexCache::Index &index);
+  // Remember the state of the file and the header. Call this after reading the header and before starting the background parser.
+  void prepareIndexForCache();
+  // Save the start positions that the background parser found (together with the header) to the index cache.
+  void saveIndexToCache(const QMap<int, QMap<int, qint64>> &pocTypeStartList, const QMap<int, qint64> &pocStartList);
+  StatisticsIndexCache::FileState indexFileState;
+  StatisticsIndexCache::Index indexForCache;
+  // Was the index of the file loaded from the index cache?
+  bool indexLoadedFromCache;
+
   // Set if the file is sorted by POC and the types are 'random' within this POC (true)
   // or if the file is sorted by typeID and the POC is 'random'
   bool fileSortedByPOC;
@@ -117,8 +168,17 @@ protected:
 
   // If an error occurred while parsing, this error text will be set and can be shown
   QString parsingError;
+  // Guards parsingError and blockOutsideOfFrame_idx which are also set from the caching threads
+  mutable QMutex loadResultMutex;
+  // Guards the index of the frame positions in the file (in the derived classes). The caching threads read it
+  // while the index is replaced when the source is reloaded.
+  mutable QReadWriteLock indexLock;
 
   FileSource file;
 
   int currentDrawnFrameIdx;
+
+protected slots:
+  //! Load the statistics with frameIdx/type from file and put it into the statSource.statsCache.
+  void loadStatisticToCache(int frameIdxInternal, int typeID);
 };
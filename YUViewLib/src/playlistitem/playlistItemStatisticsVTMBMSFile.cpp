@@ -33,12 +33,14 @@
 #include "playlistItemStatisticsVTMBMSFile.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <QDebug>
 #include <QtConcurrent>
 #include <QTime>
 
 #include "statistics/statisticsExtensions.h"
+#include "statistics/statisticsParsing.h"
 
 // The internal buffer for parsing the starting positions. The buffer must not be larger than 2GB
 // so that we can address all the positions in it with int (using such a large buffer is not a good
@@ -53,16 +55,22 @@ playlistItemStatisticsVTMBMSFile::playlistItemStatisticsVTMBMSFile(const QString
   if (!file.isOk())
     return;
 
+  // If the file was parsed before and did not change, the index is restored from the index cache
+  StatisticsIndexCache::Index index;
+  if (loadIndexFromCache(index))
+  {
+    pocStartList = index.pocStartList;
+    return;
+  }
+
   // Read the statistics file header
   readHeaderFromFile();
+  prepareIndexForCache();
 
   // Run the parsing of the file in the background
   cancelBackgroundParser = false;
   timer.start(1000, this);
   backgroundParserFuture = QtConcurrent::run(this, &playlistItemStatisticsVTMBMSFile::readFramePositionsFromFile);
-
-  connect(&statSource, &statisticHandler::updateItem, [this](bool redraw){ emit signalItemChanged(redraw, RECACHE_NONE); });
-  connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemStatisticsVTMBMSFile::loadStatisticToCache, Qt::DirectConnection);
 }
 
 /** The background task that parses the file and extracts the exact file positions
@@ -179,21 +187,25 @@ void playlistItemStatisticsVTMBMSFile::readFramePositionsFromFile()
     // Parsing complete
     backgroundParserProgress = 100.0;
 
+    // Save the index so that the file does not have to be parsed again the next time it is opened
+    saveIndexToCache(QMap<int, QMap<int, qint64>>(), pocStartList);
+
+    // Now that all frame positions are known, the statistics can be cached.
     setStartEndFrame(indexRange(0, maxPOC), false);
-    emit signalItemChanged(false, RECACHE_NONE);
+    emit signalItemChanged(false, RECACHE_UPDATE);
 
   } // try
   catch (const char *str)
   {
     std::cerr << "Error while parsing meta data: " << str << "\n";
-    parsingError = QString("Error while parsing meta data: ") + QString(str);
+    mergeLoadResult({QString("Error while parsing meta data: ") + QString(str), -1});
     emit signalItemChanged(false, RECACHE_NONE);
     return;
   }
   catch (const std::exception& ex)
   {
     std::cerr << "Error while parsing:" << ex.what() << "\n";
-    parsingError = QString("Error while parsing: ") + QString(ex.what());
+    mergeLoadResult({QString("Error while parsing: ") + QString(ex.what()), -1});
     emit signalItemChanged(false, RECACHE_NONE);
     return;
   }
@@ -360,212 +372,134 @@ void playlistItemStatisticsVTMBMSFile::readHeaderFromFile()
   return;
 }
 
-void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal, int typeID)
+void playlistItemStatisticsVTMBMSFile::loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result)
 {
   try
   {
     if (!file.isOk())
       return;
 
-    QTextStream in(file.getQFile());
-
-    if (!pocStartList.contains(frameIdxInternal))
+    qint64 startPos;
     {
-      // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
-      return;
+      QReadLocker indexLocker(&indexLock);
+      const auto pocIt = pocStartList.constFind(frameIdxInternal);
+      if (pocIt == pocStartList.constEnd())
+      {
+        // There are no statistics in the file for the given frame and index.
+        cache.insert(typeID, statisticsData());
+        return;
+      }
+      startPos = pocIt.value();
     }
 
-
-    qint64 startPos = pocStartList[frameIdxInternal];
-
-    // fast forward
-    in.seek(startPos);
-
-    QRegularExpression pocRegex("BlockStat: POC ([0-9]+)");
-
-    // prepare regex for selected type
     StatisticsType *aType = statSource.getStatisticsType(typeID);
     Q_ASSERT_X(aType != nullptr, Q_FUNC_INFO, "Stat type not found.");
-    QRegularExpression typeRegex(" " + aType->typeName + "="); // for catching lines of the type
+    // for catching lines of the type
+    const QByteArray typeName = aType->typeName.toLatin1();
+    const QByteArray typeNameMatch = " " + typeName + "=";
 
-    // for extracting scalar value statistics, need to match:
+    // Parse the lines directly from the file (without creating strings). The lines look like this:
     // BlockStat: POC 1 @( 112,  88) [ 8x 8] PredMode=0
-    QRegularExpression scalarRegex("POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+=([0-9\\-]+)");
-    // for extracting vector value statistics, need to match:
     // BlockStat: POC 1 @( 120,  80) [ 8x 8] MVL0={ -24,  -2}
-    QRegularExpression vectorRegex("POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+={ *([0-9\\-]+), *([0-9\\-]+)}");
-    // for extracting affine transform value statistics, need to match:
     // BlockStat: POC 2 @( 192,  96) [64x32] AffineMVL0={-324,-116,-276,-116,-324, -92}
-    QRegularExpression affineTFRegex("POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+={ *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+)}");
-    // for extracting scalar polygon  statistics, need to match:
-    // BlockStat: POC 2 @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=0
-    // BlockStat: POC 2 @[(416, 448)--(447, 448)--(447, 478)--(416, 463)--] GeoPUInterIntraFlag=0
-    // will capture 3-5 points. other polygons are not supported
-    QRegularExpression scalarPolygonRegex("POC ([0-9]+) @\\[((?:\\( *[0-9]+, *[0-9]+\\)--){3,5})\\] *\\w+=([0-9\\-]+)");
-    // for extracting vector polygon statistics:
-    QRegularExpression vectorPolygonRegex("POC ([0-9]+) @\\[((?:\\( *[0-9]+, *[0-9]+\\)--){3,5})\\] *\\w+={ *([0-9\\-]+), *([0-9\\-]+)}");
-    // for extracting the partitioning line, we extract
     // BlockStat: POC 2 @( 192,  96) [64x32] Line={0,0,31,31}
-    QRegularExpression lineRegex("POC ([0-9]+) @\\( *([0-9]+), *([0-9]+)\\) *\\[ *([0-9]+)x *([0-9]+)\\] *\\w+={ *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+), *([0-9\\-]+)}");
+    // BlockStat: POC 2 @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=0
+    // For polygons, 3-5 points are supported.
+    StatisticsParsing::FileLineReader reader(srcFile, startPos);
+    StatisticsParsing::VTMBMSLine statLine;
+    const char *lineBegin, *lineEnd;
 
-    while (!in.atEnd())
+    while (reader.readLine(lineBegin, lineEnd))
     {
-      // read one line
-      QString aLine = in.readLine();
-
-
-      QRegularExpressionMatch pocMatch = pocRegex.match(aLine);
+      int poc;
       // ignore not matching lines
-      if (pocMatch.hasMatch())
+      if (!StatisticsParsing::parseVTMBMSPoc(lineBegin, lineEnd, poc))
+        continue;
+      // if there is a new POC, we are done here!
+      if (poc != frameIdxInternal)
+        break;
+
+      const bool lineParsed = StatisticsParsing::parseVTMBMSLine(lineBegin, lineEnd, statLine);
+
+      // filter lines of different types
+      const int typeNameLength = int(statLine.typeNameEnd - statLine.typeNameBegin);
+      if (lineParsed && (typeNameLength != typeName.size() || memcmp(statLine.typeNameBegin, typeName.constData(), typeNameLength) != 0))
+        continue;
+      if (!lineParsed && !QByteArray::fromRawData(lineBegin, int(lineEnd - lineBegin)).contains(typeNameMatch))
+        continue;
+
+      // Check if the values match the type
+      bool statisticMatch = false;
+      if (lineParsed && statLine.isPolygon == aType->isPolygon)
       {
-        int poc = pocMatch.captured(1).toInt();
-        if (poc != frameIdxInternal)
-        {
-          break;
-        }
-
-        // filter lines of different types
-        QRegularExpressionMatch typeMatch = typeRegex.match(aLine);
-        if (typeMatch.hasMatch())
-        {
-          int poc, posX, posY, width, height, scalar, vecX, vecY;
-
-          QRegularExpressionMatch statisitcMatch;
-          // extract statistics info
-          // try block types
-          if (aType->isPolygon == false)
-          {
-            if (aType->hasValueData)
-            {
-              statisitcMatch = scalarRegex.match(aLine);
-            }
-            else if (aType->hasVectorData)
-            {
-              statisitcMatch = vectorRegex.match(aLine);
-              if (!statisitcMatch.hasMatch())
-              {
-                statisitcMatch = lineRegex.match(aLine);
-              }
-            }
-            else if (aType->hasAffineTFData)
-            {
-              statisitcMatch = affineTFRegex.match(aLine);
-            }
-          }
-          else
-          // try polygons
-          {
-            if (aType->hasValueData)
-            {
-              statisitcMatch = scalarPolygonRegex.match(aLine);
-            }
-            else if (aType->hasVectorData)
-            {
-              statisitcMatch = vectorPolygonRegex.match(aLine);
-            }
-          }
-          if (!statisitcMatch.hasMatch())
-          {
-            parsingError = QString("Error while parsing statistic: ") + QString(aLine);
-            continue;
-          }
-
-          // useful for debugging:
-  //        QStringList all_captured = statisitcMatch.capturedTexts();
+        if (aType->hasValueData)
+          statisticMatch = !statLine.valueInBraces;
+        else if (aType->hasVectorData)
+          statisticMatch = statLine.valueInBraces && (statLine.nrValues == 2 || (!aType->isPolygon && statLine.nrValues == 4));
+        else if (aType->hasAffineTFData)
+          statisticMatch = !aType->isPolygon && statLine.valueInBraces && statLine.nrValues == 6;
+      }
+      if (!statisticMatch)
+      {
+        result.parsingError = QString("Error while parsing statistic: ") + QString::fromLatin1(lineBegin, int(lineEnd - lineBegin));
+        continue;
+      }
 
-          poc = statisitcMatch.captured(1).toInt();
-          width = statisitcMatch.captured(4).toInt();
-          height = statisitcMatch.captured(5).toInt();
-          // if there is a new POC, we are done here!
-          if (poc != frameIdxInternal)
-            break;
+      const int *values = statLine.values;
 
-          // process block statistics
-          if (aType->isPolygon == false)
-          {
-            posX = statisitcMatch.captured(2).toInt();
-            posY = statisitcMatch.captured(3).toInt();
+      // process block statistics
+      if (aType->isPolygon == false)
+      {
+        int posX = statLine.posX;
+        int posY = statLine.posY;
+        int width = statLine.width;
+        int height = statLine.height;
 
-            // Check if block is within the image range
-            if (blockOutsideOfFrame_idx == -1 && (posX + width > statSource.getFrameSize().width() || posY + height > statSource.getFrameSize().height()))
-              // Block not in image. Warn about this.
-              blockOutsideOfFrame_idx = frameIdxInternal;
+        // Check if block is within the image range
+        if (result.blockOutsideOfFrameIdx == -1 && (posX + width > statSource.getFrameSize().width() || posY + height > statSource.getFrameSize().height()))
+          // Block not in image. Warn about this.
+          result.blockOutsideOfFrameIdx = frameIdxInternal;
 
-            if (aType->hasVectorData)
-            {
-              vecX = statisitcMatch.captured(6).toInt();
-              vecY = statisitcMatch.captured(7).toInt();
-              if (statisitcMatch.lastCapturedIndex()>7)
-              {
-                int vecX1 = statisitcMatch.captured(8).toInt();
-                int vecY1 = statisitcMatch.captured(9).toInt();
-                statSource.statsCache[typeID].addLine(posX, posY, width, height, vecX, vecY,vecX1,vecY1);
-              }
-              else
-              {
-                statSource.statsCache[typeID].addBlockVector(posX, posY, width, height, vecX, vecY);
-              }
-            }
-            else if (aType->hasAffineTFData)
-            {
-              int vecX0 = statisitcMatch.captured(6).toInt();
-              int vecY0 = statisitcMatch.captured(7).toInt();
-              int vecX1 = statisitcMatch.captured(8).toInt();
-              int vecY1 = statisitcMatch.captured(9).toInt();
-              int vecX2 = statisitcMatch.captured(10).toInt();
-              int vecY2 = statisitcMatch.captured(11).toInt();
-              statSource.statsCache[typeID].addBlockAffineTF(posX, posY, width, height, vecX0, vecY0, vecX1, vecY1, vecX2, vecY2);
-            }
-            else
-            {
-              scalar = statisitcMatch.captured(6).toInt();
-              statSource.statsCache[typeID].addBlockValue(posX, posY, width, height, scalar);
-            }
-          }
+        if (aType->hasVectorData)
+        {
+          if (statLine.nrValues == 4)
+            cache[typeID].addLine(posX, posY, width, height, values[0], values[1], values[2], values[3]);
           else
-          // process polygon statistics
-          {
-            QString corners = statisitcMatch.captured(2);
-            QStringList cornerList = corners.split("--");
-            QRegularExpression cornerRegex("\\( *([0-9]+), *([0-9]+)\\)");
-            QVector<QPoint> points;
-            for (const auto &corner : cornerList)
-            {
-              QRegularExpressionMatch cornerMatch = cornerRegex.match(corner);
-              if( cornerMatch.hasMatch())
-              {
-                int x = cornerMatch.captured(1).toInt();
-                int y = cornerMatch.captured(2).toInt();
-                points << QPoint(x,y);
-
-                // Check if polygon is within the image range
-                if (blockOutsideOfFrame_idx == -1 && (x + width > statSource.getFrameSize().width() || y + height > statSource.getFrameSize().height()))
-                  // Block not in image. Warn about this.
-                  blockOutsideOfFrame_idx = frameIdxInternal;
-              }
-            }
-
-            if (aType->hasVectorData)
-            {
-              vecX = statisitcMatch.captured(3).toInt();
-              vecY = statisitcMatch.captured(4).toInt();
-              statSource.statsCache[typeID].addPolygonVector(points, vecX, vecY);
-            }
-            else if(aType->hasValueData)
-            {
-              scalar = statisitcMatch.captured(3).toInt();
-              statSource.statsCache[typeID].addPolygonValue(points, scalar);
-            }
-          }
+            cache[typeID].addBlockVector(posX, posY, width, height, values[0], values[1]);
+        }
+        else if (aType->hasAffineTFData)
+          cache[typeID].addBlockAffineTF(posX, posY, width, height, values[0], values[1], values[2], values[3], values[4], values[5]);
+        else
+          cache[typeID].addBlockValue(posX, posY, width, height, values[0]);
+      }
+      else
+      // process polygon statistics
+      {
+        QVector<QPoint> points;
+        points.reserve(statLine.nrCorners);
+        for (int i = 0; i < statLine.nrCorners; i++)
+        {
+          int x = statLine.cornerX[i];
+          int y = statLine.cornerY[i];
+          points << QPoint(x, y);
+
+          // Check if polygon is within the image range
+          if (result.blockOutsideOfFrameIdx == -1 && (x > statSource.getFrameSize().width() || y > statSource.getFrameSize().height()))
+            // Block not in image. Warn about this.
+            result.blockOutsideOfFrameIdx = frameIdxInternal;
         }
+
+        if (aType->hasVectorData)
+          cache[typeID].addPolygonVector(points, values[0], values[1]);
+        else if (aType->hasValueData)
+          cache[typeID].addPolygonValue(points, values[0]);
       }
     }
 
-    if(!statSource.statsCache.contains(typeID))
+    if(!cache.contains(typeID))
     {
       // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
+      cache.insert(typeID, statisticsData());
       return;
     }
 
@@ -573,13 +507,13 @@ void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal
   catch (const char *str)
   {
     std::cerr << "Error while parsing: " << str << '\n';
-    parsingError = QString("Error while parsing meta data: ") + QString(str);
+    result.parsingError = QString("Error while parsing meta data: ") + QString(str);
     return;
   }
   catch (...)
   {
     std::cerr << "Error while parsing.";
-    parsingError = QString("Error while parsing meta data.");
+    result.parsingError = QString("Error while parsing meta data.");
     return;
   }
 
@@ -619,9 +553,8 @@ void playlistItemStatisticsVTMBMSFile::reloadItemSource()
 {
   // Set default variables
   fileSortedByPOC = false;
-  blockOutsideOfFrame_idx = -1;
+  resetLoadResult();
   backgroundParserProgress = 0.0;
-  parsingError.clear();
   currentDrawnFrameIdx = -1;
   maxPOC = 0;
 
@@ -633,18 +566,34 @@ void playlistItemStatisticsVTMBMSFile::reloadItemSource()
     backgroundParserFuture.waitForFinished();
   }
 
-  // Clear the parsed data
+  // Clear the parsed data. Caching threads may still be reading the index.
+  indexLock.lockForWrite();
   pocStartList.clear();
+  indexLock.unlock();
   statSource.statsCache.clear();
   statSource.statsCacheFrameIdx = -1;
+  statSource.removeAllFramesFromCache();
 
   // Reopen the file
   file.openFile(plItemNameOrFileName);
   if (!file.isOk())
     return;
 
+  // Restore the index from the index cache (if the file changed, the cached index is not valid anymore)
+  StatisticsIndexCache::Index index;
+  if (loadIndexFromCache(index))
+  {
+    indexLock.lockForWrite();
+    pocStartList = index.pocStartList;
+    indexLock.unlock();
+    statSource.updateStatisticsHandlerControls();
+    emit signalItemChanged(false, RECACHE_UPDATE);
+    return;
+  }
+
   // Read the new statistics file header
   readHeaderFromFile();
+  prepareIndexForCache();
 
   statSource.updateStatisticsHandlerControls();
 
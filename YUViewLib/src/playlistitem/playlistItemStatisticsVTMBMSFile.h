@@ -66,11 +66,12 @@ public:
 
   // ----- Detection of source/file change events -----
   virtual void reloadItemSource() Q_DECL_OVERRIDE;
-public slots:
+
+protected:
   //! Load the statistics with frameIdx/type from file and put it into the cache.
   //! If the statistics file is in an interleaved format (types are mixed within one POC) this function also parses
   //! types which were not requested by the given 'type'.
-  void loadStatisticToCache(int frameIdxInternal, int type);
+  void loadStatisticData(QFile *srcFile, int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache, LoadResult &result) Q_DECL_OVERRIDE;
 
 private:
 
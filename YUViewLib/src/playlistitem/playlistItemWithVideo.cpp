@@ -32,6 +32,9 @@
 
 #include "playlistItemWithVideo.h"
 
+#include <QSettings>
+#include <algorithm>
+
 using namespace YUView;
 
 // Activate this if you want to know when which buffer is loaded/converted to image and so on.
@@ -42,6 +45,10 @@ using namespace YUView;
 #define DEBUG_PLVIDEO(fmt,...) ((void)0)
 #endif
 
+// The double buffer of an item may use this fraction of the cache size (but it always holds at least one frame).
+// The video cache counts the frames in the double buffer against the cache size (see getBufferedFramesSize()).
+#define DOUBLE_BUFFER_CACHE_FRACTION 8
+
 playlistItemWithVideo::playlistItemWithVideo(const QString &itemNameOrFileName, playlistItemType type)
  : playlistItem(itemNameOrFileName, type)
 {
@@ -57,6 +64,54 @@ void playlistItemWithVideo::connectVideo()
 {
   // Forward these signals from the video source up
   connect(video.data(), &videoHandler::signalHandlerChanged, this, &playlistItem::signalItemChanged);
+
+  playlistItemWithVideo::updateSettings();
+}
+
+void playlistItemWithVideo::updateSettings()
+{
+  if (!video)
+    return;
+
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  video->setDoubleBufferDepth(settings.value("PlaybackDoubleBufferFrames", 4).toInt());
+  const int64_t cacheSize = int64_t(settings.value("ThresholdValueMB", 49).toUInt()) * 1000 * 1000;
+  settings.endGroup();
+  video->setDoubleBufferMaxSize(cacheSize / DOUBLE_BUFFER_CACHE_FRACTION);
+}
+
+void playlistItemWithVideo::loadDoubleBuffer(int frameIdxInternal, bool emitSignals)
+{
+  const int lastFrameIdx = std::min(frameIdxInternal + video->getDoubleBufferDepth(), startEndFrame.second);
+  // Frames that are not ahead of the given frame are not needed anymore (e.g. if playback jumped)
+  video->removeFramesFromDoubleBufferOutside(frameIdxInternal + 1, lastFrameIdx);
+
+  for (int nextFrameIdx = frameIdxInternal + 1; nextFrameIdx <= lastFrameIdx; nextFrameIdx++)
+  {
+    if (doubleBufferLoadingInterrupted)
+    {
+      // Playback stopped or the next loading request is waiting for this one. It continues to fill the double buffer.
+      DEBUG_PLVIDEO("playlistItemWithVideo::loadDoubleBuffer interrupted before frame %d", nextFrameIdx);
+      break;
+    }
+    if (video->isFrameReady(nextFrameIdx))
+      continue;
+    if (video->isDoubleBufferFull())
+      // The double buffer can not hold more frames
+      break;
+
+    DEBUG_PLVIDEO("playlistItemWithVideo::loadDoubleBuffer loading frame into double buffer %d", nextFrameIdx);
+    isFrameLoadingDoubleBuffer = true;
+    video->loadFrame(nextFrameIdx, true);
+    isFrameLoadingDoubleBuffer = false;
+    if (!video->isFrameReady(nextFrameIdx))
+      // Loading failed
+      break;
+    // Playback may be waiting for this frame
+    if (emitSignals)
+      emit signalItemDoubleBufferLoaded();
+  }
 }
 
 void playlistItemWithVideo::drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues)
@@ -90,19 +145,8 @@ void playlistItemWithVideo::loadFrame(int frameIdx, bool playing, bool loadRawDa
   }
   
   if (playing && (state == LoadingNeeded || state == LoadingNeededDoubleBuffer))
-  {
-    // Load the next frame into the double buffer
-    int nextFrameIdx = frameIdxInternal + 1;
-    if (nextFrameIdx <= startEndFrame.second)
-    {
-      DEBUG_PLVIDEO("playlistItemWithVideo::loadFrame loading frame into double buffer %d%s%s", nextFrameIdx, playing ? " playing" : "", loadRawData ? " raw" : "");
-      isFrameLoadingDoubleBuffer = true;
-      video->loadFrame(nextFrameIdx, true);
-      isFrameLoadingDoubleBuffer = false;
-      if (emitSignals)
-        emit signalItemDoubleBufferLoaded();
-    }
-  }
+    // Load the next frames into the double buffer
+    loadDoubleBuffer(frameIdxInternal, emitSignals);
 }
 
 itemLoadingState playlistItemWithVideo::needsLoading(int frameIdx, bool loadRawValues)
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "playlistItem.h"
 #include "video/videoHandlerRGB.h"
 #include "video/videoHandlerYUV.h"
@@ -51,15 +53,15 @@ public:
   // All the functions that we have to overload if we are using a video handler
   virtual QSize getSize() const Q_DECL_OVERRIDE { return (video) ? video->getFrameSize() : QSize(); }
   virtual frameHandler *getFrameHandler() Q_DECL_OVERRIDE { return video.data(); }
-  // Activate the double buffer (set it as current frame)
-  virtual void activateDoubleBuffer() Q_DECL_OVERRIDE { if (video) video->activateDoubleBuffer(); }
+  // Activate the frame from the double buffer (set it as current frame)
+  virtual void activateDoubleBuffer(int frameIdx) Q_DECL_OVERRIDE { if (video) video->activateDoubleBuffer(getFrameIdxInternal(frameIdx)); }
 
   // Do we need to load the frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawValues) Q_DECL_OVERRIDE;
 
   // -- Caching
   // Cache the given frame
-  virtual void cacheFrame(int frameIdx, bool testMode) Q_DECL_OVERRIDE { if (!cachingEnabled || unresolvableError) return; video->cacheFrame(getFrameIdxInternal(frameIdx), testMode); }
+  virtual void cacheFrame(int frameIdx, bool testMode, indexRange jobRange) Q_DECL_OVERRIDE { Q_UNUSED(jobRange); if (!cachingEnabled || unresolvableError) return; video->cacheFrame(getFrameIdxInternal(frameIdx), testMode); }
   // Get a list of all cached frames (just the frame indices)
   virtual QList<int> getCachedFrames() const Q_DECL_OVERRIDE;
   virtual int getNumberCachedFrames() const Q_DECL_OVERRIDE { return unresolvableError ? 0 : video->getNumberCachedFrames(); }
@@ -68,6 +70,8 @@ public:
   // Remove the given frame from the cache
   virtual void removeFrameFromCache(int idx) Q_DECL_OVERRIDE { if (video) video->removeFrameFromCache(getFrameIdxInternal(idx)); }
   virtual void removeAllFramesFromCache() Q_DECL_OVERRIDE { if (video) video->removeAllFrameFromCache(); }
+  // The frames in the double buffer are counted against the cache size
+  virtual int64_t getBufferedFramesSize() const Q_DECL_OVERRIDE { return video ? video->getDoubleBufferSizeInBytes() : 0; }
   // This item is cachable, if caching is enabled and if the raw format is valid (can be cached).
   virtual bool isCachable() const Q_DECL_OVERRIDE { return !unresolvableError && playlistItem::isCachable() && video->isFormatValid(); }
 
@@ -77,6 +81,10 @@ public:
   // Is an image currently being loaded?
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isFrameLoading; }
   virtual bool isLoadingDoubleBuffer() const Q_DECL_OVERRIDE { return isFrameLoadingDoubleBuffer; }
+  virtual void setDoubleBufferLoadingInterrupted(bool interrupted) Q_DECL_OVERRIDE { doubleBufferLoadingInterrupted = interrupted; }
+
+  // Update the number of frames and the memory that the double buffer may use during playback from the settings
+  virtual void updateSettings() Q_DECL_OVERRIDE;
 
 protected:
   // A pointer to the videHandler. In the derived class, don't foret to set this.
@@ -93,9 +101,14 @@ protected:
   // Connect the basic signals from the video
   void connectVideo();
 
+  // During playback, load the frames after the given frame (up to the depth and size limit of the double buffer) into
+  // the double buffer. Frames that are cached are not loaded again. Loading stops when it is interrupted.
+  void loadDoubleBuffer(int frameIdxInternal, bool emitSignals);
+
   // Is the loadFrame function currently loading?
   bool isFrameLoading;
   bool isFrameLoadingDoubleBuffer;
+  std::atomic_bool doubleBufferLoadingInterrupted {false};
 
   // Set if an unresolvable error occurred. In this case, we just draw an error text.
   bool unresolvableError;
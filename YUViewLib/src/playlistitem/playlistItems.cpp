@@ -47,6 +47,7 @@ namespace playlistItems
     playlistItemImageFile::getSupportedFileExtensions(allExtensions, filtersList);
     playlistItemStatisticsCSVFile::getSupportedFileExtensions(allExtensions, filtersList);
     playlistItemStatisticsVTMBMSFile::getSupportedFileExtensions(allExtensions, filtersList);
+    playlistItemStatisticsBinaryFile::getSupportedFileExtensions(allExtensions, filtersList);
 
     // Append the filter for playlist files
     allExtensions.append("yuvplaylist");
@@ -78,6 +79,7 @@ namespace playlistItems
     playlistItemImageFile::getSupportedFileExtensions(allExtensions, filtersList);
     playlistItemStatisticsCSVFile::getSupportedFileExtensions(allExtensions, filtersList);
     playlistItemStatisticsVTMBMSFile::getSupportedFileExtensions(allExtensions, filtersList);
+    playlistItemStatisticsBinaryFile::getSupportedFileExtensions(allExtensions, filtersList);
 
     // Append the filter for playlist files
       allExtensions.append("yuvplaylist");
@@ -181,8 +183,20 @@ namespace playlistItems
       }
     }
 
+    // Check playlistItemStatisticsBinaryFile
+    {
+      QStringList allExtensions, filtersList;
+      playlistItemStatisticsBinaryFile::getSupportedFileExtensions(allExtensions, filtersList);
+
+      if (allExtensions.contains(ext))
+      {
+        playlistItemStatisticsBinaryFile *newStatFile = new playlistItemStatisticsBinaryFile(fileName);
+        return newStatFile;
+      }
+    }
+
     // Unknown file type extension. Ask the user as what file type he wants to open this file.
-    QStringList types = QStringList() << "Raw YUV File" << "Raw RGB File" << "Compressed file" << "Statistics File CSV" << "Statistics File VTMBMS";
+    QStringList types = QStringList() << "Raw YUV File" << "Raw RGB File" << "Compressed file" << "Statistics File CSV" << "Statistics File VTMBMS" << "Binary Statistics File";
     bool ok;
     QString asType = QInputDialog::getItem(parent, "Select file type", "The file type could not be determined from the file extension. Please select the type of the file.", types, 0, false, &ok);
     if (ok && !asType.isEmpty())
@@ -212,6 +226,12 @@ namespace playlistItems
         playlistItemStatisticsVTMBMSFile *newStatFile = new playlistItemStatisticsVTMBMSFile(fileName);
         return newStatFile;
       }
+      else if (asType == types[5])
+      {
+        // Binary Statistics File
+        playlistItemStatisticsBinaryFile *newStatFile = new playlistItemStatisticsBinaryFile(fileName);
+        return newStatFile;
+      }
     }
 
     return nullptr;
@@ -246,6 +266,11 @@ namespace playlistItems
       // Load the playlistItemVTMBMSStatisticsFile
       newItem = playlistItemStatisticsVTMBMSFile::newplaylistItemStatisticsVTMBMSFile(elem, filePath);
     }
+    else if (elem.tagName() == "playlistItemStatisticsBinaryFile")
+    {
+      // Load the playlistItemStatisticsBinaryFile
+      newItem = playlistItemStatisticsBinaryFile::newplaylistItemStatisticsBinaryFile(elem, filePath);
+    }
     else if (elem.tagName() == "playlistItemText")
     {
       // This is a playlistItemText. Load it from file.
@@ -32,6 +32,7 @@
 
 #include "statisticHandler.h"
 
+#include <algorithm>
 #include <cmath>
 #include <QPainter>
 #include <QtGlobal>
@@ -74,6 +75,13 @@ itemLoadingState statisticHandler::needsLoading(int frameIdx)
 {
   if (frameIdx != statsCacheFrameIdx)
   {
+    // New frame. If it was cached in the background, it can be drawn right away.
+    if (isInCache(frameIdx))
+    {
+      DEBUG_STAT("statisticHandler::needsLoading %d found in cache", frameIdx);
+      return LoadingNotNeeded;
+    }
+
     // New frame, but do we even render any statistics?
     for (StatisticsType t : statsTypeList)
       if(t.render)
@@ -112,8 +120,11 @@ void statisticHandler::loadStatistics(int frameIdx)
 
   QMutexLocker lock(&statsCacheAccessMutex);
   if (frameIdx != statsCacheFrameIdx)
-    // New frame to draw. Clear the cache.
-    statsCache.clear();
+  {
+    // New frame to draw. Start with what was cached for the frame in the background (if anything). Otherwise clear the cache.
+    if (!loadStatisticsFromFrameCache(frameIdx))
+      statsCache.clear();
+  }
 
   // Request all the data for the statistics (that were not already loaded to the local cache)
   int statTypeRenderCount = 0;
@@ -136,9 +147,13 @@ void statisticHandler::loadStatistics(int frameIdx)
 void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double zoomFactor)
 {
   if (statsCacheFrameIdx != frameIdx)
-    // If the internal statistics cache is not up to date, do not display the statistics.
-    // The statistics for the new frame index should be loading the background.
-    return;
+  {
+    // If the internal statistics cache is not up to date, see if the frame was cached in the background.
+    // If not, do not display the statistics. The statistics for the new frame index should be loading the background.
+    QMutexLocker lock(&statsCacheAccessMutex);
+    if (!loadStatisticsFromFrameCache(frameIdx))
+      return;
+  }
 
   // Save the state of the painter. This is restored when the function is done.
   painter->save();
@@ -1131,6 +1146,7 @@ QWidget *statisticHandler::getSecondaryStatisticsHandlerControls(bool recreateCo
 // further signals and of course update the statsTypeList to render the stats correctly.
 void statisticHandler::onStatisticsControlChanged()
 {
+  const QList<int> renderedTypesBefore = getRenderedTypeIDs();
   for (int row = 0; row < statsTypeList.length(); ++row)
   {
     // Get the values of the statistics type from the controls
@@ -1160,13 +1176,14 @@ void statisticHandler::onStatisticsControlChanged()
     }
   }
 
-  emit updateItem(true);
+  emitUpdateItem(renderedTypesBefore);
 }
 
 // One of the secondary controls changed. Perform the inverse thing to onStatisticsControlChanged(). Update the primary
 // controls without emitting further signals and of course update the statsTypeList to render the stats correctly.
 void statisticHandler::onSecondaryStatisticsControlChanged()
 {
+  const QList<int> renderedTypesBefore = getRenderedTypeIDs();
   for (int row = 0; row < statsTypeList.length(); ++row)
   {
     // Get the values of the statistics type from the controls
@@ -1192,6 +1209,21 @@ void statisticHandler::onSecondaryStatisticsControlChanged()
     }
   }
 
+  emitUpdateItem(renderedTypesBefore);
+}
+
+void statisticHandler::emitUpdateItem(const QList<int> &renderedTypesBefore)
+{
+  for (int typeID : getRenderedTypeIDs())
+  {
+    if (!renderedTypesBefore.contains(typeID))
+    {
+      // This type was not rendered before so the frames in the cache do not contain it.
+      emit updateItem(true, RECACHE_CLEAR);
+      return;
+    }
+  }
+
   emit updateItem(true);
 }
 
@@ -1370,6 +1402,104 @@ void statisticHandler::clearStatTypes()
   statsTypeList.clear();
 }
 
+QList<int> statisticHandler::getRenderedTypeIDs() const
+{
+  QList<int> typeIDs;
+  for (const StatisticsType &t : statsTypeList)
+    if (t.render)
+      typeIDs.append(t.typeID);
+  return typeIDs;
+}
+
+// Get the number of bytes that the statistics of one frame occupy in memory
+static int64_t getFrameStatisticsSize(const QHash<int, statisticsData> &frameStatistics)
+{
+  int64_t size = 0;
+  for (const statisticsData &data : frameStatistics)
+    size += data.getMemorySize();
+  return size;
+}
+
+bool statisticHandler::loadStatisticsFromFrameCache(int frameIdx)
+{
+  QMutexLocker lock(&statsFrameCacheAccess);
+  auto it = statsFrameCache.constFind(frameIdx);
+  if (it == statsFrameCache.constEnd())
+    return false;
+
+  DEBUG_STAT("statisticHandler::loadStatisticsFromFrameCache frame %d", frameIdx);
+  statsCache = it.value();
+  statsCacheFrameIdx = frameIdx;
+  return true;
+}
+
+void statisticHandler::addFrameToCache(int frameIdx, const QHash<int, statisticsData> &frameStatistics)
+{
+  DEBUG_STAT("statisticHandler::addFrameToCache frame %d", frameIdx);
+  QMutexLocker lock(&statsFrameCacheAccess);
+  if (statsFrameCache.contains(frameIdx))
+    statsFrameCacheBytes -= getFrameStatisticsSize(statsFrameCache[frameIdx]);
+  statsFrameCache.insert(frameIdx, frameStatistics);
+  statsFrameCacheBytes += getFrameStatisticsSize(frameStatistics);
+}
+
+bool statisticHandler::isInCache(int frameIdx) const
+{
+  const QList<int> renderedTypes = getRenderedTypeIDs();
+
+  QMutexLocker lock(&statsFrameCacheAccess);
+  auto it = statsFrameCache.constFind(frameIdx);
+  if (it == statsFrameCache.constEnd())
+    return false;
+  for (int typeID : renderedTypes)
+    if (!it.value().contains(typeID))
+      return false;
+  return true;
+}
+
+QList<int> statisticHandler::getCachedFrames() const
+{
+  QMutexLocker lock(&statsFrameCacheAccess);
+  return statsFrameCache.keys();
+}
+
+int statisticHandler::getNumberCachedFrames() const
+{
+  QMutexLocker lock(&statsFrameCacheAccess);
+  return statsFrameCache.size();
+}
+
+unsigned int statisticHandler::getCachingFrameSize() const
+{
+  {
+    // Use the average size of the frames in the cache
+    QMutexLocker lock(&statsFrameCacheAccess);
+    if (!statsFrameCache.isEmpty())
+      return (unsigned int)std::max(statsFrameCacheBytes / statsFrameCache.size(), int64_t(1));
+  }
+
+  // Nothing was cached yet. Estimate one value block of 8x8 pixels per rendered statistics type.
+  const int64_t nrTypes = std::max(getRenderedTypeIDs().count(), 1);
+  const int64_t nrBlocks = (statFrameSize.width() / 8) * (statFrameSize.height() / 8);
+  return (unsigned int)std::max(nrBlocks * nrTypes * int64_t(sizeof(statisticsItem_Value)), int64_t(1));
+}
+
+void statisticHandler::removeFrameFromCache(int frameIdx)
+{
+  DEBUG_STAT("statisticHandler::removeFrameFromCache %d", frameIdx);
+  QMutexLocker lock(&statsFrameCacheAccess);
+  if (statsFrameCache.contains(frameIdx))
+    statsFrameCacheBytes -= getFrameStatisticsSize(statsFrameCache.take(frameIdx));
+}
+
+void statisticHandler::removeAllFramesFromCache()
+{
+  DEBUG_STAT("statisticHandler::removeAllFramesFromCache");
+  QMutexLocker lock(&statsFrameCacheAccess);
+  statsFrameCache.clear();
+  statsFrameCacheBytes = 0;
+}
+
 void statisticHandler::onStyleButtonClicked(int id)
 {
   statisticsStyleUI.setStatsItem(&statsTypeList[id]);
@@ -112,12 +112,28 @@ public:
   QHash<int, statisticsData> statsCache; // cache of the statistics for the current POC [statsTypeID]
   int statsCacheFrameIdx;
 
+  // --- Caching ----
+  // Items that provide statistics can cache the statistics of upcoming frames in the background (videoCache).
+  // For each cached frame, the statistics of all types that were rendered at caching time are kept.
+  // These methods are all thread-safe and can be invoked from any thread.
+  void addFrameToCache(int frameIdx, const QHash<int, statisticsData> &frameStatistics);
+  bool isInCache(int frameIdx) const;  // Are all currently rendered types of the frame in the cache?
+  QList<int> getCachedFrames() const;
+  int getNumberCachedFrames() const;
+  unsigned int getCachingFrameSize() const; // How much bytes will (approximately) be used when caching one frame?
+  void removeFrameFromCache(int frameIdx);
+  void removeAllFramesFromCache();
+
+  // Get the IDs of all statistics types that are currently rendered
+  QList<int> getRenderedTypeIDs() const;
+
   // Update the settings. For the statistics this means updating the icons for editing statistic.
   void updateSettings();
 
 signals:
-  // Update the item (and maybe redraw it)
-  void updateItem(bool redraw);
+  // Update the item (and maybe redraw it). If a statistics type that was not rendered before is now
+  // rendered, the cached frames lack this type and recache is set to RECACHE_CLEAR.
+  void updateItem(bool redraw, recacheIndicator recache=RECACHE_NONE);
   // Request to load the statistics for the given frame index/typeIdx into statsCache.
   void requestStatisticsLoading(int frameIdx, int typeIdx);
 
@@ -129,6 +145,18 @@ private:
   // Make sure that nothing is read from the stats cache while it is being changed.
   QMutex statsCacheAccessMutex;
 
+  // The statistics of the frames that were cached in the background [frameIdx][statsTypeID]
+  QMutex mutable statsFrameCacheAccess;
+  QMap<int, QHash<int, statisticsData>> statsFrameCache;
+  int64_t statsFrameCacheBytes {0};
+
+  // Set the statistics for the given frame from the frame cache as the current statistics (statsCache).
+  // Return false if the frame is not in the frame cache. The statsCacheAccessMutex must be locked.
+  bool loadStatisticsFromFrameCache(int frameIdx);
+
+  // Emit updateItem. If a type is rendered now that was not rendered before, the cache must be cleared.
+  void emitUpdateItem(const QList<int> &renderedTypesBefore);
+
   // The list of all statistics that this class can provide (and a backup for updating the list)
   StatisticsTypeList statsTypeList;
   StatisticsTypeList statsTypeListBackup;
@@ -0,0 +1,551 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "statisticsBinaryFormat.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QDataStream>
+#include <QtEndian>
+
+namespace StatisticsBinaryFormat
+{
+
+namespace
+{
+
+const char fileMagic[] = "YUVSTATS";
+const int fileMagicLength = 8;
+const quint32 fileVersion = 1;
+// Magic, version, width, height, frame rate, max POC, nr index entries, type table offset/size, index offset
+const int fileHeaderSize = fileMagicLength + 4 + 4 + 4 + 8 + 4 + 4 + 8 + 8 + 8;
+// POC, typeID, offset, size, uncompressed size
+const int indexEntrySize = 4 + 4 + 8 + 4 + 4;
+// Do not try to compress very small payloads
+const int minCompressionSize = 256;
+
+void setupStream(QDataStream &stream)
+{
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+template<typename T>
+inline void appendValue(QByteArray &data, T value)
+{
+  const T v = qToLittleEndian(value);
+  data.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template<typename T>
+inline T getValue(const char *column, int idx)
+{
+  return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(column) + idx * int(sizeof(T)));
+}
+
+// Provides the columns of the payload one after the other and checks that the payload is big enough
+class ColumnReader
+{
+public:
+  ColumnReader(const char *data, int64_t size) : pos(data), end(data + size) {}
+
+  const char *getColumn(int64_t nrBytes)
+  {
+    if (nrBytes < 0 || end - pos < nrBytes)
+    {
+      ok = false;
+      return nullptr;
+    }
+    const char *column = pos;
+    pos += nrBytes;
+    return column;
+  }
+
+  bool ok {true};
+
+private:
+  const char *pos;
+  const char *end;
+};
+
+// Encode the (x, y, width, height) of blocks as 4 columns
+template<typename T>
+void appendBlockColumns(QByteArray &data, const QVector<T> &items)
+{
+  for (int c = 0; c < 4; c++)
+    for (const T &item : items)
+      appendValue<quint16>(data, (c < 2) ? item.pos[c] : item.size[c - 2]);
+}
+
+template<typename T>
+void appendPolygonColumns(QByteArray &data, const QVector<T> &items)
+{
+  for (const T &item : items)
+    appendValue<quint32>(data, quint32(item.corners.size()));
+  for (const T &item : items)
+    for (const QPoint &p : item.corners)
+    {
+      appendValue<qint32>(data, p.x());
+      appendValue<qint32>(data, p.y());
+    }
+}
+
+bool readPolygonColumns(ColumnReader &reader, int n, QVector<QPolygon> &polygons)
+{
+  const char *nrCornersColumn = reader.getColumn(int64_t(n) * 4);
+  if (!reader.ok)
+    return false;
+  int64_t nrCornersTotal = 0;
+  for (int i = 0; i < n; i++)
+    nrCornersTotal += getValue<quint32>(nrCornersColumn, i);
+  const char *cornerColumn = reader.getColumn(nrCornersTotal * 8);
+  if (!reader.ok)
+    return false;
+
+  polygons.resize(n);
+  int cornerIdx = 0;
+  for (int i = 0; i < n; i++)
+  {
+    const int nrCorners = int(getValue<quint32>(nrCornersColumn, i));
+    polygons[i].resize(nrCorners);
+    for (int j = 0; j < nrCorners; j++, cornerIdx++)
+      polygons[i][j] = QPoint(getValue<qint32>(cornerColumn, cornerIdx * 2), getValue<qint32>(cornerColumn, cornerIdx * 2 + 1));
+  }
+  return true;
+}
+
+} // namespace
+
+void writeStatisticsType(QDataStream &out, const StatisticsType &type)
+{
+  out << qint32(type.typeID) << type.typeName << type.description << type.valMap;
+  out << type.render << qint32(type.alphaFactor);
+
+  out << type.hasValueData << type.renderValueData << type.scaleValueToBlockSize;
+  const colorMapper &mapper = type.colMapper;
+  out << qint32(mapper.type) << qint32(mapper.rangeMin) << qint32(mapper.rangeMax) << mapper.minColor << mapper.maxColor;
+  out << mapper.colorMap << mapper.colorMapOther << mapper.complexType;
+
+  out << type.hasVectorData << type.hasAffineTFData << type.renderVectorData << type.renderVectorDataValues;
+  out << type.scaleVectorToZoom << type.vectorPen << qint32(type.vectorScale) << type.mapVectorToColor << qint32(type.arrowHead);
+
+  out << type.renderGrid << type.gridPen << type.scaleGridToZoom << type.isPolygon;
+}
+
+StatisticsType readStatisticsType(QDataStream &in)
+{
+  StatisticsType type;
+  qint32 typeID, alphaFactor;
+  in >> typeID >> type.typeName >> type.description >> type.valMap;
+  in >> type.render >> alphaFactor;
+  type.typeID = typeID;
+  type.alphaFactor = alphaFactor;
+
+  in >> type.hasValueData >> type.renderValueData >> type.scaleValueToBlockSize;
+  colorMapper &mapper = type.colMapper;
+  qint32 mappingType, rangeMin, rangeMax;
+  in >> mappingType >> rangeMin >> rangeMax >> mapper.minColor >> mapper.maxColor;
+  in >> mapper.colorMap >> mapper.colorMapOther >> mapper.complexType;
+  mapper.type = colorMapper::mappingType(mappingType);
+  mapper.rangeMin = rangeMin;
+  mapper.rangeMax = rangeMax;
+
+  qint32 vectorScale, arrowHead;
+  in >> type.hasVectorData >> type.hasAffineTFData >> type.renderVectorData >> type.renderVectorDataValues;
+  in >> type.scaleVectorToZoom >> type.vectorPen >> vectorScale >> type.mapVectorToColor >> arrowHead;
+  type.vectorScale = vectorScale;
+  type.arrowHead = StatisticsType::arrowHead_t(arrowHead);
+
+  in >> type.renderGrid >> type.gridPen >> type.scaleGridToZoom >> type.isPolygon;
+
+  // The values from the file are the initial state of the type
+  type.setInitialState();
+  return type;
+}
+
+QByteArray encodeStatisticsData(const statisticsData &data)
+{
+  QByteArray out;
+  out.reserve(24 + data.valueData.size() * 12 + data.vectorData.size() * 25 + data.affineTFData.size() * 32);
+
+  appendValue<quint32>(out, quint32(data.valueData.size()));
+  appendValue<quint32>(out, quint32(data.vectorData.size()));
+  appendValue<quint32>(out, quint32(data.affineTFData.size()));
+  appendValue<quint32>(out, quint32(data.polygonValueData.size()));
+  appendValue<quint32>(out, quint32(data.polygonVectorData.size()));
+  appendValue<quint32>(out, quint32(data.maxBlockSize));
+
+  // Block values: x, y, w, h, value
+  appendBlockColumns(out, data.valueData);
+  for (const statisticsItem_Value &item : data.valueData)
+    appendValue<qint32>(out, item.value);
+
+  // Block vectors: x, y, w, h, isLine, x0, y0, x1, y1
+  appendBlockColumns(out, data.vectorData);
+  for (const statisticsItem_Vector &item : data.vectorData)
+    appendValue<quint8>(out, item.isLine ? 1 : 0);
+  for (int c = 0; c < 4; c++)
+    for (const statisticsItem_Vector &item : data.vectorData)
+      appendValue<qint32>(out, (c % 2 == 0) ? item.point[c / 2].x() : item.point[c / 2].y());
+
+  // Affine transforms: x, y, w, h, x0, y0, x1, y1, x2, y2
+  appendBlockColumns(out, data.affineTFData);
+  for (int c = 0; c < 6; c++)
+    for (const statisticsItem_AffineTF &item : data.affineTFData)
+      appendValue<qint32>(out, (c % 2 == 0) ? item.point[c / 2].x() : item.point[c / 2].y());
+
+  // Polygon values: nrCorners, corners, value
+  appendPolygonColumns(out, data.polygonValueData);
+  for (const statisticsItemPolygon_Value &item : data.polygonValueData)
+    appendValue<qint32>(out, item.value);
+
+  // Polygon vectors: nrCorners, corners, x, y
+  appendPolygonColumns(out, data.polygonVectorData);
+  for (int c = 0; c < 2; c++)
+    for (const statisticsItemPolygon_Vector &item : data.polygonVectorData)
+      appendValue<qint32>(out, (c == 0) ? item.point[0].x() : item.point[0].y());
+
+  return out;
+}
+
+bool decodeStatisticsData(const char *data, int64_t size, statisticsData &statData)
+{
+  ColumnReader reader(data, size);
+  const char *header = reader.getColumn(6 * 4);
+  if (!reader.ok)
+    return false;
+
+  const int nrValues = int(getValue<quint32>(header, 0));
+  const int nrVectors = int(getValue<quint32>(header, 1));
+  const int nrAffineTFs = int(getValue<quint32>(header, 2));
+  const int nrPolygonValues = int(getValue<quint32>(header, 3));
+  const int nrPolygonVectors = int(getValue<quint32>(header, 4));
+  statData.maxBlockSize = getValue<quint32>(header, 5);
+
+  // Block values
+  {
+    const char *blocks = reader.getColumn(int64_t(nrValues) * 8);
+    const char *values = reader.getColumn(int64_t(nrValues) * 4);
+    if (!reader.ok)
+      return false;
+    statData.valueData.reserve(nrValues);
+    for (int i = 0; i < nrValues; i++)
+    {
+      statisticsItem_Value item;
+      item.pos[0] = getValue<quint16>(blocks, i);
+      item.pos[1] = getValue<quint16>(blocks, nrValues + i);
+      item.size[0] = getValue<quint16>(blocks, nrValues * 2 + i);
+      item.size[1] = getValue<quint16>(blocks, nrValues * 3 + i);
+      item.value = getValue<qint32>(values, i);
+      statData.valueData.append(item);
+    }
+  }
+
+  // Block vectors
+  {
+    const char *blocks = reader.getColumn(int64_t(nrVectors) * 8);
+    const char *isLine = reader.getColumn(nrVectors);
+    const char *points = reader.getColumn(int64_t(nrVectors) * 16);
+    if (!reader.ok)
+      return false;
+    statData.vectorData.reserve(nrVectors);
+    for (int i = 0; i < nrVectors; i++)
+    {
+      statisticsItem_Vector item;
+      item.pos[0] = getValue<quint16>(blocks, i);
+      item.pos[1] = getValue<quint16>(blocks, nrVectors + i);
+      item.size[0] = getValue<quint16>(blocks, nrVectors * 2 + i);
+      item.size[1] = getValue<quint16>(blocks, nrVectors * 3 + i);
+      item.isLine = (isLine[i] != 0);
+      item.point[0] = QPoint(getValue<qint32>(points, i), getValue<qint32>(points, nrVectors + i));
+      item.point[1] = QPoint(getValue<qint32>(points, nrVectors * 2 + i), getValue<qint32>(points, nrVectors * 3 + i));
+      statData.vectorData.append(item);
+    }
+  }
+
+  // Affine transforms
+  {
+    const char *blocks = reader.getColumn(int64_t(nrAffineTFs) * 8);
+    const char *points = reader.getColumn(int64_t(nrAffineTFs) * 24);
+    if (!reader.ok)
+      return false;
+    statData.affineTFData.reserve(nrAffineTFs);
+    for (int i = 0; i < nrAffineTFs; i++)
+    {
+      statisticsItem_AffineTF item;
+      item.pos[0] = getValue<quint16>(blocks, i);
+      item.pos[1] = getValue<quint16>(blocks, nrAffineTFs + i);
+      item.size[0] = getValue<quint16>(blocks, nrAffineTFs * 2 + i);
+      item.size[1] = getValue<quint16>(blocks, nrAffineTFs * 3 + i);
+      for (int p = 0; p < 3; p++)
+        item.point[p] = QPoint(getValue<qint32>(points, nrAffineTFs * p * 2 + i), getValue<qint32>(points, nrAffineTFs * (p * 2 + 1) + i));
+      statData.affineTFData.append(item);
+    }
+  }
+
+  // Polygon values
+  {
+    QVector<QPolygon> polygons;
+    if (!readPolygonColumns(reader, nrPolygonValues, polygons))
+      return false;
+    const char *values = reader.getColumn(int64_t(nrPolygonValues) * 4);
+    if (!reader.ok)
+      return false;
+    statData.polygonValueData.reserve(nrPolygonValues);
+    for (int i = 0; i < nrPolygonValues; i++)
+    {
+      statisticsItemPolygon_Value item;
+      item.corners = polygons[i];
+      item.value = getValue<qint32>(values, i);
+      statData.polygonValueData.append(item);
+    }
+  }
+
+  // Polygon vectors
+  {
+    QVector<QPolygon> polygons;
+    if (!readPolygonColumns(reader, nrPolygonVectors, polygons))
+      return false;
+    const char *points = reader.getColumn(int64_t(nrPolygonVectors) * 8);
+    if (!reader.ok)
+      return false;
+    statData.polygonVectorData.reserve(nrPolygonVectors);
+    for (int i = 0; i < nrPolygonVectors; i++)
+    {
+      statisticsItemPolygon_Vector item;
+      item.corners = polygons[i];
+      item.point[0] = QPoint(getValue<qint32>(points, i), getValue<qint32>(points, nrPolygonVectors + i));
+      statData.polygonVectorData.append(item);
+    }
+  }
+
+  return true;
+}
+
+bool readFileInfo(QFile *file, FileInfo &info, QString &errorMessage)
+{
+  const int64_t fileSize = file->size();
+  if (fileSize < fileHeaderSize || !file->seek(0))
+  {
+    errorMessage = "The file is too small to be a binary statistics file.";
+    return false;
+  }
+
+  QDataStream in(file);
+  setupStream(in);
+
+  char magic[fileMagicLength];
+  if (in.readRawData(magic, fileMagicLength) != fileMagicLength || memcmp(magic, fileMagic, fileMagicLength) != 0)
+  {
+    errorMessage = "The file is not a binary statistics file.";
+    return false;
+  }
+
+  quint32 version, nrIndexEntries;
+  qint32 width, height, maxPOC;
+  qint64 typeTableOffset, typeTableSize, indexOffset;
+  in >> version >> width >> height >> info.frameRate >> maxPOC >> nrIndexEntries >> typeTableOffset >> typeTableSize >> indexOffset;
+  if (version != fileVersion)
+  {
+    errorMessage = QString("Unsupported binary statistics file version %1.").arg(version);
+    return false;
+  }
+  if (typeTableOffset < fileHeaderSize || typeTableOffset + typeTableSize > fileSize || indexOffset < fileHeaderSize || indexOffset + int64_t(nrIndexEntries) * indexEntrySize > fileSize)
+  {
+    errorMessage = "The header of the binary statistics file is corrupt.";
+    return false;
+  }
+  info.frameSize = QSize(width, height);
+  info.maxPOC = maxPOC;
+
+  // Read the statistics types
+  file->seek(typeTableOffset);
+  qint32 nrTypes;
+  in >> nrTypes;
+  info.types.clear();
+  for (int i = 0; i < nrTypes && in.status() == QDataStream::Ok; i++)
+    info.types.append(readStatisticsType(in));
+  if (in.status() != QDataStream::Ok)
+  {
+    errorMessage = "Error reading the statistics types from the binary statistics file.";
+    return false;
+  }
+
+  // Read the index
+  file->seek(indexOffset);
+  info.index.clear();
+  for (quint32 i = 0; i < nrIndexEntries; i++)
+  {
+    qint32 poc, typeID;
+    qint64 offset;
+    quint32 size, uncompressedSize;
+    in >> poc >> typeID >> offset >> size >> uncompressedSize;
+    if (offset < fileHeaderSize || offset + size > typeTableOffset)
+    {
+      errorMessage = "The index of the binary statistics file is corrupt.";
+      return false;
+    }
+    IndexEntry &entry = info.index[poc][typeID];
+    entry.offset = offset;
+    entry.size = size;
+    entry.uncompressedSize = uncompressedSize;
+  }
+  if (in.status() != QDataStream::Ok)
+  {
+    errorMessage = "Error reading the index from the binary statistics file.";
+    return false;
+  }
+
+  return true;
+}
+
+bool readStatisticsData(QFile *file, const IndexEntry &entry, statisticsData &statData)
+{
+  if (entry.size == 0)
+    return true;
+
+  QByteArray buffer;
+  const char *data = nullptr;
+  uchar *mappedData = file->map(entry.offset, entry.size);
+  if (mappedData)
+    data = reinterpret_cast<const char*>(mappedData);
+  else
+  {
+    if (!file->seek(entry.offset))
+      return false;
+    buffer = file->read(entry.size);
+    if (buffer.size() != int(entry.size))
+      return false;
+    data = buffer.constData();
+  }
+
+  bool success;
+  if (entry.size != entry.uncompressedSize)
+  {
+    const QByteArray uncompressed = qUncompress(reinterpret_cast<const uchar*>(data), int(entry.size));
+    success = (uncompressed.size() == int(entry.uncompressedSize)) && decodeStatisticsData(uncompressed.constData(), uncompressed.size(), statData);
+  }
+  else
+    success = decodeStatisticsData(data, entry.size, statData);
+
+  if (mappedData)
+    file->unmap(mappedData);
+  return success;
+}
+
+bool Writer::open(const QString &fileName, const QSize &frameSize, double frameRate, const TypeList &types, bool compress)
+{
+  file.setFileName(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return setError(QString("Could not open the file %1 for writing.").arg(fileName));
+
+  this->frameSize = frameSize;
+  this->frameRate = frameRate;
+  this->types = types;
+  this->compress = compress;
+  index.clear();
+  maxPOC = 0;
+
+  // The header is written when all data is known (finish)
+  if (file.write(QByteArray(fileHeaderSize, 0)) != fileHeaderSize)
+    return setError("Error writing to the binary statistics file.");
+  return true;
+}
+
+bool Writer::addStatisticsData(int poc, int typeID, const statisticsData &data)
+{
+  if (!file.isOpen())
+    return setError("The binary statistics file is not open.");
+  if (index.contains(poc) && index[poc].contains(typeID))
+    return setError(QString("The statistics of POC %1 type %2 were already written.").arg(poc).arg(typeID));
+
+  QByteArray payload = encodeStatisticsData(data);
+  IndexEntry entry;
+  entry.offset = file.pos();
+  entry.uncompressedSize = uint32_t(payload.size());
+  if (compress && payload.size() >= minCompressionSize)
+  {
+    QByteArray compressed = qCompress(payload);
+    if (compressed.size() < payload.size())
+      payload = compressed;
+  }
+  entry.size = uint32_t(payload.size());
+
+  if (file.write(payload) != payload.size())
+    return setError("Error writing to the binary statistics file.");
+
+  index[poc][typeID] = entry;
+  maxPOC = std::max(maxPOC, poc);
+  return true;
+}
+
+bool Writer::finish()
+{
+  if (!file.isOpen())
+    return setError("The binary statistics file is not open.");
+
+  QDataStream out(&file);
+  setupStream(out);
+
+  // The type table
+  const qint64 typeTableOffset = file.pos();
+  out << qint32(types.size());
+  for (const StatisticsType &type : types)
+    writeStatisticsType(out, type);
+  const qint64 typeTableSize = file.pos() - typeTableOffset;
+
+  // The index
+  const qint64 indexOffset = file.pos();
+  quint32 nrIndexEntries = 0;
+  for (auto pocIt = index.constBegin(); pocIt != index.constEnd(); ++pocIt)
+    for (auto typeIt = pocIt.value().constBegin(); typeIt != pocIt.value().constEnd(); ++typeIt)
+    {
+      out << qint32(pocIt.key()) << qint32(typeIt.key()) << qint64(typeIt.value().offset) << quint32(typeIt.value().size) << quint32(typeIt.value().uncompressedSize);
+      nrIndexEntries++;
+    }
+
+  // The header
+  file.seek(0);
+  out.writeRawData(fileMagic, fileMagicLength);
+  out << fileVersion << qint32(frameSize.width()) << qint32(frameSize.height()) << frameRate << qint32(maxPOC) << nrIndexEntries << typeTableOffset << typeTableSize << indexOffset;
+
+  const bool success = (out.status() == QDataStream::Ok);
+  file.close();
+  if (!success)
+    return setError("Error writing to the binary statistics file.");
+  return true;
+}
+
+} // namespace StatisticsBinaryFormat
@@ -0,0 +1,125 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <QDataStream>
+#include <QFile>
+#include <QMap>
+#include <QSize>
+#include <QVector>
+
+#include "statistics/statisticsExtensions.h"
+
+/* The YUView binary statistics file format (*.yuvstats).
+ * In contrast to the text based formats (CSV, VTM BMS) the file does not have to be scanned when opening it
+ * and the data of a frame does not have to be parsed from text. The file looks like this (all values little endian):
+ *
+ *   FileHeader      - Fixed size header with the frame size/rate and the positions of the type table and the index
+ *   Payload         - The statistics data of all POC/type combinations (see encodeStatisticsData)
+ *   Type table      - The definitions of all statistics types (StatisticsType)
+ *   Index           - One IndexEntry for each POC/type that gives the position of its data in the payload
+ *
+ * The data of each POC/type is stored column by column (all x positions, all y positions, ...) and can optionally
+ * be compressed (zlib).
+ */
+namespace StatisticsBinaryFormat
+{
+
+// The position of the data of one POC/type in the file
+struct IndexEntry
+{
+  int64_t offset {0};
+  uint32_t size {0};
+  // If the data is compressed, this is the size after decompression. Otherwise it is equal to size.
+  uint32_t uncompressedSize {0};
+};
+typedef QMap<int, QMap<int, IndexEntry>> POCTypeIndex;
+// Same as the StatisticsTypeList of the statisticHandler
+typedef QVector<StatisticsType> TypeList;
+
+// Everything that is read when opening a binary statistics file
+struct FileInfo
+{
+  QSize frameSize;
+  double frameRate {0.0};
+  int maxPOC {0};
+  TypeList types;
+  POCTypeIndex index;
+};
+
+// Write/read one statistics type (including all its render settings) to/from the stream.
+void writeStatisticsType(QDataStream &out, const StatisticsType &type);
+StatisticsType readStatisticsType(QDataStream &in);
+
+// Read the header, the types and the index from the given file. Returns false on error (with errorMessage set).
+bool readFileInfo(QFile *file, FileInfo &info, QString &errorMessage);
+
+// Convert the statistics data to/from the binary (columnar) representation.
+QByteArray encodeStatisticsData(const statisticsData &data);
+bool decodeStatisticsData(const char *data, int64_t size, statisticsData &statData);
+
+// Read and decode the data of the given index entry from the file. The data is mapped if possible.
+bool readStatisticsData(QFile *file, const IndexEntry &entry, statisticsData &statData);
+
+/* Write a binary statistics file. The statistics data can be added in any order of POC/type, but each
+ * POC/type combination may only be added once. The file is complete after finish() was called.
+ */
+class Writer
+{
+public:
+  Writer() = default;
+
+  bool open(const QString &fileName, const QSize &frameSize, double frameRate, const TypeList &types, bool compress=true);
+  bool addStatisticsData(int poc, int typeID, const statisticsData &data);
+  bool finish();
+
+  QString getErrorMessage() const { return errorMessage; }
+
+private:
+  bool setError(const QString &error) { errorMessage = error; return false; }
+
+  QFile file;
+  QSize frameSize;
+  double frameRate {0.0};
+  TypeList types;
+  bool compress {true};
+
+  POCTypeIndex index;
+  int maxPOC {0};
+  QString errorMessage;
+};
+
+} // namespace StatisticsBinaryFormat
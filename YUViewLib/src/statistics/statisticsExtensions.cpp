@@ -391,6 +391,30 @@ void statisticsData::addPolygonVector(const QVector<QPoint> &points, int vecX, i
   polygonVectorData.append(vec);
 }
 
+int64_t statisticsData::getMemorySize() const
+{
+  int64_t size = sizeof(statisticsData);
+  size += valueData.capacity() * int64_t(sizeof(statisticsItem_Value));
+  size += vectorData.capacity() * int64_t(sizeof(statisticsItem_Vector));
+  size += affineTFData.capacity() * int64_t(sizeof(statisticsItem_AffineTF));
+  size += (polygonValueData.capacity() - polygonValueData.size()) * int64_t(sizeof(statisticsItemPolygon_Value));
+  for (const statisticsItemPolygon_Value &value : polygonValueData)
+    size += sizeof(statisticsItemPolygon_Value) + value.corners.size() * int64_t(sizeof(QPoint));
+  size += (polygonVectorData.capacity() - polygonVectorData.size()) * int64_t(sizeof(statisticsItemPolygon_Vector));
+  for (const statisticsItemPolygon_Vector &vec : polygonVectorData)
+    size += sizeof(statisticsItemPolygon_Vector) + vec.corners.size() * int64_t(sizeof(QPoint));
+  return size;
+}
+
+void statisticsData::squeeze()
+{
+  valueData.squeeze();
+  vectorData.squeeze();
+  affineTFData.squeeze();
+  polygonValueData.squeeze();
+  polygonVectorData.squeeze();
+}
+
 // Setup an invalid (uninitialized color mapper)
 colorMapper::colorMapper()
 {
@@ -35,6 +35,7 @@
 #include <QColor>
 #include <QMap>
 #include <QPen>
+#include <QVector>
 
 class YUViewDomElement;
 
@@ -242,11 +243,18 @@ public:
   void addPolygonVector(const QVector<QPoint> &points, int vecX, int vecY);
   void addPolygonValue(const QVector<QPoint> &points, int val);
 
-  QList<statisticsItem_Value> valueData;
-  QList<statisticsItem_Vector> vectorData;
-  QList<statisticsItem_AffineTF> affineTFData;
-  QList<statisticsItemPolygon_Value> polygonValueData;
-  QList<statisticsItemPolygon_Vector> polygonVectorData;
+  // Get the (approximate) number of bytes that this data occupies in memory
+  int64_t getMemorySize() const;
+  bool isEmpty() const { return valueData.isEmpty() && vectorData.isEmpty() && affineTFData.isEmpty() && polygonValueData.isEmpty() && polygonVectorData.isEmpty(); }
+  // Release the memory that was reserved while adding items. Call this before the data is kept in a cache.
+  void squeeze();
+
+  // The items are stored in contiguous memory (a QList would allocate every item separately)
+  QVector<statisticsItem_Value> valueData;
+  QVector<statisticsItem_Vector> vectorData;
+  QVector<statisticsItem_AffineTF> affineTFData;
+  QVector<statisticsItemPolygon_Value> polygonValueData;
+  QVector<statisticsItemPolygon_Vector> polygonVectorData;
 
   // What is the size (area) of the biggest block)? This is needed for scaling the blocks according to their size.
   unsigned int maxBlockSize;
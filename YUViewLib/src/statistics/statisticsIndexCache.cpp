@@ -0,0 +1,86 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "statisticsIndexCache.h"
+
+namespace StatisticsIndexCache
+{
+
+namespace
+{
+
+const IndexCacheFile::Format indexFormat {"YUVSTIDX", 1, "statisticsIndex"};
+
+bool readIndex(QDataStream &in, Index &index)
+{
+  qint32 nrTypes, maxPOC;
+  in >> index.frameSize >> index.frameRate >> index.fileSortedByPOC >> maxPOC >> nrTypes;
+  if (in.status() != QDataStream::Ok || nrTypes < 0)
+    return false;
+  index.maxPOC = maxPOC;
+  for (int i = 0; i < nrTypes && in.status() == QDataStream::Ok; i++)
+    index.types.append(StatisticsBinaryFormat::readStatisticsType(in));
+  in >> index.pocTypeStartList >> index.pocStartList;
+  return true;
+}
+
+void writeIndex(QDataStream &out, const Index &index)
+{
+  out << index.frameSize << index.frameRate << index.fileSortedByPOC << qint32(index.maxPOC) << qint32(index.types.size());
+  for (const StatisticsType &type : index.types)
+    StatisticsBinaryFormat::writeStatisticsType(out, type);
+  out << index.pocTypeStartList << index.pocStartList;
+}
+
+} // namespace
+
+QString getIndexFilePath(const QString &statisticsFilePath)
+{
+  return IndexCacheFile::getIndexFilePath(statisticsFilePath, indexFormat);
+}
+
+bool loadIndex(const QString &statisticsFilePath, const QString &formatTag, Index &index)
+{
+  Index newIndex;
+  if (!IndexCacheFile::load(statisticsFilePath, indexFormat, formatTag, [&newIndex](QDataStream &in) { return readIndex(in, newIndex); }))
+    return false;
+  index = newIndex;
+  return true;
+}
+
+bool saveIndex(const QString &statisticsFilePath, const QString &formatTag, const FileState &parsedFileState, const Index &index)
+{
+  return IndexCacheFile::save(statisticsFilePath, indexFormat, formatTag, parsedFileState, [&index](QDataStream &out) { writeIndex(out, index); });
+}
+
+} // namespace StatisticsIndexCache
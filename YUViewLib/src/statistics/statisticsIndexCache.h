@@ -0,0 +1,77 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QMap>
+#include <QSize>
+#include <QString>
+
+#include "common/IndexCacheFile.h"
+#include "statistics/statisticsBinaryFormat.h"
+
+/* A persistent cache for the index (the positions of all POCs/types) of text based statistics files.
+ * Scanning a large CSV or VTM BMS file for the start positions of all frames can take a long time. The
+ * index and the header information of the file are saved using IndexCacheFile.
+ */
+namespace StatisticsIndexCache
+{
+
+using IndexCacheFile::FileState;
+using IndexCacheFile::getFileState;
+
+struct Index
+{
+  QSize frameSize;
+  double frameRate {0.0};
+  StatisticsBinaryFormat::TypeList types;
+  bool fileSortedByPOC {false};
+  int maxPOC {0};
+  // The start positions of all POCs/types (CSV files)
+  QMap<int, QMap<int, qint64>> pocTypeStartList;
+  // The start positions of all POCs (VTM BMS files)
+  QMap<int, qint64> pocStartList;
+};
+
+// Get the path of the index file for the given statistics file
+QString getIndexFilePath(const QString &statisticsFilePath);
+
+// Load the index of the given statistics file. The formatTag identifies the parser that created the index.
+// Returns false if there is no index or if it does not match the current state of the statistics file.
+bool loadIndex(const QString &statisticsFilePath, const QString &formatTag, Index &index);
+
+// Save the index of the given statistics file. parsedFileState is the state of the file when the parsing
+// started. If the file changed since then, the index is not saved.
+bool saveIndex(const QString &statisticsFilePath, const QString &formatTag, const FileState &parsedFileState, const Index &index);
+
+} // namespace StatisticsIndexCache
@@ -0,0 +1,485 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "statisticsParsing.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtConcurrent>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STATISTICS_PARSING_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define STATISTICS_PARSING_SSE2 0
+#endif
+
+namespace StatisticsParsing
+{
+
+namespace
+{
+
+#if STATISTICS_PARSING_SSE2
+// Get the index of the lowest set bit. The mask must not be 0.
+inline int countTrailingZeros(unsigned int mask)
+{
+#ifdef _MSC_VER
+  unsigned long idx;
+  _BitScanForward(&idx, mask);
+  return int(idx);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// The size of the blocks that are read by the FileLineReader if the file can not be mapped
+const int64_t fileReadBlockSize = 1048576;
+
+inline bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline void skipSpaces(const char *&pos, const char *end)
+{
+  while (pos < end && isSpace(*pos))
+    pos++;
+}
+
+// Skip spaces and then the given character. Return false if the next character is a different one.
+inline bool expectChar(const char *&pos, const char *end, char c)
+{
+  skipSpaces(pos, end);
+  if (pos == end || *pos != c)
+    return false;
+  pos++;
+  return true;
+}
+
+inline bool isNameChar(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Find the given string in [begin, end). Return end if it was not found.
+const char *findString(const char *begin, const char *end, const char *str, size_t length)
+{
+  const char *pos = begin;
+  while (size_t(end - pos) >= length)
+  {
+    const void *found = memchr(pos, str[0], size_t(end - pos) - length + 1);
+    if (found == nullptr)
+      return end;
+    pos = static_cast<const char*>(found);
+    if (memcmp(pos, str, length) == 0)
+      return pos;
+    pos++;
+  }
+  return end;
+}
+
+// Parse the "BlockStat: POC x" start of a VTM BMS line and move pos behind it
+bool parseVTMBMSPocPrefix(const char *&pos, const char *end, int &poc)
+{
+  static const char blockStatPrefix[] = "BlockStat: POC ";
+  const size_t prefixLength = sizeof(blockStatPrefix) - 1;
+
+  const char *prefix = findString(pos, end, blockStatPrefix, prefixLength);
+  if (prefix == end)
+    return false;
+  pos = prefix + prefixLength;
+  if (pos == end || *pos < '0' || *pos > '9')
+    return false;
+  return parseInt(pos, end, poc);
+}
+
+// A range of complete lines in a buffer that is indexed by one thread
+struct CSVLineRange
+{
+  const char *begin;
+  const char *end;
+  int64_t fileOffset;
+};
+
+CSVPocTypeStartList indexCSVLineRange(const CSVLineRange &range)
+{
+  CSVPocTypeStartList startList;
+
+  const char *pos = range.begin;
+  while (pos < range.end)
+  {
+    const char *lineEnd = findNewline(pos, range.end);
+
+    int poc, typeID;
+    if (parseCSVPocAndType(pos, lineEnd, poc, typeID))
+    {
+      // Only save the positions where the POC or type changes
+      if (startList.isEmpty() || startList.last().poc != poc || startList.last().typeID != typeID)
+        startList.append({poc, typeID, range.fileOffset + (pos - range.begin)});
+    }
+
+    if (lineEnd == range.end)
+      break;
+    pos = lineEnd + 1;
+  }
+
+  return startList;
+}
+
+} // namespace
+
+const char *findNewline(const char *begin, const char *end)
+{
+  const char *pos = begin;
+#if STATISTICS_PARSING_SSE2
+  // Compare 16 bytes at a time and get a bit mask of all bytes that are a newline
+  const __m128i newline = _mm_set1_epi8('\n');
+  while (end - pos >= 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+    const unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+    if (mask != 0)
+      return pos + countTrailingZeros(mask);
+    pos += 16;
+  }
+#endif
+  if (pos >= end)
+    return end;
+  const void *found = memchr(pos, '\n', size_t(end - pos));
+  return (found == nullptr) ? end : static_cast<const char*>(found);
+}
+
+bool parseInt(const char *&pos, const char *end, int &value)
+{
+  const char *p = pos;
+  while (p < end && isSpace(*p))
+    p++;
+
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    p++;
+  }
+
+  if (p == end || *p < '0' || *p > '9')
+    return false;
+
+  int64_t v = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+  {
+    v = v * 10 + (*p - '0');
+    p++;
+  }
+
+  value = int(negative ? -v : v);
+  pos = p;
+  return true;
+}
+
+bool skipFields(const char *&pos, const char *end, int nrFields, char delimiter)
+{
+  const char *p = pos;
+  for (int i = 0; i < nrFields; i++)
+  {
+    const void *found = memchr(p, delimiter, size_t(end - p));
+    if (found == nullptr)
+      return false;
+    p = static_cast<const char*>(found) + 1;
+  }
+  pos = p;
+  return true;
+}
+
+bool parseCSVPocAndType(const char *lineBegin, const char *lineEnd, int &poc, int &typeID)
+{
+  const char *pos = lineBegin;
+  while (pos < lineEnd && isSpace(*pos))
+    pos++;
+
+  // Ignore empty entries and headers
+  if (pos == lineEnd || *pos == '%' || *pos == ';')
+    return false;
+
+  // Line: POC;xPos;yPos;width;height;type;value0;...
+  if (!parseInt(pos, lineEnd, poc))
+    return false;
+  if (!skipFields(pos, lineEnd, 5, ';'))
+    return false;
+  return parseInt(pos, lineEnd, typeID);
+}
+
+FileLineReader::FileLineReader(QIODevice *file, int64_t startPos) : file(file)
+{
+  const int64_t fileSize = file->size();
+  if (startPos >= fileSize)
+  {
+    fileAtEnd = true;
+    return;
+  }
+
+  mappedFile = qobject_cast<QFileDevice*>(file);
+  if (mappedFile)
+    mappedData = mappedFile->map(startPos, fileSize - startPos);
+  if (mappedData)
+  {
+    dataBegin = reinterpret_cast<const char*>(mappedData);
+    dataEnd = dataBegin + (fileSize - startPos);
+    pos = dataBegin;
+    fileAtEnd = true;
+  }
+  else
+    fileAtEnd = !file->seek(startPos);
+}
+
+FileLineReader::~FileLineReader()
+{
+  if (mappedData)
+    mappedFile->unmap(mappedData);
+}
+
+bool FileLineReader::readLine(const char *&lineBegin, const char *&lineEnd)
+{
+  const char *newline = findNewline(pos, dataEnd);
+  while (newline == dataEnd && !fileAtEnd)
+  {
+    // The line continues after the buffer. Read more data and search again.
+    const int64_t searchStart = dataEnd - pos;
+    if (!fillBuffer())
+    {
+      newline = dataEnd;
+      break;
+    }
+    newline = findNewline(pos + searchStart, dataEnd);
+  }
+
+  if (pos == dataEnd)
+    return false;
+
+  lineBegin = pos;
+  lineEnd = newline;
+  pos = (newline == dataEnd) ? dataEnd : newline + 1;
+  if (lineEnd > lineBegin && *(lineEnd - 1) == '\r')
+    lineEnd--;
+  return true;
+}
+
+bool FileLineReader::fillBuffer()
+{
+  // Keep the (incomplete) line that was not returned yet and append the next block from the file
+  const int remaining = int(dataEnd - pos);
+  buffer.remove(0, int(pos - dataBegin));
+  buffer.resize(remaining + int(fileReadBlockSize));
+  int64_t nrBytesRead = file->read(buffer.data() + remaining, fileReadBlockSize);
+  if (nrBytesRead < fileReadBlockSize)
+    fileAtEnd = true;
+  if (nrBytesRead < 0)
+    nrBytesRead = 0;
+  buffer.resize(remaining + int(nrBytesRead));
+
+  dataBegin = buffer.constData();
+  dataEnd = dataBegin + buffer.size();
+  pos = dataBegin;
+  return nrBytesRead > 0;
+}
+
+int parseCSVLine(const char *lineBegin, const char *lineEnd, int *values, int maxValues)
+{
+  const char *pos = lineBegin;
+  skipSpaces(pos, lineEnd);
+  if (pos == lineEnd || *pos == ';')
+    return 0;
+
+  int nrFields = 0;
+  while (true)
+  {
+    int value;
+    const char *valuePos = pos;
+    if (!parseInt(valuePos, lineEnd, value))
+      value = 0;
+    if (nrFields < maxValues)
+      values[nrFields] = value;
+    nrFields++;
+
+    const void *delimiter = memchr(pos, ';', size_t(lineEnd - pos));
+    if (delimiter == nullptr)
+      break;
+    pos = static_cast<const char*>(delimiter) + 1;
+  }
+  return nrFields;
+}
+
+int64_t indexCSVBuffer(const char *data, int64_t size, int64_t fileOffset, bool atEnd, int nrThreads, CSVPocTypeStartList &startList)
+{
+  // Only index complete lines. If this is not the end of the file, the last line may be incomplete.
+  int64_t indexSize = size;
+  if (!atEnd)
+  {
+    while (indexSize > 0 && data[indexSize - 1] != '\n')
+      indexSize--;
+  }
+  if (indexSize == 0)
+    return 0;
+
+  // Split the buffer into ranges of complete lines (one per thread)
+  QVector<CSVLineRange> ranges;
+  const char *dataEnd = data + indexSize;
+  const int64_t rangeSize = std::max(indexSize / std::max(nrThreads, 1), int64_t(1));
+  const char *rangeBegin = data;
+  while (rangeBegin < dataEnd)
+  {
+    const char *rangeEnd = dataEnd;
+    if (dataEnd - rangeBegin > rangeSize)
+    {
+      rangeEnd = findNewline(rangeBegin + rangeSize, dataEnd);
+      if (rangeEnd != dataEnd)
+        rangeEnd++;  // The newline belongs to the line
+    }
+    ranges.append({rangeBegin, rangeEnd, fileOffset + (rangeBegin - data)});
+    rangeBegin = rangeEnd;
+  }
+
+  // Index all ranges (in parallel) and merge the results in the order of the file
+  QList<CSVPocTypeStartList> rangeStartLists;
+  if (ranges.size() == 1)
+    rangeStartLists.append(indexCSVLineRange(ranges[0]));
+  else
+    rangeStartLists = QtConcurrent::blockingMapped<QList<CSVPocTypeStartList>>(ranges, indexCSVLineRange);
+
+  for (const CSVPocTypeStartList &rangeStartList : rangeStartLists)
+  {
+    for (const CSVPocTypeStart &start : rangeStartList)
+    {
+      // The first entry of a range may continue the POC/type from the end of the previous range
+      if (!startList.isEmpty() && startList.last().poc == start.poc && startList.last().typeID == start.typeID)
+        continue;
+      startList.append(start);
+    }
+  }
+
+  return indexSize;
+}
+
+bool parseVTMBMSPoc(const char *lineBegin, const char *lineEnd, int &poc)
+{
+  const char *pos = lineBegin;
+  return parseVTMBMSPocPrefix(pos, lineEnd, poc);
+}
+
+bool parseVTMBMSLine(const char *lineBegin, const char *lineEnd, VTMBMSLine &line)
+{
+  const char *pos = lineBegin;
+  const char *end = lineEnd;
+  if (!parseVTMBMSPocPrefix(pos, end, line.poc))
+    return false;
+  if (!expectChar(pos, end, '@'))
+    return false;
+
+  skipSpaces(pos, end);
+  if (pos == end)
+    return false;
+  if (*pos == '(')
+  {
+    // A block: @( 112,  88) [ 8x 8]
+    line.isPolygon = false;
+    line.nrCorners = 0;
+    pos++;
+    if (!parseInt(pos, end, line.posX) || !expectChar(pos, end, ',') || !parseInt(pos, end, line.posY) || !expectChar(pos, end, ')'))
+      return false;
+    if (!expectChar(pos, end, '[') || !parseInt(pos, end, line.width) || !expectChar(pos, end, 'x') || !parseInt(pos, end, line.height) || !expectChar(pos, end, ']'))
+      return false;
+  }
+  else if (*pos == '[')
+  {
+    // A polygon with 3 to 5 corners: @[(505, 384)--(511, 384)--(511, 415)--]
+    line.isPolygon = true;
+    line.posX = line.posY = line.width = line.height = 0;
+    line.nrCorners = 0;
+    pos++;
+    while (!expectChar(pos, end, ']'))
+    {
+      if (line.nrCorners == 5)
+        return false;
+      int &x = line.cornerX[line.nrCorners];
+      int &y = line.cornerY[line.nrCorners];
+      if (!expectChar(pos, end, '(') || !parseInt(pos, end, x) || !expectChar(pos, end, ',') || !parseInt(pos, end, y) || !expectChar(pos, end, ')'))
+        return false;
+      if (!expectChar(pos, end, '-') || !expectChar(pos, end, '-'))
+        return false;
+      line.nrCorners++;
+    }
+    if (line.nrCorners < 3)
+      return false;
+  }
+  else
+    return false;
+
+  // The type name and the value(s): PredMode=0 or MVL0={ -24,  -2}
+  skipSpaces(pos, end);
+  line.typeNameBegin = pos;
+  while (pos < end && isNameChar(*pos))
+    pos++;
+  line.typeNameEnd = pos;
+  if (line.typeNameBegin == line.typeNameEnd || pos == end || *pos != '=')
+    return false;
+  pos++;
+
+  line.nrValues = 0;
+  line.valueInBraces = expectChar(pos, end, '{');
+  if (!line.valueInBraces)
+  {
+    if (!parseInt(pos, end, line.values[0]))
+      return false;
+    line.nrValues = 1;
+    return true;
+  }
+
+  while (true)
+  {
+    if (line.nrValues == 6 || !parseInt(pos, end, line.values[line.nrValues]))
+      return false;
+    line.nrValues++;
+    if (expectChar(pos, end, '}'))
+      return true;
+    if (!expectChar(pos, end, ','))
+      return false;
+  }
+}
+
+} // namespace StatisticsParsing
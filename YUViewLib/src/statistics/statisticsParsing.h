@@ -0,0 +1,144 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QFileDevice>
+#include <QIODevice>
+#include <QVector>
+
+/* Fast, allocation free helpers for parsing the text based statistics files.
+ * The functions work directly on the bytes of the file (e.g. a memory mapped file or a read buffer)
+ * so that no QString/QStringList has to be created for every line in the file.
+ */
+namespace StatisticsParsing
+{
+
+// Find the next newline character ('\n') in the range [begin, end). Return end if there is none.
+// This is vectorized using SSE2 (if available).
+const char *findNewline(const char *begin, const char *end);
+
+// Parse a decimal integer (with optional sign) at pos. Leading spaces/tabs are skipped. On success, pos is
+// moved behind the number and true is returned. If there is no number at pos, false is returned.
+bool parseInt(const char *&pos, const char *end, int &value);
+
+// Move pos behind the next nrFields delimiters. Return false if the line ends before that.
+bool skipFields(const char *&pos, const char *end, int nrFields, char delimiter);
+
+// Provides the lines of a file, starting at the given position, without copying them. The file is memory mapped
+// if possible. Otherwise (or if the device is not a file) it is read in blocks into an internal buffer.
+class FileLineReader
+{
+public:
+  FileLineReader(QIODevice *file, int64_t startPos);
+  ~FileLineReader();
+
+  // Get the next line (without the newline characters). The line is valid until the next call.
+  // Returns false if the end of the file was reached.
+  bool readLine(const char *&lineBegin, const char *&lineEnd);
+
+private:
+  bool fillBuffer();
+
+  QIODevice *file {nullptr};
+  QFileDevice *mappedFile {nullptr};
+  uchar *mappedData {nullptr};
+
+  const char *dataBegin {nullptr};
+  const char *dataEnd {nullptr};
+  const char *pos {nullptr};
+
+  // Used if the file could not be mapped
+  QByteArray buffer;
+  bool fileAtEnd {false};
+};
+
+// ------- CSV statistics files -------
+// A position in a CSV statistics file where the POC/typeID changes relative to the previous line.
+struct CSVPocTypeStart
+{
+  int poc;
+  int typeID;
+  int64_t filePos;
+};
+typedef QVector<CSVPocTypeStart> CSVPocTypeStartList;
+
+// Get the POC (column 0) and typeID (column 5) from the given CSV line. Return false for
+// empty lines, header lines (starting with '%') and lines that can not be parsed.
+bool parseCSVPocAndType(const char *lineBegin, const char *lineEnd, int &poc, int &typeID);
+
+// Parse all fields of the given CSV line as integers into values (at most maxValues). Fields that are not
+// a number are set to 0. Returns the number of fields in the line or 0 if the line or its first field is empty.
+int parseCSVLine(const char *lineBegin, const char *lineEnd, int *values, int maxValues);
+
+// Index the lines in the given buffer (which starts at fileOffset in the file). Only complete lines
+// are indexed. If atEnd is set, the buffer is the end of the file and a last line without a newline
+// is also indexed. The buffer is split into ranges which are indexed in parallel using nrThreads threads.
+// The positions where a new POC/type starts are appended to startList (in the order of the file).
+// Returns the number of bytes that were indexed (the rest belongs to a line that is continued after the buffer).
+int64_t indexCSVBuffer(const char *data, int64_t size, int64_t fileOffset, bool atEnd, int nrThreads, CSVPocTypeStartList &startList);
+
+// ------- VTM/VVC block statistics (BMS) files -------
+// One parsed line of a VTM BMS statistics file, e.g.
+// BlockStat: POC 1 @( 112,  88) [ 8x 8] PredMode=0
+// BlockStat: POC 1 @( 120,  80) [ 8x 8] MVL0={ -24,  -2}
+// BlockStat: POC 2 @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=0
+struct VTMBMSLine
+{
+  int poc;
+  bool isPolygon;
+  // Block position/size (if !isPolygon)
+  int posX, posY, width, height;
+  // Polygon corners (if isPolygon). Up to 5 corners are supported.
+  int nrCorners;
+  int cornerX[5];
+  int cornerY[5];
+  // The name of the statistics type (points into the line)
+  const char *typeNameBegin;
+  const char *typeNameEnd;
+  // A scalar value (no braces) or the values in braces (e.g. {x, y})
+  bool valueInBraces;
+  int nrValues;
+  int values[6];
+};
+
+// Get only the POC from a line of a VTM BMS file. Return false if this is not a BlockStat line.
+bool parseVTMBMSPoc(const char *lineBegin, const char *lineEnd, int &poc);
+
+// Parse a complete line of a VTM BMS file. Return false if the line can not be parsed.
+bool parseVTMBMSLine(const char *lineBegin, const char *lineEnd, VTMBMSLine &line);
+
+} // namespace StatisticsParsing
@@ -33,6 +33,7 @@
 #include "playbackController.h"
 
 #include <QSettings>
+#include <algorithm>
 
 #include "playlistitem/playlistItem.h"
 #include "common/functions.h"
@@ -55,8 +56,7 @@ PlaybackController::PlaybackController()
     this->frameSlider->setTickPosition(QSlider::NoTicks);
 
   // Default fps
-  fpsLabel->setText("0");
-  fpsLabel->setStyleSheet("");
+  resetFPSLabel();
 
   // Load current repeat mode from settings
   QSettings settings;
@@ -68,9 +68,9 @@ PlaybackController::PlaybackController()
   // Initialize variables
   currentFrameIdx = -1;
   lastValidFrameIdx = -1;
-  timerInterval = -1;
-  timerFPSCounter = 0;
-  timerLastFPSTime = QTime::currentTime();
+  timerLastFPSTime = 0;
+  timerStaticItemCountDown = -1;
+  playbackTime.start();
   playbackMode = PlaybackStopped;
   playbackWasStalled = false;
   waitingForItem[0] = false;
@@ -118,10 +118,13 @@ void PlaybackController::on_playPauseButton_clicked()
     DEBUG_PLAYBACK("PlaybackController::on_playPauseButton_clicked Stop");
     timer.stop();
     playbackMode = PlaybackStopped;
+    // The items do not have to load any more frames ahead of playback
+    for (const auto &item : currentItem)
+      if (item)
+        item->setDoubleBufferLoadingInterrupted(true);
     emit(waitForItemCaching(nullptr));
     playPauseButton->setIcon(iconPlay);
-    fpsLabel->setText("0");
-    fpsLabel->setStyleSheet("");
+    resetFPSLabel();
     splitViewPrimary->freezeView(false);
 
     splitViewPrimary->update(false, true);
@@ -189,30 +192,77 @@ void PlaybackController::startPlayback()
 
 void PlaybackController::startOrUpdateTimer()
 {
-  // Get the frame rate of the current item. Lower limit is 0.01 fps (100 seconds per frame).
   if (currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame()))
-  {
-    // One (of the possibly two items) is indexed by frame. Get and set the frame rate
-    double frameRate = currentItem[0]->isIndexedByFrame() ? currentItem[0]->getFrameRate() : currentItem[1]->getFrameRate();
-    if (frameRate < 0.01)
-      frameRate = 0.01;
     timerStaticItemCountDown = -1;
-    timerInterval = 1000.0 / frameRate;
-    DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer framerate %f", frameRate);
-  }
   else
-  {
-    // The item (or both items) are not indexed by frame.
-    // Use the duration of item 0
-    timerInterval = int(1000 / 10);
+    // The item (or both items) are not indexed by frame. Use the duration of item 0.
     timerStaticItemCountDown = currentItem[0]->getDuration() * 10;
-    DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer duration %d", timerInterval);
-  }
-  
-  timer.start(timerInterval, Qt::PreciseTimer, this);
+  DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer framerate %f", getPlaybackFrameRate());
+
+  // The schedule starts with the frame that is shown now
+  const auto now = playbackTime.nsecsElapsed();
+  playbackClock.start(now, getPlaybackFrameRate());
+  playbackClock.resetStatistics();
+  timerLastFPSTime = now;
+  lastDrawnFrameIdx = -1;
+  scheduleNextTimerEvent();
   playbackMode = PlaybackRunning;
-  timerLastFPSTime = QTime::currentTime();
-  timerFPSCounter = 0;
+}
+
+void PlaybackController::scheduleNextTimerEvent()
+{
+  timer.start(playbackClock.getMsecsToNextFrame(playbackTime.nsecsElapsed()), Qt::PreciseTimer, this);
+}
+
+double PlaybackController::getPlaybackFrameRate() const
+{
+  if (currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame()))
+    // One (of the possibly two items) is indexed by frame. Use its frame rate.
+    return currentItem[0]->isIndexedByFrame() ? currentItem[0]->getFrameRate() : currentItem[1]->getFrameRate();
+  return 10;
+}
+
+void PlaybackController::updateFPSLabel()
+{
+  const auto now = playbackTime.nsecsElapsed();
+  if (now - timerLastFPSTime < 1000000000)
+    return;
+
+  // Print the frames per second as float with one digit after the decimal dot. The jitter is the standard deviation
+  // of the time between the frames that were drawn by the view.
+  const double framesPerSec = playbackClock.getAverageFrameRate();
+  const int nrDroppedFrames = playbackClock.getNumberDroppedFrames();
+  if (framesPerSec > 0)
+  {
+    fpsLabel->setText(QString::number(framesPerSec, 'f', 1));
+    QString text = QString("fps (jitter %1 ms").arg(playbackClock.getFrameTimeJitter(), 0, 'f', 1);
+    if (nrDroppedFrames > 0)
+      text += QString(", %1 dropped").arg(nrDroppedFrames);
+    fpsTextLabel->setText(text + ")");
+  }
+  if (playbackWasStalled || nrDroppedFrames > 0)
+    fpsLabel->setStyleSheet("QLabel { background-color: yellow }");
+  else
+    fpsLabel->setStyleSheet("");
+  playbackWasStalled = false;
+
+  playbackClock.resetStatistics();
+  timerLastFPSTime = now;
+}
+
+void PlaybackController::currentFrameDrawn()
+{
+  if (!playing() || currentFrameIdx == lastDrawnFrameIdx)
+    return;
+  lastDrawnFrameIdx = currentFrameIdx;
+  playbackClock.addDrawnFrame(playbackTime.nsecsElapsed());
+}
+
+void PlaybackController::resetFPSLabel()
+{
+  fpsLabel->setText("0");
+  fpsLabel->setStyleSheet("");
+  fpsTextLabel->setText("fps");
 }
 
 void PlaybackController::nextFrame()
@@ -383,6 +433,8 @@ void PlaybackController::updateSettings()
   bool caching = settings.value("Enabled", true).toBool();
   bool wait = settings.value("PlaybackPauseCaching", false).toBool();
   waitForCachingOfItem = caching && wait;
+  settings.endGroup();
+  dropLateFrames = settings.value("PlaybackDropLateFrames", false).toBool();
 
   // Load the icons for the buttons
   iconPlay = functions::convertIcon(":img_play.png");
@@ -437,8 +489,7 @@ void PlaybackController::enableControls(bool enable)
   if (!enable)
   {
     const QSignalBlocker blocker(frameSlider);
-    fpsLabel->setText("0");
-    fpsLabel->setStyleSheet("");
+    resetFPSLabel();
     playbackWasStalled = false;
   }
 
@@ -467,6 +518,18 @@ void PlaybackController::timerEvent(QTimerEvent *event)
     DEBUG_PLAYBACK("PlaybackController::timerEvent Different Timer IDs");
     return QWidget::timerEvent(event);
   }
+
+  // The timer may fire before the next frame is due. Without a timer event, the next frame is shown right away.
+  const auto now = playbackTime.nsecsElapsed();
+  int nrFramesDue = playbackClock.getNumberFramesDue(now);
+  if (!event)
+    nrFramesDue = std::max(nrFramesDue, 1);
+  if (nrFramesDue == 0)
+  {
+    scheduleNextTimerEvent();
+    return;
+  }
+
   if (timerStaticItemCountDown > 0)
   {
     // We are currently displaying a static item (until timerStaticItemCountDown reaches 0)
@@ -477,6 +540,8 @@ void PlaybackController::timerEvent(QTimerEvent *event)
     timerStaticItemCountDown--;
     frameSlider->setValue(frameSlider->value() + 1);
     frameSpinBox->setValue((timerStaticItemCountDown / 10 + 1));
+    playbackClock.advance(now);
+    scheduleNextTimerEvent();
     return;
   }
 
@@ -521,9 +586,36 @@ void PlaybackController::timerEvent(QTimerEvent *event)
   }
   else
   {
-    // Do we have to wait for one of the (possibly two) items to load until we can display it/them?
-    waitingForItem[0] = currentItem[0]->isLoading() || currentItem[0]->isLoadingDoubleBuffer();
-    waitingForItem[1] = splitViewPrimary->isSplitting() && currentItem[1] && (currentItem[1]->isLoading() || currentItem[1]->isLoadingDoubleBuffer());
+    int nrFramesAdvanced = 1;
+    if (dropLateFrames && nrFramesDue > 1 && nextFrameIdx == currentFrameIdx + 1)
+    {
+      // Playback is late. Drop frames to show the furthest frame that is due now and already loaded in both items (but
+      // not beyond the last frame). Jumping to a frame that is not loaded yet would stall playback and the items would
+      // discard the frames that they already loaded ahead.
+      auto isFrameLoaded = [](playlistItem *item, int frameIdx) {
+        return item->needsLoading(frameIdx, false) != LoadingNeeded;
+      };
+      const bool splitting = splitViewPrimary->isSplitting() && currentItem[1];
+      const int lastDueFrameIdx = std::min(currentFrameIdx + nrFramesDue, frameSlider->maximum());
+      for (int frameIdx = lastDueFrameIdx; frameIdx > nextFrameIdx; frameIdx--)
+      {
+        if (isFrameLoaded(currentItem[0], frameIdx) && (!splitting || isFrameLoaded(currentItem[1], frameIdx)))
+        {
+          nextFrameIdx = frameIdx;
+          break;
+        }
+      }
+      nrFramesAdvanced = nextFrameIdx - currentFrameIdx;
+      DEBUG_PLAYBACK("PlaybackController::timerEvent dropping %d frames", nrFramesAdvanced - 1);
+    }
+
+    // Do we have to wait for one of the (possibly two) items to load until we can display it/them? While the double
+    // buffer is loading, we only have to wait if the next frame is not loaded yet.
+    auto isWaitingForItem = [nextFrameIdx](playlistItem *item) {
+      return item->isLoading() || (item->isLoadingDoubleBuffer() && item->needsLoading(nextFrameIdx, false) == LoadingNeeded);
+    };
+    waitingForItem[0] = isWaitingForItem(currentItem[0]);
+    waitingForItem[1] = splitViewPrimary->isSplitting() && currentItem[1] && isWaitingForItem(currentItem[1]);
     if (waitingForItem[0] || waitingForItem[1])
     {
       // The double buffer of the current item or the second item is still loading. Playback is not fast enough.
@@ -539,40 +631,14 @@ void PlaybackController::timerEvent(QTimerEvent *event)
     // Go to the next frame and update the splitView
     DEBUG_PLAYBACK("PlaybackController::timerEvent next frame %d", nextFrameIdx);
     setCurrentFrame(nextFrameIdx);
-
-    // Update the FPS counter every 50 frames
-    timerFPSCounter++;
-    if (timerFPSCounter >= 50)
-    {
-      QTime newFrameTime = QTime::currentTime();
-      double msecsSinceLastUpdate = (double)timerLastFPSTime.msecsTo(newFrameTime);
-
-      // Print the frames per second as float with one digit after the decimal dot.
-      double framesPerSec = (50 / (msecsSinceLastUpdate / 1000.0));
-      if (framesPerSec > 0)
-        fpsLabel->setText(QString::number(framesPerSec, 'f', 1));
-      if (playbackWasStalled)
-        fpsLabel->setStyleSheet("QLabel { background-color: yellow }");
-      else
-        fpsLabel->setStyleSheet("");
-      playbackWasStalled = false;
-
-      timerLastFPSTime = QTime::currentTime();
-      timerFPSCounter = 0;
-    }
-
-    // Check if the time interval changed (the user changed the rate of the item)
-    if (currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame()))
-    {
-      // One (of the possibly two items) is indexed by frame. Get and set the frame rate
-      double frameRate = currentItem[0]->isIndexedByFrame() ? currentItem[0]->getFrameRate() : currentItem[1]->getFrameRate();
-      if (frameRate < 0.01)
-        frameRate = 0.01;
-
-      int newtimerInterval = 1000.0 / frameRate;
-      if (timerInterval != newtimerInterval)
-        startOrUpdateTimer();
-    }
+    playbackClock.advance(now, nrFramesAdvanced);
+    updateFPSLabel();
+
+    // Check if the frame rate changed (the user changed the rate of the item). The schedule continues from this frame.
+    const double frameRate = getPlaybackFrameRate();
+    if (frameRate != playbackClock.getFrameRate())
+      playbackClock.setFrameRate(frameRate);
+    scheduleNextTimerEvent();
   }
 }
 
@@ -585,12 +651,11 @@ void PlaybackController::currentSelectedItemsDoubleBufferLoad(int itemID)
     if (!waitingForItem[0] && !waitingForItem[1])
     {
       // Playback was stalled because we were waiting for the double buffer to load.
-      // We can go on now.
-      DEBUG_PLAYBACK("PlaybackController::currentSelectedItemsDoubleBufferLoad - timer interval %d", timerInterval);
-      timer.start(timerInterval, Qt::PreciseTimer, this);
-      timerEvent(nullptr);
-      // Playback is not stalled anymore
+      // We can go on now. The schedule restarts with the next frame which is shown right away.
+      DEBUG_PLAYBACK("PlaybackController::currentSelectedItemsDoubleBufferLoad - frame rate %f", playbackClock.getFrameRate());
       playbackMode = PlaybackRunning;
+      playbackClock.start(playbackTime.nsecsElapsed(), getPlaybackFrameRate());
+      timerEvent(nullptr);
     }
   }
 }
@@ -611,6 +676,12 @@ bool PlaybackController::setCurrentFrame(int frame, bool updateView)
   // Set the new value in the controls without invoking another signal
   const QSignalBlocker blocker1(frameSpinBox);
   const QSignalBlocker blocker2(frameSlider);
+  // Playback always runs forward. Otherwise the user is stepping through the sequence in some direction.
+  const int direction = (!playing() && frame < currentFrameIdx) ? -1 : 1;
+  for (const auto &item : currentItem)
+    if (item && item->isIndexedByFrame() && frame >= 0)
+      item->setPlaybackPosition(frame, direction);
+
   currentFrameIdx = frame;
   frameSpinBox->setValue(frame);
   frameSlider->setValue(frame);
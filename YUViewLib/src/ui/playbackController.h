@@ -33,12 +33,13 @@
 #pragma once
 
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QPointer>
-#include <QTime>
 #include <QWidget>
 
 #include "widgets/PlaylistTreeWidget.h"
 #include "views/splitViewWidget.h"
+#include "common/PlaybackClock.h"
 #include "common/typedef.h"
 
 #include "ui_playbackController.h"
@@ -70,6 +71,10 @@ public:
   // Return if an update was performed.
   bool setCurrentFrame(int frame, bool updateView=true);
 
+  // Called by the views after they drew the current frame. During playback, the frame times that are shown in the fps
+  // label are measured here. Both views may draw the same frame.
+  void currentFrameDrawn();
+
   // Using the currentFrameIdx and the repreat mode, calculate the next frame index.
   // -1: The next frame is the first fame of the next item.
   int getNextFrameIndex();
@@ -173,14 +178,26 @@ private:
 
   // Before starting playback of an item, do we wait until caching is complete?
   bool waitForCachingOfItem;
+  // If playback is late, are frames dropped to keep the time? If not, late frames are shown and playback slows down.
+  bool dropLateFrames;
 
-  // The timer for playback
+  // The timer for playback. It is restarted after every frame to fire when the next frame is due according to the
+  // playback clock. The playback clock uses the monotonic playbackTime as time source.
   QBasicTimer timer;
-  int    timerInterval;        // The current timer interval in milli seconds. If it changes, update the running timer.
-  int    timerFPSCounter;      // Every time the timer is toggled count this up. If it reaches 50, calculate FPS.
-  QTime  timerLastFPSTime;     // The last time we updated the FPS counter. Used to calculate new FPS.
+  QElapsedTimer playbackTime;
+  PlaybackClock playbackClock;
+  int64_t timerLastFPSTime;    // The last time (playbackTime) we updated the FPS label
+  int lastDrawnFrameIdx {-1};  // The last frame that a view drew during playback
   int    timerStaticItemCountDown; // Also for static items we run the timer to update the slider.
   virtual void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE; // Overloaded from QObject. Called when the timer fires.
+  // Start the timer so that it fires when the next frame is due
+  void scheduleNextTimerEvent();
+  // Get the frame rate for playback of the current item(s). For items that are not indexed by frame, the
+  // slider is updated with 10 fps.
+  double getPlaybackFrameRate() const;
+  // Show the frame rate and frame time jitter (measured when the frames are drawn) in the fps label (once per second)
+  void updateFPSLabel();
+  void resetFPSLabel();
 
   // We keep a pointer to the currently selected item(s)
   QPointer<playlistItem> currentItem[2];
@@ -65,6 +65,7 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   ui.checkBoxAskToSave->setChecked(settings.value("AskToSaveOnExit", true).toBool());
   ui.checkBoxContinuePlaybackNewSelection->setChecked(settings.value("ContinuePlaybackOnSequenceSelection", false).toBool());
   ui.checkBoxSavePositionPerItem->setChecked(settings.value("SavePositionAndZoomPerItem", false).toBool());
+  ui.checkBoxDropLateFrames->setChecked(settings.value("PlaybackDropLateFrames", false).toBool());
   // UI
   const auto theme = settings.value("Theme", "Default").toString();
   int themeIdx = functions::getThemeNameList().indexOf(theme);
@@ -125,6 +126,8 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   ui.checkBoxEnablePlaybackCaching->setChecked(playbackCaching);
   ui.spinBoxThreadLimit->setValue(settings.value("PlaybackCachingThreadLimit", 1).toInt());
   ui.spinBoxThreadLimit->setEnabled(playbackCaching);
+  ui.spinBoxReadAheadFrames->setValue(settings.value("ReadAheadFrames", 4).toInt());
+  ui.spinBoxDoubleBufferFrames->setValue(settings.value("PlaybackDoubleBufferFrames", 4).toInt());
   settings.endGroup();
 
   // "Decoders" tab
@@ -143,6 +146,11 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   ui.lineEditAVCodec->setText(settings.value("FFmpeg.avcodec", "").toString());
   ui.lineEditAVUtil->setText(settings.value("FFmpeg.avutil", "").toString());
   ui.lineEditSWResample->setText(settings.value("FFmpeg.swresample", "").toString());
+  // Threading (0 threads is automatic)
+  ui.spinBoxDecoderThreads->setValue(settings.value("DecoderThreads", 0).toInt());
+  ui.spinBoxCachingDecoderThreads->setValue(settings.value("CachingDecoderThreads", 0).toInt());
+  ui.comboBoxDav1dThreading->setCurrentIndex(settings.value("dav1dThreading", 0).toInt());
+  ui.comboBoxFFmpegThreading->setCurrentIndex(settings.value("FFmpegThreading", 0).toInt());
   settings.endGroup();
 }
 
@@ -361,6 +369,7 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("AskToSaveOnExit", ui.checkBoxAskToSave->isChecked());
   settings.setValue("ContinuePlaybackOnSequenceSelection", ui.checkBoxContinuePlaybackNewSelection->isChecked());
   settings.setValue("SavePositionAndZoomPerItem", ui.checkBoxSavePositionPerItem->isChecked());
+  settings.setValue("PlaybackDropLateFrames", ui.checkBoxDropLateFrames->isChecked());
   // UI
   settings.setValue("Theme", ui.comboBoxTheme->currentText());
   settings.setValue("SplitViewLineStyle", ui.comboBoxSplitLineStyle->currentText());
@@ -393,6 +402,8 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("PlaybackPauseCaching", ui.checkBoxPausPlaybackForCaching->isChecked());
   settings.setValue("PlaybackCachingEnabled", ui.checkBoxEnablePlaybackCaching->isChecked());
   settings.setValue("PlaybackCachingThreadLimit", ui.spinBoxThreadLimit->value());
+  settings.setValue("ReadAheadFrames", ui.spinBoxReadAheadFrames->value());
+  settings.setValue("PlaybackDoubleBufferFrames", ui.spinBoxDoubleBufferFrames->value());
   settings.endGroup();
 
   // "Decoders" tab
@@ -409,6 +420,11 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("FFmpeg.avcodec", ui.lineEditAVCodec->text());
   settings.setValue("FFmpeg.avutil", ui.lineEditAVUtil->text());
   settings.setValue("FFmpeg.swresample", ui.lineEditSWResample->text());
+  // Threading
+  settings.setValue("DecoderThreads", ui.spinBoxDecoderThreads->value());
+  settings.setValue("CachingDecoderThreads", ui.spinBoxCachingDecoderThreads->value());
+  settings.setValue("dav1dThreading", ui.comboBoxDav1dThreading->currentIndex());
+  settings.setValue("FFmpegThreading", ui.comboBoxFFmpegThreading->currentIndex());
   settings.endGroup();
   
   accept();
@@ -37,6 +37,7 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QVector>
 
 #include <optional>
 
@@ -93,6 +94,15 @@ public:
     bool intra;
   };
 
+  // A point that represents multiple points of a plot (level of detail). It covers the x range [xMin, xMax]
+  // and the values of the points in it are in the range [yMin, yMax].
+  struct DecimatedPoint
+  {
+    double xMin, xMax;
+    double yMin, yMax;
+    bool intra;
+  };
+
   virtual unsigned getNrStreams() const = 0;
   virtual StreamParameter getStreamParameter(unsigned streamIndex) const = 0;
   virtual Point getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const = 0;
@@ -100,6 +110,14 @@ public:
   virtual std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const = 0;
   virtual QString formatValue(Axis axis, double value) const = 0;
 
+  // If a plot has a lot of points in the given x range, the model can return a reduced set of points of which
+  // there are not (much) more than maxNrPoints. If nothing is returned, all points in the range must be drawn.
+  virtual std::optional<QVector<DecimatedPoint>> getDecimatedPlotPoints(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrPoints) const
+  {
+    Q_UNUSED(streamIndex); Q_UNUSED(plotIndex); Q_UNUSED(xRange); Q_UNUSED(maxNrPoints);
+    return {};
+  }
+
   std::optional<unsigned> getPointIndex(unsigned streamIndex, unsigned plotIndex, QPointF point) const;
 
 protected:
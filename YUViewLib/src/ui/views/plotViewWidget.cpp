@@ -34,6 +34,7 @@
 
 #include <QPainter>
 #include <QTextDocument>
+#include <algorithm>
 #include <cmath>
 
 #include "common/typedef.h"
@@ -617,6 +618,15 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
           detailedPainting = true;
       }
 
+      // When zoomed out, the model may provide a reduced set of points (a few per pixel)
+      const auto maxNrPoints = unsigned(std::max(this->plotRect.width(), 1.0) * 2);
+      const auto decimatedPoints = this->model->getDecimatedPlotPoints(streamIndex, plotIndex, {plotXMin, plotXMax}, maxNrPoints);
+      if (decimatedPoints)
+      {
+        this->drawDecimatedPlot(painter, plotParam.type, *decimatedPoints);
+        continue;
+      }
+
       if (plotParam.type == PlotModel::PlotType::Bar)
       {
         auto setPainterColor = [&painter, &detailedPainting](bool isIntra, bool isHighlight)
@@ -751,6 +761,49 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
   }
 }
 
+void PlotViewWidget::drawDecimatedPlot(QPainter &painter, PlotModel::PlotType type, const QVector<PlotModel::DecimatedPoint> &points) const
+{
+  DEBUG_PLOT("PlotViewWidget::drawDecimatedPlot Start drawing " << points.size() << " points");
+  if (type == PlotModel::PlotType::Bar)
+  {
+    // Every point is drawn as a bar from 0 to the maximum value
+    QVector<QRectF> normalBars;
+    QVector<QRectF> intraBars;
+    for (const auto &point : points)
+    {
+      const auto barTopLeft = this->convertPlotPosToPixelPos(QPointF(point.xMin, point.yMax));
+      const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(point.xMax, 0));
+      if (point.intra)
+        intraBars.append(QRectF(barTopLeft, barBottomRight));
+      else
+        normalBars.append(QRectF(barTopLeft, barBottomRight));
+    }
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 200, 100));
+    painter.drawRects(normalBars);
+    painter.setBrush(QColor(200, 100, 0, 100));
+    painter.drawRects(intraBars);
+  }
+  else if (type == PlotModel::PlotType::Line)
+  {
+    // Draw a vertical line from the minimum to the maximum value of each point
+    QPolygonF linePoints;
+    for (const auto &point : points)
+    {
+      const auto x = (point.xMin + point.xMax) / 2;
+      linePoints.append(this->convertPlotPosToPixelPos(QPointF(x, point.yMin)));
+      if (point.yMax != point.yMin)
+        linePoints.append(this->convertPlotPosToPixelPos(QPointF(x, point.yMax)));
+    }
+
+    QPen linePen(QColor(255, 200, 30));
+    linePen.setWidthF(1.0);
+    painter.setPen(linePen);
+    painter.drawPolyline(linePoints);
+  }
+}
+
 void PlotViewWidget::drawInfoBox(QPainter &painter) const
 {
   if (!this->model)
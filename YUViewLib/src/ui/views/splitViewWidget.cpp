@@ -470,6 +470,8 @@ void splitViewWidget::paintEvent(QPaintEvent *paint_event)
     QPoint pos = QPoint(10, drawArea_botR.y() - 10 - waitingForCachingPixmap.height());
     painter.drawPixmap(pos, waitingForCachingPixmap);
   }
+  else if (playing && anyItemsSelected)
+    playback->currentFrameDrawn();
 
   MoveAndZoomableView::updateMouseCursor();
 
@@ -1402,7 +1404,7 @@ void splitViewWidget::update(bool newFrame, bool itemRedraw)
         // We can immediately draw the new frame but then we need to update the double buffer
         if (this->isMasterView)
         {
-          item[0]->activateDoubleBuffer();
+          item[0]->activateDoubleBuffer(frameIdx);
           cache->loadFrame(item[0], frameIdx, 0);
         }
       }
@@ -1422,7 +1424,7 @@ void splitViewWidget::update(bool newFrame, bool itemRedraw)
         // We can immediately draw the new frame but then we need to update the double buffer
         if (this->isMasterView)
         {
-          item[1]->activateDoubleBuffer();
+          item[1]->activateDoubleBuffer(frameIdx);
           cache->loadFrame(item[1], frameIdx, 1);
         }
       }
@@ -59,6 +59,7 @@ BitstreamAnalysisWidget::BitstreamAnalysisWidget(QWidget *parent) :
   this->connect(this->ui.colorCodeStreamsCheckBox, &QCheckBox::toggled, this, &BitstreamAnalysisWidget::colorCodeStreamsCheckBoxToggled);
   this->connect(this->ui.parseEntireFileCheckBox, &QCheckBox::toggled, this, &BitstreamAnalysisWidget::parseEntireBitstreamCheckBoxToggled);
   this->connect(this->ui.bitratePlotOrderComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BitstreamAnalysisWidget::bitratePlotOrderComboBoxIndexChanged);
+  this->connect(this->ui.dataTreeView, &QTreeView::expanded, this, &BitstreamAnalysisWidget::dataTreeViewItemExpanded);
 
   this->currentSelectedItemsChanged(nullptr, nullptr, false);
 }
@@ -148,7 +149,7 @@ void BitstreamAnalysisWidget::updateParsingStatusText(int progressValue)
     this->ui.parsingStatusText->setText(QString("Parsing file (%1%)").arg(progressValue));
   else
   {
-    const bool parsingLimitSet = !this->ui.parseEntireFileCheckBox->isChecked();
+    const bool parsingLimitSet = !this->ui.parseEntireFileCheckBox->isChecked() && this->parser && this->parser->usesParsingLimit();
     this->ui.parsingStatusText->setText(parsingLimitSet ? "Partial parsing done. Enable full parsing if needed." : "Parsing done.");
   }
 }
@@ -251,6 +252,7 @@ void BitstreamAnalysisWidget::createAndConnectNewParser(inputFormat inputFormatT
   this->parser->enableModel();
   const bool parsingLimitSet = !this->ui.parseEntireFileCheckBox->isChecked();
   this->parser->setParsingLimitEnabled(parsingLimitSet);
+  this->ui.parseEntireFileCheckBox->setEnabled(this->parser->usesParsingLimit());
 
   this->connect(this->parser.data(), &parserBase::modelDataUpdated, this, &BitstreamAnalysisWidget::updateParserItemModel);
   this->connect(this->parser.data(), &parserBase::streamInfoUpdated, this, &BitstreamAnalysisWidget::updateStreamInfo);
@@ -65,6 +65,7 @@ private slots:
   void colorCodeStreamsCheckBoxToggled(bool state) { this->parser->setStreamColorCoding(state); }
   void parseEntireBitstreamCheckBoxToggled(bool state) { Q_UNUSED(state); this->restartParsingOfCurrentItem(); }
   void bitratePlotOrderComboBoxIndexChanged(int index);
+  void dataTreeViewItemExpanded(const QModelIndex &index) { if (this->parser) this->parser->setPacketItemUsed(index); }
 
 protected:
   void hideEvent(QHideEvent *event) override;
@@ -0,0 +1,154 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ReadyFrameQueue.h"
+
+#include <algorithm>
+
+namespace
+{
+
+int64_t getImageSize(const QImage &image)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  return int64_t(image.byteCount());
+#else
+  return int64_t(image.sizeInBytes());
+#endif
+}
+
+} // namespace
+
+void ReadyFrameQueue::setDepth(int depth)
+{
+  QMutexLocker locker(&this->mutex);
+  this->depth = std::max(depth, 1);
+  this->removeFramesBeyondLimits();
+}
+
+int ReadyFrameQueue::getDepth() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->depth;
+}
+
+void ReadyFrameQueue::setMaxSize(int64_t maxSize)
+{
+  QMutexLocker locker(&this->mutex);
+  this->maxSize = std::max(maxSize, int64_t(0));
+  this->removeFramesBeyondLimits();
+}
+
+int64_t ReadyFrameQueue::getMaxSize() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->maxSize;
+}
+
+bool ReadyFrameQueue::isFull() const
+{
+  QMutexLocker locker(&this->mutex);
+  if (this->frames.size() >= this->depth)
+    return true;
+  if (this->maxSize == 0 || this->frames.isEmpty())
+    return false;
+  return this->getSizeInBytesInternal() + getImageSize(this->frames.last()) > this->maxSize;
+}
+
+void ReadyFrameQueue::addFrame(int frameIdx, const QImage &image)
+{
+  QMutexLocker locker(&this->mutex);
+  this->frames.insert(frameIdx, image);
+  this->removeFramesBeyondLimits();
+}
+
+QImage ReadyFrameQueue::takeFrame(int frameIdx)
+{
+  QMutexLocker locker(&this->mutex);
+  if (!this->frames.contains(frameIdx))
+    return {};
+  const QImage image = this->frames.value(frameIdx);
+  while (!this->frames.isEmpty() && this->frames.firstKey() <= frameIdx)
+    this->frames.erase(this->frames.begin());
+  return image;
+}
+
+bool ReadyFrameQueue::contains(int frameIdx) const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->frames.contains(frameIdx);
+}
+
+void ReadyFrameQueue::removeFramesOutside(int firstFrameIdx, int lastFrameIdx)
+{
+  QMutexLocker locker(&this->mutex);
+  for (auto it = this->frames.begin(); it != this->frames.end();)
+  {
+    if (it.key() < firstFrameIdx || it.key() > lastFrameIdx)
+      it = this->frames.erase(it);
+    else
+      ++it;
+  }
+}
+
+void ReadyFrameQueue::clear()
+{
+  QMutexLocker locker(&this->mutex);
+  this->frames.clear();
+}
+
+int ReadyFrameQueue::getNumberOfFrames() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->frames.size();
+}
+
+int64_t ReadyFrameQueue::getSizeInBytes() const
+{
+  QMutexLocker locker(&this->mutex);
+  return this->getSizeInBytesInternal();
+}
+
+void ReadyFrameQueue::removeFramesBeyondLimits()
+{
+  while (this->frames.size() > this->depth || (this->maxSize > 0 && this->frames.size() > 1 && this->getSizeInBytesInternal() > this->maxSize))
+    this->frames.erase(std::prev(this->frames.end()));
+}
+
+int64_t ReadyFrameQueue::getSizeInBytesInternal() const
+{
+  int64_t size = 0;
+  for (const auto &image : this->frames)
+    size += getImageSize(image);
+  return size;
+}
@@ -0,0 +1,83 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+
+/* The frames that are prepared for playback ahead of the current frame (a double buffer that can hold more than
+ * one frame). While playback is running, the interactive loading thread of an item fills the queue with the next
+ * frames up to the depth of the queue. So a single frame that takes longer to load than one frame interval
+ * (e.g. an intra coded frame) does not stall playback as long as the frames are loaded fast enough on average.
+ */
+class ReadyFrameQueue
+{
+public:
+  ReadyFrameQueue(int depth = 1) { setDepth(depth); }
+
+  // The maximum number of frames in the queue (at least 1)
+  void setDepth(int depth);
+  int getDepth() const;
+  // The maximum size of all frames in the queue in bytes. The queue always holds at least one frame.
+  // A size of 0 does not limit the size.
+  void setMaxSize(int64_t maxSize);
+  int64_t getMaxSize() const;
+  // Can no other frame be added without removing a frame? The next frame is assumed to be as big as the last one.
+  bool isFull() const;
+
+  // Add a frame. An existing frame with the same index is replaced. If the queue is full,
+  // the frames that are furthest ahead are removed.
+  void addFrame(int frameIdx, const QImage &image);
+  // Take the frame out of the queue. All frames before it are removed as well (playback passed them).
+  // Return a null image if the frame is not in the queue.
+  QImage takeFrame(int frameIdx);
+  bool contains(int frameIdx) const;
+  // Remove all frames that are not in the range [firstFrameIdx, lastFrameIdx] (e.g. after playback jumped)
+  void removeFramesOutside(int firstFrameIdx, int lastFrameIdx);
+  void clear();
+
+  int getNumberOfFrames() const;
+  int64_t getSizeInBytes() const;
+
+private:
+  // Remove the frames that are furthest ahead until the depth and the size limit are met (the mutex must be locked)
+  void removeFramesBeyondLimits();
+  int64_t getSizeInBytesInternal() const;
+
+  QMap<int, QImage> frames;
+  int depth {1};
+  int64_t maxSize {0};
+  mutable QMutex mutex;
+};
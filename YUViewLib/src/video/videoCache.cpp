@@ -38,6 +38,7 @@
 #include <QScrollArea>
 #include <QSettings>
 #include <QThread>
+#include <atomic>
 
 #include "common/functions.h"
 #include "ui/playbackController.h"
@@ -78,10 +79,13 @@ public:
   loadingWorker(QObject *parent) : QObject(parent) { currentCacheItem = nullptr; working = false; id = id_counter++; }
   playlistItem *getCacheItem() { return currentCacheItem; }
   int getCacheFrame() { return currentFrame; }
-  void setJob(playlistItem *item, int frame, bool test=false);
+  // Set a job for the worker. A caching job may contain a range of consecutive frames (up to lastFrame).
+  void setJob(playlistItem *item, int frame, bool test=false, int lastFrame=-1);
   void setWorking(bool state) { working = state; }
   bool isWorking() { return working; }
-  QString getStatus() { return QString("T%1: %2").arg(id).arg(working ? QString::number(currentFrame) : QString("-")); }
+  // Stop a running caching job after the frame that is currently cached
+  void interruptJob() { interrupted = true; }
+  QString getStatus();
   // Process the job in the thread that this worker was moved to. This function can be directly
   // called from the main thread. It will still process the call in the separate thread.
   void processCacheJob();
@@ -94,6 +98,8 @@ private slots:
 private:
   playlistItem *currentCacheItem;
   int currentFrame;
+  int lastFrame;
+  std::atomic_bool interrupted {false};
   bool working;
   bool testMode;
   int id;   // A static ID of the thread. Only used in getStatus().
@@ -102,13 +108,24 @@ private:
 // Initially this is 0. The threads will number themselves so that there are never two threads with the same id
 int loadingWorker::id_counter = 0;
 
-void loadingWorker::setJob(playlistItem *item, int frame, bool test)
+void loadingWorker::setJob(playlistItem *item, int frame, bool test, int lastFrame)
 {
   Q_ASSERT_X(item != nullptr, Q_FUNC_INFO, "Given item is nullptr");
   Q_ASSERT_X(frame >= 0 || !item->isIndexedByFrame(), Q_FUNC_INFO, "Given frame index invalid");
   currentCacheItem = item;
   currentFrame = frame;
+  this->lastFrame = std::max(frame, lastFrame);
   testMode = test;
+  interrupted = false;
+}
+
+QString loadingWorker::getStatus()
+{
+  if (!working)
+    return QString("T%1: -").arg(id);
+  if (lastFrame > currentFrame)
+    return QString("T%1: %2-%3").arg(id).arg(currentFrame).arg(lastFrame);
+  return QString("T%1: %2").arg(id).arg(currentFrame);
 }
 
 void loadingWorker::processCacheJob()
@@ -129,9 +146,12 @@ void loadingWorker::processCacheJobInternal()
   Q_ASSERT_X(currentFrame >= 0 || !currentCacheItem->isIndexedByFrame(), Q_FUNC_INFO, "Given frame index invalid");
   DEBUG_JOBS("loadingWorker::processCacheJobInternal");
 
-  // Just cache the frame that was given to us.
+  // Just cache the frames that were given to us.
   // This is performed in the thread that this worker is currently placed in.
-  currentCacheItem->cacheFrame(currentFrame, testMode);
+  const indexRange jobRange(currentFrame, lastFrame);
+  currentCacheItem->cacheFrame(currentFrame, testMode, jobRange);
+  while (currentFrame < lastFrame && !interrupted)
+    currentCacheItem->cacheFrame(++currentFrame, testMode, jobRange);
   
   currentCacheItem = nullptr;
   DEBUG_JOBS("loadingWorker::processCacheJobInternal emit loadingFinished");
@@ -281,7 +301,8 @@ void videoCache::updateSettings()
   QSettings settings;
   settings.beginGroup("VideoCache");
   cachingEnabled = settings.value("Enabled", true).toBool();
-  cacheLevelMax = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
+  cacheSizeLimit = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
+  cacheLevelMax = cacheSizeLimit;
 
   // See if the user changed the number of threads
   int targetNrThreads = functions::getOptimalThreadCount();
@@ -351,12 +372,17 @@ void videoCache::loadFrame(playlistItem * item, int frameIndex, int loadingSlot)
       DEBUG_CACHING_DETAIL("videoCache::loadFrame %d queued for later - slot %d", frameIndex, loadingSlot);
       interactiveItemQueued[loadingSlot] = item;
       interactiveItemQueued_Idx[loadingSlot] = frameIndex;
+      // Don't let the request wait until the running job loaded all frames ahead of playback into the double buffer
+      playlistItem *loadingItem = interactiveThread[loadingSlot]->worker()->getCacheItem();
+      if (loadingItem)
+        loadingItem->setDoubleBufferLoadingInterrupted(true);
     }
   }
   else
   {
     // Let the interactive worker work...
     bool loadRawData = splitView->showRawData() && !playback->playing();
+    item->setDoubleBufferLoadingInterrupted(false);
     interactiveThread[loadingSlot]->worker()->setJob(item, frameIndex);
     interactiveThread[loadingSlot]->worker()->setWorking(true);
     interactiveThread[loadingSlot]->worker()->processLoadingJob(playback->playing(), loadRawData);
@@ -410,6 +436,7 @@ void videoCache::interactiveLoaderFinished()
   {
     // Let the interactive worker work on the queued request.
     bool loadRawData = splitView->showRawData() && !playback->playing();
+    interactiveItemQueued[threadID]->setDoubleBufferLoadingInterrupted(false);
     interactiveThread[threadID]->worker()->setJob(interactiveItemQueued[threadID], interactiveItemQueued_Idx[threadID]);
     interactiveThread[threadID]->worker()->setWorking(true);
     interactiveThread[threadID]->worker()->processLoadingJob(playback->playing(), loadRawData);
@@ -433,6 +460,7 @@ void videoCache::scheduleCachingListUpdate()
   {
     // First, the worker has to stop. Request a stop and an update of the queue.
     workersState = workersIntReqRestart;
+    interruptCachingJobs();
     DEBUG_CACHING("videoCache::playlistChanged new state %d (workersIntReqRestart)", workersState);
     return;
   }
@@ -506,6 +534,14 @@ void videoCache::updateCacheQueue()
   int itemPos = allItems.indexOf(selection[0]);
   Q_ASSERT_X(itemPos >= 0, Q_FUNC_INFO, "The current item is not in the list of all items? No possible.");
 
+  // The items buffer frames outside of the cache (e.g. the decoded picture buffer of the interactive decoder).
+  // These use memory as well so the space for the cache is reduced accordingly.
+  int64_t bufferedFramesSize = 0;
+  for (playlistItem *item : allItems)
+    bufferedFramesSize += item->getBufferedFramesSize();
+  cacheLevelMax = std::max(cacheSizeLimit - bufferedFramesSize, int64_t(0));
+  DEBUG_CACHING("videoCache::updateCacheQueue %d bytes buffered outside of the cache", int(bufferedFramesSize));
+
   // At first, let's find out how much space in the cache is used.
   // In combination with cacheLevelMax we also know how much space is free.
   // While we are iterating through the list, we will delete all cached frames from the cache that will 
@@ -1186,16 +1222,25 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
           continue;
       }
 
-      // We can start another thread for this item
+      // We can start another thread for this item. The item may want to cache more than one
+      // frame in one job (e.g. all frames up to the next random access point).
       plItem = job.plItem;
       range = job.frameRange;
+      range.second = clip(plItem->getCachingJobEnd(range.first), range.first, range.second);
+      // One job should not take more than its share of the cache
+      const int64_t itemFrameSize = plItem->getCachingFrameSize();
+      if (itemFrameSize > 0)
+      {
+        const int64_t maxFramesPerJob = std::max(int64_t(1), cacheLevelMax / std::max(1, cachingThreadList.count()) / itemFrameSize);
+        range.second = int(std::min(int64_t(range.second), range.first + maxFramesPerJob - 1));
+      }
 
-      // Check if this is the last frame to cache in the item 
-      if (range.first == range.second)
+      // Check if these are the last frames to cache in the item 
+      if (range.second == job.frameRange.second)
         j.remove();
       else
         // Update the frame range of the head item in the cache queue
-        job.frameRange.first = range.first + 1;
+        job.frameRange.first = range.second + 1;
 
       break;
     }
@@ -1204,13 +1249,13 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
     // No item found that we can start another caching thread for.
     return false;
 
-  // Get the size of one frame in bytes
-  unsigned int frameSize = plItem->getCachingFrameSize();
+  // Get the size of the frames of the job in bytes
+  int64_t frameSize = int64_t(plItem->getCachingFrameSize()) * (range.second - range.first + 1);
 
-  // We found an item that we can cache. Cache the first frame of it.
+  // We found an item that we can cache. Cache the frames of the job.
   int frameToCache = range.first;
 
-  // First check if we need to free up space to cache this frame.
+  // First check if we need to free up space to cache these frames.
   while (cacheLevelCurrent + frameSize >= cacheLevelMax && !cacheDeQueue.isEmpty())
   {
     plItemFrame frameToRemove = cacheDeQueue.dequeue();
@@ -1231,10 +1276,10 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
 
   // Push the job to the thread
   Q_ASSERT_X(plItem != nullptr && frameToCache >= 0, Q_FUNC_INFO, "Invalid job.");
-  thread->worker()->setJob(plItem, frameToCache);
+  thread->worker()->setJob(plItem, frameToCache, false, range.second);
   thread->worker()->setWorking(true);
   thread->worker()->processCacheJob();
-  DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread - %d of %s", frameToCache, plItem->getName().toStdString().c_str());
+  DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread - %d-%d of %s", frameToCache, range.second, plItem->getName().toStdString().c_str());
 
   // Update the cache level
   cacheLevelCurrent += frameSize;
@@ -1242,6 +1287,13 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
   return true;
 }
 
+void videoCache::interruptCachingJobs()
+{
+  for (loadingThread *t : cachingThreadList)
+    if (t->worker()->isWorking())
+      t->worker()->interruptJob();
+}
+
 void videoCache::itemAboutToBeDeleted(playlistItem* item)
 {
   // One of the items is about to be deleted. Let's stop the caching. Then the item can be deleted
@@ -1260,6 +1312,7 @@ void videoCache::itemAboutToBeDeleted(playlistItem* item)
 
     // An item is about to be deleted. We need to rethink what to cache next.
     workersState = workersIntReqRestart;
+    interruptCachingJobs();
   }
 
   if (cachingItem || loadingItem)
@@ -1318,6 +1371,7 @@ void videoCache::itemNeedsRecache(playlistItem* item, recacheIndicator clearItem
         // We can clear the cache now
         item->removeAllFramesFromCache();
       workersState = workersIntReqRestart;
+      interruptCachingJobs();
     }
     else
     {
@@ -131,6 +131,9 @@ private:
   // If a frame is removed can be determined by the following cache states:
   int64_t cacheLevelMax;
   int64_t cacheLevelCurrent;
+  // The cache size from the settings. The frames that the items buffer outside of the cache are counted against it,
+  // so cacheLevelMax is this size minus the size of the buffered frames of all items.
+  int64_t cacheSizeLimit {0};
 
   // Enqueue the job in the queue. If all frames within the range are already cached in the item, do nothing.
   void enqueueCacheJob(playlistItem* item, indexRange range);
@@ -172,9 +175,12 @@ private:
   playlistItem  *interactiveItemQueued[2];
   int            interactiveItemQueued_Idx[2];
 
-  // Get the next item and frame to cache from the queue and push it to the given worker.
+  // Get the next item and frames to cache from the queue and push them to the given worker. An item can
+  // request that more than one frame is cached in one job (playlistItem::getCachingJobEnd()).
   // Return false if there are no more jobs to be pushed.
   bool pushNextJobToCachingThread(loadingThread *thread);
+  // A job can contain many frames. When a restart is requested, the running jobs stop after the current frame.
+  void interruptCachingJobs();
   
   bool updateCacheQueueAndRestartWorker;
 
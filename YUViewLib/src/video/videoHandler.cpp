@@ -49,7 +49,6 @@ videoHandler::videoHandler()
   // Initialize variables
   currentImageIdx = -1;
   currentImage_frameIndex = -1;
-  doubleBufferImageFrameIdx = -1;
   cacheValid = true;
   currentFrameRawData_frameIdx = -1;
   rawData_frameIdx = -1;
@@ -103,72 +102,35 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   // Lock the mutex for checking the cache
   QMutexLocker lock(&imageCacheAccess);
 
-  // The raw values are not needed. 
-  if (frameIdx == currentImageIdx)
+  // The raw values are not needed. Is the frame the current frame, in the double buffer or in the cache?
+  auto isReady = [this](int idx) { return doubleBuffer.contains(idx) || (cacheValid && imageCache.contains(idx)); };
+  if (frameIdx != currentImageIdx && !isReady(frameIdx))
   {
-    if (doubleBufferImageFrameIdx == frameIdx + 1)
-    {
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in double buffer", frameIdx, frameIdx+1);
-      return LoadingNotNeeded;
-    }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
-    {
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in cache", frameIdx, frameIdx+1);
-      return LoadingNotNeeded;
-    }
-    else
-    {
-      // The next frame is not in the double buffer so that needs to be loaded.
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current but %d not found in double buffer", frameIdx, frameIdx+1);
-      return LoadingNeededDoubleBuffer;
-    }
+    // Frame not in buffer. Return false and request the background loading thread to load the frame.
+    DEBUG_VIDEO("videoHandler::needsLoading %d not found in cache - request load", frameIdx);
+    return LoadingNeeded;
   }
 
-  // Check the double buffer
-  if (doubleBufferImageFrameIdx == frameIdx)
+  // The frame can be drawn. What about the next frames? Are they also in the double buffer or in the cache?
+  const int depth = doubleBuffer.getDepth();
+  for (int i = 1; i <= depth; i++)
   {
-    // The frame in question is in the double buffer...
-    if (cacheValid && imageCache.contains(frameIdx + 1))
-    {
-      // ... and the one after that is in the cache.
-      DEBUG_VIDEO("videoHandler::needsLoading %d found in double buffer. Next frame in cache.", frameIdx);
-      return LoadingNotNeeded;
-    }
-    else
+    if (!isReady(frameIdx + i))
     {
-      // .. and the one after that is not in the cache.
-      // Loading of the given frame index is not needed because it is in the double buffer but if you draw it, 
-      // the double buffer needs an update.
-      DEBUG_VIDEO("videoHandler::needsLoading %d found in double buffer", frameIdx);
+      // Loading of the given frame index is not needed but the double buffer needs an update.
+      DEBUG_VIDEO("videoHandler::needsLoading %d found but %d not found in double buffer", frameIdx, frameIdx + i);
       return LoadingNeededDoubleBuffer;
     }
   }
 
-  // Check the cache
-  if (cacheValid && imageCache.contains(frameIdx))
-  {
-    // What about the next frame? Is it also in the cache or in the double buffer?
-    if (doubleBufferImageFrameIdx == frameIdx + 1)
-    {
-      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in double buffer", frameIdx, frameIdx+1);
-      return LoadingNotNeeded;
-    }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
-    {
-      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in cache", frameIdx, frameIdx+1);
-      return LoadingNotNeeded;
-    }
-    else
-    {
-      // The next frame is not in the double buffer so that needs to be loaded.
-      DEBUG_VIDEO("videoHandler::needsLoading %d found in cache but %d not found in double buffer", frameIdx, frameIdx+1);
-      return LoadingNeededDoubleBuffer;
-    }
-  }
+  DEBUG_VIDEO("videoHandler::needsLoading %d found and the next %d frames found", frameIdx, depth);
+  return LoadingNotNeeded;
+}
 
-  // Frame not in buffer. Return false and request the background loading thread to load the frame.
-  DEBUG_VIDEO("videoHandler::needsLoading %d not found in cache - request load", frameIdx);
-  return LoadingNeeded;
+bool videoHandler::isFrameReady(int frameIdx) const
+{
+  QMutexLocker lock(&imageCacheAccess);
+  return doubleBuffer.contains(frameIdx) || (cacheValid && imageCache.contains(frameIdx));
 }
 
 void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues)
@@ -179,7 +141,8 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
     // The current buffer is out of date. Update it.
 
     // Check the double buffer
-    if (frameIdx == doubleBufferImageFrameIdx)
+    const QImage doubleBufferImage = doubleBuffer.takeFrame(frameIdx);
+    if (!doubleBufferImage.isNull())
     {
       currentImage = doubleBufferImage;
       currentImageIdx = frameIdx;
@@ -275,6 +238,26 @@ void videoHandler::cacheFrame(int frameIdx, bool testMode)
     DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
 }
 
+void videoHandler::cacheFrame(int frameIdx, const QByteArray &frameRawData, bool testMode)
+{
+  DEBUG_VIDEO("videoHandler::cacheFrame %d from raw data %s", frameIdx, testMode ? "testMode" : "");
+
+  if (cacheValid && isInCache(frameIdx) && !testMode)
+    return;
+
+  QImage cacheImage;
+  convertRawFrameForCaching(frameRawData, cacheImage);
+
+  if (!cacheImage.isNull())
+  {
+    QMutexLocker imageCacheLock(&imageCacheAccess);
+    if (cacheValid && !testMode)
+      imageCache.insert(frameIdx, cacheImage);
+  }
+  else
+    DEBUG_VIDEO("videoHandler::cacheFrame converting frame %i for caching failed", frameIdx);
+}
+
 unsigned int videoHandler::getCachingFrameSize() const
 {
   auto bytes = functions::bytesPerPixel(functions::platformImageFormat());
@@ -334,11 +317,8 @@ void videoHandler::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   }
 
   if (loadToDoubleBuffer)
-  {
     // Save the requested frame in the double buffer
-    doubleBufferImage = requestedFrame;
-    doubleBufferImageFrameIdx = frameIndex;
-  }
+    doubleBuffer.addFrame(frameIndex, requestedFrame);
   else
   {
     // Set the requested frame as the current frame
@@ -379,18 +359,21 @@ void videoHandler::invalidateAllBuffers()
   currentImage = QImage();
   currentImageSetMutex.unlock();
   requestedFrame_idx = -1;
+  doubleBuffer.clear();
 
   imageCache.clear();
   cacheValid = true;
 }
 
-void videoHandler::activateDoubleBuffer()
+void videoHandler::activateDoubleBuffer(int frameIndex)
 {
-  if (doubleBufferImageFrameIdx != -1)
+  const QImage doubleBufferImage = doubleBuffer.takeFrame(frameIndex);
+  if (!doubleBufferImage.isNull())
   {
+    QMutexLocker imageLock(&currentImageSetMutex);
     currentImage = doubleBufferImage;
-    currentImageIdx = doubleBufferImageFrameIdx;
-    DEBUG_VIDEO("videoHandler::drawFrame %d loaded from double buffer", currentImageIdx);
+    currentImageIdx = frameIndex;
+    DEBUG_VIDEO("videoHandler::activateDoubleBuffer %d loaded from double buffer", currentImageIdx);
   }
 }
 
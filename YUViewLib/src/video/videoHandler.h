@@ -37,6 +37,7 @@
 #include <QMutex>
 
 #include "video/frameHandler.h"
+#include "video/ReadyFrameQueue.h"
 
 /* TODO
 */
@@ -58,6 +59,10 @@ public:
   // These methods are all thread-safe and can be invoked from any thread.
   int getNrFramesCached() const;
   void cacheFrame(int frameIdx, bool testMode);
+  // Cache a frame from raw data that was already loaded by the caller (e.g. from one of several decoders
+  // of a compressed stream). Unlike cacheFrame(int, bool), this does not request the data and several frames can be
+  // converted and cached at the same time.
+  void cacheFrame(int frameIdx, const QByteArray &frameRawData, bool testMode);
   unsigned int getCachingFrameSize() const; // How much bytes will be used when caching one frame?
   QList<int> getCachedFrames() const;
   int getNumberCachedFrames() const;
@@ -92,9 +97,12 @@ public:
   // the data will be reloaded from file.
   void invalidateAllBuffers();
 
-  // The user changed the frame. Do we need to load something before we can draw it? Do we need to update the double buffer?
+  // The user changed the frame. Do we need to load something before we can draw it? Do we need to update the double buffer
+  // (the queue of frames that are ready for playback after this frame)?
   // loadRawValues: Do we also need to update the buffer of the raw values because they will be drawn?
   itemLoadingState needsLoading(int frameIndex, bool loadRawValues);
+  // Is the frame in the queue of ready frames or in the cache?
+  bool isFrameReady(int frameIndex) const;
 
   // The video handler want's to draw a frame but it's not cached yet and has to be loaded.
   // A sub class can change this implementation to request raw data of a certain format instead of an image.
@@ -104,8 +112,18 @@ public:
 
   int getCurrentImageIndex() { return currentImageIdx; }
 
-  // Set the image in the double buffer as the current image. After this, a new image can be loaded to the double buffer.
-  void activateDoubleBuffer();
+  // Take the given frame from the double buffer and set it as the current image. The frames before it are removed
+  // from the double buffer so that the following frames can be loaded.
+  void activateDoubleBuffer(int frameIndex);
+  // How many frames ahead of the current frame are loaded into the double buffer during playback?
+  void setDoubleBufferDepth(int nrFrames) { doubleBuffer.setDepth(nrFrames); }
+  int getDoubleBufferDepth() const { return doubleBuffer.getDepth(); }
+  // The maximum number of bytes that the frames in the double buffer may use (0: no limit)
+  void setDoubleBufferMaxSize(int64_t maxSize) { doubleBuffer.setMaxSize(maxSize); }
+  bool isDoubleBufferFull() const { return doubleBuffer.isFull(); }
+  int64_t getDoubleBufferSizeInBytes() const { return doubleBuffer.getSizeInBytes(); }
+  // Remove the frames that are not in the given range from the double buffer
+  void removeFramesFromDoubleBufferOutside(int firstFrameIdx, int lastFrameIdx) { doubleBuffer.removeFramesOutside(firstFrameIdx, lastFrameIdx); }
 
   // Create the controls for this videoHandler and return a pointer to the layout (nullptr if the handler has no controls).
   // isSizeFixed: For example a YUV file does not have a fixed format (the user can change this),
@@ -162,6 +180,8 @@ protected:
   // the requested frame. No other internal state of the specific video format handler should be changed.
   // currentFrame/currentFrameIdx is still the frame on screen. This is called from a background thread.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache);
+  // Convert the given raw data (in the format of the handler) for caching. The default implementation does nothing.
+  virtual void convertRawFrameForCaching(const QByteArray &frameRawData, QImage &frameToCache) { Q_UNUSED(frameRawData); Q_UNUSED(frameToCache); }
     
   // Only one thread at a time should request something to be loaded. 
   QMutex requestDataMutex;
@@ -172,9 +192,8 @@ protected:
   // Don't let the background loading thread set the image while we are drawing it.
   QMutex currentImageSetMutex;
 
-  // Double buffering
-  QImage doubleBufferImage;
-  int    doubleBufferImageFrameIdx;
+  // Double buffering. During playback, the next frames are loaded into this queue.
+  ReadyFrameQueue doubleBuffer;
 
   // Set the cache to be invalid until a call to removefromCache(-1) clears it.
   void setCacheInvalid() { cacheValid = false; }
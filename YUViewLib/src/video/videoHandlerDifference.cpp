@@ -63,7 +63,8 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter, int frameIdx
     // The current buffer is out of date. Update it.
 
     // Check the double buffer
-    if (frameIdx == doubleBufferImageFrameIdx)
+    const QImage doubleBufferImage = doubleBuffer.takeFrame(frameIdx);
+    if (!doubleBufferImage.isNull())
     {
       currentImage = doubleBufferImage;
       currentImageIdx = frameIdx;
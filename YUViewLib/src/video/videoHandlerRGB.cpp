@@ -370,8 +370,7 @@ void videoHandlerRGB::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   {
     QImage newImage;
     convertRGBToImage(currentFrameRawData, newImage);
-    doubleBufferImage = newImage;
-    doubleBufferImageFrameIdx = frameIndex;
+    doubleBuffer.addFrame(frameIndex, newImage);
   }
   else if (currentImageIdx != frameIndex)
   {
@@ -410,6 +409,15 @@ void videoHandlerRGB::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   rgbFormatMutex.unlock();
 }
 
+void videoHandlerRGB::convertRawFrameForCaching(const QByteArray &frameRawData, QImage &frameToCache)
+{
+  // The RGB format must not change while converting
+  QMutexLocker lock(&rgbFormatMutex);
+  if (frameRawData.size() < srcPixelFormat.bytesPerFrame(frameSize))
+    return;
+  convertRGBToImage(frameRawData, frameToCache);
+}
+
 // Load the raw RGB data for the given frame index into currentFrameRawData.
 bool videoHandlerRGB::loadRawRGBData(int frameIndex)
 {
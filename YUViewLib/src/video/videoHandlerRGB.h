@@ -141,6 +141,7 @@ protected:
   // Load the given frame and return it for caching. The current buffers (currentFrameRawRGBData and currentFrame)
   // will not be modified.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache) Q_DECL_OVERRIDE;
+  virtual void convertRawFrameForCaching(const QByteArray &frameRawData, QImage &frameToCache) Q_DECL_OVERRIDE;
 
 private:
 
@@ -988,8 +988,7 @@ void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   {
     QImage newImage;
     convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
-    doubleBufferImage = newImage;
-    doubleBufferImageFrameIdx = frameIndex;
+    doubleBuffer.addFrame(frameIndex, newImage);
   }
   else if (currentImageIdx != frameIndex)
   {
@@ -1025,6 +1024,17 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   convertYUVToImage(tmpBufferRawYUVDataCaching, frameToCache, yuvFormat, curFrameSize);
 }
 
+void videoHandlerYUV::convertRawFrameForCaching(const QByteArray &frameRawData, QImage &frameToCache)
+{
+  // Get the YUV format and the size here, so that the caching process does not crash if this changes.
+  yuvPixelFormat yuvFormat = srcPixelFormat;
+  const QSize curFrameSize = frameSize;
+
+  if (frameRawData.size() < yuvFormat.bytesPerFrame(curFrameSize))
+    return;
+  convertYUVToImage(frameRawData, frameToCache, yuvFormat, curFrameSize);
+}
+
 // Load the raw YUV data for the given frame index into currentFrameRawData.
 bool videoHandlerYUV::loadRawYUVData(int frameIndex)
 {
@@ -2998,11 +3008,11 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
   const int nrBytesLumaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeLuma_In[0] : componentSizeLuma_In[0], bps_in[1] > 8 ? 2 * componentSizeLuma_In[1] : componentSizeLuma_In[1]};
   const int nrBytesChromaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeChroma_In[0] : componentSizeChroma_In[0], bps_in[1] > 8 ? 2 * componentSizeChroma_In[1] : componentSizeChroma_In[1]};
   // Current item
-  const unsigned char * restrict srcY1 = (unsigned char*)currentFrameRawData.data();
+  const unsigned char * restrict srcY1 = (unsigned char*)currentFrameRawData.constData();
   const unsigned char * restrict srcU1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] : srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0];
   const unsigned char * restrict srcV1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0]: srcY1 + nrBytesLumaPlane_In[0];
   // The other item
-  const unsigned char * restrict srcY2 = (unsigned char*)yuvItem2->currentFrameRawData.data();
+  const unsigned char * restrict srcY2 = (unsigned char*)yuvItem2->currentFrameRawData.constData();
   const unsigned char * restrict srcU2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] : srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1];
   const unsigned char * restrict srcV2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1]: srcY2 + nrBytesLumaPlane_In[1];
 
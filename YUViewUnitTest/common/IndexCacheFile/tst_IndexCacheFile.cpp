@@ -0,0 +1,154 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <common/IndexCacheFile.h>
+
+class IndexCacheFileTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  IndexCacheFileTest();
+  ~IndexCacheFileTest();
+
+private slots:
+  void testSaveAndLoad();
+  void testFileChanged();
+  void testFormatTagMismatch();
+  void testFormatMismatch();
+  void testReadError();
+};
+
+namespace
+{
+
+const IndexCacheFile::Format testFormat {"YUVTEST1", 1, "testIndex"};
+const QString formatTag = "parserAnnexBHEVC";
+const QList<qint64> testIndex {0, 100, 2000, 30000};
+
+bool writeFile(const QString &fileName, const QByteArray &data)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  return file.write(data) == data.size();
+}
+
+bool saveTestIndex(const QString &fileName, const IndexCacheFile::Format &format, const QString &tag, const IndexCacheFile::FileState &fileState)
+{
+  return IndexCacheFile::save(fileName, format, tag, fileState, [](QDataStream &out) { out << testIndex; });
+}
+
+bool loadTestIndex(const QString &fileName, const IndexCacheFile::Format &format, const QString &tag, QList<qint64> &index)
+{
+  return IndexCacheFile::load(fileName, format, tag, [&index](QDataStream &in) { in >> index; return true; });
+}
+
+} // namespace
+
+IndexCacheFileTest::IndexCacheFileTest()
+{
+  // Do not write to the cache directory of the user
+  QStandardPaths::setTestModeEnabled(true);
+}
+
+IndexCacheFileTest::~IndexCacheFileTest() {}
+
+void IndexCacheFileTest::testSaveAndLoad()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stream.hevc");
+  QVERIFY(writeFile(fileName, QByteArray(2000, 'x')));
+
+  const auto fileState = IndexCacheFile::getFileState(fileName);
+  QCOMPARE(fileState.size, qint64(2000));
+  QVERIFY(saveTestIndex(fileName, testFormat, formatTag, fileState));
+
+  QList<qint64> loaded;
+  QVERIFY(loadTestIndex(fileName, testFormat, formatTag, loaded));
+  QCOMPARE(loaded, testIndex);
+
+  QFile::remove(IndexCacheFile::getIndexFilePath(fileName, testFormat));
+}
+
+void IndexCacheFileTest::testFileChanged()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stream.hevc");
+  QVERIFY(writeFile(fileName, QByteArray(2000, 'x')));
+
+  // The file changed while it was parsed. The index must not be saved.
+  auto fileState = IndexCacheFile::getFileState(fileName);
+  QVERIFY(writeFile(fileName, QByteArray(3000, 'x')));
+  QVERIFY(!saveTestIndex(fileName, testFormat, formatTag, fileState));
+
+  // The file changed after the index was saved. The index must not be used.
+  fileState = IndexCacheFile::getFileState(fileName);
+  QVERIFY(saveTestIndex(fileName, testFormat, formatTag, fileState));
+  QVERIFY(writeFile(fileName, QByteArray(4000, 'x')));
+  QList<qint64> loaded;
+  QVERIFY(!loadTestIndex(fileName, testFormat, formatTag, loaded));
+
+  QFile::remove(IndexCacheFile::getIndexFilePath(fileName, testFormat));
+}
+
+void IndexCacheFileTest::testFormatTagMismatch()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("video.mp4");
+  QVERIFY(writeFile(fileName, QByteArray(100, 'x')));
+
+  QVERIFY(saveTestIndex(fileName, testFormat, "FFmpeg/0", IndexCacheFile::getFileState(fileName)));
+
+  QList<qint64> loaded;
+  QVERIFY(!loadTestIndex(fileName, testFormat, "FFmpeg/1", loaded));
+  QVERIFY(loadTestIndex(fileName, testFormat, "FFmpeg/0", loaded));
+
+  QFile::remove(IndexCacheFile::getIndexFilePath(fileName, testFormat));
+}
+
+void IndexCacheFileTest::testFormatMismatch()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stats.csv");
+  QVERIFY(writeFile(fileName, QByteArray(100, 'x')));
+  QVERIFY(saveTestIndex(fileName, testFormat, formatTag, IndexCacheFile::getFileState(fileName)));
+
+  // An index file with a different magic or version (in the same directory) is not used
+  const IndexCacheFile::Format otherMagic {"YUVTEST2", 1, "testIndex"};
+  const IndexCacheFile::Format otherVersion {"YUVTEST1", 2, "testIndex"};
+  QCOMPARE(IndexCacheFile::getIndexFilePath(fileName, otherMagic), IndexCacheFile::getIndexFilePath(fileName, testFormat));
+  QList<qint64> loaded;
+  QVERIFY(!loadTestIndex(fileName, otherMagic, formatTag, loaded));
+  QVERIFY(!loadTestIndex(fileName, otherVersion, formatTag, loaded));
+
+  // Different formats are saved in different directories
+  const IndexCacheFile::Format otherDir {"YUVTEST1", 1, "otherIndex"};
+  QVERIFY(IndexCacheFile::getIndexFilePath(fileName, otherDir) != IndexCacheFile::getIndexFilePath(fileName, testFormat));
+  QVERIFY(!loadTestIndex(fileName, otherDir, formatTag, loaded));
+
+  QFile::remove(IndexCacheFile::getIndexFilePath(fileName, testFormat));
+}
+
+void IndexCacheFileTest::testReadError()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stream.hevc");
+  QVERIFY(writeFile(fileName, QByteArray(100, 'x')));
+  QVERIFY(saveTestIndex(fileName, testFormat, formatTag, IndexCacheFile::getFileState(fileName)));
+
+  // Reading past the end of the index file or a failing read function fails the load
+  QVERIFY(!IndexCacheFile::load(fileName, testFormat, formatTag, [](QDataStream &in) { QList<qint64> index; in >> index >> index; return true; }));
+  QVERIFY(!IndexCacheFile::load(fileName, testFormat, formatTag, [](QDataStream &) { return false; }));
+
+  QFile::remove(IndexCacheFile::getIndexFilePath(fileName, testFormat));
+}
+
+QTEST_MAIN(IndexCacheFileTest)
+
+#include "tst_IndexCacheFile.moc"
@@ -0,0 +1,153 @@
+#include <QtTest>
+
+#include <common/PlaybackClock.h>
+
+class PlaybackClockTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PlaybackClockTest();
+  ~PlaybackClockTest();
+
+private slots:
+  void testSchedule();
+  void testNoDrift();
+  void testLateFrames();
+  void testFrameRateChange();
+  void testStatistics();
+};
+
+namespace
+{
+
+int64_t msToNs(double msec)
+{
+  return int64_t(msec * 1e6);
+}
+
+} // namespace
+
+PlaybackClockTest::PlaybackClockTest()
+{
+}
+
+PlaybackClockTest::~PlaybackClockTest()
+{
+}
+
+void PlaybackClockTest::testSchedule()
+{
+  // 59.94 fps must not be rounded to an integer millisecond interval
+  PlaybackClock clock;
+  clock.start(0, 60000.0 / 1001);
+  QCOMPARE(clock.getNumberFramesDue(0), 0);
+  QCOMPARE(clock.getMsecsToNextFrame(0), 17);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(16.68)), 0);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(16.69)), 1);
+
+  // After 1001 ms exactly 60 frames are due
+  QCOMPARE(clock.getNumberFramesDue(msToNs(1000.99)), 59);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(1001.01)), 60);
+}
+
+void PlaybackClockTest::testNoDrift()
+{
+  PlaybackClock clock;
+  clock.start(0, 50);
+
+  // The timer fires a bit late every time. The frames are still scheduled at multiples of 20 ms.
+  for (int frame = 1; frame <= 100; frame++)
+  {
+    const auto now = msToNs(frame * 20 + 3);
+    QCOMPARE(clock.getNumberFramesDue(now), 1);
+    clock.advance(now);
+    QCOMPARE(clock.getMsecsToNextFrame(now), 17);
+  }
+  QCOMPARE(clock.getNumberDroppedFrames(), 0);
+  QCOMPARE(clock.getNumberPresentedFrames(), 100);
+}
+
+void PlaybackClockTest::testLateFrames()
+{
+  // Late frames are dropped
+  PlaybackClock clock;
+  clock.start(0, 50);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(70)), 3);
+  clock.advance(msToNs(70), 3);
+  QCOMPARE(clock.getNumberDroppedFrames(), 2);
+  QCOMPARE(clock.getMsecsToNextFrame(msToNs(70)), 10);
+
+  // A late frame is shown. The schedule restarts instead of showing the following frames without a delay.
+  clock.start(0, 50);
+  clock.advance(msToNs(70));
+  QCOMPARE(clock.getNumberDroppedFrames(), 2);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(71)), 0);
+  QCOMPARE(clock.getMsecsToNextFrame(msToNs(70)), 20);
+
+  // A frame that is shown before it is due also restarts the schedule
+  clock.start(0, 50);
+  clock.advance(0);
+  QCOMPARE(clock.getMsecsToNextFrame(0), 20);
+}
+
+void PlaybackClockTest::testFrameRateChange()
+{
+  PlaybackClock clock;
+  clock.start(0, 50);
+  clock.advance(msToNs(21));
+
+  // The schedule continues from the due time of the last frame (20 ms)
+  clock.setFrameRate(25);
+  QCOMPARE(clock.getFrameRate(), 25.0);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(59)), 0);
+  QCOMPARE(clock.getNumberFramesDue(msToNs(60)), 1);
+
+  // Very low frame rates are limited
+  clock.setFrameRate(0);
+  QCOMPARE(clock.getFrameRate(), 0.01);
+}
+
+void PlaybackClockTest::testStatistics()
+{
+  PlaybackClock clock;
+  clock.start(0, 100);
+  QCOMPARE(clock.getAverageFrameRate(), 0.0);
+  QCOMPARE(clock.getFrameTimeJitter(), 0.0);
+
+  // The frame times are measured when the frames are drawn, not when they are presented
+  for (int frame = 1; frame <= 10; frame++)
+    clock.advance(msToNs(frame * 10));
+  QCOMPARE(clock.getNumberPresentedFrames(), 10);
+  QCOMPARE(clock.getAverageFrameRate(), 0.0);
+
+  // The first frame after the start has no frame time
+  for (int frame = 1; frame <= 10; frame++)
+    clock.addDrawnFrame(msToNs(frame * 10 + 3));
+  QCOMPARE(clock.getAverageFrameRate(), 100.0);
+  QCOMPARE(clock.getFrameTimeJitter(), 0.0);
+
+  // Alternating frame times of 8 and 12 ms
+  clock.resetStatistics();
+  QCOMPARE(clock.getNumberPresentedFrames(), 0);
+  int64_t now = msToNs(103);
+  for (int frame = 0; frame < 10; frame++)
+  {
+    now += msToNs(frame % 2 == 0 ? 8 : 12);
+    clock.addDrawnFrame(now);
+  }
+  QCOMPARE(clock.getAverageFrameRate(), 100.0);
+  QVERIFY(qAbs(clock.getFrameTimeJitter() - 2.0) < 1e-6);
+
+  // A restart of the schedule (e.g. after playback stalled) does not count the time until the next frame is drawn
+  clock.resetStatistics();
+  clock.start(msToNs(1000), 100);
+  clock.addDrawnFrame(msToNs(1001));
+  QCOMPARE(clock.getAverageFrameRate(), 0.0);
+  clock.addDrawnFrame(msToNs(1011));
+  QCOMPARE(clock.getAverageFrameRate(), 100.0);
+}
+
+QTEST_MAIN(PlaybackClockTest)
+
+#include "tst_PlaybackClock.moc"
@@ -0,0 +1,4 @@
+TEMPLATE = subdirs
+
+SUBDIRS = PlaybackClock
+SUBDIRS += IndexCacheFile
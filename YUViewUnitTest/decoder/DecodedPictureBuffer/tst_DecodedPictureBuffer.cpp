@@ -0,0 +1,133 @@
+#include <QtTest>
+
+#include <decoder/DecodedPictureBuffer.h>
+
+class DecodedPictureBufferTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DecodedPictureBufferTest();
+  ~DecodedPictureBufferTest();
+
+private slots:
+  void testAddAndGet();
+  void testReplacePicture();
+  void testRemoveOldest();
+  void testPictureTooBig();
+  void testSetMaxSize();
+};
+
+namespace
+{
+
+QByteArray createPicture(int frameIdx, int nrBytes)
+{
+  return QByteArray(nrBytes, char(frameIdx));
+}
+
+} // namespace
+
+DecodedPictureBufferTest::DecodedPictureBufferTest()
+{
+}
+
+DecodedPictureBufferTest::~DecodedPictureBufferTest()
+{
+}
+
+void DecodedPictureBufferTest::testAddAndGet()
+{
+  DecodedPictureBuffer buffer(1000);
+  QCOMPARE(buffer.getNumberOfPictures(), 0);
+  QVERIFY(buffer.getPicture(0).isEmpty());
+
+  buffer.addPicture(0, createPicture(0, 100));
+  buffer.addPicture(1, createPicture(1, 100));
+  QCOMPARE(buffer.getNumberOfPictures(), 2);
+  QCOMPARE(buffer.getSizeInBytes(), int64_t(200));
+  QVERIFY(buffer.contains(1));
+  QVERIFY(!buffer.contains(2));
+  QCOMPARE(buffer.getPicture(1), createPicture(1, 100));
+
+  // Empty pictures are not added
+  buffer.addPicture(2, QByteArray());
+  QVERIFY(!buffer.contains(2));
+
+  buffer.clear();
+  QCOMPARE(buffer.getNumberOfPictures(), 0);
+  QCOMPARE(buffer.getSizeInBytes(), int64_t(0));
+  QVERIFY(!buffer.contains(0));
+}
+
+void DecodedPictureBufferTest::testReplacePicture()
+{
+  DecodedPictureBuffer buffer(1000);
+  buffer.addPicture(5, createPicture(5, 100));
+  buffer.addPicture(5, createPicture(6, 300));
+  QCOMPARE(buffer.getNumberOfPictures(), 1);
+  QCOMPARE(buffer.getSizeInBytes(), int64_t(300));
+  QCOMPARE(buffer.getPicture(5), createPicture(6, 300));
+}
+
+void DecodedPictureBufferTest::testRemoveOldest()
+{
+  DecodedPictureBuffer buffer(1000);
+  // Pictures are added in decoding order which is not the display order
+  const QList<int> decodingOrder = {0, 8, 4, 2, 1, 3, 6, 5, 7};
+  for (auto frameIdx : decodingOrder)
+    buffer.addPicture(frameIdx, createPicture(frameIdx, 300));
+
+  // Only the 3 pictures that were added last fit
+  QCOMPARE(buffer.getNumberOfPictures(), 3);
+  QCOMPARE(buffer.getSizeInBytes(), int64_t(900));
+  QVERIFY(buffer.contains(6));
+  QVERIFY(buffer.contains(5));
+  QVERIFY(buffer.contains(7));
+  QVERIFY(!buffer.contains(3));
+  QVERIFY(!buffer.contains(8));
+}
+
+void DecodedPictureBufferTest::testPictureTooBig()
+{
+  DecodedPictureBuffer buffer(1000);
+  buffer.addPicture(0, createPicture(0, 600));
+  buffer.addPicture(1, createPicture(1, 1001));
+  QVERIFY(!buffer.contains(1));
+  // The buffer is not emptied by a picture that can not be added
+  QVERIFY(buffer.contains(0));
+
+  buffer.addPicture(2, createPicture(2, 1000));
+  QCOMPARE(buffer.getNumberOfPictures(), 1);
+  QVERIFY(buffer.contains(2));
+}
+
+void DecodedPictureBufferTest::testSetMaxSize()
+{
+  DecodedPictureBuffer buffer;
+  buffer.addPicture(0, createPicture(0, 100));
+  QVERIFY(!buffer.contains(0));
+  QVERIFY(!buffer.canHold(1, 100));
+
+  buffer.setMaxSize(1000);
+  for (int frameIdx = 0; frameIdx < 5; frameIdx++)
+    buffer.addPicture(frameIdx, createPicture(frameIdx, 200));
+  QCOMPARE(buffer.getNumberOfPictures(), 5);
+  QVERIFY(buffer.canHold(5, 200));
+  QVERIFY(!buffer.canHold(6, 200));
+
+  // Shrinking the buffer removes the oldest pictures
+  buffer.setMaxSize(500);
+  QCOMPARE(buffer.getMaxSize(), int64_t(500));
+  QCOMPARE(buffer.getNumberOfPictures(), 2);
+  QVERIFY(buffer.contains(3));
+  QVERIFY(buffer.contains(4));
+
+  buffer.setMaxSize(0);
+  QCOMPARE(buffer.getNumberOfPictures(), 0);
+  QCOMPARE(buffer.getSizeInBytes(), int64_t(0));
+}
+
+QTEST_MAIN(DecodedPictureBufferTest)
+
+#include "tst_DecodedPictureBuffer.moc"
@@ -0,0 +1,140 @@
+#include <QtTest>
+
+#include <decoder/decoderBase.h>
+
+class DecoderStatisticsTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DecoderStatisticsTest();
+  ~DecoderStatisticsTest();
+
+private slots:
+  void testOnlyRequestedTypesExtracted();
+  void testExtractOnDemand();
+  void testNoExtractionAfterNextFrame();
+};
+
+namespace
+{
+
+// A decoder that "decodes" frames with the statistics types 0 to 3. Each type is one block with the frame number as value.
+class TestDecoder : public decoderBase
+{
+public:
+  TestDecoder() : decoderBase(false)
+  {
+    internalsSupported = true;
+    decoderState = DecoderState::RetrieveFrames;
+  }
+
+  bool decodeNextFrame() override
+  {
+    frameNr++;
+    currentOutputBufferFilled = false;
+    return true;
+  }
+  QByteArray getRawFrameData() override
+  {
+    if (!currentOutputBufferFilled)
+    {
+      currentOutputBufferFilled = true;
+      if (retrieveStatistics)
+        cacheStatisticsOfCurrentFrame();
+    }
+    return QByteArray(16, char(frameNr));
+  }
+  bool pushData(QByteArray &data) override { Q_UNUSED(data); return true; }
+  QStringList getLibraryPaths() const override { return {}; }
+  QString getDecoderName() const override { return "Test"; }
+  QString getCodecName() override { return "Test"; }
+
+  QList<int> extractedTypes;
+
+protected:
+  void cacheStatistics(const QSet<int> &typeIDs) override
+  {
+    for (int typeID = 0; typeID < 4; typeID++)
+    {
+      if (!typeIDs.contains(typeID))
+        continue;
+      extractedTypes.append(typeID);
+      curPOCStats[typeID].addBlockValue(0, 0, 8, 8, frameNr);
+    }
+  }
+
+private:
+  int frameNr {0};
+};
+
+} // namespace
+
+DecoderStatisticsTest::DecoderStatisticsTest()
+{
+}
+
+DecoderStatisticsTest::~DecoderStatisticsTest()
+{
+}
+
+void DecoderStatisticsTest::testOnlyRequestedTypesExtracted()
+{
+  TestDecoder decoder;
+  decoder.enableStatisticsRetrieval();
+  decoder.setStatisticsTypesToRetrieve(QList<int>() << 1 << 3);
+
+  for (int i = 0; i < 3; i++)
+  {
+    decoder.decodeNextFrame();
+    decoder.getRawFrameData();
+  }
+  QCOMPARE(decoder.extractedTypes, QList<int>() << 1 << 3 << 1 << 3 << 1 << 3);
+  QCOMPARE(decoder.getStatisticsData(3).valueData.size(), 1);
+  QCOMPARE(decoder.getStatisticsData(3).valueData[0].value, 3);
+
+  // Without statistics retrieval, nothing is extracted
+  decoder.disableStatisticsRetrieval();
+  decoder.extractedTypes.clear();
+  decoder.decodeNextFrame();
+  decoder.getRawFrameData();
+  QVERIFY(decoder.extractedTypes.isEmpty());
+  QVERIFY(decoder.getStatisticsData(1).isEmpty());
+}
+
+void DecoderStatisticsTest::testExtractOnDemand()
+{
+  TestDecoder decoder;
+  decoder.enableStatisticsRetrieval();
+  decoder.setStatisticsTypesToRetrieve(QList<int>() << 0);
+  decoder.decodeNextFrame();
+  decoder.getRawFrameData();
+  QCOMPARE(decoder.extractedTypes, QList<int>() << 0);
+
+  // Type 2 was enabled. It is extracted from the current frame once.
+  QVERIFY(decoder.isStatisticsTypeAvailable(2));
+  QCOMPARE(decoder.getStatisticsData(2).valueData.size(), 1);
+  QCOMPARE(decoder.getStatisticsData(2).valueData.size(), 1);
+  QCOMPARE(decoder.extractedTypes, QList<int>() << 0 << 2);
+  // The already extracted types are kept
+  QCOMPARE(decoder.getStatisticsData(0).valueData.size(), 1);
+}
+
+void DecoderStatisticsTest::testNoExtractionAfterNextFrame()
+{
+  TestDecoder decoder;
+  decoder.enableStatisticsRetrieval();
+  decoder.setStatisticsTypesToRetrieve(QList<int>() << 0);
+  decoder.decodeNextFrame();
+  decoder.getRawFrameData();
+
+  // The next frame was decoded but not retrieved. The statistics of the last frame can not be extracted anymore.
+  decoder.decodeNextFrame();
+  QVERIFY(!decoder.isStatisticsTypeAvailable(1));
+  QVERIFY(decoder.getStatisticsData(1).isEmpty());
+  QCOMPARE(decoder.extractedTypes, QList<int>() << 0);
+}
+
+QTEST_MAIN(DecoderStatisticsTest)
+
+#include "tst_DecoderStatistics.moc"
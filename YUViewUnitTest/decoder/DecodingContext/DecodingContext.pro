@@ -0,0 +1,17 @@
+TEMPLATE = app
+
+CONFIG += qt console warn_on no_testcase_installs depend_includepath testcase
+CONFIG -= debug_and_release
+CONFIG -= app_bundled
+CONFIG += c++1z
+
+TARGET = tst_DecodingContext
+
+QT += testlib widgets
+
+INCLUDEPATH += $$top_srcdir/YUViewLib/src
+# The playlist item includes its generated ui header
+INCLUDEPATH += $$top_builddir/YUViewLib
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+SOURCES += tst_DecodingContext.cpp
@@ -0,0 +1,65 @@
+#include <QtTest>
+
+#include <playlistitem/playlistItemCompressedVideo.h>
+
+class DecodingContextTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DecodingContextTest();
+  ~DecodingContextTest();
+
+private slots:
+  void testNoCachingJob();
+  void testCachingJobRange();
+};
+
+namespace
+{
+
+// The decoding context is only used internally by the compressed video item
+class CompressedVideoItem : public playlistItemCompressedVideo
+{
+public:
+  using playlistItemCompressedVideo::DecodingContext;
+};
+
+} // namespace
+
+DecodingContextTest::DecodingContextTest()
+{
+}
+
+DecodingContextTest::~DecodingContextTest()
+{
+}
+
+void DecodingContextTest::testNoCachingJob()
+{
+  // A context that does not decode for a caching job (the loading decoder) does not cache any frames
+  CompressedVideoItem::DecodingContext context;
+  for (int frameIdx = 0; frameIdx < 8; frameIdx++)
+    QVERIFY(!context.isInCachingJob(frameIdx));
+}
+
+void DecodingContextTest::testCachingJobRange()
+{
+  // A job for frames 10 to 15. Decoding starts at the random access point at frame 8.
+  CompressedVideoItem::DecodingContext context;
+  context.cachingJobRange = indexRange(10, 15);
+  QVERIFY(!context.isInCachingJob(8));
+  QVERIFY(!context.isInCachingJob(9));
+  for (int frameIdx = 10; frameIdx <= 15; frameIdx++)
+    QVERIFY(context.isInCachingJob(frameIdx));
+  QVERIFY(!context.isInCachingJob(16));
+
+  // When the context is lent to interactive loading, the job is reset
+  context.cachingJobRange = indexRange(-1, -1);
+  QVERIFY(!context.isInCachingJob(-1));
+  QVERIFY(!context.isInCachingJob(12));
+}
+
+QTEST_MAIN(DecodingContextTest)
+
+#include "tst_DecodingContext.moc"
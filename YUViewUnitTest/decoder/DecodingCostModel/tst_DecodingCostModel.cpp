@@ -0,0 +1,96 @@
+#include <QtTest>
+
+#include <decoder/DecodingCostModel.h>
+
+class DecodingCostModelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DecodingCostModelTest();
+  ~DecodingCostModelTest();
+
+private slots:
+  void testDefaultThreshold();
+  void testMeasuredCosts();
+  void testAlwaysSeek();
+  void testSeekCostFloor();
+};
+
+DecodingCostModelTest::DecodingCostModelTest()
+{
+}
+
+DecodingCostModelTest::~DecodingCostModelTest()
+{
+}
+
+void DecodingCostModelTest::testDefaultThreshold()
+{
+  // Without measurements, seeking costs as much as decoding 5 frames
+  DecodingCostModel model;
+  QVERIFY(!model.hasMeasurements());
+  QVERIFY(!model.shouldSeek(10, 16, 16));
+  QVERIFY(model.shouldSeek(10, 30, 30));
+  QVERIFY(!model.shouldSeek(10, 20, 12));
+  QCOMPARE(model.getCost(10, 16, 16), 6.0);
+}
+
+void DecodingCostModelTest::testMeasuredCosts()
+{
+  DecodingCostModel model;
+  model.addFrameDecodeTime(100.0, 10);
+  // The decoding of the first frame after the seek is not counted as seek time
+  model.addSeekTime(60.0);
+  QVERIFY(model.hasMeasurements());
+  QCOMPARE(model.getFrameDecodeTime(), 10.0);
+  QCOMPARE(model.getSeekTime(), 50.0);
+
+  // Decoding 20 frames forward (200 msec) or seeking and decoding 5 frames (100 msec)
+  QCOMPARE(model.getDecodeForwardCost(10, 30), 200.0);
+  QCOMPARE(model.getSeekCost(26, 30), 100.0);
+  QVERIFY(model.shouldSeek(10, 30, 26));
+  QCOMPARE(model.getCost(10, 30, 26), 100.0);
+
+  // Expensive seeks (e.g. long GOPs with a lot of decoder delay) favor decoding forward
+  for (int i = 0; i < 50; i++)
+    model.addSeekTime(1000.0);
+  QVERIFY(model.getSeekTime() > 900.0);
+  QVERIFY(!model.shouldSeek(10, 30, 26));
+  QCOMPARE(model.getCost(10, 30, 26), 200.0);
+
+  // Invalid measurements are ignored
+  model.addFrameDecodeTime(100.0, 0);
+  QCOMPARE(model.getFrameDecodeTime(), 10.0);
+}
+
+void DecodingCostModelTest::testAlwaysSeek()
+{
+  DecodingCostModel model;
+  model.addFrameDecodeTime(1.0, 1);
+  model.addSeekTime(1000.0);
+
+  // Nothing decoded yet or going backwards requires seeking
+  QVERIFY(model.shouldSeek(-1, 5, 0));
+  QVERIFY(model.shouldSeek(20, 5, 0));
+  QVERIFY(qIsInf(model.getDecodeForwardCost(20, 5)));
+  // A random access point before the current frame does not help
+  QVERIFY(!model.shouldSeek(10, 100, 8));
+  QVERIFY(!model.shouldSeek(10, 10, 8));
+}
+
+void DecodingCostModelTest::testSeekCostFloor()
+{
+  // The first frame after the seek was output immediately. Seeking is still not free.
+  DecodingCostModel model;
+  model.addFrameDecodeTime(100.0, 10);
+  model.addSeekTime(10.0);
+  QCOMPARE(model.getSeekTime(), 0.0);
+  QCOMPARE(model.getSeekCost(26, 30), 70.0);
+  QVERIFY(!model.shouldSeek(24, 27, 26));
+  QVERIFY(model.shouldSeek(20, 30, 26));
+}
+
+QTEST_MAIN(DecodingCostModelTest)
+
+#include "tst_DecodingCostModel.moc"
@@ -0,0 +1,3 @@
+TEMPLATE = subdirs
+
+SUBDIRS = DecodingCostModel DecodedPictureBuffer DecoderStatistics DecodingContext
@@ -7,7 +7,7 @@ CONFIG += c++1z
 
 TARGET = tst_Filesource
 
-QT += testlib
+QT += testlib concurrent
 QT -= gui
 
 INCLUDEPATH += $$top_srcdir/YUViewLib/src
@@ -1,5 +1,9 @@
 #include <QtTest>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <filesource/FileSource.h>
 
 class FileSourceTest : public QObject
@@ -13,9 +17,44 @@ public:
 private slots:
   void testFormatFromFilename_data();
   void testFormatFromFilename();
+  void testReadBytes();
+  void testReadBytesFileChanged();
+  void testReadAhead();
+  void benchmarkReadAhead_data();
+  void benchmarkReadAhead();
+};
+
+namespace
+{
+
+const int frameSize = 100000;
+const int nrFrames = 20;
+
+QByteArray createFrameData()
+{
+  QByteArray data(frameSize * nrFrames, char(0));
+  for (int i = 0; i < data.size(); i++)
+    data[i] = char(i * 7 + i / 256);
+  return data;
+}
 
+// Keeps the mapping if the file changes (like a file source that uses the mapping directly)
+class KeepMappingFileSource : public FileSource
+{
+public:
+  KeepMappingFileSource() { this->keepMappingIfChanged = true; }
 };
 
+QList<FileSource::FileRange> getNextFrameRanges(int frameIdx, int nrReadAheadFrames)
+{
+  QList<FileSource::FileRange> ranges;
+  for (int i = frameIdx + 1; i <= frameIdx + nrReadAheadFrames && i < nrFrames; i++)
+    ranges.append(FileSource::FileRange(i * frameSize, frameSize));
+  return ranges;
+}
+
+} // namespace
+
 FileSourceTest::FileSourceTest()
 {
 }
@@ -120,6 +159,181 @@ void FileSourceTest::testFormatFromFilename()
   QCOMPARE(fileFormat.packed, packed);
 }
 
+void FileSourceTest::testReadBytes()
+{
+  QByteArray content(1000000, char(0));
+  for (int i = 0; i < content.size(); i++)
+    content[i] = char(i * 7 + i / 256);
+
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+
+  FileSource source;
+  QVERIFY(source.openFile(file.fileName()));
+#ifndef Q_OS_WIN
+  QVERIFY(source.isMemoryMapped());
+#endif
+
+  // Read from multiple threads at the same time
+  const int nrThreads = 8;
+  const int nrBytes = 10000;
+  std::atomic<int> nrErrors(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nrThreads; t++)
+  {
+    threads.emplace_back([&, t]() {
+      QByteArray data;
+      for (int64_t startPos = t; startPos + nrBytes <= content.size(); startPos += 9973)
+      {
+        if (source.readBytes(data, startPos, nrBytes) != nrBytes || data.left(nrBytes) != content.mid(int(startPos), nrBytes))
+          nrErrors++;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  QCOMPARE(nrErrors.load(), 0);
+
+  // Reading over the end of the file returns the remaining bytes
+  QByteArray data;
+  QCOMPARE(source.readBytes(data, content.size() - 100, 1000), int64_t(100));
+  QCOMPARE(data.left(100), content.right(100));
+
+  // Data that was appended after the file was mapped can still be read
+  const QByteArray appended(500, char(42));
+  QCOMPARE(file.write(appended), int64_t(appended.size()));
+  QVERIFY(file.flush());
+  QCOMPARE(source.readBytes(data, content.size() - 100, 600), int64_t(600));
+  QCOMPARE(data.left(600), content.right(100) + appended);
+}
+
+void FileSourceTest::testReadBytesFileChanged()
+{
+  const auto content = createFrameData();
+
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+
+  FileSource source;
+  QVERIFY(source.openFile(file.fileName()));
+  QByteArray data;
+  QCOMPARE(source.readBytes(data, frameSize, frameSize), int64_t(frameSize));
+
+  // The data that was read does not depend on the file (or its mapping) anymore
+  QVERIFY(file.resize(0));
+  QVERIFY(source.openFile(file.fileName()));
+  QCOMPARE(data.left(frameSize), content.mid(frameSize, frameSize));
+
+  // A changed file is not accessed through the mapping anymore
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+  QVERIFY(source.openFile(file.fileName()));
+  QVERIFY(file.resize(frameSize));
+  QTRY_VERIFY(source.isFileChanged());
+  QVERIFY(!source.isMemoryMapped());
+  QCOMPARE(source.readBytes(data, frameSize, frameSize), int64_t(0));
+  QCOMPARE(source.readBytes(data, 0, frameSize), int64_t(frameSize));
+  QCOMPARE(data.left(frameSize), content.left(frameSize));
+
+  // A truncated file is not read from a mapping that is kept (before the change is noticed or if it is never noticed)
+  QVERIFY(file.resize(0));
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+  KeepMappingFileSource keepingSource;
+  QVERIFY(keepingSource.openFile(file.fileName()));
+#ifndef Q_OS_WIN
+  QVERIFY(keepingSource.isMemoryMapped());
+#endif
+  QVERIFY(file.resize(frameSize));
+  QCOMPARE(keepingSource.readBytes(data, frameSize, frameSize), int64_t(0));
+  QCOMPARE(keepingSource.readBytes(data, 0, frameSize), int64_t(frameSize));
+  QCOMPARE(data.left(frameSize), content.left(frameSize));
+}
+
+void FileSourceTest::testReadAhead()
+{
+  const auto content = createFrameData();
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+
+  // The read ahead is only used for files which are not mapped
+  FileSource source;
+  source.setUseMemoryMapping(false);
+  QVERIFY(source.openFile(file.fileName()));
+  QVERIFY(!source.isMemoryMapped());
+
+  // Read forward and backward. Also request ranges that are dropped again before they are read.
+  QByteArray data;
+  for (const int direction : {1, -1})
+  {
+    for (int i = 0; i < nrFrames; i++)
+    {
+      const int frameIdx = (direction == 1) ? i : nrFrames - 1 - i;
+      QCOMPARE(source.readBytes(data, frameIdx * frameSize, frameSize), int64_t(frameSize));
+      QCOMPARE(data.left(frameSize), content.mid(frameIdx * frameSize, frameSize));
+      source.readAhead(getNextFrameRanges(nrFrames - 1 - frameIdx, 3));
+      source.readAhead(getNextFrameRanges(frameIdx, 3));
+    }
+  }
+
+  // Two consumers reading in opposite directions do not drop each others ranges
+  for (int i = 0; i < nrFrames; i++)
+  {
+    for (const int consumerID : {1, 2})
+    {
+      const int frameIdx = (consumerID == 1) ? i : nrFrames - 1 - i;
+      QCOMPARE(source.readBytes(data, frameIdx * frameSize, frameSize), int64_t(frameSize));
+      QCOMPARE(data.left(frameSize), content.mid(frameIdx * frameSize, frameSize));
+      source.readAhead(getNextFrameRanges(frameIdx, 3), consumerID);
+    }
+  }
+
+  // A range that only partly matches a read ahead range is read directly
+  source.readAhead(getNextFrameRanges(0, 2));
+  QCOMPARE(source.readBytes(data, frameSize + 10, 100), int64_t(100));
+  QCOMPARE(data.left(100), content.mid(frameSize + 10, 100));
+}
+
+void FileSourceTest::benchmarkReadAhead_data()
+{
+  QTest::addColumn<int>("nrReadAheadFrames");
+  QTest::newRow("No read ahead") << 0;
+  QTest::newRow("Read ahead 4 frames") << 4;
+}
+
+void FileSourceTest::benchmarkReadAhead()
+{
+  QFETCH(int, nrReadAheadFrames);
+
+  const auto content = createFrameData();
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QCOMPARE(file.write(content), int64_t(content.size()));
+  QVERIFY(file.flush());
+
+  // The difference is only significant on storage with a high latency (e.g. a network share)
+  FileSource source;
+  source.setUseMemoryMapping(false);
+  QVERIFY(source.openFile(file.fileName()));
+
+  QBENCHMARK
+  {
+    // Read all frames in order like the playback of a raw file does
+    QByteArray data;
+    for (int frameIdx = 0; frameIdx < nrFrames; frameIdx++)
+    {
+      QCOMPARE(source.readBytes(data, frameIdx * frameSize, frameSize), int64_t(frameSize));
+      source.readAhead(getNextFrameRanges(frameIdx, nrReadAheadFrames));
+    }
+  }
+}
+
 QTEST_MAIN(FileSourceTest)
 
 #include "tst_Filesource.moc"
@@ -1,4 +1,5 @@
 #include <QtTest>
+#include <QRandomGenerator>
 #include <QTemporaryFile>
 
 #include <filesource/FileSourceAnnexBFile.h>
@@ -16,6 +17,9 @@ public:
 private slots:
   void testNalUnitParsing_data();
   void testNalUnitParsing();
+  void testFindStartCodes_data();
+  void testFindStartCodes();
+  void testFindNextStartCode();
 };
 
 FileSourceAnnexBTest::FileSourceAnnexBTest()
@@ -41,16 +45,18 @@ void FileSourceAnnexBTest::testNalUnitParsing_data()
   QTest::newRow("testNormalPosition7") << unsigned(3) << unsigned(10000) << QList<unsigned>({4, 80, 208, 9990});
   QTest::newRow("testNormalPosition8") << unsigned(3) << unsigned(10000) << QList<unsigned>({4, 80, 208, 9997});
 
-  // Test cases where a buffer reload is needed (the buffer is 500k)
-  QTest::newRow("testBufferReload") << unsigned(3) << unsigned(1000000) << QList<unsigned>({80, 208, 500, 50000, 800000});
+  // Test cases where a buffer reload is needed if the file is not mapped (the file is read in blocks of 1MB)
+  QTest::newRow("testBufferReload") << unsigned(3) << unsigned(3000000) << QList<unsigned>({80, 208, 500, 50000, 2800000});
+  QTest::newRow("testBufferLargeNAL") << unsigned(4) << unsigned(3000000) << QList<unsigned>({80, 2500000});
 
-  // The buffer is 500k in size. Test all variations with a start code around this position
-  QTest::newRow("testBufferEdge1") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 499997});
-  QTest::newRow("testBufferEdge2") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 499998});
-  QTest::newRow("testBufferEdge3") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 499999});
-  QTest::newRow("testBufferEdge4") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 500000});
-  QTest::newRow("testBufferEdge5") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 500001});
-  QTest::newRow("testBufferEdge6") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 500002});
+  // Test all variations with a start code around the end of the first block (1048576)
+  QTest::newRow("testBufferEdge1") << unsigned(3) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048573});
+  QTest::newRow("testBufferEdge2") << unsigned(3) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048574});
+  QTest::newRow("testBufferEdge3") << unsigned(3) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048575});
+  QTest::newRow("testBufferEdge4") << unsigned(3) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048576});
+  QTest::newRow("testBufferEdge5") << unsigned(4) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048574});
+  QTest::newRow("testBufferEdge6") << unsigned(4) << unsigned(1500000) << QList<unsigned>({80, 208, 500, 50000, 1048575});
+  QTest::newRow("testFirstNALBehindFirstBlock") << unsigned(3) << unsigned(1500000) << QList<unsigned>({1048575, 1200000});
 
   QTest::newRow("testBufferEnd1") << unsigned(3) << unsigned(10000) << QList<unsigned>({80, 208, 500, 9995});
   QTest::newRow("testBufferEnd2") << unsigned(3) << unsigned(10000) << QList<unsigned>({80, 208, 500, 9996});
@@ -100,15 +106,121 @@ void FileSourceAnnexBTest::testNalUnitParsing()
   f.write(data);
   f.close();
 
-  FileSourceAnnexBFile annexBFile(f.fileName());
-  QCOMPARE(unsigned(annexBFile.getNrBytesBeforeFirstNAL()), startCodePositions[0]);
+  // Read the NAL units from the memory mapped file and from the file without mapping
+  for (const bool useMemoryMapping : {true, false})
+  {
+    FileSourceAnnexBFile annexBFile;
+    annexBFile.setUseMemoryMapping(useMemoryMapping);
+    QVERIFY(annexBFile.openFile(f.fileName()));
+    QCOMPARE(unsigned(annexBFile.getNrBytesBeforeFirstNAL()), startCodePositions[0]);
+
+    pairUint64 startEndPos;
+    auto nalData = annexBFile.getNextNALUnit(false, &startEndPos);
+    int counter = 0;
+    while (nalData.size() > 0)
+    {
+      QVERIFY(counter < nalSizes.size());
+      QCOMPARE(nalSizes[counter], unsigned(nalData.size()));
+      QCOMPARE(nalData, data.mid(int(startEndPos.first), nalData.size()));
+      counter++;
+      nalData = annexBFile.getNextNALUnit(false, &startEndPos);
+    }
+    QCOMPARE(counter, nalSizes.size());
+
+    // Seek back to the second NAL unit
+    if (startCodePositions.size() > 1)
+    {
+      QVERIFY(annexBFile.seek(int64_t(startCodePositions[1])));
+      QCOMPARE(unsigned(annexBFile.getNextNALUnit().size()), nalSizes[1]);
+    }
+  }
+}
+
+void FileSourceAnnexBTest::testFindStartCodes_data()
+{
+  QTest::addColumn<int>("nrThreads");
+  QTest::addColumn<QList<unsigned>>("startCodePositions");
+  QTest::addColumn<QList<unsigned>>("startCodeLengths");
+
+  QTest::newRow("testSingleThread") << 1 << QList<unsigned>({0, 80, 208, 2999990}) << QList<unsigned>({4, 3, 4, 3});
+  QTest::newRow("testNoStartCodeAtStart") << 4 << QList<unsigned>({7, 80, 1500000}) << QList<unsigned>({3, 4, 3});
+
+  // With 4 threads, the 3MB of data are split into chunks of 1MB (1048576 bytes). Test start codes around the chunk edges.
+  QTest::newRow("testChunkEdge1") << 4 << QList<unsigned>({80, 1048573, 2097151}) << QList<unsigned>({3, 3, 3});
+  QTest::newRow("testChunkEdge2") << 4 << QList<unsigned>({80, 1048574, 2097150}) << QList<unsigned>({3, 3, 4});
+  QTest::newRow("testChunkEdge3") << 4 << QList<unsigned>({80, 1048575, 2097152}) << QList<unsigned>({3, 4, 3});
+  QTest::newRow("testChunkEdge4") << 4 << QList<unsigned>({80, 1048576, 2097153}) << QList<unsigned>({3, 3, 4});
+  QTest::newRow("testChunkEdge5") << 4 << QList<unsigned>({80, 1048575, 1048580}) << QList<unsigned>({3, 3, 3});
+}
+
+void FileSourceAnnexBTest::testFindStartCodes()
+{
+  QFETCH(int, nrThreads);
+  QFETCH(QList<unsigned>, startCodePositions);
+  QFETCH(QList<unsigned>, startCodeLengths);
+
+  QByteArray data(3000000, char(128));
+  for (int i = 0; i < startCodePositions.size(); i++)
+  {
+    const auto pos = int(startCodePositions[i]);
+    if (startCodeLengths[i] == 4)
+      data[pos++] = char(0);
+    data[pos] = char(0);
+    data[pos + 1] = char(0);
+    data[pos + 2] = char(1);
+  }
+
+  const auto startCodes = FileSourceAnnexBFile::findStartCodes(data.constData(), data.size(), 0, data.size(), nrThreads);
+  QCOMPARE(startCodes.size(), startCodePositions.size());
+  for (int i = 0; i < startCodes.size(); i++)
+    QCOMPARE(startCodes[i], int64_t(startCodePositions[i]));
+
+  // The positions must match the start positions of the NAL units from the file reader
+  QTemporaryFile f;
+  f.open();
+  f.write(data);
+  f.close();
 
-  auto nalData = annexBFile.getNextNALUnit();
-  unsigned counter = 0;
-  while (nalData.size() > 0)
+  for (const bool useMemoryMapping : {true, false})
   {
-    QCOMPARE(nalSizes[counter++], unsigned(nalData.size()));
-    nalData = annexBFile.getNextNALUnit();
+    FileSourceAnnexBFile annexBFile;
+    annexBFile.setUseMemoryMapping(useMemoryMapping);
+    QVERIFY(annexBFile.openFile(f.fileName()));
+    pairUint64 startEndPos;
+    for (int i = 0; i < startCodes.size(); i++)
+    {
+      annexBFile.getNextNALUnit(false, &startEndPos);
+      QCOMPARE(int64_t(startEndPos.first), startCodes[i]);
+    }
+  }
+}
+
+void FileSourceAnnexBTest::testFindNextStartCode()
+{
+  // Random data with many 0 and 1 bytes. Compare the (vectorized) search to a simple search at all offsets.
+  QRandomGenerator random(42);
+  QByteArray data(1000, char(0));
+  for (auto &c : data)
+  {
+    const auto r = random.bounded(6);
+    c = (r < 2) ? char(0) : (r == 2) ? char(1) : char(128);
+  }
+
+  for (int begin = 0; begin < 200; begin++)
+  {
+    for (const int end : {begin + 1, begin + 17, begin + 40, data.size()})
+    {
+      int64_t expected = -1;
+      for (int pos = begin; pos < std::min(end, data.size() - 2); pos++)
+      {
+        if (data[pos] == char(0) && data[pos + 1] == char(0) && data[pos + 2] == char(1))
+        {
+          expected = pos;
+          break;
+        }
+      }
+      QCOMPARE(FileSourceAnnexBFile::findNextStartCode(data.constData(), data.size(), begin, end), expected);
+    }
   }
 }
 
@@ -0,0 +1,122 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <filesource/SeekIndexCache.h>
+
+class SeekIndexCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  SeekIndexCacheTest();
+  ~SeekIndexCacheTest();
+
+private slots:
+  void testSaveAndLoad();
+  void testEmptyLists();
+};
+
+namespace
+{
+
+const QString formatTag = "parserAnnexBHEVC";
+
+bool writeFile(const QString &fileName, const QByteArray &data)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  return file.write(data) == data.size();
+}
+
+SeekIndexCache::Index createTestIndex()
+{
+  SeekIndexCache::Index index;
+  for (int i = 0; i < 8; i++)
+  {
+    SeekIndexCache::Frame frame;
+    frame.dts = i * 512;
+    frame.poc = (i % 4 == 0) ? i : i + 1;
+    frame.startPos = 100 + i * 200;
+    frame.endPos = 100 + (i + 1) * 200 - 1;
+    frame.keyFrame = (i % 4 == 0);
+    index.frames.append(frame);
+  }
+  index.parameterSetPositions.append(pairUint64(0, 50));
+  index.parameterSetPositions.append(pairUint64(50, 100));
+
+  SeekIndexCache::SeekPoint seekPoint;
+  seekPoint.filePos = 900;
+  seekPoint.parameterSets.append(QByteArray("\x40\x01\x0c", 3));
+  seekPoint.parameterSets.append(QByteArray("\x42\x01\x01", 3));
+  index.seekPoints.insert(4, seekPoint);
+  return index;
+}
+
+} // namespace
+
+SeekIndexCacheTest::SeekIndexCacheTest()
+{
+  // Do not write to the cache directory of the user
+  QStandardPaths::setTestModeEnabled(true);
+}
+
+SeekIndexCacheTest::~SeekIndexCacheTest() {}
+
+void SeekIndexCacheTest::testSaveAndLoad()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stream.hevc");
+  QVERIFY(writeFile(fileName, QByteArray(2000, 'x')));
+
+  const auto fileState = SeekIndexCache::getFileState(fileName);
+  QCOMPARE(fileState.size, qint64(2000));
+
+  const auto index = createTestIndex();
+  QVERIFY(SeekIndexCache::saveIndex(fileName, formatTag, fileState, index));
+
+  SeekIndexCache::Index loaded;
+  QVERIFY(SeekIndexCache::loadIndex(fileName, formatTag, loaded));
+  QCOMPARE(loaded.frames.size(), index.frames.size());
+  for (int i = 0; i < index.frames.size(); i++)
+  {
+    QCOMPARE(loaded.frames[i].dts, index.frames[i].dts);
+    QCOMPARE(loaded.frames[i].poc, index.frames[i].poc);
+    QCOMPARE(loaded.frames[i].startPos, index.frames[i].startPos);
+    QCOMPARE(loaded.frames[i].endPos, index.frames[i].endPos);
+    QCOMPARE(loaded.frames[i].keyFrame, index.frames[i].keyFrame);
+  }
+  QCOMPARE(loaded.parameterSetPositions, index.parameterSetPositions);
+  QCOMPARE(loaded.seekPoints.keys(), index.seekPoints.keys());
+  QCOMPARE(loaded.seekPoints[4].filePos, index.seekPoints[4].filePos);
+  QCOMPARE(loaded.seekPoints[4].parameterSets, index.seekPoints[4].parameterSets);
+
+  QFile::remove(SeekIndexCache::getIndexFilePath(fileName));
+}
+
+void SeekIndexCacheTest::testEmptyLists()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("video.mp4");
+  QVERIFY(writeFile(fileName, QByteArray(100, 'x')));
+
+  // An FFmpeg index has no parameter sets and seek points
+  auto index = createTestIndex();
+  index.parameterSetPositions.clear();
+  index.seekPoints.clear();
+  QVERIFY(SeekIndexCache::saveIndex(fileName, "FFmpeg/0", SeekIndexCache::getFileState(fileName), index));
+
+  SeekIndexCache::Index loaded;
+  QVERIFY(SeekIndexCache::loadIndex(fileName, "FFmpeg/0", loaded));
+  QCOMPARE(loaded.frames.size(), index.frames.size());
+  QVERIFY(loaded.parameterSetPositions.isEmpty());
+  QVERIFY(loaded.seekPoints.isEmpty());
+
+  QFile::remove(SeekIndexCache::getIndexFilePath(fileName));
+}
+
+QTEST_MAIN(SeekIndexCacheTest)
+
+#include "tst_SeekIndexCache.moc"
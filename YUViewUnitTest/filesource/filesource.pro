@@ -1,4 +1,5 @@
 TEMPLATE = subdirs
 
 SUBDIRS = Filesource
-SUBDIRS += FilesourceAnnexB
\ No newline at end of file
+SUBDIRS += FilesourceAnnexB
+SUBDIRS += SeekIndexCache
\ No newline at end of file
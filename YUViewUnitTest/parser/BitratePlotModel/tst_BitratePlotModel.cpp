@@ -0,0 +1,123 @@
+#include <QtTest>
+
+#include <parser/common/BitratePlotModel.h>
+
+class BitratePlotModelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  BitratePlotModelTest();
+  ~BitratePlotModelTest();
+
+private slots:
+  void testDecimatedPoints_data();
+  void testDecimatedPoints();
+  void testNoDecimationWhenZoomedIn();
+};
+
+namespace
+{
+
+const int nrEntries = 10000;
+const int gopSize = 32;
+
+unsigned int getBitrate(int i)
+{
+  return unsigned((i * 7919) % 1000 + (i % gopSize == 0 ? 5000 : 0));
+}
+
+void fillModel(BitratePlotModel &model, bool presentationOrder)
+{
+  model.setBitrateSortingIndex(presentationOrder ? 1 : 0);
+  for (int i = 0; i < nrEntries; i++)
+  {
+    // Swap the PTS of pairs of frames so that entries are inserted out of order in presentation order
+    BitratePlotModel::BitrateEntry entry;
+    entry.dts = i;
+    entry.pts = (i % 2 == 0) ? i + 1 : i - 1;
+    entry.bitrate = getBitrate(i);
+    entry.keyframe = (i % gopSize == 0);
+    model.addBitratePoint(0, entry);
+  }
+}
+
+} // namespace
+
+BitratePlotModelTest::BitratePlotModelTest()
+{
+}
+
+BitratePlotModelTest::~BitratePlotModelTest()
+{
+}
+
+void BitratePlotModelTest::testDecimatedPoints_data()
+{
+  QTest::addColumn<bool>("presentationOrder");
+  QTest::newRow("DecodeOrder") << false;
+  QTest::newRow("PresentationOrder") << true;
+}
+
+void BitratePlotModelTest::testDecimatedPoints()
+{
+  QFETCH(bool, presentationOrder);
+
+  BitratePlotModel model;
+  fillModel(model, presentationOrder);
+
+  const unsigned maxNrPoints = 500;
+  const Range<double> xRange {1000, 9000};
+  const auto points = model.getDecimatedPlotPoints(0, 0, xRange, maxNrPoints);
+  QVERIFY(points);
+  QVERIFY(!points->isEmpty());
+  QVERIFY(unsigned(points->size()) <= 2 * maxNrPoints + 4);
+
+  // The decimated points must cover the range and contain the maximum values of the entries. The first and
+  // last point may also contain some entries outside of the range.
+  QVERIFY(points->first().xMin <= xRange.min);
+  QVERIFY(points->last().xMax >= xRange.max);
+  auto getMaxBitrate = [](int first, int last, bool intra)
+  {
+    unsigned int maxBitrate = 0;
+    for (int i = std::max(first, 0); i <= std::min(last, nrEntries - 1); i++)
+      if ((i % gopSize == 0) == intra)
+        maxBitrate = std::max(maxBitrate, getBitrate(i));
+    return maxBitrate;
+  };
+  const int firstCovered = int(std::ceil(points->first().xMin)) - 1;
+  const int lastCovered = int(std::floor(points->last().xMax)) + 1;
+  double maxDecimatedInter = 0;
+  double maxDecimatedIntra = 0;
+  for (const auto &p : *points)
+  {
+    QVERIFY(p.yMin <= p.yMax);
+    if (p.intra)
+      maxDecimatedIntra = std::max(maxDecimatedIntra, p.yMax);
+    else
+      maxDecimatedInter = std::max(maxDecimatedInter, p.yMax);
+  }
+  QVERIFY(maxDecimatedInter >= getMaxBitrate(1000, 9000, false));
+  QVERIFY(maxDecimatedInter <= getMaxBitrate(firstCovered, lastCovered, false));
+  QVERIFY(maxDecimatedIntra >= getMaxBitrate(1000, 9000, true));
+  QVERIFY(maxDecimatedIntra <= getMaxBitrate(firstCovered, lastCovered, true));
+
+  // The average line only has one value per point
+  const auto averagePoints = model.getDecimatedPlotPoints(0, 1, xRange, maxNrPoints);
+  QVERIFY(averagePoints);
+  QVERIFY(unsigned(averagePoints->size()) <= maxNrPoints + 2);
+}
+
+void BitratePlotModelTest::testNoDecimationWhenZoomedIn()
+{
+  BitratePlotModel model;
+  fillModel(model, false);
+
+  QVERIFY(!model.getDecimatedPlotPoints(0, 0, {100, 300}, 500));
+  QVERIFY(!model.getDecimatedPlotPoints(1, 0, {0, nrEntries}, 500));
+  QVERIFY(model.getDecimatedPlotPoints(0, 0, {0, nrEntries}, 500));
+}
+
+QTEST_MAIN(BitratePlotModelTest)
+
+#include "tst_BitratePlotModel.moc"
@@ -0,0 +1,147 @@
+#include <QtTest>
+
+#include <parser/common/PacketItemModel.h>
+
+class PacketItemModelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PacketItemModelTest();
+  ~PacketItemModelTest();
+
+private slots:
+  void testLazyLoading();
+  void testUnloadLeastRecentlyUsed();
+  void testItemData();
+};
+
+namespace
+{
+
+const int nrFirstLevelItems = 10;
+const int maxNrLoadedItems = 3;
+
+void fillModel(PacketItemModel &model, QList<int> &loadedRows)
+{
+  model.rootItem.reset(new TreeItem(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning", nullptr));
+  for (int i = 0; i < nrFirstLevelItems; i++)
+    new TreeItem(QString("NAL %1").arg(i), model.getRootItem());
+  model.updateNumberModelItems();
+
+  model.setLazyChildLoader([&loadedRows](int row, TreeItem *item) {
+    loadedRows.append(row);
+    new TreeItem("child_a", row, item);
+    new TreeItem("child_b", row * 2, item);
+    return true;
+  }, maxNrLoadedItems);
+}
+
+} // namespace
+
+PacketItemModelTest::PacketItemModelTest()
+{
+}
+
+PacketItemModelTest::~PacketItemModelTest()
+{
+}
+
+void PacketItemModelTest::testLazyLoading()
+{
+  PacketItemModel model(nullptr);
+  QList<int> loadedRows;
+  fillModel(model, loadedRows);
+
+  QCOMPARE(model.rowCount(), nrFirstLevelItems);
+  QVERIFY(!model.canFetchMore(QModelIndex()));
+
+  const auto index = model.index(5, 0);
+  QVERIFY(model.hasChildren(index));
+  QVERIFY(model.canFetchMore(index));
+  QCOMPARE(model.rowCount(index), 0);
+
+  model.fetchMore(index);
+  QCOMPARE(loadedRows, QList<int>() << 5);
+  QVERIFY(!model.canFetchMore(index));
+  QCOMPARE(model.rowCount(index), 2);
+
+  const auto child = model.index(1, 0, index);
+  QCOMPARE(model.data(child).toString(), QString("child_b"));
+  QCOMPARE(model.data(model.index(1, 1, index)).toString(), QString("10"));
+  QCOMPARE(model.parent(child), index);
+
+  // Fetching again does not call the loader
+  model.fetchMore(index);
+  QCOMPARE(loadedRows.size(), 1);
+}
+
+void PacketItemModelTest::testUnloadLeastRecentlyUsed()
+{
+  PacketItemModel model(nullptr);
+  QList<int> loadedRows;
+  fillModel(model, loadedRows);
+
+  for (int row = 0; row < maxNrLoadedItems; row++)
+    model.fetchMore(model.index(row, 0));
+  for (int row = 0; row < maxNrLoadedItems; row++)
+    QCOMPARE(model.rowCount(model.index(row, 0)), 2);
+
+  // Row 0 was used last now. Loading another item unloads row 1.
+  QCOMPARE(model.rowCount(model.index(0, 0)), 2);
+  model.fetchMore(model.index(maxNrLoadedItems, 0));
+  QCOMPARE(model.rowCount(model.index(0, 0)), 2);
+  QCOMPARE(model.rowCount(model.index(1, 0)), 0);
+  QVERIFY(model.canFetchMore(model.index(1, 0)));
+  QCOMPARE(model.rowCount(model.index(2, 0)), 2);
+  QCOMPARE(model.rowCount(model.index(maxNrLoadedItems, 0)), 2);
+
+  // An unloaded item can be loaded again
+  model.fetchMore(model.index(1, 0));
+  QCOMPARE(loadedRows, QList<int>() << 0 << 1 << 2 << 3 << 1);
+  QCOMPARE(model.rowCount(model.index(1, 0)), 2);
+}
+
+void PacketItemModelTest::testItemData()
+{
+  TreeItem root(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning", nullptr);
+  QCOMPARE(root.getData(0), QString("Name"));
+  QCOMPARE(root.getData(4), QString("Meaning"));
+
+  auto item = new TreeItem("slice_qp_delta", -3, "se(v) -> se(5)", "00111", "Some meaning", &root);
+  QCOMPARE(item->getData(0), QString("slice_qp_delta"));
+  QCOMPARE(item->getData(1), QString("-3"));
+  QCOMPARE(item->getData(2), QString("se(v) -> se(5)"));
+  QCOMPARE(item->getData(3), QString("00111"));
+  QCOMPARE(item->getData(4), QString("Some meaning"));
+  QCOMPARE(item->getData(5), QString());
+
+  auto flagItem = new TreeItem("flag", true, "u(1)", "1", &root);
+  QCOMPARE(flagItem->getData(1), QString("1"));
+  QCOMPARE(flagItem->getData(4), QString());
+
+  auto bigItem = new TreeItem("big", uint64_t(0xFFFFFFFFFFFFFFFF), "u(64)", QString(64, '1'), &root);
+  QCOMPARE(bigItem->getData(1), QString("18446744073709551615"));
+  QCOMPARE(bigItem->getData(3), QString(64, '1'));
+
+  // Codes which are no bit strings and strings values are saved in the item
+  auto textItem = new TreeItem("text", QString("Not 0"), "u(v) -> u(70)", QString(70, '0') + "x", &root);
+  QCOMPARE(textItem->getData(1), QString("Not 0"));
+  QCOMPARE(textItem->getData(3), QString(70, '0') + "x");
+  textItem->setName("NAL 5: IDR");
+  QCOMPARE(textItem->getName(false), QString("NAL 5: IDR"));
+  QCOMPARE(textItem->getData(1), QString("Not 0"));
+  QCOMPARE(textItem->getData(2), QString("u(v) -> u(70)"));
+
+  // Repeated names, codings and meanings are only saved once
+  const int nrStrings = TreeItem::getNumberInternedStrings();
+  for (int i = 0; i < 1000; i++)
+    new TreeItem("slice_qp_delta", i, "se(v) -> se(5)", "00111", "Some meaning", &root);
+  QCOMPARE(TreeItem::getNumberInternedStrings(), nrStrings);
+  QCOMPARE(root.childItems.size(), 1004);
+  QCOMPARE(root.childItems.last()->getData(1), QString("999"));
+}
+
+QTEST_MAIN(PacketItemModelTest)
+
+#include "tst_PacketItemModel.moc"
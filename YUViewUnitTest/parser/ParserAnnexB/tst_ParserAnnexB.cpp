@@ -0,0 +1,294 @@
+#include <QtTest>
+
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <atomic>
+
+#include <filesource/SeekIndexCache.h>
+#include <parser/parserAnnexB.h>
+
+class ParserAnnexBTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ParserAnnexBTest();
+  ~ParserAnnexBTest();
+
+private slots:
+  void testParseInSegments();
+};
+
+namespace
+{
+
+/* A parser for a simple bitstream format. The byte after the start code is the type of the NAL:
+ * 'P' parameter set, 'A' access unit delimiter, 'I' IDR slice, 'S' slice and 'E' a NAL that follows a slice.
+ * The second byte of a slice is its POC. Like in HEVC, the POC counting restarts at every IDR picture and
+ * slices can only be parsed after a parameter set.
+ */
+class TestParser : public parserAnnexB
+{
+public:
+  TestParser(bool inSegments) : inSegments(inSegments) {}
+
+  parserAnnexB *createNewParser() const override
+  {
+    this->nrCreatedParsers++;
+    return new TestParser(this->inSegments);
+  }
+
+  ParseResult parseAndAddNALUnit(int nalID, QByteArray data, std::optional<BitratePlotModel::BitrateEntry> bitrateEntry, std::optional<pairUint64> nalStartEndPosFile, TreeItem *parent) override
+  {
+    Q_UNUSED(bitrateEntry);
+    Q_UNUSED(parent);
+
+    ParseResult result;
+    if (nalID == -1 && data.isEmpty())
+    {
+      if (this->curFramePOC != -1)
+        this->addFrameToList(this->curFramePOC, this->curFrameFileStartEndPos, this->curFrameIsIDR);
+      std::sort(this->POCList.begin(), this->POCList.end());
+      return result;
+    }
+
+    const char type = data.at(3);
+    const bool isSlice = (type == 'I' || type == 'S');
+    if (type == 'P')
+    {
+      this->nalUnitList.append(QSharedPointer<TestNAL>(new TestNAL(nalID, nalStartEndPosFile, true)));
+      this->parameterSetReceived = true;
+    }
+    else if (isSlice)
+    {
+      if (!this->parameterSetReceived)
+        return result;
+
+      const bool isIDR = (type == 'I');
+      if (isIDR && this->maxPOC > 0)
+      {
+        this->pocOffset = this->maxPOC + 1;
+        this->maxPOC = -1;
+      }
+      const int poc = this->pocOffset + int(data.at(4));
+      if (!isIDR && poc > this->maxPOC)
+        this->maxPOC = poc;
+
+      if (this->curFramePOC != -1)
+        this->addFrameToList(this->curFramePOC, this->curFrameFileStartEndPos, this->curFrameIsIDR);
+      this->curFramePOC = poc;
+      this->curFrameFileStartEndPos = nalStartEndPosFile;
+      this->curFrameIsIDR = isIDR;
+
+      if (isIDR)
+      {
+        auto nal = QSharedPointer<TestNAL>(new TestNAL(nalID, nalStartEndPosFile, false));
+        nal->poc = poc;
+        this->nalUnitList.append(nal);
+      }
+      result.poc = poc;
+      result.isRandomAccessPoint = isIDR;
+    }
+
+    // Every slice is a picture. After a slice, the next slice, parameter set or delimiter starts a new access unit.
+    const bool isStartOfNewAU = this->primaryPictureFound && (isSlice || type == 'P' || type == 'A');
+    if (isStartOfNewAU)
+    {
+      BitratePlotModel::BitrateEntry entry;
+      entry.pts = this->lastFramePOC;
+      entry.dts = this->counterAU++;
+      entry.bitrate = this->sizeCurrentAU;
+      result.bitrateEntry = entry;
+      this->sizeCurrentAU = 0;
+    }
+    if (isSlice)
+      this->primaryPictureFound = true;
+    else if (isStartOfNewAU)
+      this->primaryPictureFound = false;
+    this->lastFramePOC = this->curFramePOC;
+    this->sizeCurrentAU += unsigned(data.size());
+
+    result.success = true;
+    return result;
+  }
+
+  double getFramerate() const override { return 25.0; }
+  QSize getSequenceSizeSamples() const override { return QSize(64, 64); }
+  yuvPixelFormat getPixelFormat() const override { return yuvPixelFormat(); }
+  QByteArray getExtradata() override { return {}; }
+  QPair<int,int> getProfileLevel() override { return {0, 0}; }
+  QPair<int,int> getSampleAspectRatio() override { return {1, 1}; }
+
+  QStringList getFrames() const
+  {
+    QStringList frames;
+    for (const auto &frame : this->frameList)
+      frames.append(QString("POC %1 pos %2-%3%4").arg(frame.poc).arg(frame.fileStartEndPos->first).arg(frame.fileStartEndPos->second).arg(frame.randomAccessPoint ? " RA" : ""));
+    return frames;
+  }
+  QList<int> getPOCList() const { return this->POCList; }
+  QStringList getNALUnits() const
+  {
+    QStringList nalUnits;
+    for (const auto &nal : this->nalUnitList)
+      nalUnits.append(QString("NAL %1 POC %2%3").arg(nal->nal_idx).arg(nal->getPOC()).arg(nal->isParameterSet() ? " PS" : ""));
+    return nalUnits;
+  }
+
+  mutable std::atomic_int nrCreatedParsers {0};
+
+protected:
+  QList<QByteArray> getSeekFrameParamerSetsFromNALList(int iFrameNr, uint64_t &filePos) override
+  {
+    Q_UNUSED(iFrameNr);
+    Q_UNUSED(filePos);
+    return {};
+  }
+
+  bool canParseInSegments() const override { return this->inSegments; }
+  SegmentNALType getSegmentNALType(const QByteArray &nalData) const override
+  {
+    switch (nalData.at(3))
+    {
+    case 'P':
+      return SegmentNALType::ParameterSet;
+    case 'A':
+      return SegmentNALType::AccessUnitPrefix;
+    case 'I':
+      return SegmentNALType::IDRSlice;
+    case 'S':
+      return SegmentNALType::Slice;
+    default:
+      return SegmentNALType::Other;
+    }
+  }
+  int getPOCOffsetOfNextIDR() const override { return (this->maxPOC > 0) ? this->maxPOC + 1 : this->pocOffset; }
+
+private:
+  struct TestNAL : nal_unit
+  {
+    TestNAL(int nalID, std::optional<pairUint64> filePosStartEnd, bool parameterSet) : nal_unit(nalID, filePosStartEnd), parameterSet(parameterSet) {}
+    bool parse_nal_unit_header(const QByteArray &header_data, TreeItem *root) override { Q_UNUSED(header_data); Q_UNUSED(root); return true; }
+    QByteArray getNALHeader() const override { return {}; }
+    bool isParameterSet() const override { return this->parameterSet; }
+    int getPOC() const override { return this->poc; }
+    void addPOCOffset(int offset) override { this->poc += offset; }
+    bool parameterSet {false};
+    int poc {-1};
+  };
+
+  const bool inSegments;
+  bool parameterSetReceived {false};
+  int pocOffset {0};
+  int maxPOC {-1};
+  int curFramePOC {-1};
+  std::optional<pairUint64> curFrameFileStartEndPos;
+  bool curFrameIsIDR {false};
+  bool primaryPictureFound {false};
+  int lastFramePOC {-1};
+  int counterAU {0};
+  unsigned int sizeCurrentAU {0};
+};
+
+QByteArray createStream()
+{
+  QByteArray stream;
+  int nalIdx = 0;
+  auto addNAL = [&stream, &nalIdx](char type, int poc) {
+    stream.append(QByteArray::fromHex("000001"));
+    stream.append(type);
+    if (poc >= 0)
+      stream.append(char(poc));
+    // Give every NAL a different size
+    stream.append(QByteArray(nalIdx++ % 7 + 1, char(0x55)));
+  };
+
+  // The first segment ends with a NAL that belongs to the last access unit
+  addNAL('P', -1);
+  addNAL('I', 0);
+  for (int poc : {4, 2, 1, 3})
+    addNAL('S', poc);
+  addNAL('E', -1);
+  // A segment starting with a delimiter and a repeated parameter set
+  addNAL('A', -1);
+  addNAL('P', -1);
+  addNAL('I', 0);
+  for (int poc : {4, 2, 1, 3})
+    addNAL('S', poc);
+  // A segment that only starts with the IDR slice. The parameter set is taken from the previous segments.
+  addNAL('I', 0);
+  for (int poc : {2, 1})
+    addNAL('S', poc);
+  return stream;
+}
+
+struct ParsingResult
+{
+  QStringList frames;
+  QList<int> pocList;
+  QStringList nalUnits;
+  QStringList bitrateEntries;
+  int nrCreatedParsers {0};
+};
+
+ParsingResult parseStream(const QByteArray &stream, bool inSegments)
+{
+  QTemporaryFile file;
+  file.open();
+  file.write(stream);
+  file.close();
+
+  TestParser parser(inSegments);
+  QScopedPointer<FileSourceAnnexBFile> annexBFile(new FileSourceAnnexBFile(file.fileName()));
+  parser.parseAnnexBFile(annexBFile);
+  annexBFile.reset();
+  QFile::remove(SeekIndexCache::getIndexFilePath(file.fileName()));
+
+  ParsingResult result;
+  result.frames = parser.getFrames();
+  result.pocList = parser.getPOCList();
+  result.nalUnits = parser.getNALUnits();
+  auto bitrateModel = parser.getBitratePlotModel();
+  if (bitrateModel->getNrStreams() > 0)
+  {
+    const auto nrPoints = bitrateModel->getStreamParameter(0).plotParameters[0].nrpoints;
+    for (unsigned i = 0; i < nrPoints; i++)
+      result.bitrateEntries.append(bitrateModel->getPointInfo(0, 0, i));
+  }
+  result.nrCreatedParsers = parser.nrCreatedParsers;
+  return result;
+}
+
+} // namespace
+
+ParserAnnexBTest::ParserAnnexBTest()
+{
+}
+
+ParserAnnexBTest::~ParserAnnexBTest()
+{
+}
+
+void ParserAnnexBTest::testParseInSegments()
+{
+  const auto stream = createStream();
+  const auto inOrder = parseStream(stream, false);
+  const auto inSegments = parseStream(stream, true);
+
+  QCOMPARE(inOrder.nrCreatedParsers, 0);
+  QCOMPARE(inSegments.nrCreatedParsers, 3);
+
+  QCOMPARE(inOrder.pocList, QList<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}));
+  QCOMPARE(inOrder.nalUnits.size(), 5);
+  QCOMPARE(inOrder.bitrateEntries.size(), 12);
+
+  QCOMPARE(inSegments.frames, inOrder.frames);
+  QCOMPARE(inSegments.pocList, inOrder.pocList);
+  QCOMPARE(inSegments.nalUnits, inOrder.nalUnits);
+  QCOMPARE(inSegments.bitrateEntries, inOrder.bitrateEntries);
+}
+
+QTEST_MAIN(ParserAnnexBTest)
+
+#include "tst_ParserAnnexB.moc"
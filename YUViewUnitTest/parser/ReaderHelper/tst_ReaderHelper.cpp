@@ -0,0 +1,190 @@
+#include <QtTest>
+
+#include <parser/common/ReaderHelper.h>
+#include <parser/common/parserMacros.h>
+
+class ReaderHelperTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ReaderHelperTest();
+  ~ReaderHelperTest();
+
+private slots:
+  void testLoggingAndFastMode_data();
+  void testLoggingAndFastMode();
+  void benchmarkReading_data();
+  void benchmarkReading();
+};
+
+namespace
+{
+
+// Writes bits and exp-golomb codes into a byte array
+class BitWriter
+{
+public:
+  void writeBits(unsigned int value, int nrBits)
+  {
+    for (int i = nrBits - 1; i >= 0; i--)
+    {
+      if (bitPos == 0)
+        data.append(char(0));
+      if (value & (1u << i))
+        data[data.size() - 1] = char(data[data.size() - 1] | (1 << (7 - bitPos)));
+      bitPos = (bitPos + 1) % 8;
+    }
+  }
+  void writeUEV(unsigned int value)
+  {
+    const unsigned int codeNum = value + 1;
+    int nrBits = 0;
+    while ((codeNum >> nrBits) > 1)
+      nrBits++;
+    writeBits(0, nrBits);
+    writeBits(codeNum, nrBits + 1);
+  }
+  void writeSEV(int value)
+  {
+    writeUEV(value > 0 ? 2 * value - 1 : -2 * value);
+  }
+  QByteArray data;
+
+private:
+  int bitPos {0};
+};
+
+struct SyntaxElement
+{
+  unsigned int value_uev {0};
+  int value_sev {0};
+  bool flag {false};
+  unsigned int value_u5 {0};
+};
+
+const QStringList flagMeanings = QStringList() << "Off" << "On";
+
+QString getU5Meaning(unsigned int value)
+{
+  return QString("Value %1").arg(value);
+}
+
+QByteArray createTestData(int nrElements)
+{
+  BitWriter writer;
+  for (int i = 0; i < nrElements; i++)
+  {
+    writer.writeUEV(i * 7);
+    writer.writeSEV((i % 2 == 0) ? i : -i);
+    writer.writeBits(i % 2, 1);
+    writer.writeBits(i % 32, 5);
+  }
+  // Pad to the byte boundary with a trailing bit
+  writer.writeBits(1, 8);
+  return writer.data;
+}
+
+bool parseElements(ReaderHelper &reader, int nrElements, QList<SyntaxElement> &elements)
+{
+  for (int i = 0; i < nrElements; i++)
+  {
+    reader_sub_level r(reader, "syntax_element()");
+    SyntaxElement e;
+    unsigned int value_uev;
+    int value_sev;
+    bool flag;
+    unsigned int value_u5;
+    READUEV(value_uev);
+    READSEV(value_sev);
+    READFLAG_M(flag, flagMeanings);
+    READBITS_M(value_u5, 5, &getU5Meaning);
+    LOGVAL(value_uev);
+    e.value_uev = value_uev;
+    e.value_sev = value_sev;
+    e.flag = flag;
+    e.value_u5 = value_u5;
+    elements.append(e);
+  }
+  return true;
+}
+
+} // namespace
+
+ReaderHelperTest::ReaderHelperTest()
+{
+}
+
+ReaderHelperTest::~ReaderHelperTest()
+{
+}
+
+void ReaderHelperTest::testLoggingAndFastMode_data()
+{
+  QTest::addColumn<bool>("logging");
+  QTest::newRow("Logging") << true;
+  QTest::newRow("Fast") << false;
+}
+
+void ReaderHelperTest::testLoggingAndFastMode()
+{
+  QFETCH(bool, logging);
+
+  const int nrElements = 200;
+  const QByteArray data = createTestData(nrElements);
+
+  QScopedPointer<TreeItem> root(new TreeItem(nullptr));
+  ReaderHelper reader(data, logging ? root.data() : nullptr);
+  reader.disableEmulationPrevention();
+  QCOMPARE(reader.isLogging(), logging);
+
+  QList<SyntaxElement> elements;
+  QVERIFY(parseElements(reader, nrElements, elements));
+  QCOMPARE(elements.size(), nrElements);
+  for (int i = 0; i < nrElements; i++)
+  {
+    QCOMPARE(elements[i].value_uev, unsigned(i * 7));
+    QCOMPARE(elements[i].value_sev, (i % 2 == 0) ? i : -i);
+    QCOMPARE(elements[i].flag, i % 2 == 1);
+    QCOMPARE(elements[i].value_u5, unsigned(i % 32));
+  }
+
+  if (logging)
+  {
+    QCOMPARE(root->childItems.size(), nrElements);
+    const TreeItem *first = root->childItems[1];
+    QCOMPARE(first->childItems.size(), 5);
+    QCOMPARE(first->childItems[0]->getData(0), QString("value_uev"));
+    QCOMPARE(first->childItems[0]->getData(3), QString("0001000"));
+    QCOMPARE(first->childItems[2]->getData(4), QString("On"));
+    QCOMPARE(first->childItems[3]->getData(4), QString("Value 1"));
+  }
+  else
+    QCOMPARE(root->childItems.size(), 0);
+}
+
+void ReaderHelperTest::benchmarkReading_data()
+{
+  testLoggingAndFastMode_data();
+}
+
+void ReaderHelperTest::benchmarkReading()
+{
+  QFETCH(bool, logging);
+
+  const int nrElements = 10000;
+  const QByteArray data = createTestData(nrElements);
+
+  QBENCHMARK
+  {
+    QScopedPointer<TreeItem> root(new TreeItem(nullptr));
+    ReaderHelper reader(data, logging ? root.data() : nullptr);
+    reader.disableEmulationPrevention();
+    QList<SyntaxElement> elements;
+    QVERIFY(parseElements(reader, nrElements, elements));
+  }
+}
+
+QTEST_MAIN(ReaderHelperTest)
+
+#include "tst_ReaderHelper.moc"
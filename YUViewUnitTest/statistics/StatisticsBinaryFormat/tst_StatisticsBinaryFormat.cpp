@@ -0,0 +1,199 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <statistics/statisticsBinaryFormat.h>
+
+class StatisticsBinaryFormatTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsBinaryFormatTest();
+  ~StatisticsBinaryFormatTest();
+
+private slots:
+  void testWriteAndRead_data();
+  void testWriteAndRead();
+  void testInvalidFile();
+};
+
+namespace
+{
+
+statisticsData createTestData(int seed)
+{
+  statisticsData data;
+  for (int i = 0; i < 100; i++)
+  {
+    data.addBlockValue(i * 8, seed, 8, 8, i - seed);
+    data.addBlockVector(i * 4, seed, 4, 8, i, -i);
+    data.addLine(i * 16, seed, 16, 16, 0, 0, 15, i % 16);
+    data.addBlockAffineTF(i * 32, seed, 32, 16, i, -i, 2 * i, -2 * i, 3 * i, -3 * i);
+  }
+  data.addPolygonValue({QPoint(0, 0), QPoint(seed, 0), QPoint(seed, seed)}, 7);
+  data.addPolygonVector({QPoint(1, 2), QPoint(3, 4), QPoint(5, 6), QPoint(7, 8)}, -3, seed);
+  return data;
+}
+
+void compareStatisticsData(const statisticsData &data, const statisticsData &expected)
+{
+  QCOMPARE(data.maxBlockSize, expected.maxBlockSize);
+
+  QCOMPARE(data.valueData.size(), expected.valueData.size());
+  for (int i = 0; i < data.valueData.size(); i++)
+  {
+    const auto &a = data.valueData[i];
+    const auto &b = expected.valueData[i];
+    QVERIFY(a.pos[0] == b.pos[0] && a.pos[1] == b.pos[1] && a.size[0] == b.size[0] && a.size[1] == b.size[1]);
+    QCOMPARE(a.value, b.value);
+  }
+
+  QCOMPARE(data.vectorData.size(), expected.vectorData.size());
+  for (int i = 0; i < data.vectorData.size(); i++)
+  {
+    const auto &a = data.vectorData[i];
+    const auto &b = expected.vectorData[i];
+    QVERIFY(a.pos[0] == b.pos[0] && a.pos[1] == b.pos[1] && a.size[0] == b.size[0] && a.size[1] == b.size[1]);
+    QCOMPARE(a.isLine, b.isLine);
+    QCOMPARE(a.point[0], b.point[0]);
+    if (b.isLine)
+      QCOMPARE(a.point[1], b.point[1]);
+  }
+
+  QCOMPARE(data.affineTFData.size(), expected.affineTFData.size());
+  for (int i = 0; i < data.affineTFData.size(); i++)
+  {
+    const auto &a = data.affineTFData[i];
+    const auto &b = expected.affineTFData[i];
+    QVERIFY(a.pos[0] == b.pos[0] && a.pos[1] == b.pos[1] && a.size[0] == b.size[0] && a.size[1] == b.size[1]);
+    for (int p = 0; p < 3; p++)
+      QCOMPARE(a.point[p], b.point[p]);
+  }
+
+  QCOMPARE(data.polygonValueData.size(), expected.polygonValueData.size());
+  for (int i = 0; i < data.polygonValueData.size(); i++)
+  {
+    QCOMPARE(data.polygonValueData[i].corners, expected.polygonValueData[i].corners);
+    QCOMPARE(data.polygonValueData[i].value, expected.polygonValueData[i].value);
+  }
+
+  QCOMPARE(data.polygonVectorData.size(), expected.polygonVectorData.size());
+  for (int i = 0; i < data.polygonVectorData.size(); i++)
+  {
+    QCOMPARE(data.polygonVectorData[i].corners, expected.polygonVectorData[i].corners);
+    QCOMPARE(data.polygonVectorData[i].point[0], expected.polygonVectorData[i].point[0]);
+  }
+}
+
+} // namespace
+
+StatisticsBinaryFormatTest::StatisticsBinaryFormatTest()
+{
+}
+
+StatisticsBinaryFormatTest::~StatisticsBinaryFormatTest()
+{
+}
+
+void StatisticsBinaryFormatTest::testWriteAndRead_data()
+{
+  QTest::addColumn<bool>("compress");
+
+  QTest::newRow("testUncompressed") << false;
+  QTest::newRow("testCompressed") << true;
+}
+
+void StatisticsBinaryFormatTest::testWriteAndRead()
+{
+  QFETCH(bool, compress);
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("test.yuvstats");
+
+  StatisticsBinaryFormat::TypeList types;
+  types.append(StatisticsType(1, "Value", "jet", -10, 100));
+  types.append(StatisticsType(2, "Vector", 4));
+  types[1].valMap.insert(0, "Zero");
+  types[1].description = "A vector type";
+
+  // Write the POCs in a random order and leave out type 2 of POC 1
+  StatisticsBinaryFormat::Writer writer;
+  QVERIFY(writer.open(fileName, QSize(1920, 1080), 50.0, types, compress));
+  QVERIFY(writer.addStatisticsData(3, 1, createTestData(3)));
+  QVERIFY(writer.addStatisticsData(0, 2, createTestData(0)));
+  QVERIFY(writer.addStatisticsData(0, 1, createTestData(10)));
+  QVERIFY(writer.addStatisticsData(1, 1, createTestData(1)));
+  QVERIFY(!writer.addStatisticsData(1, 1, createTestData(1)));
+  QVERIFY(writer.finish());
+
+  QFile file(fileName);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  StatisticsBinaryFormat::FileInfo info;
+  QString errorMessage;
+  QVERIFY2(StatisticsBinaryFormat::readFileInfo(&file, info, errorMessage), qPrintable(errorMessage));
+
+  QCOMPARE(info.frameSize, QSize(1920, 1080));
+  QCOMPARE(info.frameRate, 50.0);
+  QCOMPARE(info.maxPOC, 3);
+
+  QCOMPARE(info.types.size(), 2);
+  QCOMPARE(info.types[0].typeID, 1);
+  QCOMPARE(info.types[0].typeName, QString("Value"));
+  QVERIFY(info.types[0].hasValueData);
+  QCOMPARE(info.types[0].colMapper.rangeMin, -10);
+  QCOMPARE(info.types[0].colMapper.rangeMax, 100);
+  QCOMPARE(info.types[0].colMapper.complexType, QString("jet"));
+  QCOMPARE(info.types[1].typeID, 2);
+  QVERIFY(info.types[1].hasVectorData);
+  QCOMPARE(info.types[1].vectorScale, 4);
+  QCOMPARE(info.types[1].valMap.value(0), QString("Zero"));
+  QCOMPARE(info.types[1].description, QString("A vector type"));
+
+  QCOMPARE(info.index.keys(), QList<int>({0, 1, 3}));
+  QCOMPARE(info.index[0].keys(), QList<int>({1, 2}));
+  QCOMPARE(info.index[1].keys(), QList<int>({1}));
+  if (!compress)
+    QCOMPARE(info.index[3][1].size, info.index[3][1].uncompressedSize);
+  else
+    QVERIFY(info.index[3][1].size < info.index[3][1].uncompressedSize);
+
+  const QList<QPair<int, int>> pocTypeSeeds({{0, 1}, {0, 2}, {1, 1}, {3, 1}});
+  const QList<int> seeds({10, 0, 1, 3});
+  for (int i = 0; i < pocTypeSeeds.size(); i++)
+  {
+    statisticsData data;
+    QVERIFY(StatisticsBinaryFormat::readStatisticsData(&file, info.index[pocTypeSeeds[i].first][pocTypeSeeds[i].second], data));
+    compareStatisticsData(data, createTestData(seeds[i]));
+  }
+}
+
+void StatisticsBinaryFormatTest::testInvalidFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  // A CSV file is not a binary statistics file
+  QFile file(dir.filePath("test.yuvstats"));
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("%;syntax-version;v1.22\n%;seq-specs;test;0;1920;1080;50\n");
+  file.write(QByteArray(100, ';'));
+  file.close();
+
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  StatisticsBinaryFormat::FileInfo info;
+  QString errorMessage;
+  QVERIFY(!StatisticsBinaryFormat::readFileInfo(&file, info, errorMessage));
+  QVERIFY(!errorMessage.isEmpty());
+
+  // Corrupt payload data can not be decoded
+  statisticsData data;
+  const QByteArray payload = StatisticsBinaryFormat::encodeStatisticsData(createTestData(5));
+  QVERIFY(StatisticsBinaryFormat::decodeStatisticsData(payload.constData(), payload.size(), data));
+  statisticsData truncatedData;
+  QVERIFY(!StatisticsBinaryFormat::decodeStatisticsData(payload.constData(), payload.size() - 10, truncatedData));
+}
+
+QTEST_MAIN(StatisticsBinaryFormatTest)
+
+#include "tst_StatisticsBinaryFormat.moc"
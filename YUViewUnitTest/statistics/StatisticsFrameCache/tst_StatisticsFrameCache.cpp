@@ -0,0 +1,93 @@
+#include <QtTest>
+
+#include <statistics/statisticHandler.h>
+
+class StatisticsFrameCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsFrameCacheTest();
+  ~StatisticsFrameCacheTest();
+
+private slots:
+  void testSqueeze();
+  void testFrameCache();
+};
+
+namespace
+{
+
+statisticsData createTestData(int nrBlocks)
+{
+  statisticsData data;
+  for (int i = 0; i < nrBlocks; i++)
+    data.addBlockValue(i * 8, 0, 8, 8, i);
+  return data;
+}
+
+} // namespace
+
+StatisticsFrameCacheTest::StatisticsFrameCacheTest()
+{
+}
+
+StatisticsFrameCacheTest::~StatisticsFrameCacheTest()
+{
+}
+
+void StatisticsFrameCacheTest::testSqueeze()
+{
+  statisticsData data = createTestData(100);
+  data.valueData.reserve(1000);
+  const int64_t sizeReserved = data.getMemorySize();
+  QVERIFY(sizeReserved >= int64_t(1000 * sizeof(statisticsItem_Value)));
+
+  data.squeeze();
+  QCOMPARE(data.valueData.size(), 100);
+  QCOMPARE(data.valueData[99].value, 99);
+  QCOMPARE(data.getMemorySize(), int64_t(sizeof(statisticsData) + 100 * sizeof(statisticsItem_Value)));
+}
+
+void StatisticsFrameCacheTest::testFrameCache()
+{
+  statisticHandler handler;
+  StatisticsType renderedType(0, "Rendered", "jet", 0, 10);
+  renderedType.render = true;
+  handler.addStatType(renderedType);
+  handler.addStatType(StatisticsType(1, "Not Rendered", "jet", 0, 10));
+  QCOMPARE(handler.getRenderedTypeIDs(), QList<int>() << 0);
+
+  // A frame is only in the cache if all rendered types are cached
+  QHash<int, statisticsData> frameStatistics;
+  frameStatistics[1] = createTestData(10);
+  handler.addFrameToCache(5, frameStatistics);
+  QVERIFY(!handler.isInCache(5));
+  frameStatistics[0] = createTestData(10);
+  frameStatistics[0].squeeze();
+  frameStatistics[1].squeeze();
+  handler.addFrameToCache(5, frameStatistics);
+  QVERIFY(handler.isInCache(5));
+  QCOMPARE(handler.getNumberCachedFrames(), 1);
+
+  // The cached statistics count against the cache budget
+  const auto frameSize = int64_t(2 * (sizeof(statisticsData) + 10 * sizeof(statisticsItem_Value)));
+  QCOMPARE(int64_t(handler.getCachingFrameSize()), frameSize);
+  handler.addFrameToCache(6, frameStatistics);
+  QCOMPARE(int64_t(handler.getCachingFrameSize()), frameSize);
+  QCOMPARE(handler.getCachedFrames(), QList<int>() << 5 << 6);
+
+  // A cached frame does not need loading
+  QCOMPARE(handler.needsLoading(6), LoadingNotNeeded);
+  QCOMPARE(handler.needsLoading(7), LoadingNeeded);
+
+  handler.removeFrameFromCache(5);
+  QVERIFY(!handler.isInCache(5));
+  QVERIFY(handler.isInCache(6));
+  handler.removeAllFramesFromCache();
+  QCOMPARE(handler.getNumberCachedFrames(), 0);
+}
+
+QTEST_MAIN(StatisticsFrameCacheTest)
+
+#include "tst_StatisticsFrameCache.moc"
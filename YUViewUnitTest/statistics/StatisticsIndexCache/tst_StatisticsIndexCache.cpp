@@ -0,0 +1,95 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <statistics/statisticsIndexCache.h>
+
+class StatisticsIndexCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsIndexCacheTest();
+  ~StatisticsIndexCacheTest();
+
+private slots:
+  void testSaveAndLoad();
+};
+
+namespace
+{
+
+const QString formatTag = "playlistItemStatisticsCSVFile";
+
+bool writeFile(const QString &fileName, const QByteArray &data)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  return file.write(data) == data.size();
+}
+
+StatisticsIndexCache::Index createTestIndex()
+{
+  StatisticsIndexCache::Index index;
+  index.frameSize = QSize(416, 240);
+  index.frameRate = 50.0;
+  index.types.append(StatisticsType(0, "Value", "jet", 0, 255));
+  index.types.append(StatisticsType(1, "Vector", 4));
+  index.fileSortedByPOC = true;
+  index.maxPOC = 2;
+  for (int poc = 0; poc <= 2; poc++)
+  {
+    index.pocTypeStartList[poc][0] = poc * 1000;
+    index.pocTypeStartList[poc][1] = poc * 1000 + 500;
+    index.pocStartList[poc] = poc * 1000;
+  }
+  return index;
+}
+
+} // namespace
+
+StatisticsIndexCacheTest::StatisticsIndexCacheTest()
+{
+  // Do not write to the cache directory of the user
+  QStandardPaths::setTestModeEnabled(true);
+}
+
+StatisticsIndexCacheTest::~StatisticsIndexCacheTest() {}
+
+void StatisticsIndexCacheTest::testSaveAndLoad()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath("stats.csv");
+  QVERIFY(writeFile(fileName, QByteArray(3000, 'x')));
+
+  const auto fileState = StatisticsIndexCache::getFileState(fileName);
+  QCOMPARE(fileState.size, qint64(3000));
+
+  const auto index = createTestIndex();
+  QVERIFY(StatisticsIndexCache::saveIndex(fileName, formatTag, fileState, index));
+
+  StatisticsIndexCache::Index loaded;
+  QVERIFY(StatisticsIndexCache::loadIndex(fileName, formatTag, loaded));
+  QCOMPARE(loaded.frameSize, index.frameSize);
+  QCOMPARE(loaded.frameRate, index.frameRate);
+  QCOMPARE(loaded.fileSortedByPOC, index.fileSortedByPOC);
+  QCOMPARE(loaded.maxPOC, index.maxPOC);
+  QCOMPARE(loaded.pocTypeStartList, index.pocTypeStartList);
+  QCOMPARE(loaded.pocStartList, index.pocStartList);
+  QCOMPARE(loaded.types.size(), index.types.size());
+  for (int i = 0; i < index.types.size(); i++)
+  {
+    QCOMPARE(loaded.types[i].typeID, index.types[i].typeID);
+    QCOMPARE(loaded.types[i].typeName, index.types[i].typeName);
+    QCOMPARE(loaded.types[i].hasValueData, index.types[i].hasValueData);
+    QCOMPARE(loaded.types[i].hasVectorData, index.types[i].hasVectorData);
+    QCOMPARE(loaded.types[i].vectorScale, index.types[i].vectorScale);
+  }
+
+  QFile::remove(StatisticsIndexCache::getIndexFilePath(fileName));
+}
+
+QTEST_MAIN(StatisticsIndexCacheTest)
+
+#include "tst_StatisticsIndexCache.moc"
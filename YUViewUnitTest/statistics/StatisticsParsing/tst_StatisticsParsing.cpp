@@ -0,0 +1,348 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QTemporaryFile>
+
+#include <statistics/statisticsParsing.h>
+
+class StatisticsParsingTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsParsingTest();
+  ~StatisticsParsingTest();
+
+private slots:
+  void testFindNewline_data();
+  void testFindNewline();
+  void testCSVIndexing_data();
+  void testCSVIndexing();
+  void testCSVLineParsing_data();
+  void testCSVLineParsing();
+  void testVTMBMSLineParsing_data();
+  void testVTMBMSLineParsing();
+  void testFileLineReader();
+  void testFileLineReaderBuffered();
+
+  void benchmarkCSVFrameLoading();
+  void benchmarkVTMBMSFrameLoading();
+};
+
+namespace
+{
+
+// Write the data to a temporary file and parse all lines of the file with the given function (in a benchmark)
+template<typename ParseFunction>
+void benchmarkLineParsing(const QByteArray &data, int nrLines, ParseFunction parseLine)
+{
+  QTemporaryFile f;
+  QVERIFY(f.open());
+  f.write(data);
+  f.flush();
+
+  int nrLinesParsed = 0;
+  int nrIterations = 0;
+  QElapsedTimer timer;
+  timer.start();
+  QBENCHMARK
+  {
+    StatisticsParsing::FileLineReader reader(&f, 0);
+    const char *lineBegin, *lineEnd;
+    while (reader.readLine(lineBegin, lineEnd))
+      if (parseLine(lineBegin, lineEnd))
+        nrLinesParsed++;
+    nrIterations++;
+  }
+  const auto elapsed = timer.nsecsElapsed();
+
+  QCOMPARE(nrLinesParsed, nrLines * nrIterations);
+  if (elapsed > 0)
+    qInfo() << "Parsed" << qint64(double(nrLinesParsed) * 1e9 / double(elapsed)) << "lines per second";
+}
+
+// Lines with \n and \r\n, an empty line and a last line without a newline. The data is larger than the
+// block size of the FileLineReader so that lines are continued across blocks if the file is not mapped.
+QByteArray createLineReaderTestData(QList<QByteArray> &lines)
+{
+  QByteArray data;
+  for (int i = 0; i < 200000; i++)
+  {
+    lines.append((i == 100) ? QByteArray() : QByteArray("line") + QByteArray::number(i));
+    data.append(lines.last());
+    data.append((i % 2 == 0) ? "\n" : "\r\n");
+  }
+  lines.append("last");
+  data.append("last");
+  return data;
+}
+
+// Read all lines from the device (starting at the beginning of line startLine) and compare them
+void checkLineReader(QIODevice *device, const QList<QByteArray> &lines, int startLine)
+{
+  const qint64 startPos = (startLine == 0) ? 0 : lines[0].size() + 1;
+  StatisticsParsing::FileLineReader reader(device, startPos);
+  const char *lineBegin, *lineEnd;
+  int lineIdx = startLine;
+  while (reader.readLine(lineBegin, lineEnd))
+  {
+    QVERIFY(lineIdx < lines.size());
+    QCOMPARE(QByteArray(lineBegin, int(lineEnd - lineBegin)), lines[lineIdx]);
+    lineIdx++;
+  }
+  QCOMPARE(lineIdx, lines.size());
+}
+
+} // namespace
+
+StatisticsParsingTest::StatisticsParsingTest()
+{
+}
+
+StatisticsParsingTest::~StatisticsParsingTest()
+{
+}
+
+void StatisticsParsingTest::testFindNewline_data()
+{
+  QTest::addColumn<int>("dataLength");
+  QTest::addColumn<int>("newlinePosition");
+
+  // Test positions around the 16 byte blocks of the vectorized search
+  QTest::newRow("testNewlineStart") << 100 << 0;
+  QTest::newRow("testNewlineBlockEnd") << 100 << 15;
+  QTest::newRow("testNewlineBlockStart") << 100 << 16;
+  QTest::newRow("testNewlineTail") << 100 << 97;
+  QTest::newRow("testNewlineLast") << 100 << 99;
+  QTest::newRow("testNewlineShortBuffer") << 7 << 5;
+  QTest::newRow("testNoNewline") << 100 << -1;
+}
+
+void StatisticsParsingTest::testFindNewline()
+{
+  QFETCH(int, dataLength);
+  QFETCH(int, newlinePosition);
+
+  QByteArray data(dataLength, 'a');
+  if (newlinePosition >= 0)
+    data[newlinePosition] = '\n';
+
+  const char *begin = data.constData();
+  const char *end = begin + data.size();
+  const int expectedPosition = (newlinePosition >= 0) ? newlinePosition : dataLength;
+  QCOMPARE(int(StatisticsParsing::findNewline(begin, end) - begin), expectedPosition);
+}
+
+void StatisticsParsingTest::testCSVIndexing_data()
+{
+  QTest::addColumn<int>("nrThreads");
+  QTest::addColumn<int>("bufferSize");
+
+  QTest::newRow("testSingleThread") << 1 << 0;
+  QTest::newRow("testMultipleThreads") << 4 << 0;
+  QTest::newRow("testManyThreads") << 64 << 0;
+  QTest::newRow("testSmallBuffer") << 1 << 100;
+  QTest::newRow("testSmallBufferMultipleThreads") << 3 << 100;
+}
+
+void StatisticsParsingTest::testCSVIndexing()
+{
+  QFETCH(int, nrThreads);
+  QFETCH(int, bufferSize);
+
+  // Create a CSV file with a header, multiple blocks per POC/type and no newline at the end
+  const int nrPOCs = 20;
+  const int nrTypes = 3;
+  const int nrLinesPerBlock = 5;
+  QByteArray data("%;syntax-version;v1.22\n%;type;0;Test;range\n");
+  QList<qint64> expectedPositions;
+  for (int poc = 0; poc < nrPOCs; poc++)
+    for (int type = 0; type < nrTypes; type++)
+    {
+      expectedPositions.append(data.size());
+      for (int i = 0; i < nrLinesPerBlock; i++)
+      {
+        data.append(QString("%1;%2;0;8;8;%3;%4").arg(poc).arg(i * 8).arg(type).arg(i).toLatin1());
+        if (poc != nrPOCs - 1 || type != nrTypes - 1 || i != nrLinesPerBlock - 1)
+          data.append('\n');
+      }
+    }
+
+  if (bufferSize == 0)
+    bufferSize = data.size();
+
+  // Index the data in buffers of the given size (like reading the file in parts)
+  StatisticsParsing::CSVPocTypeStartList startList;
+  qint64 pos = 0;
+  while (pos < data.size())
+  {
+    const qint64 size = std::min(qint64(bufferSize), data.size() - pos);
+    const bool atEnd = (pos + size == data.size());
+    const qint64 bytesIndexed = StatisticsParsing::indexCSVBuffer(data.constData() + pos, size, pos, atEnd, nrThreads, startList);
+    QVERIFY(bytesIndexed > 0);
+    pos += bytesIndexed;
+  }
+
+  QCOMPARE(startList.size(), nrPOCs * nrTypes);
+  for (int i = 0; i < startList.size(); i++)
+  {
+    QCOMPARE(startList[i].poc, i / nrTypes);
+    QCOMPARE(startList[i].typeID, i % nrTypes);
+    QCOMPARE(qint64(startList[i].filePos), expectedPositions[i]);
+  }
+}
+
+void StatisticsParsingTest::testCSVLineParsing_data()
+{
+  QTest::addColumn<QByteArray>("line");
+  QTest::addColumn<QList<int>>("expectedValues");
+
+  QTest::newRow("testValue") << QByteArray("1;16;32;8;8;2;7") << QList<int>({1, 16, 32, 8, 8, 2, 7});
+  QTest::newRow("testVector") << QByteArray("3;0;0;16;8;1;-4;12") << QList<int>({3, 0, 0, 16, 8, 1, -4, 12});
+  QTest::newRow("testLine") << QByteArray("3;0;0;16;8;1;0;0;15;7") << QList<int>({3, 0, 0, 16, 8, 1, 0, 0, 15, 7});
+  QTest::newRow("testSpaces") << QByteArray(" 3; 4 ;-5;8;8;2;7\r") << QList<int>({3, 4, -5, 8, 8, 2, 7});
+  QTest::newRow("testEmptyFields") << QByteArray("3;;;8;8;2;x") << QList<int>({3, 0, 0, 8, 8, 2, 0});
+  QTest::newRow("testEmptyLine") << QByteArray("") << QList<int>();
+  QTest::newRow("testEmptyFirstField") << QByteArray(";1;2") << QList<int>();
+}
+
+void StatisticsParsingTest::testCSVLineParsing()
+{
+  QFETCH(QByteArray, line);
+  QFETCH(QList<int>, expectedValues);
+
+  int values[10];
+  const int nrValues = StatisticsParsing::parseCSVLine(line.constData(), line.constData() + line.size(), values, 10);
+  QCOMPARE(nrValues, expectedValues.size());
+  for (int i = 0; i < nrValues; i++)
+    QCOMPARE(values[i], expectedValues[i]);
+}
+
+void StatisticsParsingTest::testVTMBMSLineParsing_data()
+{
+  QTest::addColumn<QByteArray>("line");
+  QTest::addColumn<bool>("valid");
+  QTest::addColumn<int>("poc");
+  QTest::addColumn<QByteArray>("typeName");
+  QTest::addColumn<QList<int>>("position");
+  QTest::addColumn<QList<int>>("values");
+
+  QTest::newRow("testScalar") << QByteArray("BlockStat: POC 1 @( 112,  88) [ 8x 8] PredMode=0") << true << 1 << QByteArray("PredMode") << QList<int>({112, 88, 8, 8}) << QList<int>({0});
+  QTest::newRow("testVector") << QByteArray("BlockStat: POC 1 @( 120,  80) [ 8x 8] MVL0={ -24,  -2}") << true << 1 << QByteArray("MVL0") << QList<int>({120, 80, 8, 8}) << QList<int>({-24, -2});
+  QTest::newRow("testLine") << QByteArray("BlockStat: POC 2 @( 192,  96) [64x32] Line={0,0,31,31}") << true << 2 << QByteArray("Line") << QList<int>({192, 96, 64, 32}) << QList<int>({0, 0, 31, 31});
+  QTest::newRow("testAffine") << QByteArray("BlockStat: POC 2 @( 192,  96) [64x32] AffineMVL0={-324,-116,-276,-116,-324, -92}") << true << 2 << QByteArray("AffineMVL0") << QList<int>({192, 96, 64, 32}) << QList<int>({-324, -116, -276, -116, -324, -92});
+  QTest::newRow("testPolygon") << QByteArray("BlockStat: POC 2 @[(505, 384)--(511, 384)--(511, 415)--] GeoPUInterIntraFlag=1") << true << 2 << QByteArray("GeoPUInterIntraFlag") << QList<int>({505, 384, 511, 384, 511, 415}) << QList<int>({1});
+  QTest::newRow("testPolygonVector") << QByteArray("BlockStat: POC 4 @[(416, 448)--(447, 448)--(447, 478)--(416, 463)--] GeoMVL0={3, -1}") << true << 4 << QByteArray("GeoMVL0") << QList<int>({416, 448, 447, 448, 447, 478, 416, 463}) << QList<int>({3, -1});
+  QTest::newRow("testOtherLine") << QByteArray("# Sequence size: [416x 240]") << false << 0 << QByteArray() << QList<int>() << QList<int>();
+  QTest::newRow("testMissingBrace") << QByteArray("BlockStat: POC 3 @( 1, 2) [3x4] MVL0={1,2") << false << 3 << QByteArray() << QList<int>() << QList<int>();
+  QTest::newRow("testPolygonTooFewCorners") << QByteArray("BlockStat: POC 3 @[(1, 2)--(3, 4)--] Geo=1") << false << 3 << QByteArray() << QList<int>() << QList<int>();
+}
+
+void StatisticsParsingTest::testVTMBMSLineParsing()
+{
+  QFETCH(QByteArray, line);
+  QFETCH(bool, valid);
+  QFETCH(int, poc);
+  QFETCH(QByteArray, typeName);
+  QFETCH(QList<int>, position);
+  QFETCH(QList<int>, values);
+
+  const char *lineBegin = line.constData();
+  const char *lineEnd = line.constData() + line.size();
+
+  int parsedPOC;
+  const bool isBlockStat = line.startsWith("BlockStat");
+  QCOMPARE(StatisticsParsing::parseVTMBMSPoc(lineBegin, lineEnd, parsedPOC), isBlockStat);
+  if (isBlockStat)
+    QCOMPARE(parsedPOC, poc);
+
+  StatisticsParsing::VTMBMSLine statLine;
+  QCOMPARE(StatisticsParsing::parseVTMBMSLine(lineBegin, lineEnd, statLine), valid);
+  if (!valid)
+    return;
+
+  QCOMPARE(statLine.poc, poc);
+  QCOMPARE(QByteArray(statLine.typeNameBegin, int(statLine.typeNameEnd - statLine.typeNameBegin)), typeName);
+  if (statLine.isPolygon)
+  {
+    QCOMPARE(statLine.nrCorners * 2, position.size());
+    for (int i = 0; i < statLine.nrCorners; i++)
+    {
+      QCOMPARE(statLine.cornerX[i], position[i * 2]);
+      QCOMPARE(statLine.cornerY[i], position[i * 2 + 1]);
+    }
+  }
+  else
+    QCOMPARE(QList<int>({statLine.posX, statLine.posY, statLine.width, statLine.height}), position);
+
+  QCOMPARE(statLine.nrValues, values.size());
+  for (int i = 0; i < statLine.nrValues; i++)
+    QCOMPARE(statLine.values[i], values[i]);
+}
+
+void StatisticsParsingTest::testFileLineReader()
+{
+  QList<QByteArray> lines;
+  const auto data = createLineReaderTestData(lines);
+
+  QTemporaryFile f;
+  QVERIFY(f.open());
+  f.write(data);
+  f.flush();
+
+  // Start at the beginning of the file and at the beginning of the second line
+  for (const int startLine : {0, 1})
+    checkLineReader(&f, lines, startLine);
+}
+
+void StatisticsParsingTest::testFileLineReaderBuffered()
+{
+  // A QBuffer can not be mapped so the lines are read in blocks
+  QList<QByteArray> lines;
+  auto data = createLineReaderTestData(lines);
+
+  QBuffer buffer(&data);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+  for (const int startLine : {0, 1})
+    checkLineReader(&buffer, lines, startLine);
+}
+
+void StatisticsParsingTest::benchmarkCSVFrameLoading()
+{
+  // One frame of 8x8 block statistics of a 1080p sequence
+  QByteArray data;
+  int nrLines = 0;
+  for (int y = 0; y < 1080; y += 8)
+    for (int x = 0; x < 1920; x += 8)
+    {
+      data.append(QString("0;%1;%2;8;8;1;%3;%4\n").arg(x).arg(y).arg(x % 17 - 8).arg(y % 13 - 6).toLatin1());
+      nrLines++;
+    }
+
+  benchmarkLineParsing(data, nrLines, [](const char *lineBegin, const char *lineEnd) {
+    int values[10];
+    return StatisticsParsing::parseCSVLine(lineBegin, lineEnd, values, 10) == 8;
+  });
+}
+
+void StatisticsParsingTest::benchmarkVTMBMSFrameLoading()
+{
+  // One frame of 8x8 block statistics of a 1080p sequence
+  QByteArray data;
+  int nrLines = 0;
+  for (int y = 0; y < 1080; y += 8)
+    for (int x = 0; x < 1920; x += 8)
+    {
+      data.append(QString("BlockStat: POC 0 @(%1,%2) [ 8x 8] MVL0={%3,%4}\n").arg(x, 4).arg(y, 4).arg(x % 17 - 8, 3).arg(y % 13 - 6, 3).toLatin1());
+      nrLines++;
+    }
+
+  benchmarkLineParsing(data, nrLines, [](const char *lineBegin, const char *lineEnd) {
+    StatisticsParsing::VTMBMSLine statLine;
+    return StatisticsParsing::parseVTMBMSLine(lineBegin, lineEnd, statLine) && statLine.nrValues == 2;
+  });
+}
+
+QTEST_MAIN(StatisticsParsingTest)
+
+#include "tst_StatisticsParsing.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+SUBDIRS = StatisticsParsing
+SUBDIRS += StatisticsBinaryFormat
+SUBDIRS += StatisticsIndexCache
+SUBDIRS += StatisticsFrameCache
@@ -0,0 +1,117 @@
+#include <QtTest>
+
+#include <video/ReadyFrameQueue.h>
+
+class ReadyFrameQueueTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ReadyFrameQueueTest() {};
+  ~ReadyFrameQueueTest() {};
+
+private slots:
+  void testAddAndTake();
+  void testDepth();
+  void testRemoveFramesOutside();
+  void testMaxSize();
+};
+
+QImage createImage(int frameIdx)
+{
+  QImage image(4, 4, QImage::Format_RGB32);
+  image.fill(QColor(frameIdx, 0, 0));
+  return image;
+}
+
+void ReadyFrameQueueTest::testAddAndTake()
+{
+  ReadyFrameQueue queue(4);
+  for (int frameIdx = 10; frameIdx < 14; frameIdx++)
+    queue.addFrame(frameIdx, createImage(frameIdx));
+  QCOMPARE(queue.getNumberOfFrames(), 4);
+  QVERIFY(queue.contains(12));
+  QVERIFY(queue.takeFrame(20).isNull());
+
+  // Taking a frame also removes the frames before it
+  QCOMPARE(queue.takeFrame(11), createImage(11));
+  QVERIFY(!queue.contains(10));
+  QVERIFY(!queue.contains(11));
+  QCOMPARE(queue.getNumberOfFrames(), 2);
+
+  queue.clear();
+  QCOMPARE(queue.getNumberOfFrames(), 0);
+}
+
+void ReadyFrameQueueTest::testDepth()
+{
+  // If the queue is full, the frames that are furthest ahead are removed
+  ReadyFrameQueue queue(2);
+  queue.addFrame(5, createImage(5));
+  queue.addFrame(7, createImage(7));
+  queue.addFrame(6, createImage(6));
+  QCOMPARE(queue.getNumberOfFrames(), 2);
+  QVERIFY(queue.contains(5));
+  QVERIFY(queue.contains(6));
+  QVERIFY(!queue.contains(7));
+
+  queue.setDepth(1);
+  QCOMPARE(queue.getNumberOfFrames(), 1);
+  QVERIFY(queue.contains(5));
+
+  // The queue can always hold one frame
+  queue.setDepth(0);
+  QCOMPARE(queue.getDepth(), 1);
+}
+
+void ReadyFrameQueueTest::testRemoveFramesOutside()
+{
+  ReadyFrameQueue queue(8);
+  for (int frameIdx = 0; frameIdx < 8; frameIdx++)
+    queue.addFrame(frameIdx, createImage(frameIdx));
+  queue.removeFramesOutside(3, 5);
+  QCOMPARE(queue.getNumberOfFrames(), 3);
+  QVERIFY(!queue.contains(2));
+  QVERIFY(queue.contains(3));
+  QVERIFY(queue.contains(5));
+  QVERIFY(!queue.contains(6));
+}
+
+void ReadyFrameQueueTest::testMaxSize()
+{
+  // Each image has 4x4 pixels with 4 bytes
+  const int64_t imageSize = 4 * 4 * 4;
+  ReadyFrameQueue queue(8);
+  QCOMPARE(queue.getMaxSize(), int64_t(0));
+  queue.setMaxSize(imageSize * 3);
+  for (int frameIdx = 0; frameIdx < 2; frameIdx++)
+    queue.addFrame(frameIdx, createImage(frameIdx));
+  QVERIFY(!queue.isFull());
+  queue.addFrame(2, createImage(2));
+  QVERIFY(queue.isFull());
+
+  // If the size is exceeded, the frames that are furthest ahead are removed
+  queue.addFrame(3, createImage(3));
+  QCOMPARE(queue.getNumberOfFrames(), 3);
+  QCOMPARE(queue.getSizeInBytes(), imageSize * 3);
+  QVERIFY(!queue.contains(3));
+
+  queue.setMaxSize(imageSize * 2);
+  QCOMPARE(queue.getNumberOfFrames(), 2);
+  QVERIFY(queue.contains(1));
+  QVERIFY(!queue.contains(2));
+
+  // The queue always holds one frame, even if it is bigger than the size limit
+  queue.setMaxSize(imageSize / 2);
+  QCOMPARE(queue.getNumberOfFrames(), 1);
+  QVERIFY(queue.contains(0));
+  QVERIFY(queue.isFull());
+
+  // Without a size limit, only the depth limits the queue
+  queue.setMaxSize(0);
+  QVERIFY(!queue.isFull());
+}
+
+QTEST_MAIN(ReadyFrameQueueTest)
+
+#include "ReadyFrameQueueTest.moc"
@@ -4,4 +4,5 @@ requires(qtHaveModule(testlib))
 
 SUBDIRS = yuvPixelFormatTest.pro \
           rgbPixelFormatTest.pro \
-          yuvPixelFormatGuessTest.pro
+          yuvPixelFormatGuessTest.pro \
+          ReadyFrameQueueTest.pro